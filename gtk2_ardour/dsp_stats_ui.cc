@@ -23,6 +23,8 @@
 #include "ardour/session.h"
 #include "ardour/audioengine.h"
 #include "ardour/audio_backend.h"
+#include "ardour/audio_block_cache.h"
+#include "ardour/track.h"
 
 #include "widgets/tooltips.h"
 
@@ -39,6 +41,8 @@ using namespace Gtk;
 
 DspStatisticsGUI::DspStatisticsGUI ()
 	: buffer_size_label ("", ALIGN_RIGHT, ALIGN_CENTER)
+	, disk_cache_label ("", ALIGN_RIGHT, ALIGN_CENTER)
+	, disk_refill_label ("", ALIGN_RIGHT, ALIGN_CENTER)
 	, reset_button (_("Reset"))
 {
 	const size_t nlabels = Session::NTT + AudioEngine::NTT + AudioBackend::NTT;
@@ -80,6 +84,14 @@ DspStatisticsGUI::DspStatisticsGUI ()
 	table.attach (*labels[AudioEngine::NTT + Session::OverallProcess], 2, 3, row, row+1, Gtk::FILL, Gtk::SHRINK, 2, 0);
 	row++;
 
+	table.attach (*manage (new Gtk::Label (_("Disk cache: "), ALIGN_RIGHT, ALIGN_CENTER)), 0, 1, row, row+1, Gtk::FILL, Gtk::SHRINK, 2, 0);
+	table.attach (disk_cache_label, 2, 3, row, row+1, Gtk::FILL, Gtk::SHRINK, 2, 0);
+	row++;
+
+	table.attach (*manage (new Gtk::Label (_("Disk refill: "), ALIGN_RIGHT, ALIGN_CENTER)), 0, 1, row, row+1, Gtk::FILL, Gtk::SHRINK, 2, 0);
+	table.attach (disk_refill_label, 2, 3, row, row+1, Gtk::FILL, Gtk::SHRINK, 2, 0);
+	row++;
+
 	HBox* hbox2 = manage (new HBox);
 	hbox2->pack_start (reset_button, true, true);
 
@@ -109,6 +121,18 @@ void
 DspStatisticsGUI::reset_button_clicked ()
 {
 	ARDOUR::reset_performance_meters (_session);
+	if (AudioBlockCache::instance ()) {
+		AudioBlockCache::instance ()->reset_stats ();
+	}
+	if (_session) {
+		boost::shared_ptr<RouteList> tl = _session->get_tracks ();
+		for (RouteList::const_iterator i = tl->begin (); i != tl->end (); ++i) {
+			boost::shared_ptr<Track> t = boost::dynamic_pointer_cast<Track> (*i);
+			if (t) {
+				t->reset_playback_refill_stats ();
+			}
+		}
+	}
 }
 
 void
@@ -148,6 +172,22 @@ DspStatisticsGUI::update ()
 	snprintf (buf, sizeof (buf), "%d samples / %5.2f msecs", bufsize, bufsize_msecs);
 	buffer_size_label.set_text (buf);
 
+	AudioBlockCache* cache = AudioBlockCache::instance ();
+	if (cache && cache->enabled ()) {
+		AudioBlockCache::Stats cs (cache->stats ());
+		snprintf (buf, sizeof (buf), _("%5.1f%% hits"), 100.0 * cs.hit_rate ());
+		disk_cache_label.set_text (buf);
+		char tip[256];
+		snprintf (tip, sizeof (tip), _("hits: %" PRIu64 " misses: %" PRIu64 " prefetched: %" PRIu64 " evicted: %" PRIu64 " (%.1f of %.1f MB used)"),
+		          cs.hits, cs.misses, cs.prefetched, cs.evictions, cs.bytes / 1048576.0, cs.budget / 1048576.0);
+		ArdourWidgets::set_tooltip (&disk_cache_label, tip);
+	} else {
+		disk_cache_label.set_text (not_measured_string);
+		ArdourWidgets::set_tooltip (&disk_cache_label, "");
+	}
+
+	update_disk_refill ();
+
 	if (AudioEngine::instance()->current_backend()->dsp_stats[AudioBackend::DeviceWait].get_stats (min, max, avg, dev)) {
 
 		/* We show the min time here, since that's the worst case
@@ -291,3 +331,60 @@ DspStatisticsGUI::on_key_press_event (GdkEventKey* ev)
 	Gtk::Window& main_window (ARDOUR_UI::instance()->main_window());
 	return ARDOUR_UI_UTILS::relay_key_press (ev, &main_window);
 }
+
+/* Show the slowest playback buffer refill of all tracks, and the least
+ * amount of buffered data that was left when a refill completed.
+ */
+void
+DspStatisticsGUI::update_disk_refill ()
+{
+	char buf[64];
+	char tip[256];
+
+	RefillStats worst;
+	std::string worst_name;
+	bool        headroom_known = false;
+	double      min_headroom   = 0;
+	std::string headroom_name;
+
+	if (_session) {
+		boost::shared_ptr<RouteList> tl = _session->get_tracks ();
+		for (RouteList::const_iterator i = tl->begin (); i != tl->end (); ++i) {
+			boost::shared_ptr<Track> t = boost::dynamic_pointer_cast<Track> (*i);
+			if (!t) {
+				continue;
+			}
+			RefillStats rs (t->playback_refill_stats ());
+			if (rs.count == 0) {
+				continue;
+			}
+			if (worst.count == 0 || rs.max > worst.max) {
+				worst      = rs;
+				worst_name = t->name ();
+			}
+			if (rs.rolling > 0 && (!headroom_known || rs.min_headroom < min_headroom)) {
+				headroom_known = true;
+				min_headroom   = rs.min_headroom;
+				headroom_name  = t->name ();
+			}
+		}
+	}
+
+	if (worst.count == 0) {
+		disk_refill_label.set_text (X_("--"));
+		ArdourWidgets::set_tooltip (&disk_refill_label, "");
+		return;
+	}
+
+	if (headroom_known) {
+		snprintf (buf, sizeof (buf), _("%7.2f msec, %5.2f sec left"), worst.max / 1000.0, min_headroom);
+		snprintf (tip, sizeof (tip), _("slowest refill: %.2f msec (%s, average %.2f msec)\nleast buffered data after a refill: %.2f sec (%s)"),
+		          worst.max / 1000.0, worst_name.c_str (), worst.avg / 1000.0, min_headroom, headroom_name.c_str ());
+	} else {
+		snprintf (buf, sizeof (buf), _("%7.2f msec"), worst.max / 1000.0);
+		snprintf (tip, sizeof (tip), _("slowest refill: %.2f msec (%s, average %.2f msec)"),
+		          worst.max / 1000.0, worst_name.c_str (), worst.avg / 1000.0);
+	}
+	disk_refill_label.set_text (buf);
+	ArdourWidgets::set_tooltip (&disk_refill_label, tip);
+}
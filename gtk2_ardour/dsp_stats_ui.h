@@ -39,11 +39,14 @@ protected:
 
 private:
 	void update ();
+	void update_disk_refill ();
 
 	sigc::connection update_connection;
 
 	Gtk::Table table;
 	Gtk::Label buffer_size_label;
+	Gtk::Label disk_cache_label;
+	Gtk::Label disk_refill_label;
 	Gtk::Label** labels;
 	Gtk::Button reset_button;
 	Gtk::Label info_text;
@@ -1527,6 +1527,7 @@ private:
 	EditorImportStatus import_status;
 	static void*_import_thread (void*);
 	void* import_thread ();
+	void run_import_thread (std::vector<std::string> const& paths, Editing::ImportDisposition, ARDOUR::SrcQuality, bool replace);
 	void finish_import ();
 
 	/* to support this ... */
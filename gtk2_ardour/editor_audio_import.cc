@@ -449,9 +449,12 @@ Editor::do_import (vector<string>          paths,
 
 	} else {
 
-		bool replace = false;
+		/* skip periodic saves while importing */
+		Session::StateProtector sp (_session);
 
-		for (vector<string>::iterator a = paths.begin(); a != paths.end() && !import_status.cancel; ++a) {
+		vector<string> checked;
+
+		for (vector<string>::iterator a = paths.begin(); a != paths.end(); ++a) {
 
 			const int check = check_whether_and_how_to_import (*a, true);
 
@@ -464,57 +467,51 @@ Editor::do_import (vector<string>          paths,
 				abort(); /* NOTREACHED*/
 				break;
 			case 1:
-				replace = false;
 				break;
 			default:
 				fatal << "Illegal return " << check <<  " from check_whether_and_how_to_import()!" << endmsg;
 				abort(); /* NOTREACHED*/
 			}
 
-			/* have to reset this for every file we handle */
+			checked.push_back (*a);
+		}
 
-			if (use_timestamp) {
-				pos = timepos_t::max (pos.time_domain());
-			}
+		if (!checked.empty ()) {
 
 			ipw.show ();
 
-			switch (disposition) {
-			case Editing::ImportDistinctFiles:
+			/* import all files at once, so that they are decoded in
+			 * parallel, then add each file's sources separately.
+			 */
+			run_import_thread (checked, disposition, quality, false);
 
-				to_import.clear ();
-				to_import.push_back (*a);
-
-				if (mode == Editing::ImportToTrack) {
-					track = get_nth_selected_audio_track (nth++);
-				}
+			const int target_regions = (disposition == Editing::ImportDistinctChannels) ? -1 : 1;
+			const int target_tracks  = (disposition == Editing::ImportSerializeFiles) ? 1 : -1;
 
-				import_sndfiles (to_import, disposition, mode, quality, pos, 1, -1, track, pgroup_id, replace, instrument);
-				import_status.clear();
-				break;
+			for (size_t n = 0; n < checked.size () && !import_status.cancel && n < import_status.path_sources.size (); ++n) {
 
-			case Editing::ImportDistinctChannels:
+				if (import_status.path_sources[n].empty ()) {
+					continue;
+				}
 
-				to_import.clear ();
-				to_import.push_back (*a);
+				/* have to reset this for every file we handle */
 
-				import_sndfiles (to_import, disposition, mode, quality, pos, -1, -1, track, pgroup_id, replace, instrument);
-				import_status.clear();
-				break;
+				if (use_timestamp) {
+					pos = timepos_t::max (pos.time_domain());
+				}
 
-			case Editing::ImportSerializeFiles:
+				if (disposition == Editing::ImportDistinctFiles && mode == Editing::ImportToTrack) {
+					track = get_nth_selected_audio_track (nth++);
+				}
 
 				to_import.clear ();
-				to_import.push_back (*a);
-
-				import_sndfiles (to_import, disposition, mode, quality, pos, 1, 1, track, pgroup_id, replace, instrument);
-				import_status.clear();
-				break;
+				to_import.push_back (checked[n]);
 
-			case Editing::ImportMergeFiles:
-				// Not entered, handled in earlier if() branch
-				break;
+				add_sources (to_import, import_status.path_sources[n], pos, disposition, mode,
+				             target_regions, target_tracks, track, pgroup_id, false, instrument);
 			}
+
+			import_status.clear();
 		}
 	}
 
@@ -616,13 +613,6 @@ Editor::import_sndfiles (vector<string>            paths,
 	/* skip periodic saves while importing */
 	Session::StateProtector sp (_session);
 
-	import_status.paths = paths;
-	import_status.done = false;
-	import_status.freeze = false;
-	import_status.quality = quality;
-	import_status.replace_existing_source = replace;
-	import_status.split_midi_channels = (disposition == Editing::ImportDistinctChannels);
-
 	import_status.mode = mode;
 	import_status.pos = pos;
 	import_status.target_tracks = target_tracks;
@@ -630,25 +620,7 @@ Editor::import_sndfiles (vector<string>            paths,
 	import_status.track = track;
 	import_status.replace = replace;
 
-	CursorContext::Handle cursor_ctx = CursorContext::create(*this, _cursors->wait);
-	gdk_flush ();
-
-	/* start import thread for this spec. this will ultimately call Session::import_files()
-	   which, if successful, will add the files as regions to the region list. its up to us
-	   (the GUI) to direct additional steps after that.
-	*/
-
-	pthread_create_and_store ("import", &import_status.thread, _import_thread, this);
-	pthread_detach (import_status.thread);
-
-	while (!import_status.done && !import_status.cancel) {
-		gtk_main_iteration ();
-	}
-
-	// wait for thread to terminate
-	while (!import_status.done) {
-		gtk_main_iteration ();
-	}
+	run_import_thread (paths, disposition, quality, replace);
 
 	int result = -1;
 
@@ -672,6 +644,38 @@ Editor::import_sndfiles (vector<string>            paths,
 	return result;
 }
 
+/** Import @param paths in the import thread, the new sources are left in import_status */
+void
+Editor::run_import_thread (vector<string> const& paths, ImportDisposition disposition, SrcQuality quality, bool replace)
+{
+	import_status.paths = paths;
+	import_status.done = false;
+	import_status.freeze = false;
+	import_status.quality = quality;
+	import_status.replace_existing_source = replace;
+	import_status.split_midi_channels = (disposition == Editing::ImportDistinctChannels);
+
+	CursorContext::Handle cursor_ctx = CursorContext::create(*this, _cursors->wait);
+	gdk_flush ();
+
+	/* start import thread for this spec. this will ultimately call Session::import_files()
+	   which, if successful, will add the files as regions to the region list. its up to us
+	   (the GUI) to direct additional steps after that.
+	*/
+
+	pthread_create_and_store ("import", &import_status.thread, _import_thread, this);
+	pthread_detach (import_status.thread);
+
+	while (!import_status.done && !import_status.cancel) {
+		gtk_main_iteration ();
+	}
+
+	// wait for thread to terminate
+	while (!import_status.done) {
+		gtk_main_iteration ();
+	}
+}
+
 int
 Editor::embed_sndfiles (vector<string>            paths,
                         bool                      multifile,
@@ -18,8 +18,11 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <cmath>
+
 #include <glibmm/main.h>
 #include <gtkmm/stock.h>
+#include "pbd/compose.h"
 #include "gtkmm2ext/utils.h"
 #include "ardour/import_status.h"
 #include "interthread_progress_window.h"
@@ -99,7 +102,11 @@ bool
 ImportProgressWindow::update ()
 {
 	_cancel_button.set_sensitive (!_import_status->freeze);
-	_label.set_markup ("<i>" + Gtkmm2ext::markup_escape_text (_import_status->doing_what) + "</i>");
+	std::string what = _import_status->doing_what;
+	if (_import_status->throughput > 0) {
+		what += string_compose (_(" (%1 MB/s)"), (int) rintf (_import_status->throughput));
+	}
+	_label.set_markup ("<i>" + Gtkmm2ext::markup_escape_text (what) + "</i>");
 
 	/* use overall progress for the bar, rather than that for individual files */
 	_bar.set_fraction ((_import_status->current - 1 + _import_status->progress) / _import_status->total);
@@ -2421,6 +2421,16 @@ RCOptionEditor::RCOptionEditor ()
 		     sigc::mem_fun (*_rc_config, &RCConfiguration::set_periodic_safety_backups)
 		     ));
 
+	bo = new BoolOption (
+		     "binary-safety-backups",
+		     _("Use incremental binary format for periodic backups"),
+		     sigc::mem_fun (*_rc_config, &RCConfiguration::get_binary_safety_backups),
+		     sigc::mem_fun (*_rc_config, &RCConfiguration::set_binary_safety_backups)
+		     );
+	Gtkmm2ext::UI::instance()->set_tip (bo->tip_widget(),
+			_("When enabled, periodic backups only write the objects whose state changed since the previous backup. The session file itself is always saved as XML."));
+	add_option (_("General"), bo);
+
 	add_option (_("General"), new DirectoryOption (
 			    X_("default-session-parent-dir"),
 			    _("Default folder for new sessions:"),
@@ -3790,6 +3800,24 @@ These settings will only take effect after %1 is restarted.\n\
 				sigc::mem_fun (*this, &RCOptionEditor::plugin_scan_refresh)));
 
 	add_option (_("Plugins"), new PluginScanTimeOutSliderOption (_rc_config));
+
+	if (hardware_concurrency () > 1) {
+		ComboOption<uint32_t>* sj = new ComboOption<uint32_t> (
+				"plugin-scan-jobs",
+				_("Concurrent plugin scans"),
+				sigc::mem_fun (*_rc_config, &RCConfiguration::get_plugin_scan_jobs),
+				sigc::mem_fun (*_rc_config, &RCConfiguration::set_plugin_scan_jobs)
+				);
+
+		sj->add (0, _("automatic (one per CPU)"));
+		sj->add (1, _("one at a time"));
+		for (uint32_t i = 2; i <= std::min<uint32_t> (hardware_concurrency (), 16); ++i) {
+			sj->add (i, string_compose (P_("%1 process", "%1 processes", i), i));
+		}
+		Gtkmm2ext::UI::instance()->set_tip (sj->tip_widget(),
+				_("Number of external scanner processes that test new or updated VST plugins at the same time."));
+		add_option (_("Plugins"), sj);
+	}
 #endif
 
 	add_option (_("Plugins"), new OptionEditorHeading (_("General")));
@@ -4550,6 +4578,34 @@ These settings will only take effect after %1 is restarted.\n\
 		procs->set_note (string_compose (_("This setting will only take effect when %1 is restarted."), PROGRAM_NAME));
 
 		add_option (_("Performance"), procs);
+
+		bo = new BoolOption (
+				"graph-work-stealing",
+				_("Use work-stealing DSP scheduler"),
+				sigc::mem_fun (*_rc_config, &RCConfiguration::get_graph_work_stealing),
+				sigc::mem_fun (*_rc_config, &RCConfiguration::set_graph_work_stealing)
+				);
+		set_tooltip (bo->tip_widget(), _("When enabled, each DSP thread has its own queue of routes ready to be processed, and idle threads steal work from busy ones. A route that was made ready by the route just processed continues on the same CPU core. This reduces contention with large sessions and many processors."));
+		add_option (_("Performance"), bo);
+
+		bo = new BoolOption (
+				"parallel-replicated-plugins",
+				_("Process replicated plugin instances in parallel"),
+				sigc::mem_fun (*_rc_config, &RCConfiguration::get_parallel_replicated_plugins),
+				sigc::mem_fun (*_rc_config, &RCConfiguration::set_parallel_replicated_plugins)
+				);
+		set_tooltip (bo->tip_widget(), _("When a mono plugin is replicated to process a multi-channel signal, run the instances concurrently on the DSP threads instead of one after another. This shortens the critical path of busses with many channels and heavy plugins."));
+		add_option (_("Performance"), bo);
+
+		SpinOption<uint32_t>* so = new SpinOption<uint32_t> (
+				"parallel-plugin-threshold",
+				_("Minimum DSP time per plugin instance (microseconds)"),
+				sigc::mem_fun (*_rc_config, &RCConfiguration::get_parallel_plugin_threshold),
+				sigc::mem_fun (*_rc_config, &RCConfiguration::set_parallel_plugin_threshold),
+				0, 10000, 10, 100
+				);
+		set_tooltip (so->tip_widget(), _("Replicated plugin instances are only processed in parallel if each instance takes longer than this on average. Cheaper plugins are run one after another, since the synchronization overhead would outweigh the gain."));
+		add_option (_("Performance"), so);
 	}
 
 #if !(defined PLATFORM_WINDOWS || defined __APPLE__)
@@ -4662,6 +4718,50 @@ These settings will only take effect after %1 is restarted.\n\
 
 	add_option (_("Performance"), new BufferingOptions (_rc_config));
 
+	if (hwcpus > 1) {
+		ComboOption<int32_t>* iothreads = new ComboOption<int32_t> (
+				"disk-io-threads",
+				_("Disk reads use"),
+				sigc::mem_fun (*_rc_config, &RCConfiguration::get_disk_io_threads),
+				sigc::mem_fun (*_rc_config, &RCConfiguration::set_disk_io_threads)
+				);
+
+		iothreads->add (0, _("automatic"));
+		iothreads->add (1, _("a single thread"));
+		for (uint32_t i = 2; i <= std::min<uint32_t> (hwcpus, 16); ++i) {
+			iothreads->add (i, string_compose (P_("%1 thread", "%1 threads", i), i));
+		}
+		set_tooltip (iothreads->tip_widget(), _("Number of threads used to refill track playback buffers from disk. Tracks with the least amount of buffered data are read first. Using more than one thread helps to keep fast storage busy with large sessions, in particular after a locate."));
+
+		add_option (_("Performance"), iothreads);
+	}
+
+	ComboOption<uint32_t>* blockcache = new ComboOption<uint32_t> (
+			"audio-block-cache-size",
+			_("Decoded audio cache"),
+			sigc::mem_fun (*_rc_config, &RCConfiguration::get_audio_block_cache_size),
+			sigc::mem_fun (*_rc_config, &RCConfiguration::set_audio_block_cache_size)
+			);
+
+	blockcache->add (0, _("disabled"));
+	blockcache->add (64, _("64 MB"));
+	blockcache->add (128, _("128 MB"));
+	blockcache->add (256, _("256 MB"));
+	blockcache->add (512, _("512 MB"));
+	blockcache->add (1024, _("1 GB"));
+	blockcache->add (2048, _("2 GB"));
+	set_tooltip (blockcache->tip_widget(), _("Memory used to cache audio data that was read from disk. Tracks that share audio files (comped takes, duplicated playlists, looped regions) read each part of a file only once."));
+	add_option (_("Performance"), blockcache);
+
+	bo = new BoolOption (
+			"prefetch-locations",
+			_("Prefetch audio at markers and loop range"),
+			sigc::mem_fun (*_rc_config, &RCConfiguration::get_prefetch_locations),
+			sigc::mem_fun (*_rc_config, &RCConfiguration::set_prefetch_locations)
+			);
+	set_tooltip (bo->tip_widget(), _("When enabled, audio data at the position of markers and the loop range is loaded into the decoded audio cache in the background, so that playback can start quickly after locating there."));
+	add_option (_("Performance"), bo);
+
 	/* Image cache size */
 	add_option (_("Performance"), new OptionEditorHeading (_("Memory Usage")));
 
@@ -4677,6 +4777,18 @@ These settings will only take effect after %1 is restarted.\n\
 		 _("Increasing the cache size uses more memory to store waveform images, which can improve graphical performance."));
 	add_option (_("Performance"), sics);
 
+	SpinOption<uint32_t>* tmb = new SpinOption<uint32_t> (
+			"trigger-memory-budget",
+			_("Clip memory per cue track (megabytes, 0: unlimited)"),
+			sigc::mem_fun (*_rc_config, &RCConfiguration::get_trigger_memory_budget),
+			sigc::mem_fun (*_rc_config, &RCConfiguration::set_trigger_memory_budget),
+			0, 65536, 64, 256
+			);
+	Gtkmm2ext::UI::instance()->set_tip (
+			tmb->tip_widget(),
+			_("Audio clips are loaded into memory until this limit is reached. Clips that do not fit are streamed from disk, keeping only their first few seconds in memory for instant launch. Changes apply to clips loaded afterwards."));
+	add_option (_("Performance"), tmb);
+
 	add_option (_("Performance"), new OptionEditorHeading (_("Automation")));
 
 	add_option (_("Performance"),
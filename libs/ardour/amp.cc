@@ -33,6 +33,7 @@
 #include "ardour/gain_control.h"
 #include "ardour/midi_buffer.h"
 #include "ardour/rc_configuration.h"
+#include "ardour/runtime_functions.h"
 #include "ardour/session.h"
 
 #include "pbd/i18n.h"
@@ -105,12 +106,18 @@ Amp::run (BufferSet& bufs, samplepos_t /*start_sample*/, samplepos_t /*end_sampl
 		const gain_t a = 156.825f / (gain_t)_session.nominal_sample_rate(); // 25 Hz LPF; see Amp::apply_gain for details
 		gain_t lpf = _current_gain;
 
-		for (BufferSet::audio_iterator i = bufs.audio_begin(); i != bufs.audio_end(); ++i) {
-			Sample* const sp = i->data();
-			lpf = _current_gain;
+		if (bufs.count().n_audio() > 0) {
+			/* smooth the automation curve once (in place, the buffer is
+			 * re-filled by setup_gain_automation() every cycle), then apply
+			 * it to all channels using the vectorized gain-vector routine.
+			 */
 			for (pframes_t nx = 0; nx < nframes; ++nx) {
-				sp[nx] *= lpf;
+				const gain_t g = lpf;
 				lpf += a * (gab[nx] - lpf);
+				gab[nx] = g;
+			}
+			for (BufferSet::audio_iterator i = bufs.audio_begin(); i != bufs.audio_end(); ++i) {
+				apply_gain_vector_to_buffer (i->data(), gab, nframes);
 			}
 		}
 
@@ -174,13 +181,7 @@ Amp::apply_gain (BufferSet& bufs, samplecnt_t sample_rate, samplecnt_t nframes,
 	const gain_t a = 156.825f / (gain_t)sample_rate; // 25 Hz LPF
 
 	for (BufferSet::audio_iterator i = bufs.audio_begin(); i != bufs.audio_end(); ++i) {
-		Sample* const buffer = i->data();
-		double lpf = initial;
-
-		for (pframes_t nx = 0; nx < nframes; ++nx) {
-			buffer[nx] *= lpf;
-			lpf += a * (target - lpf);
-		}
+		const gain_t lpf = apply_gain_ramp_to_buffer (i->data(), nframes, initial, target, a);
 		if (i == bufs.audio_begin()) {
 			rv = lpf;
 		}
@@ -256,11 +257,7 @@ Amp::apply_gain (AudioBuffer& buf, samplecnt_t sample_rate, samplecnt_t nframes,
 	Sample* const buffer = buf.data (offset);
 	const gain_t a = 156.825f / (gain_t)sample_rate; // 25 Hz LPF, see [other] Amp::apply_gain() above for details
 
-	gain_t lpf = initial;
-	for (pframes_t nx = 0; nx < nframes; ++nx) {
-		buffer[nx] *= lpf;
-		lpf += a * (target - lpf);
-	}
+	const gain_t lpf = apply_gain_ramp_to_buffer (buffer, nframes, initial, target, a);
 
 	if (fabsf (lpf - target) < GAIN_COEFF_DELTA) return target;
 	return lpf;
@@ -306,7 +303,11 @@ Amp::apply_simple_gain (BufferSet& bufs, samplecnt_t nframes, gain_t target, boo
 		}
 
 		for (BufferSet::audio_iterator i = bufs.audio_begin(); i != bufs.audio_end(); ++i) {
-			apply_gain_to_buffer (i->data(), nframes, target);
+			if (target == -GAIN_COEFF_UNITY) {
+				invert_buffer (i->data(), nframes);
+			} else {
+				apply_gain_to_buffer (i->data(), nframes, target);
+			}
 		}
 	}
 }
@@ -316,6 +317,8 @@ Amp::apply_simple_gain (AudioBuffer& buf, samplecnt_t nframes, gain_t target, sa
 {
 	if (fabsf (target) < GAIN_COEFF_SMALL) {
 		memset (buf.data (offset), 0, sizeof (Sample) * nframes);
+	} else if (target == -GAIN_COEFF_UNITY) {
+		invert_buffer (buf.data(offset), nframes);
 	} else if (target != GAIN_COEFF_UNITY) {
 		apply_gain_to_buffer (buf.data(offset), nframes, target);
 	}
@@ -398,6 +401,33 @@ Amp::visible() const
  *  gain automationc curves.  Must be called before setup_gain_automation,
  *  and must be called with process lock held.
  */
+/** Query if run() would apply a constant gain during this cycle,
+ *  without gain automation or declick. This allows callers to fuse
+ *  the gain-stage with other operations.
+ *
+ *  Only valid after calling setup_gain_automation().
+ *
+ *  @param g set to the gain that would be applied
+ */
+bool
+Amp::constant_gain (gain_t& g) const
+{
+	if (!_pending_active || _apply_gain_automation) {
+		return false;
+	}
+	g = _gain_control->get_value ();
+	return fabsf (_current_gain - g) < GAIN_COEFF_DELTA;
+}
+
+/** To be called instead of run() by a caller that applied the
+ *  gain returned by constant_gain() itself.
+ */
+void
+Amp::constant_gain_applied (gain_t g)
+{
+	_current_gain = g;
+}
+
 void
 Amp::set_gain_automation_buffer (gain_t* g)
 {
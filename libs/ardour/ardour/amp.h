@@ -54,6 +54,9 @@ public:
 
 	void setup_gain_automation (samplepos_t start_sample, samplepos_t end_sample, samplecnt_t nframes);
 
+	bool constant_gain (gain_t& g) const;
+	void constant_gain_applied (gain_t g);
+
 	XMLNode& state ();
 	int set_state (const XMLNode&, int version);
 
@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2026 The Ardour Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __ardour_audio_block_cache_h__
+#define __ardour_audio_block_cache_h__
+
+#include <atomic>
+#include <list>
+#include <map>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
+
+#include <glibmm/threads.h>
+
+#include "pbd/pthread_utils.h"
+#include "pbd/signals.h"
+
+#include "ardour/libardour_visibility.h"
+#include "ardour/types.h"
+
+namespace ARDOUR
+{
+class AudioFileSource;
+class AudioSource;
+
+/** A process-wide LRU cache of decoded audio.
+ *
+ * Audio file data is cached in fixed size blocks, keyed by source and
+ * block index. Reads of AudioFileSources go through the cache, so tracks
+ * that share sources (comped takes, duplicated playlists, looped regions)
+ * decode each block only once. Only immutable sources are cached.
+ *
+ * The memory budget is set by the "audio-block-cache-size" preference,
+ * a size of zero (the default) disables the cache.
+ *
+ * Every source has a generation which is bumped when its blocks are
+ * dropped. Blocks read before that are rejected by insert(), so a read
+ * racing with e.g. a gain change cannot re-add stale data.
+ */
+class LIBARDOUR_API AudioBlockCache
+{
+public:
+	static const samplecnt_t block_samples = 32768;
+
+	struct Block {
+		Block (samplecnt_t n) : data (new Sample[n]), length (n) {}
+		~Block () { delete[] data; }
+		Sample*     data;
+		samplecnt_t length;
+
+	private:
+		Block (Block const&);
+		Block& operator= (Block const&);
+	};
+
+	typedef boost::shared_ptr<Block> BlockPtr;
+
+	struct Stats {
+		Stats () : hits (0), misses (0), prefetched (0), evictions (0), bytes (0), budget (0) {}
+		uint64_t hits;
+		uint64_t misses;
+		uint64_t prefetched; ///< blocks loaded ahead of time
+		uint64_t evictions;
+		size_t   bytes;      ///< memory currently used
+		size_t   budget;
+
+		double hit_rate () const { return hits + misses > 0 ? hits / (double)(hits + misses) : 0; }
+	};
+
+	static void init ();
+	static void terminate ();
+
+	/** @return the cache, or 0 if ARDOUR was not initialized */
+	static AudioBlockCache* instance () { return _instance; }
+
+	bool enabled () const { return _budget.load () > 0; }
+	void set_budget (size_t bytes);
+
+	BlockPtr lookup (AudioSource const*, int64_t block);
+	bool     contains (AudioSource const*, int64_t block) const;
+	void     insert (AudioSource const*, int64_t block, BlockPtr, uint64_t generation, bool prefetched = false);
+
+	/** @return the generation to pass to insert() for data read from now on */
+	uint64_t generation (AudioSource const*) const;
+
+	/** remove all blocks of the given source and invalidate pending inserts */
+	void drop (AudioSource const*);
+	/** remove all state of a source that is going away */
+	void forget (AudioSource const*);
+	void clear ();
+
+	/** Asynchronously load the given range of a source into the cache */
+	void prefetch (boost::shared_ptr<AudioFileSource>, samplepos_t start, samplecnt_t cnt);
+
+	Stats stats () const;
+	void  reset_stats ();
+
+private:
+	AudioBlockCache ();
+	~AudioBlockCache ();
+
+	static AudioBlockCache* _instance;
+
+	typedef std::pair<AudioSource const*, int64_t> Key;
+	typedef std::list<std::pair<Key, BlockPtr> >   LRU;
+	typedef std::map<Key, LRU::iterator>           Index;
+	typedef std::map<AudioSource const*, uint64_t> Generations;
+
+	struct PrefetchRequest {
+		PrefetchRequest (boost::shared_ptr<AudioFileSource> s, samplepos_t p, samplecnt_t c)
+			: source (s), start (p), cnt (c) {}
+		boost::weak_ptr<AudioFileSource> source;
+		samplepos_t                      start;
+		samplecnt_t                      cnt;
+	};
+
+	void evict_to (size_t bytes);
+	void drop_locked (AudioSource const*);
+	void prefetch_thread ();
+	void config_changed (std::string const&);
+
+	mutable Glib::Threads::Mutex _lock;
+	LRU                          _lru;
+	Index                        _index;
+	Generations                  _generations;
+	std::atomic<size_t>          _budget;
+	size_t                       _bytes;
+	Stats                        _stats;
+
+	Glib::Threads::Mutex       _queue_lock;
+	Glib::Threads::Cond        _queue_cond;
+	std::list<PrefetchRequest> _queue;
+	bool                       _thread_run;
+	PBD::Thread*               _thread;
+
+	PBD::ScopedConnection _config_connection;
+};
+
+} // namespace ARDOUR
+
+#endif /* __ardour_audio_block_cache_h__ */
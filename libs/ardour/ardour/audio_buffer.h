@@ -128,6 +128,47 @@ public:
 		_written = true;
 	}
 
+	/** Accumulate (add) \p len samples from \p src into self, and return the
+	 * absolute peak of the result, combined with \p peak.
+	 * This is a fused mix-and-meter operation, see PeakMeter::set_input_peaks()
+	 */
+	float accumulate_from_with_peak (const AudioBuffer& src, samplecnt_t len, float peak)
+	{
+		assert (_capacity > 0);
+		assert (len <= _capacity);
+
+		if (src.silent ()) {
+			return _silent ? peak : compute_peak (_data, len, peak);
+		}
+
+		peak = mix_buffers_no_gain_and_peak (_data, src.data (), len, peak);
+
+		_silent  = false;
+		_written = true;
+		return peak;
+	}
+
+	/** Copy \p len samples from \p src into self scaling by \p gain_coeff, and
+	 * return the absolute peak of the result, combined with \p peak.
+	 * This is a fused copy, gain and meter operation, see PeakMeter::set_input_peaks()
+	 */
+	float read_from_with_gain_and_peak (const AudioBuffer& src, samplecnt_t len, gain_t gain_coeff, float peak)
+	{
+		assert (&src != this);
+		assert (_capacity > 0);
+		assert (len <= _capacity);
+
+		if (src.silent () || gain_coeff == 0) {
+			memset (_data, 0, sizeof (Sample) * len);
+			_silent = (len == _capacity) ? true : _silent;
+		} else {
+			peak    = copy_vector_with_gain_and_peak (_data, src.data (), len, gain_coeff, peak);
+			_silent = false;
+		}
+		_written = true;
+		return peak;
+	}
+
 	/** Accumulate (add) \p len samples if \p src starting at \p src_offset into self
 	 * starting at \p dst_offset scaling by \p gain_coeff
 	 */
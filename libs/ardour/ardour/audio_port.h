@@ -56,11 +56,17 @@ protected:
 	/* special access for PortManager only (hah, C++) */
 	Sample* engine_get_whole_audio_buffer ();
 
+	/* PortManager resampled the external source of this port, see
+	 * PortManager::cycle_start. Must be called before ::cycle_start
+	 */
+	void set_resampled_input (Sample const*);
+
 private:
 	AudioBuffer*            _buffer;
 	ArdourZita::VMResampler _src;
 	Sample*                 _data;
 	bool                    _buf_valid;
+	bool                    _resampled_input;
 };
 
 } // namespace ARDOUR
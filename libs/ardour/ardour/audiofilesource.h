@@ -25,6 +25,7 @@
 
 #include <exception>
 #include <time.h>
+#include "ardour/audio_block_cache.h"
 #include "ardour/audiosource.h"
 #include "ardour/file_source.h"
 
@@ -43,6 +44,12 @@ class LIBARDOUR_API AudioFileSource : public AudioSource, public FileSource {
 public:
 	virtual ~AudioFileSource ();
 
+	/** Read through the AudioBlockCache, if the source is immutable */
+	samplecnt_t read (Sample *dst, samplepos_t start, samplecnt_t cnt, int channel=0) const;
+
+	/** Load the given range into the AudioBlockCache */
+	void prefetch (samplepos_t start, samplecnt_t cnt) const;
+
 	std::string construct_peak_filepath (const std::string& audio_path, const bool in_session = false, const bool old_peak_name = false) const;
 
 	static bool get_soundfile_info (const std::string& path, SoundFileInfo& _info, std::string& error);
@@ -105,6 +112,9 @@ protected:
 
 	int move_dependents_to_trash();
 
+	virtual bool cacheable () const;
+	AudioBlockCache::BlockPtr load_block (int64_t block) const;
+
 	static Sample* get_interleave_buffer (samplecnt_t size);
 
 	static char bwf_country_code[3];
@@ -94,6 +94,15 @@ class LIBARDOUR_API AudioSource : virtual public Source, public ARDOUR::AudioRea
 	virtual int setup_peakfile () { return 0; }
 	int close_peakfile ();
 
+	/** Compute the peak pyramid from an existing peakfile.
+	 * This reads the complete peakfile and is called by the peak
+	 * building threads. Until it is done, peaks are read from the
+	 * peakfile.
+	 * @return 0 on success
+	 */
+	int  build_peak_pyramid ();
+	bool has_peak_pyramid () const;
+
 	int prepare_for_peakfile_writes ();
 	void done_with_peakfile_writes (bool done = true);
 
@@ -158,6 +167,29 @@ class LIBARDOUR_API AudioSource : virtual public Source, public ARDOUR::AudioRea
 	mutable off_t _last_map_off;
 	mutable size_t  _last_raw_map_length;
 	mutable boost::scoped_array<PeakData> peak_cache;
+
+	/* Peak pyramid: additional, lower resolution levels of peak data
+	 * that are stored in a separate, versioned file next to the peakfile.
+	 * The peakfile itself retains its plain format, since it is written
+	 * incrementally while recording.
+	 */
+	struct PeakLevel {
+		PeakLevel (samplecnt_t f, off_t o, samplecnt_t n) : fpp (f), offset (o), n_peaks (n) {}
+		samplecnt_t fpp;
+		off_t       offset;
+		samplecnt_t n_peaks;
+	};
+
+	mutable bool                   _pyramid_checked;
+	mutable bool                   _pyramid_queued;
+	mutable std::vector<PeakLevel> _pyramid;
+
+	std::string peak_pyramid_path () const;
+	bool load_peak_pyramid () const;
+	void queue_peak_pyramid () const;
+	int  write_peak_pyramid (std::vector<PeakData> const* levels) const;
+	int  read_pyramid_peaks (PeakLevel const&, PeakData*, samplecnt_t npeaks, samplepos_t start, samplecnt_t cnt, double samples_per_visual_peak) const;
+	void invalidate_peak_pyramid ();
 };
 
 }
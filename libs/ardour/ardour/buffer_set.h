@@ -135,6 +135,7 @@ public:
 	void read_from(const BufferSet& in, samplecnt_t nframes);
 	void read_from(const BufferSet& in, samplecnt_t nframes, DataType);
 	void merge_from(const BufferSet& in, samplecnt_t nframes);
+	uint32_t merge_from_with_peaks (const BufferSet& in, samplecnt_t nframes, float* audio_peaks, uint32_t n_peaks);
 
 	template <typename BS, typename B>
 	class iterator_base {
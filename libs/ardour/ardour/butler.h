@@ -24,6 +24,7 @@
 #define __ardour_butler_h__
 
 #include <pthread.h>
+#include <vector>
 
 #include <glibmm/threads.h>
 
@@ -38,6 +39,9 @@
 
 namespace ARDOUR {
 
+class IOTaskList;
+class Track;
+
 /**
  *  One of the Butler's functions is to clean up (ie delete) unused CrossThreadPools.
  *  When a thread with a CrossThreadPool terminates, its CTP is added to pool_trash.
@@ -97,6 +101,23 @@ private:
 
 	bool flush_tracks_to_disk_normal (boost::shared_ptr<RouteList>, uint32_t& errors);
 
+	struct RefillJob {
+		RefillJob (boost::shared_ptr<Track> t, float l) : track (t), load (l), result (0) {}
+		boost::shared_ptr<Track> track;
+		float                    load;
+		int                      result;
+	};
+
+	static bool emptiest_first (RefillJob const& a, RefillJob const& b) { return a.load < b.load; }
+
+	bool refill_tracks (RouteList const&);
+	void refill_track (RefillJob*);
+	void reset_io_tasklist ();
+
+	IOTaskList*            _io_tasklist;
+	GATOMIC_QUAL gint      _io_threads_changed;
+	std::vector<RefillJob> _refill_jobs;
+
 	/**
 	 * Add request to butler thread request queue
 	 */
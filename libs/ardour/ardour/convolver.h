@@ -20,6 +20,8 @@
 
 #include <vector>
 
+#include <boost/shared_ptr.hpp>
+
 #include "zita-convolver/zita-convolver.h"
 
 #include "ardour/libardour_visibility.h"
@@ -54,7 +56,18 @@ public:
 	void restart ();
 	void run (BufferSet&, ChanMapping const&, ChanMapping const&, pframes_t, samplecnt_t);
 
+	/* process C arrays, 1 in, 1 out */
+	void run_mono_buffered (float*, uint32_t);
+	void run_mono_no_latency (float*, uint32_t);
+
+	/* process C arrays, 1 or 2 in, 2 out */
+	void run_stereo_buffered (float* L, float* R, uint32_t);
+	void run_stereo_no_latency (float* L, float* R, uint32_t);
+
 protected:
+	/* IR data shared with other instances, this must outlive _convproc */
+	std::vector<boost::shared_ptr<ArdourZita::Convproc> > _shared_ir;
+
 	ArdourZita::Convproc _convproc;
 
 	uint32_t _n_samples;
@@ -165,12 +178,6 @@ public:
 
 	Convolver (Session&, std::string const&, IRChannelConfig irc = Mono, IRSettings irs = IRSettings ());
 
-	void run_mono_buffered (float*, uint32_t);
-	void run_stereo_buffered (float* L, float* R, uint32_t);
-
-	void run_mono_no_latency (float*, uint32_t);
-	void run_stereo_no_latency (float* L, float* R, uint32_t);
-
 private:
 	std::vector<boost::shared_ptr<AudioReadable> > _readables;
 
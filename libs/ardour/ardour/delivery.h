@@ -123,6 +123,13 @@ protected:
 
 	gain_t target_gain ();
 
+	/* fused copy-and-meter: if set, run() computes the absolute peak of
+	 * each output port buffer while copying, see PeakMeter::set_input_peaks()
+	 */
+	bool               _compute_output_peaks;
+	std::vector<float> _output_peaks;
+	uint32_t           _n_output_peaks;
+
 private:
 	bool _no_outs_cuz_we_no_monitor;
 
@@ -135,6 +142,7 @@ private:
 	void panners_became_legal ();
 	PBD::ScopedConnection panner_legal_c;
 	void output_changed (IOChange, void*);
+	uint32_t copy_to_outputs_with_peaks (BufferSet&, pframes_t);
 
 	bool _no_panner_reset;
 };
@@ -90,6 +90,16 @@ public:
 	static void allocate_working_buffers ();
 	static void free_working_buffers ();
 
+	/* Working buffers for do_refill, used by the calling thread only
+	 * (additional disk I/O threads, see IOTaskList). They are allocated
+	 * on demand, sized for the playback buffers that are refilled.
+	 */
+	static void allocate_thread_working_buffers ();
+	static void free_thread_working_buffers ();
+
+	RefillStats refill_stats () const;
+	void reset_refill_stats ();
+
 	void adjust_buffering ();
 
 	bool can_internal_playback_seek (sampleoffset_t distance);
@@ -231,6 +241,11 @@ private:
 	static Sample* _mixdown_buffer;
 	static gain_t* _gain_buffer;
 
+	mutable Glib::Threads::Mutex _refill_stats_lock;
+	RefillStats                  _refill_stats;
+
+	void update_refill_stats (int64_t elapsed, samplecnt_t buffered);
+
 	int refill (Sample* sum_buffer, Sample* mixdown_buffer, float* gain_buffer, samplecnt_t fill_level, bool reversed);
 	int refill_audio (Sample* sum_buffer, Sample* mixdown_buffer, float* gain_buffer, samplecnt_t fill_level, bool reversed);
 
@@ -21,12 +21,15 @@
 #include <stdint.h>
 #include <string.h>
 #include <assert.h>
+#include <vector>
 #include <glib.h>
 #include <glibmm.h>
 #include <fftw3.h>
 
 #include "pbd/malign.h"
 
+#include "zita-resampler/vmresampler.h"
+
 #include "ardour/buffer_set.h"
 #include "ardour/chan_mapping.h"
 #include "ardour/libardour_visibility.h"
@@ -152,6 +155,38 @@ namespace ARDOUR { namespace DSP {
 	 */
 	void peaks (const float *data, float &min, float &max, uint32_t n_samples);
 
+	/** apply a linear gain ramp
+	 *
+	 * The gain moves linearly from `g0` at the first sample
+	 * and reaches `g1` after the last sample.
+	 *
+	 * @param data audio-data, modified in-place
+	 * @param g0 initial gain
+	 * @param g1 target gain
+	 * @param n_samples number of samples to process
+	 */
+	void gain_ramp (float *data, const float g0, const float g1, const uint32_t n_samples);
+	/** mix with a linear gain ramp
+	 *
+	 * add every sample of `src', multiplied by a gain that moves
+	 * linearly from `g0' to `g1', to `dst'.
+	 *
+	 * @param dst destination, modified in-place
+	 * @param src data to mix
+	 * @param g0 initial gain
+	 * @param g1 target gain
+	 * @param n_samples number of samples to process
+	 */
+	void mix_ramp (float *dst, const float *src, const float g0, const float g1, const uint32_t n_samples);
+	/** crossfade from `data' to `other'
+	 *
+	 * @param data signal to fade out, the result is written here
+	 * @param other signal to fade in
+	 * @param n_samples number of samples to process (length of the fade)
+	 * @param equal_power use a constant-power fade (for uncorrelated signals), otherwise a linear fade
+	 */
+	void xfade (float *data, const float *other, const uint32_t n_samples, bool equal_power);
+
 	/** non-linear power-scale meter deflection
 	 *
 	 * @param power signal power (dB)
@@ -263,6 +298,140 @@ namespace ARDOUR { namespace DSP {
 			double _b0, _b1, _b2;
 	};
 
+	/** A cascade of Biquad filters for one or more channels
+	 *
+	 * Every channel uses the same filter settings, the state
+	 * is kept separately for each channel.
+	 */
+	class LIBARDOUR_API BiquadCascade {
+		public:
+			/** Instantiate a filter cascade
+			 *
+			 * @param samplerate Samplerate
+			 * @param n_stages number of biquad filters to apply in series
+			 * @param n_channels number of independent channels to process
+			 */
+			BiquadCascade (double samplerate, uint32_t n_stages, uint32_t n_channels);
+
+			/** process audio data, apply all stages
+			 *
+			 * @param channel channel to process 0 .. n_channels - 1
+			 * @param data pointer to audio-data
+			 * @param n_samples number of samples to process
+			 */
+			void run (uint32_t channel, float *data, const uint32_t n_samples);
+			/** setup filter of a given stage, compute coefficients
+			 *
+			 * @param stage filter to set 0 .. n_stages - 1
+			 * @param t filter type (LowPass, HighPass, etc)
+			 * @param freq filter frequency
+			 * @param Q filter quality
+			 * @param gain filter gain
+			 */
+			void compute (uint32_t stage, Biquad::Type t, double freq, double Q, double gain);
+			/** setup filter of a given stage, set coefficients directly */
+			void configure (uint32_t stage, double a1, double a2, double b0, double b1, double b2);
+
+			/** transfer function of the complete cascade
+			 * @param freq frequency
+			 * @return gain at given frequency in dB
+			 */
+			float dB_at_freq (float freq) const;
+
+			/** reset filter state of all channels */
+			void reset ();
+
+			uint32_t n_stages () const { return _n_stages; }
+			uint32_t n_channels () const { return _n_channels; }
+
+		private:
+			uint32_t            _n_stages;
+			uint32_t            _n_channels;
+			std::vector<Biquad> _filters; // [channel * n_stages + stage]
+	};
+
+	/** Peak envelope follower */
+	class LIBARDOUR_API EnvelopeFollower {
+		public:
+			/** instantiate an envelope follower
+			 *
+			 * @param samplerate samplerate
+			 * @param attack attack time-constant in ms
+			 * @param release release time-constant in ms
+			 */
+			EnvelopeFollower (double samplerate, float attack, float release);
+
+			/** compute the envelope
+			 *
+			 * @param data audio-data to analyze
+			 * @param env envelope output, may be the same array as `data'
+			 * @param n_samples number of samples to process
+			 */
+			void run (const float *data, float *env, const uint32_t n_samples);
+			/** analyze audio data
+			 *
+			 * @param data audio-data to analyze
+			 * @param n_samples number of samples to process
+			 * @returns envelope value after the last sample
+			 */
+			float process (const float *data, const uint32_t n_samples);
+
+			void set_attack (float ms);
+			void set_release (float ms);
+
+			/** current envelope value */
+			float value () const { return _env; }
+			/** reset state */
+			void reset () { _env = 0.f; }
+
+		private:
+			double _rate;
+			float  _env;
+			float  _att;
+			float  _rel;
+	};
+
+	/** Sample-rate converter */
+	class LIBARDOUR_API Resampler {
+		public:
+			/** instantiate a resampler
+			 *
+			 * Since memory allocation is not realtime safe this
+			 * should be done in dsp_init() or dsp_configure().
+			 *
+			 * The anti-aliasing filter is designed for the given ratio,
+			 * a different ratio requires a new instance.
+			 *
+			 * @param ratio target-rate / source-rate (0.02 .. 16)
+			 * @param quality filter length, 8 .. 96 (32 is a good default)
+			 */
+			Resampler (double ratio, uint32_t quality);
+
+			/** convert audio data
+			 *
+			 * All input is consumed, unless the output array is full.
+			 *
+			 * @param in source data
+			 * @param n_in number of source samples
+			 * @param out destination
+			 * @param n_out space available in destination
+			 * @returns number of samples written to the destination
+			 */
+			uint32_t process (const float *in, const uint32_t n_in, float *out, const uint32_t n_out);
+
+			/** @returns delay of the filter in source samples */
+			uint32_t latency () const;
+			/** @returns target-rate / source-rate */
+			double ratio () const { return _ratio; }
+
+			/** reset state */
+			void reset ();
+
+		private:
+			ArdourZita::VMResampler _src;
+			double                  _ratio;
+	};
+
 	class LIBARDOUR_API FFTSpectrum {
 		public:
 			FFTSpectrum (uint32_t window_size, double rate);
@@ -57,6 +57,7 @@ class LIBARDOUR_API Graph : public SessionHandleRef
 {
 public:
 	Graph (Session& session);
+	~Graph ();
 
 	void trigger (GraphNode* n);
 	void rechain (boost::shared_ptr<RouteList>, GraphEdges const&);
@@ -75,6 +76,7 @@ public:
 
 	void clear_other_chain ();
 	void swap_process_chain ();
+	void reprioritize ();
 
 	bool in_process_thread () const;
 
@@ -85,9 +87,15 @@ private:
 	void reset_thread_list ();
 	void drop_threads ();
 	void run_one ();
+	void run_one_stealing ();
+	GraphNode* pop_or_steal ();
+	guint claim_idle_threads (guint);
 	void main_thread ();
 	void prep ();
 	void dump (int chain) const;
+	float compute_critical_path (GraphNode*, int chain, std::set<GraphNode*>& done);
+	void  prioritize (int chain);
+	bool  priority_outdated (GraphNode const*, int chain) const;
 
 	node_list_t _nodes_rt[2];
 	node_list_t _init_trigger_list[2];
@@ -95,12 +103,23 @@ private:
 	PBD::MPMCQueue<GraphNode*> _trigger_queue;      ///< nodes that can be processed
 	GATOMIC_QUAL guint         _trigger_queue_size; ///< number of entries in trigger-queue
 
+	/** Per worker-thread queues, used with work-stealing scheduling.
+	 * Index 0 belongs to the main graph thread, helpers use 1..N-1
+	 */
+	std::vector<PBD::MPMCQueue<GraphNode*>*> _worker_queues;
+
+	/** Work-stealing mode, latched at the start of each cycle */
+	bool _work_stealing;
+
 	/** Start worker threads */
 	PBD::Semaphore _execution_sem;
 
 	/** The number of processing threads that are asleep */
 	GATOMIC_QUAL guint _idle_thread_cnt;
 
+	/** Idle threads that were signalled but did not wake up yet (work-stealing) */
+	GATOMIC_QUAL guint _pending_wakeups;
+
 	/** Signalled to start a run of the graph for a process callback */
 	PBD::Semaphore _callback_start_sem;
 	PBD::Semaphore _callback_done_sem;
@@ -126,6 +145,10 @@ private:
 	GATOMIC_QUAL gint _pending_chain;
 	GATOMIC_QUAL gint _setup_chain;
 
+	/* set by the process thread when execution times drifted, cleared by reprioritize () */
+	GATOMIC_QUAL gint _reprioritize;
+	int64_t           _next_priority_check;
+
 	/* parameter caches */
 	pframes_t   _process_nframes;
 	samplepos_t _process_start_sample;
@@ -142,6 +165,8 @@ private:
 	void                      engine_stopped ();
 
 	void setup_thread_local_variables ();
+	void allocate_worker_queues (uint32_t);
+	void free_worker_queues ();
 };
 
 } // namespace
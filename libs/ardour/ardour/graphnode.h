@@ -28,6 +28,7 @@
 #include <boost/shared_ptr.hpp>
 
 #include "pbd/g_atomic_compat.h"
+#include "pbd/microseconds.h"
 
 namespace ARDOUR
 {
@@ -40,12 +41,22 @@ typedef std::list<node_ptr_t>        node_list_t;
 
 class LIBARDOUR_API GraphActivision
 {
+public:
+	/** @return length of the most expensive dependency chain starting at this node [usec] */
+	float critical_path (int chain) const { return _critical_path[chain]; }
+
 protected:
 	friend class Graph;
 	/** Nodes that we directly feed */
 	node_set_t _activation_set[2];
+	/** Nodes that we directly feed, in order of descending critical-path */
+	node_list_t _activation_list[2];
 	/** The number of nodes that we directly feed us (one count for each chain) */
 	gint _init_refcount[2];
+	/** Critical-path priority, computed by Graph::rechain */
+	float _critical_path[2];
+	/** Execution time that the critical-path was computed with */
+	float _prioritized_exec_time[2];
 };
 
 /** A node on our processing graph, ie a Route */
@@ -57,13 +68,10 @@ public:
 
 	void prep (int chain);
 	void trigger ();
+	void run (int chain);
 
-	void
-	run (int chain)
-	{
-		process ();
-		finish (chain);
-	}
+	/** @return moving average of the time it takes to process this node [usec] */
+	float exec_time () const { return _exec_time; }
 
 private:
 	void finish (int chain);
@@ -71,6 +79,11 @@ private:
 
 	boost::shared_ptr<Graph> _graph;
 	GATOMIC_QUAL gint        _refcount;
+
+	/* exponentially weighted moving average of process() duration.
+	 * Written by the thread processing the node, read when rechaining.
+	 */
+	float _exec_time;
 };
 }
 
@@ -34,12 +34,15 @@ namespace ARDOUR {
 
 class LIBARDOUR_API ImportStatus : public InterThreadInfo {
 public:
+	ImportStatus () : throughput (0) {}
+
 	virtual ~ImportStatus() {
 		clear ();
 	}
 
 	virtual void clear () {
 		sources.clear ();
+		path_sources.clear ();
 		paths.clear ();
 	}
 
@@ -60,8 +63,13 @@ public:
 	 */
 	bool all_done;
 
+	/** decoding rate of the current import in MB/s, 0 if unknown */
+	volatile float throughput;
+
 	/* result */
 	SourceList sources;
+	/** the sources of each of the paths, in the same order as paths */
+	std::vector<SourceList> path_sources;
 };
 
 } // namespace ARDOUR
@@ -30,6 +30,7 @@
 namespace ARDOUR {
 
 class InternalSend;
+class PeakMeter;
 
 class LIBARDOUR_API InternalReturn : public Processor
 {
@@ -45,6 +46,12 @@ public:
 
 	void set_playback_offset (samplecnt_t cnt);
 
+	/** Set the meter that directly follows this return in the
+	 * processor chain (or null). The return will then compute the
+	 * meter's peaks while mixing the sends.
+	 */
+	void set_fused_meter (boost::shared_ptr<PeakMeter>);
+
 protected:
 	XMLNode& state ();
 
@@ -53,6 +60,9 @@ private:
 	std::list<InternalSend*> _sends;
 	/** mutex to protect _sends */
 	Glib::Threads::Mutex _sends_mutex;
+
+	boost::shared_ptr<PeakMeter> _fused_meter;
+	std::vector<float>           _fused_peaks;
 };
 
 } // namespace ARDOUR
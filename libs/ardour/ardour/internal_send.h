@@ -68,6 +68,7 @@ protected:
 
 private:
 	BufferSet mixbufs;
+	std::vector<float> _send_peaks;
 	boost::shared_ptr<Route> _send_from;
 	boost::shared_ptr<Route> _send_to;
 	bool _allow_feedback;
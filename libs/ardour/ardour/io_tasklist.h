@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2026 The Ardour Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _ardour_io_tasklist_h_
+#define _ardour_io_tasklist_h_
+
+#include <atomic>
+#include <vector>
+
+#include <boost/function.hpp>
+
+#include "pbd/semutils.h"
+
+#include "ardour/libardour_visibility.h"
+
+namespace ARDOUR {
+
+/** A pool of threads to perform disk I/O.
+ *
+ * Unlike RTTaskList, the worker threads do not run with realtime
+ * priority and sleep while idle. Each worker has its own set of
+ * DiskReader working buffers, so that tracks can be refilled concurrently.
+ *
+ * Tasks are started in the order in which they were added.
+ */
+class LIBARDOUR_API IOTaskList
+{
+public:
+	/** @param n_threads total number of threads that perform I/O,
+	 * including the thread calling process ()
+	 */
+	IOTaskList (uint32_t n_threads);
+	~IOTaskList ();
+
+	void push_back (boost::function<void ()> fn);
+
+	/** process queued tasks in parallel, wait for them to complete */
+	void process ();
+
+	uint32_t n_threads () const { return _threads.size () + 1; }
+
+	/** Number of I/O threads to use for a given "disk-io-threads" preference */
+	static uint32_t n_threads_for (int32_t pref);
+
+private:
+	static void* _worker_thread (void*);
+	void io_thread ();
+	void run_tasks ();
+
+	std::vector<boost::function<void ()> > _tasks;
+	std::vector<pthread_t>                 _threads;
+
+	std::atomic<uint32_t> _next_task;
+	std::atomic<bool>     _terminate;
+
+	PBD::Semaphore _exec_sem;
+	PBD::Semaphore _idle_sem;
+};
+
+} // namespace ARDOUR
+#endif
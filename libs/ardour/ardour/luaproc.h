@@ -30,6 +30,8 @@
 #include <vector>
 #include <string>
 
+#include <glibmm/threads.h>
+
 #define USE_TLSF
 #ifdef USE_TLSF
 #  include "pbd/tlsf.h"
@@ -144,7 +146,57 @@ protected:
 
 private:
 #ifdef USE_TLSF
-	PBD::TLSF _mempool;
+	/* Per instance handle to the TLSF arenas that are shared by
+	 * several LuaProc instances. Tracks and limits the memory
+	 * used by the instance's lua_State.
+	 */
+	class SharedPool {
+	public:
+		SharedPool (std::string const& name, size_t quota);
+		~SharedPool ();
+
+		void set_name (std::string const& n) { _name = n; }
+
+		static void* lalloc (void* pool, void* ptr, size_t oldsize, size_t newsize);
+
+		size_t get_used_size () const { return _used; }
+		size_t get_max_size () const { return _quota; }
+
+		/* true while the lua_State is used by a process thread */
+		bool& realtime () { return _realtime; }
+
+		/* true if the instances sharing the arena use more memory
+		 * than it can hold, garbage should be collected without delay.
+		 */
+		bool arena_full () const;
+
+	private:
+		struct Arena;
+		static Glib::Threads::Mutex _arena_lock;
+		static std::vector<Arena*>  _arenas;
+
+		static Arena* find_arena (size_t size, std::vector<Arena*> const& exclude);
+
+		void* realloc (void* ptr, size_t oldsize, size_t newsize);
+		void* allocate (size_t size);
+		Arena* owner (void const* ptr) const;
+		void  free_deferred (Arena*);
+		void  free_later (void* ptr);
+		void  charge ();
+
+		std::vector<Arena*> _pools;    // arenas with memory of this instance, the first one was assigned on creation
+		std::string         _name;
+		size_t              _used;
+		size_t              _quota;
+		size_t              _charged;  // amount of the first arena accounted to this instance
+		bool                _realtime;
+		PBD::TLSF           _reserve;  // used by the process thread when the arenas are busy
+		std::vector<void*>  _deferred; // arena memory to free when its arena is locked next
+
+		SharedPool (SharedPool const&);
+	};
+
+	SharedPool _mempool;
 #else
 	PBD::ReallocPool _mempool;
 #endif
@@ -168,6 +220,7 @@ private:
 	void init ();
 	bool load_script ();
 	void lua_print (std::string s);
+	void collect_garbage_rt ();
 
 	std::string preset_name_to_uri (const std::string&) const;
 	std::string presets_file () const;
@@ -198,6 +251,8 @@ private:
 	bool _has_midi_input;
 	bool _has_midi_output;
 
+	int  _gc_threshold; // kB
+	bool _gc_pending;
 
 #ifdef WITH_LUAPROC_STATS
 	int64_t _stats_avg[2];
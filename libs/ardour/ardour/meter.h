@@ -75,6 +75,19 @@ public:
 	/** Compute peaks */
 	void run (BufferSet& bufs, samplepos_t start_sample, samplepos_t end_sample, double speed, pframes_t nframes, bool);
 
+	/** Provide the absolute peak of the first @a n_audio audio buffers that
+	 * will be passed to the next call to run(). This is used by processors
+	 * that compute the peak while mixing (fused mix-and-meter), so that the
+	 * meter does not walk the buffers again.
+	 *
+	 * Must be called from the process thread, right before run();
+	 * @a peaks must remain valid until then.
+	 */
+	void set_input_peaks (float const* peaks, uint32_t n_audio) {
+		_input_peaks   = peaks;
+		_n_input_peaks = n_audio;
+	}
+
 	void activate () {}
 	void deactivate () {}
 
@@ -104,6 +117,8 @@ private:
 	GATOMIC_QUAL gint _reset_max;
 
 	uint32_t           _bufcnt;
+	float const*       _input_peaks;
+	uint32_t           _n_input_peaks;
 	std::vector<float> _peak_buffer;     // internal, integrate
 	std::vector<float> _peak_power;      // includes accurate falloff, hence dB
 	std::vector<float> _max_peak_signal; // dB calculation is done on demand
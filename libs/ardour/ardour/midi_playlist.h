@@ -25,6 +25,8 @@
 
 #include <vector>
 #include <list>
+#include <map>
+#include <set>
 
 #include <boost/utility.hpp>
 
@@ -39,6 +41,8 @@
 #include "evoral/Parameter.h"
 #include "ardour/rt_midibuffer.h"
 
+#include "temporal/tempo.h"
+
 namespace Evoral {
 template<typename Time> class EventSink;
 class                         Beats;
@@ -80,20 +84,50 @@ public:
 
 	void _split_region (boost::shared_ptr<Region>, timepos_t const & position, ThawList& thawlist);
 
-	void set_note_mode (NoteMode m) { _note_mode = m; }
+	void set_note_mode (NoteMode m);
 
 	std::set<Evoral::Parameter> contained_automation();
 
   protected:
 	void remove_dependents (boost::shared_ptr<Region> region);
 	void region_going_away (boost::weak_ptr<Region> region);
+	bool region_changed (const PBD::PropertyChange&, boost::shared_ptr<Region>);
 
   private:
 	void dump () const;
 
+	typedef std::vector<boost::shared_ptr<Region> > RenderList;
+
+	void render_all (RenderList const &, MidiChannelFilter*);
+	bool render_changed (RenderList const &, std::set<PBD::ID> const & dirty, MidiChannelFilter*);
+
 	NoteMode     _note_mode;
 
 	RTMidiBuffer _rendered;
+
+	/* What _rendered currently holds for each region. Every event in
+	 * _rendered is tagged with the region it came from, so that a region
+	 * which changed can be spliced in again without touching any others.
+	 */
+	struct RenderedRegion {
+		uint32_t          tag;
+		samplepos_t       start;
+		samplepos_t       end;
+		timepos_t         source_start;
+		MidiModel const * model;
+	};
+
+	typedef std::map<PBD::ID, RenderedRegion> RenderedRegions;
+
+	RenderedRegions               _rendered_regions;
+	uint32_t                      _next_render_tag;
+	Temporal::TempoMap::SharedPtr _rendered_tempo_map;
+	ChannelMode                   _rendered_channel_mode;
+	uint16_t                      _rendered_channel_mask;
+
+	Glib::Threads::Mutex          _dirty_lock;
+	std::set<PBD::ID>             _dirty_regions;
+	bool                          _full_render_pending;
 };
 
 } /* namespace ARDOUR */
@@ -35,6 +35,14 @@ extern "C" {
 
 LIBARDOUR_API void x86_sse_find_peaks              (float const* buf, uint32_t nsamples, float* min, float* max);
 
+LIBARDOUR_API float x86_sse_apply_gain_ramp_to_buffer   (float* buf, uint32_t nframes, float initial, float target, float coeff);
+LIBARDOUR_API void  x86_sse_apply_gain_vector_to_buffer (float* buf, float const* gain, uint32_t nframes);
+LIBARDOUR_API void  x86_sse_invert_buffer               (float* buf, uint32_t nframes);
+
+LIBARDOUR_API float x86_sse_mix_buffers_no_gain_and_peak   (float* dst, float const* src, uint32_t nframes, float current);
+LIBARDOUR_API float x86_sse_mix_buffers_with_gain_and_peak (float* dst, float const* src, uint32_t nframes, float gain, float current);
+LIBARDOUR_API float x86_sse_copy_vector_with_gain_and_peak (float* dst, float const* src, uint32_t nframes, float gain, float current);
+
 extern "C" {
 /* AVX functions */
 	LIBARDOUR_API float x86_sse_avx_compute_peak          (float const* buf, uint32_t nsamples, float current);
@@ -50,11 +58,37 @@ extern "C" {
 LIBARDOUR_API void x86_sse_avx_find_peaks               (float const* buf, uint32_t nsamples, float* min, float* max);
 #endif
 
+LIBARDOUR_API float x86_sse_avx_apply_gain_ramp_to_buffer   (float* buf, uint32_t nframes, float initial, float target, float coeff);
+LIBARDOUR_API void  x86_sse_avx_apply_gain_vector_to_buffer (float* buf, float const* gain, uint32_t nframes);
+LIBARDOUR_API void  x86_sse_avx_invert_buffer               (float* buf, uint32_t nframes);
+
+LIBARDOUR_API float x86_sse_avx_mix_buffers_no_gain_and_peak   (float* dst, float const* src, uint32_t nframes, float current);
+LIBARDOUR_API float x86_sse_avx_mix_buffers_with_gain_and_peak (float* dst, float const* src, uint32_t nframes, float gain, float current);
+LIBARDOUR_API float x86_sse_avx_copy_vector_with_gain_and_peak (float* dst, float const* src, uint32_t nframes, float gain, float current);
+
 /* FMA functions */
 #ifdef FPU_AVX_FMA_SUPPORT
 LIBARDOUR_API void  x86_fma_mix_buffers_with_gain       (float* dst, float const* src, uint32_t nframes, float gain);
 #endif
 
+/* AVX-512F functions */
+#ifdef FPU_AVX512F_SUPPORT
+LIBARDOUR_API float x86_avx512f_compute_peak                (float const* buf, uint32_t nsamples, float current);
+LIBARDOUR_API void  x86_avx512f_find_peaks                  (float const* buf, uint32_t nsamples, float* min, float* max);
+LIBARDOUR_API void  x86_avx512f_apply_gain_to_buffer        (float* buf, uint32_t nframes, float gain);
+LIBARDOUR_API void  x86_avx512f_mix_buffers_with_gain       (float* dst, float const* src, uint32_t nframes, float gain);
+LIBARDOUR_API void  x86_avx512f_mix_buffers_no_gain         (float* dst, float const* src, uint32_t nframes);
+LIBARDOUR_API void  x86_avx512f_copy_vector                 (float* dst, float const* src, uint32_t nframes);
+LIBARDOUR_API float x86_avx512f_apply_gain_ramp_to_buffer   (float* buf, uint32_t nframes, float initial, float target, float coeff);
+LIBARDOUR_API void  x86_avx512f_apply_gain_vector_to_buffer (float* buf, float const* gain, uint32_t nframes);
+LIBARDOUR_API void  x86_avx512f_invert_buffer               (float* buf, uint32_t nframes);
+LIBARDOUR_API void  x86_avx512f_interleave_buffer           (float* dst, float const* src, uint32_t nframes, uint32_t chn, uint32_t n_chn);
+LIBARDOUR_API void  x86_avx512f_deinterleave_buffer         (float* dst, float const* src, uint32_t nframes, uint32_t chn, uint32_t n_chn);
+LIBARDOUR_API float x86_avx512f_mix_buffers_no_gain_and_peak   (float* dst, float const* src, uint32_t nframes, float current);
+LIBARDOUR_API float x86_avx512f_mix_buffers_with_gain_and_peak (float* dst, float const* src, uint32_t nframes, float gain, float current);
+LIBARDOUR_API float x86_avx512f_copy_vector_with_gain_and_peak (float* dst, float const* src, uint32_t nframes, float gain, float current);
+#endif
+
 /* debug wrappers for SSE functions */
 
 LIBARDOUR_API float debug_compute_peak               (ARDOUR::Sample const* buf, ARDOUR::pframes_t nsamples, float current);
@@ -96,4 +130,14 @@ LIBARDOUR_API void  default_mix_buffers_with_gain     (ARDOUR::Sample* dst, ARDO
 LIBARDOUR_API void  default_mix_buffers_no_gain       (ARDOUR::Sample* dst, ARDOUR::Sample const* src, ARDOUR::pframes_t nframes);
 LIBARDOUR_API void  default_copy_vector               (ARDOUR::Sample* dst, ARDOUR::Sample const* src, ARDOUR::pframes_t nframes);
 
+LIBARDOUR_API float default_apply_gain_ramp_to_buffer   (ARDOUR::Sample* buf, ARDOUR::pframes_t nframes, float initial, float target, float coeff);
+LIBARDOUR_API void  default_apply_gain_vector_to_buffer (ARDOUR::Sample* buf, ARDOUR::gain_t const* gain, ARDOUR::pframes_t nframes);
+LIBARDOUR_API void  default_invert_buffer               (ARDOUR::Sample* buf, ARDOUR::pframes_t nframes);
+LIBARDOUR_API void  default_interleave_buffer           (ARDOUR::Sample* dst, ARDOUR::Sample const* src, ARDOUR::pframes_t nframes, uint32_t chn, uint32_t n_chn);
+LIBARDOUR_API void  default_deinterleave_buffer         (ARDOUR::Sample* dst, ARDOUR::Sample const* src, ARDOUR::pframes_t nframes, uint32_t chn, uint32_t n_chn);
+
+LIBARDOUR_API float default_mix_buffers_no_gain_and_peak   (ARDOUR::Sample* dst, ARDOUR::Sample const* src, ARDOUR::pframes_t nframes, float current);
+LIBARDOUR_API float default_mix_buffers_with_gain_and_peak (ARDOUR::Sample* dst, ARDOUR::Sample const* src, ARDOUR::pframes_t nframes, float gain, float current);
+LIBARDOUR_API float default_copy_vector_with_gain_and_peak (ARDOUR::Sample* dst, ARDOUR::Sample const* src, ARDOUR::pframes_t nframes, float gain, float current);
+
 #endif /* __ardour_mix_h__ */
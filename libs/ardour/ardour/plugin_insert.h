@@ -24,6 +24,7 @@
 #ifndef __ardour_plugin_insert_h__
 #define __ardour_plugin_insert_h__
 
+#include <atomic>
 #include <vector>
 #include <string>
 
@@ -421,6 +422,7 @@ private:
 
 	bool sanitize_maps ();
 	bool check_inplace ();
+	bool check_parallel () const;
 	void mapping_changed ();
 
 	boost::shared_ptr<Plugin> plugin_factory (boost::shared_ptr<Plugin>);
@@ -445,6 +447,26 @@ private:
 	PBD::TimingStats  _timing_stats;
 	GATOMIC_QUAL gint _stat_reset;
 	GATOMIC_QUAL gint _flush;
+
+	/* in-place processing of replicated instances, optionally in parallel */
+	struct InstanceCycle {
+		BufferSet*         bufs;
+		PinMappings const* in_map;
+		PinMappings const* out_map;
+		samplepos_t        start;
+		samplepos_t        end;
+		double             speed;
+		pframes_t          nframes;
+		samplecnt_t        offset;
+	};
+
+	void run_instance (uint32_t pc);
+
+	bool               _parallel_ok; // instances use disjoint buffers, see check_parallel ()
+	bool               _run_parallel;
+	InstanceCycle      _instance_cycle;
+	std::vector<float> _instance_dsp; // average DSP time per instance [usec]
+	std::atomic<bool>  _instance_failed;
 };
 
 } // namespace ARDOUR
@@ -300,6 +300,29 @@ private:
 
 	bool no_timeout () const { return _cancel_scan_timeout_one || _cancel_scan_timeout_all; }
 
+	/* Persistent index of scanned plugin modules (path -> mtime, size).
+	 * A module whose stat does not match its entry is rescanned, even if
+	 * its cache file looks up-to-date.
+	 */
+	struct ScanIndexEntry {
+		ScanIndexEntry (int64_t m = 0, int64_t s = 0) : mtime (m), size (s) {}
+		int64_t mtime;
+		int64_t size;
+	};
+
+	typedef std::map<std::string, ScanIndexEntry> ScanIndex;
+	ScanIndex _scan_index;
+	uint32_t  _n_changed; /* modules found new or modified, but not scanned, during the last refresh */
+
+	void load_scan_index ();
+	void save_scan_index ();
+	bool module_changed (std::string const&) const;
+	void index_module (std::string const&);
+
+	/* run external scanner apps for many modules concurrently */
+	bool needs_external_scan (ARDOUR::PluginType, std::string const&) const;
+	void run_scanner_apps (ARDOUR::PluginType, std::vector<std::string> const&, std::set<std::string>& failed);
+
 	void detect_name_ambiguities (ARDOUR::PluginInfoList*);
 	void detect_type_ambiguities (ARDOUR::PluginInfoList&);
 
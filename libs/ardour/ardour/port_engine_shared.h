@@ -129,6 +129,83 @@ public:
 	virtual pframes_t timestamp () const = 0;
 	virtual const uint8_t* data () const = 0;
 	bool operator< (const BackendMIDIEvent &other) const;
+
+	/** order of concurrent events (same timestamp), lower comes first */
+	static uint8_t concurrent_rank (const uint8_t* data, size_t size);
+};
+
+/** Fixed capacity MIDI event buffer for backend ports.
+ *
+ * Events are kept in order (timestamp, then concurrent events as
+ * BackendMIDIEvent::operator<). Event data is copied into a pre-allocated
+ * arena, there is no memory allocation after construction.
+ */
+class LIBARDOUR_API BackendMIDIBuffer
+{
+public:
+	BackendMIDIBuffer (size_t max_events = 4096, size_t max_bytes = 32768);
+
+	struct Event {
+		pframes_t      timestamp;
+		size_t         size;
+		const uint8_t* data;
+	};
+
+	size_t size () const { return _n_events; }
+	bool   empty () const { return _n_events == 0; }
+
+	/** number of events that were dropped because the buffer was full */
+	size_t dropped () const { return _dropped; }
+
+	Event operator[] (size_t i) const {
+		Event e;
+		e.timestamp = _index[i].timestamp;
+		e.size      = _index[i].size;
+		e.data      = &_data[_index[i].offset];
+		return e;
+	}
+
+	void clear ();
+
+	/** Add an event. Events that arrive out of order are inserted
+	 * at the correct position.
+	 * @return 0 on success, -1 if the buffer is full
+	 */
+	int push (pframes_t timestamp, const uint8_t* data, size_t size);
+
+	/** Replace the content with a copy of the given buffer */
+	void copy (BackendMIDIBuffer const&);
+
+	/** Queue a buffer to be merged by the next call to ::merge ().
+	 * The source must remain valid until then.
+	 */
+	void add_source (BackendMIDIBuffer const&);
+
+	/** k-way merge events of all queued sources into this buffer */
+	void merge ();
+
+	static const size_t max_sources = 32;
+
+private:
+	struct Index {
+		pframes_t timestamp;
+		uint32_t  offset;
+		uint32_t  size;
+		uint8_t   rank;
+	};
+
+	static bool before (Index const& a, Index const& b) {
+		return a.timestamp < b.timestamp || (a.timestamp == b.timestamp && a.rank < b.rank);
+	}
+
+	std::vector<Index>   _index;
+	std::vector<uint8_t> _data;
+	size_t               _n_events;
+	size_t               _used;
+	size_t               _dropped;
+
+	BackendMIDIBuffer const* _sources[max_sources];
+	size_t                   _n_sources;
 };
 
 class LIBARDOUR_API PortEngineSharedImpl
@@ -43,6 +43,7 @@ namespace ARDOUR {
 
 class PortEngine;
 class AudioBackend;
+class AudioPort;
 class Session;
 
 class CircularSampleBuffer;
@@ -377,6 +378,29 @@ private:
 	SerializedRCUManager<AudioInputPorts> _audio_input_ports;
 	SerializedRCUManager<MIDIInputPorts>  _midi_input_ports;
 	GATOMIC_QUAL gint                     _reset_meters;
+
+	/* A backend port that is the only connection of more than one of
+	 * our audio inputs. It is resampled once per cycle, and the result
+	 * is copied to all of those inputs, see cycle_start ().
+	 */
+	class InputResampler;
+
+	struct InputSource {
+		boost::shared_ptr<InputResampler>          resampler;
+		PortEngine::PortPtr                        port;
+		std::vector<boost::shared_ptr<AudioPort> > ports;
+	};
+
+	typedef std::vector<InputSource> InputSources;
+
+	void update_input_source (boost::shared_ptr<Port>);
+	void update_input_sources ();
+	void drop_input_source (std::string const&);
+	void run_input_source (InputSource const*, pframes_t);
+
+	Glib::Threads::Mutex               _input_source_lock;
+	std::map<std::string, std::string> _input_source_map; // our port -> its only connection
+	SerializedRCUManager<InputSources> _input_sources;
 };
 
 } // namespace ARDOUR
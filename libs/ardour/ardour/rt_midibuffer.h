@@ -57,22 +57,38 @@ class LIBARDOUR_API RTMidiBuffer : public Evoral::EventSink<samplepos_t>
 	void resize(size_t);
 	size_t size() const { return _size; }
 	bool empty() const { return _size == 0; }
+	/** @return bytes used in the blob pool (events of more than 3 bytes) */
+	uint32_t pool_size() const { return _pool_size; }
 
 	samplecnt_t span() const;
 
 	uint32_t write (TimeType time, Evoral::EventType type, uint32_t size, const uint8_t* buf);
+	uint32_t write (TimeType time, Evoral::EventType type, uint32_t size, const uint8_t* buf, uint32_t tag);
 	uint32_t read (MidiBuffer& dst, samplepos_t start, samplepos_t end, MidiNoteTracker& tracker, samplecnt_t offset = 0);
 
 	void dump (uint32_t);
 	void reverse ();
 	bool reversed() const;
 
+	/* Replace every event tagged with @param tag whose time falls within
+	 * [@param start .. @param end] with the events in @param src (which
+	 * must be sorted, and are retagged with @param tag), keeping the
+	 * buffer sorted. Events with other tags are left as-is.
+	 *
+	 * Caller must hold a WriteProtectRender.
+	 */
+	void splice (RTMidiBuffer const & src, uint32_t tag, samplepos_t start, samplepos_t end);
+
 	struct Item {
 		samplepos_t timestamp;
 		union {
 			uint8_t  bytes[4];
 			uint32_t offset;
 		};
+		/* identifies the producer (e.g. region) of this event. This
+		 * occupies what would otherwise be padding.
+		 */
+		uint32_t tag;
 	};
 
 	Item const & operator[](size_t n) const {
@@ -87,7 +103,7 @@ class LIBARDOUR_API RTMidiBuffer : public Evoral::EventSink<samplepos_t>
 			size = Evoral::midi_event_size (item.bytes[1]);
 			return &item.bytes[1];
 		} else {
-			uint32_t offset = item.offset & ~(1<<(CHAR_BIT-1));
+			uint32_t offset = blob_offset (item);
 			Blob* blob = reinterpret_cast<Blob*> (&_pool[offset]);
 
 			size = blob->size;
@@ -117,10 +133,22 @@ class LIBARDOUR_API RTMidiBuffer : public Evoral::EventSink<samplepos_t>
 	bool   _reversed;
 	/* secondary blob storage. Holds Blobs (arbitrary size + data) */
 
+	/* Items that refer to a blob have the MSbit of bytes[0] set, which
+	 * is bit 7 of Item::offset. The offset into the pool is stored
+	 * around that bit.
+	 */
+	static uint32_t blob_ref (uint32_t off) { return ((off >> 7) << 8) | (1<<(CHAR_BIT-1)) | (off & 0x7f); }
+	static uint32_t blob_offset (Item const & item) { return ((item.offset >> 8) << 7) | (item.offset & 0x7f); }
+
 	uint32_t alloc_blob (uint32_t size);
 	uint32_t store_blob (uint32_t size, uint8_t const * data);
+	uint8_t  first_byte (Item const &) const;
+	Item     import_item (RTMidiBuffer const & src, Item const &, uint32_t tag);
+	void     compact_pool ();
+
 	uint32_t _pool_size;
 	uint32_t _pool_capacity;
+	uint32_t _pool_dead; ///< bytes of blobs that are no longer referenced
 	uint8_t* _pool;
 
 	Glib::Threads::RWLock _lock;
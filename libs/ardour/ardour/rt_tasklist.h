@@ -19,8 +19,14 @@
 #ifndef _ardour_rt_tasklist_h_
 #define _ardour_rt_tasklist_h_
 
+#include <atomic>
+#include <cassert>
 #include <list>
+#include <new>
+#include <vector>
+
 #include <boost/function.hpp>
+#include <boost/static_assert.hpp>
 
 #include "pbd/semutils.h"
 #include "pbd/g_atomic_compat.h"
@@ -32,18 +38,121 @@
 
 namespace ARDOUR {
 
+/** A slot in the RTTaskList task arena.
+ *
+ * The functor is copied in-place into a fixed size buffer, so
+ * that adding a task does not involve any heap allocation.
+ */
+class LIBARDOUR_API RTTask
+{
+public:
+	static const size_t storage_size = 64;
+
+	RTTask () : _invoke (0), _destroy (0) {}
+	~RTTask () { clear (); }
+
+	template <typename F>
+	void set (F const& f)
+	{
+		BOOST_STATIC_ASSERT (sizeof (F) <= storage_size);
+		clear ();
+		new (_storage.data) F (f);
+		_invoke  = &invoke<F>;
+		_destroy = &destroy<F>;
+	}
+
+	void run () { _invoke (_storage.data); }
+
+	void clear ()
+	{
+		if (_destroy) {
+			_destroy (_storage.data);
+			_invoke  = 0;
+			_destroy = 0;
+		}
+	}
+
+private:
+	RTTask (RTTask const&);
+	RTTask& operator= (RTTask const&);
+
+	template <typename F>
+	static void invoke (void* p) { (*static_cast<F*> (p)) (); }
+
+	template <typename F>
+	static void destroy (void* p) { static_cast<F*> (p)->~F (); }
+
+	union {
+		char    data[storage_size];
+		double  _align_d;
+		int64_t _align_i;
+		void*   _align_p;
+	} _storage;
+
+	void (*_invoke) (void*);
+	void (*_destroy) (void*);
+};
+
 class LIBARDOUR_API RTTaskList
 {
 public:
-	RTTaskList ();
+	RTTaskList (size_t capacity = 4096);
 	~RTTaskList ();
 
-	// TODO use dedicated allocator of a boost::intrusive::list
 	typedef std::list<boost::function<void ()> > TaskList;
 
-	/** process tasks in list in parallel, wait for them to complete */
+	/** Queue a task to be run by the next call to process ().
+	 *
+	 * The functor (usually the result of boost::bind) is copied into
+	 * a pre-allocated slot, it must not be larger than RTTask::storage_size.
+	 * If all slots are used, queued tasks are processed first.
+	 *
+	 * There must only be one producer, and push_back () must not be
+	 * called while process () is running (e.g. by one of the tasks).
+	 * If that happens regardless, the task is run in place.
+	 */
+	template <typename F>
+	void push_back (F const& f)
+	{
+		if (_processing.load (std::memory_order_acquire)) {
+			assert (0);
+			F task (f);
+			task ();
+			return;
+		}
+		if (_n_queued == _tasks.size ()) {
+			process ();
+		}
+		_tasks[_n_queued++].set (f);
+	}
+
+	/** process queued tasks in parallel, wait for them to complete */
+	void process ();
+
+	/** process tasks in list in parallel, wait for them to complete.
+	 * This copies the tasks into the arena, prefer push_back () and process ()
+	 */
 	void process (TaskList const&);
 
+	size_t capacity () const { return _tasks.size (); }
+
+	/** Claim exclusive use of the task list.
+	 *
+	 * push_back () and process () must not be called concurrently.
+	 * Threads that may run at the same time as other users (e.g.
+	 * process-graph workers) call this first, and only queue tasks if
+	 * it succeeds. This is realtime-safe and never blocks.
+	 *
+	 * @return true if the list was acquired, call release () when done.
+	 */
+	bool try_acquire ()
+	{
+		bool expected = false;
+		return _acquired.compare_exchange_strong (expected, true, std::memory_order_acquire);
+	}
+
+	void release () { _acquired.store (false, std::memory_order_release); }
+
 private:
 	GATOMIC_QUAL gint      _threads_active;
 	std::vector<pthread_t> _threads;
@@ -51,17 +160,29 @@ private:
 	void reset_thread_list ();
 	void drop_threads ();
 
-	void process_tasklist ();
+	bool claim (uint32_t&, uint32_t&);
+	bool run_tasks ();
 
 	static void* _thread_run (void *arg);
 	void run ();
 
 	Glib::Threads::Mutex _process_mutex;
-	Glib::Threads::Mutex _tasklist_mutex;
 	PBD::Semaphore _task_run_sem;
 	PBD::Semaphore _task_end_sem;
 
-	TaskList _tasklist;
+	/* task arena */
+	std::vector<RTTask> _tasks;
+	uint32_t            _n_queued;
+
+	/* number of tasks in the current batch (upper 32 bit)
+	 * and index of the next task to claim (lower 32 bit).
+	 */
+	std::atomic<uint64_t> _claim;
+	std::atomic<uint32_t> _n_done;
+	std::atomic<uint32_t> _n_sleeping;
+	std::atomic<bool>     _processing;
+
+	std::atomic<bool>     _acquired;
 };
 
 } // namespace ARDOUR
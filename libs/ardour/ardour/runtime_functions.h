@@ -32,12 +32,48 @@ namespace ARDOUR {
 	typedef void  (*mix_buffers_no_gain_t)   (ARDOUR::Sample *, const ARDOUR::Sample *, pframes_t);
 	typedef void  (*copy_vector_t)           (ARDOUR::Sample *, const ARDOUR::Sample *, pframes_t);
 
+	typedef float (*apply_gain_ramp_to_buffer_t)   (ARDOUR::Sample *, pframes_t, float, float, float);
+	typedef void  (*apply_gain_vector_to_buffer_t) (ARDOUR::Sample *, const ARDOUR::gain_t *, pframes_t);
+	typedef void  (*invert_buffer_t)               (ARDOUR::Sample *, pframes_t);
+	typedef void  (*interleave_buffer_t)           (ARDOUR::Sample *, const ARDOUR::Sample *, pframes_t, uint32_t, uint32_t);
+	typedef void  (*deinterleave_buffer_t)         (ARDOUR::Sample *, const ARDOUR::Sample *, pframes_t, uint32_t, uint32_t);
+
+	typedef float (*mix_buffers_no_gain_and_peak_t)   (ARDOUR::Sample *, const ARDOUR::Sample *, pframes_t, float);
+	typedef float (*mix_buffers_with_gain_and_peak_t) (ARDOUR::Sample *, const ARDOUR::Sample *, pframes_t, float, float);
+	typedef float (*copy_vector_with_gain_and_peak_t) (ARDOUR::Sample *, const ARDOUR::Sample *, pframes_t, float, float);
+
 	LIBARDOUR_API extern compute_peak_t          compute_peak;
 	LIBARDOUR_API extern find_peaks_t            find_peaks;
 	LIBARDOUR_API extern apply_gain_to_buffer_t  apply_gain_to_buffer;
 	LIBARDOUR_API extern mix_buffers_with_gain_t mix_buffers_with_gain;
 	LIBARDOUR_API extern mix_buffers_no_gain_t   mix_buffers_no_gain;
 	LIBARDOUR_API extern copy_vector_t           copy_vector;
+
+	/** Apply a one-pole smoothed gain (Amp's declick):
+	 * g[0] = initial, g[n+1] = g[n] + coeff * (target - g[n]).
+	 * @return gain after the last sample
+	 */
+	LIBARDOUR_API extern apply_gain_ramp_to_buffer_t   apply_gain_ramp_to_buffer;
+	/** Multiply each sample with the corresponding gain-coefficient (gain automation) */
+	LIBARDOUR_API extern apply_gain_vector_to_buffer_t apply_gain_vector_to_buffer;
+	/** Polarity inversion */
+	LIBARDOUR_API extern invert_buffer_t               invert_buffer;
+	/** Copy a mono buffer into channel @a chn of an interleaved buffer with @a n_chn channels */
+	LIBARDOUR_API extern interleave_buffer_t           interleave_buffer;
+	/** Copy channel @a chn of an interleaved buffer with @a n_chn channels into a mono buffer */
+	LIBARDOUR_API extern deinterleave_buffer_t         deinterleave_buffer;
+
+	/* Fused mix-and-meter kernels: perform the operation and return
+	 * max (current, absolute peak of the destination after the operation),
+	 * so that a subsequent PeakMeter does not need to walk the buffer again.
+	 */
+
+	/** dst += src */
+	LIBARDOUR_API extern mix_buffers_no_gain_and_peak_t   mix_buffers_no_gain_and_peak;
+	/** dst += src * gain */
+	LIBARDOUR_API extern mix_buffers_with_gain_and_peak_t mix_buffers_with_gain_and_peak;
+	/** dst = src * gain */
+	LIBARDOUR_API extern copy_vector_with_gain_and_peak_t copy_vector_with_gain_and_peak;
 }
 
 #endif /* __ardour_runtime_functions_h__ */
@@ -170,6 +170,7 @@ class SceneChanger;
 class SessionDirectory;
 class SessionMetadata;
 class SessionPlaylists;
+class SessionSnapshot;
 class SoloMuteRelease;
 class Source;
 class Speakers;
@@ -351,6 +352,7 @@ public:
 	uint32_t nbusses () const;
 
 	bool plot_process_graph (std::string const& file_name) const;
+	void reprioritize_process_graph ();
 
 	boost::shared_ptr<BundleList> bundles () {
 		return _bundles.reader ();
@@ -497,6 +499,11 @@ public:
 	void adjust_playback_buffering();
 	void adjust_capture_buffering();
 
+	/** Asynchronously load audio data that will be needed to start
+	 * playback at the given position into the AudioBlockCache.
+	 */
+	void prefetch_audio (samplepos_t);
+
 	bool global_locate_pending() const { return _global_locate_pending; }
 	bool locate_pending() const;
 	bool locate_initiated() const;
@@ -1573,6 +1580,7 @@ private:
 	std::string _current_snapshot_name;
 
 	XMLTree*         state_tree;
+	SessionSnapshot* _pending_snapshot;
 	bool             state_was_pending;
 	StateOfTheState _state_of_the_state;
 
@@ -1634,6 +1642,7 @@ private:
 
 	void update_skips (Location*, bool consolidate);
 	void update_marks (Location* loc);
+	void prefetch_location (Location*);
 	void consolidate_skips (Location*);
 	void sync_locations_to_skips ();
 	void _sync_locations_to_skips ();
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2026 The Ardour Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __ardour_session_snapshot_h__
+#define __ardour_session_snapshot_h__
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+
+#include "ardour/libardour_visibility.h"
+
+class XMLNode;
+
+namespace ARDOUR {
+
+/** Compact binary container for session state.
+ *
+ * The state is stored as a skeleton of the XML tree, and one chunk per
+ * object (the children of top-level nodes that have an "id" property),
+ * keyed by PBD::ID. Re-writing the same file only appends chunks whose
+ * content has changed since the last write, followed by a new index.
+ * The file is compacted once it contains more stale than live data.
+ *
+ * Reading a snapshot reproduces the XML tree that was written, so
+ * conversion in either direction is lossless.
+ */
+class LIBARDOUR_API SessionSnapshot
+{
+public:
+	SessionSnapshot ();
+
+	/** Write @a root to @a path. If the file was previously written
+	 * or read by this instance and has not been modified since,
+	 * the write is incremental.
+	 * @return 0 on success
+	 */
+	int write (std::string const& path, XMLNode const& root);
+
+	/** Read the snapshot at @a path.
+	 * @return the root node (owned by the caller), or 0 on error
+	 */
+	XMLNode* read (std::string const& path);
+
+	/** Forget about the previously written file, the next write is a full one */
+	void reset ();
+
+	/** number of object chunks written by the last call to ::write () */
+	size_t chunks_written () const { return _chunks_written; }
+
+	/** number of object chunks in the last written or read snapshot */
+	size_t n_chunks () const { return _chunks.size (); }
+
+	/** @return true if the file at @a path is a binary snapshot */
+	static bool is_snapshot (std::string const& path);
+
+private:
+	struct Chunk {
+		Chunk () : hash (0), offset (0), size (0) {}
+		uint64_t hash;
+		uint64_t offset;
+		uint32_t size;
+	};
+
+	typedef std::map<uint64_t, Chunk> ChunkMap;
+
+	struct Object;
+	typedef std::vector<Object> Objects;
+
+	int write_full (std::string const& path, std::string const& skeleton, Objects const&);
+	int append (std::string const& path, std::string const& skeleton, Objects const&);
+	static void encode_index (std::string&, std::string const& skeleton, ChunkMap const&);
+	static XMLNode* decode (char const*, size_t, ChunkMap&);
+
+	std::string _path;
+	uint64_t    _file_size;
+	size_t      _chunks_written;
+	ChunkMap    _chunks;
+};
+
+} // namespace ARDOUR
+
+#endif /* __ardour_session_snapshot_h__ */
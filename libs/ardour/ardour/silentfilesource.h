@@ -43,6 +43,7 @@ public:
 
 protected:
 	void close() {}
+	bool cacheable () const { return false; }
 	friend class SourceFactory;
 
 	SilentFileSource (Session& s, const XMLNode& x, samplecnt_t len, float srate)
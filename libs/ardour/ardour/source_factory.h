@@ -57,9 +57,11 @@ public:
 	static std::vector<PBD::Thread*> peak_thread_pool;
 
 	static std::list<boost::weak_ptr<AudioSource>> files_with_peaks;
+	static std::list<boost::weak_ptr<AudioSource>> pyramids_to_build;
 
 	static int peak_work_queue_length ();
 	static int setup_peakfile (boost::shared_ptr<Source>, bool async);
+	static void queue_peak_pyramid (boost::shared_ptr<AudioSource>);
 };
 
 } // namespace ARDOUR
@@ -51,6 +51,8 @@ public:
 
 protected:
 	void close ();
+	/* the resampler is stateful, reads have to be sequential */
+	bool cacheable () const { return false; }
 	samplecnt_t read_unlocked (Sample *dst, samplepos_t start, samplecnt_t cnt) const;
 	samplecnt_t write_unlocked (Sample */*dst*/, samplecnt_t /*cnt*/) { return 0; }
 
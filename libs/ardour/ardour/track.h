@@ -143,6 +143,8 @@ public:
 	void reset_write_sources (bool, bool force = false);
 	float playback_buffer_load () const;
 	float capture_buffer_load () const;
+	RefillStats playback_refill_stats () const;
+	void reset_playback_refill_stats ();
 	int do_refill ();
 	int do_flush (RunContext, bool force = false);
 	void set_pending_overwrite (OverwriteReason);
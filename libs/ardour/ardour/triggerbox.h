@@ -506,6 +506,15 @@ class LIBARDOUR_API AudioTrigger : public Trigger {
 
 	bool stretching () const;
 
+	/* true if only the head of the region is held in memory and the rest
+	 * is streamed from disk by the TriggerBoxThread
+	 */
+	bool streaming () const { return _stream != 0; }
+	uint32_t stream_underruns () const;
+
+	/* called from the TriggerBoxThread */
+	void refill_stream ();
+
   protected:
 	void retrigger ();
 
@@ -516,7 +525,12 @@ class LIBARDOUR_API AudioTrigger : public Trigger {
 		Data () : length (0) {}
 	};
 
+	struct Stream;
+
 	Data        data;
+	Stream*     _stream;
+	int64_t     _data_bytes; /* accounted with TriggerBox::reserve_clip_memory() */
+	std::vector<Sample*> _data_ptrs;
 	RubberBand::RubberBandStretcher*  _stretcher;
 	samplepos_t _start_offset;
 
@@ -535,6 +549,9 @@ class LIBARDOUR_API AudioTrigger : public Trigger {
 
 	void drop_data ();
 	int load_data (boost::shared_ptr<AudioRegion>);
+	Sample* const* audio_data (samplepos_t pos, samplecnt_t cnt, bool in_process_context);
+	void stream_read (samplepos_t pos, samplecnt_t cnt, bool in_process_context);
+	void stream_seek (samplepos_t);
 	void estimate_tempo ();
 	void reset_stretcher ();
 	void _startup (BufferSet&, pframes_t dest_offset, Temporal::BBT_Offset const &);
@@ -638,6 +655,11 @@ class LIBARDOUR_API TriggerBoxThread
 	void set_region (TriggerBox&, uint32_t slot, boost::shared_ptr<Region>);
 	void request_delete_trigger (Trigger* t);
 
+	/* streaming AudioTriggers; request_refill() is RT-safe */
+	void add_stream (AudioTrigger*);
+	void remove_stream (AudioTrigger*);
+	void request_refill ();
+
 	void summon();
 	void stop();
 	void wait_until_finished();
@@ -649,7 +671,8 @@ class LIBARDOUR_API TriggerBoxThread
 	enum RequestType {
 		Quit,
 		SetRegion,
-		DeleteTrigger
+		DeleteTrigger,
+		Refill
 	};
 
 	struct Request {
@@ -677,6 +700,12 @@ class LIBARDOUR_API TriggerBoxThread
 	CrossThreadChannel _xthread;
 	void queue_request (Request*);
 	void delete_trigger (Trigger*);
+
+	std::atomic<bool>          _refill_pending;
+	Glib::Threads::Mutex       _stream_lock;
+	std::vector<AudioTrigger*> _streams;
+
+	void refill_streams ();
 };
 
 struct CueRecord {
@@ -798,6 +827,14 @@ class LIBARDOUR_API TriggerBox : public Processor
 
 	static void start_transport_stop (Session&);
 
+	/* Account for @param bytes of audio data held in memory by a trigger
+	 * of this box. Returns false (without accounting) if that would
+	 * exceed the trigger-memory-budget, unless @param force is true.
+	 */
+	bool reserve_clip_memory (int64_t bytes, bool force = false);
+	void release_clip_memory (int64_t bytes);
+	int64_t clip_memory () const { return _clip_memory; }
+
   private:
 	struct Requests {
 		std::atomic<bool> stop_all;
@@ -809,6 +846,7 @@ class LIBARDOUR_API TriggerBox : public Processor
 
 	DataType _data_type;
 	int32_t _order;
+	std::atomic<int64_t> _clip_memory;
 	Glib::Threads::RWLock trigger_lock; /* protects all_triggers */
 	Triggers all_triggers;
 
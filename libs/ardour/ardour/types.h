@@ -792,6 +792,19 @@ struct CaptureInfo {
 	XrunPositions xruns;
 };
 
+/** Timing of playback buffer refills of a DiskReader.
+ * Durations are in microseconds, headroom in seconds.
+ */
+struct RefillStats {
+	RefillStats () : count (0), rolling (0), last (0), max (0), avg (0), min_headroom (0) {}
+	uint64_t count;        ///< number of refills that read data
+	uint64_t rolling;      ///< number of those refills while rolling
+	int64_t  last;         ///< duration of the most recent refill
+	int64_t  max;          ///< longest refill
+	double   avg;          ///< moving average of the refill duration
+	double   min_headroom; ///< smallest amount of buffered data left after a refill, while rolling
+};
+
 enum LoopFadeChoice {
 	NoLoopFade,
 	EndLoopFade,
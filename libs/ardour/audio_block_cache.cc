@@ -0,0 +1,262 @@
+/*
+ * Copyright (C) 2026 The Ardour Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <limits>
+
+#include <boost/bind.hpp>
+
+#include "ardour/audio_block_cache.h"
+#include "ardour/audiofilesource.h"
+#include "ardour/rc_configuration.h"
+#include "ardour/session_event.h"
+
+using namespace ARDOUR;
+
+AudioBlockCache* AudioBlockCache::_instance = 0;
+
+void
+AudioBlockCache::init ()
+{
+	if (_instance) {
+		return;
+	}
+	_instance = new AudioBlockCache ();
+}
+
+void
+AudioBlockCache::terminate ()
+{
+	delete _instance;
+	_instance = 0;
+}
+
+AudioBlockCache::AudioBlockCache ()
+	: _budget (0)
+	, _bytes (0)
+	, _thread_run (true)
+{
+	set_budget ((size_t)Config->get_audio_block_cache_size () * 1048576);
+	Config->ParameterChanged.connect_same_thread (_config_connection, boost::bind (&AudioBlockCache::config_changed, this, _1));
+	_thread = PBD::Thread::create (boost::bind (&AudioBlockCache::prefetch_thread, this), "AudioPrefetch");
+}
+
+AudioBlockCache::~AudioBlockCache ()
+{
+	{
+		Glib::Threads::Mutex::Lock lm (_queue_lock);
+		_thread_run = false;
+		_queue.clear ();
+		_queue_cond.signal ();
+	}
+	_thread->join ();
+	delete _thread;
+	clear ();
+}
+
+void
+AudioBlockCache::config_changed (std::string const& p)
+{
+	if (p == "audio-block-cache-size") {
+		set_budget ((size_t)Config->get_audio_block_cache_size () * 1048576);
+	}
+}
+
+void
+AudioBlockCache::set_budget (size_t bytes)
+{
+	Glib::Threads::Mutex::Lock lm (_lock);
+	_budget.store (bytes);
+	evict_to (bytes);
+}
+
+void
+AudioBlockCache::evict_to (size_t bytes)
+{
+	/* _lock must be held */
+	while (_bytes > bytes && !_lru.empty ()) {
+		_bytes -= _lru.back ().second->length * sizeof (Sample);
+		_index.erase (_lru.back ().first);
+		_lru.pop_back ();
+		++_stats.evictions;
+	}
+}
+
+AudioBlockCache::BlockPtr
+AudioBlockCache::lookup (AudioSource const* src, int64_t block)
+{
+	Glib::Threads::Mutex::Lock lm (_lock);
+	Index::iterator i = _index.find (Key (src, block));
+	if (i == _index.end ()) {
+		++_stats.misses;
+		return BlockPtr ();
+	}
+	++_stats.hits;
+	/* move to the front of the LRU list */
+	_lru.splice (_lru.begin (), _lru, i->second);
+	return i->second->second;
+}
+
+bool
+AudioBlockCache::contains (AudioSource const* src, int64_t block) const
+{
+	Glib::Threads::Mutex::Lock lm (_lock);
+	return _index.find (Key (src, block)) != _index.end ();
+}
+
+uint64_t
+AudioBlockCache::generation (AudioSource const* src) const
+{
+	Glib::Threads::Mutex::Lock lm (_lock);
+	Generations::const_iterator i = _generations.find (src);
+	return i == _generations.end () ? 0 : i->second;
+}
+
+void
+AudioBlockCache::insert (AudioSource const* src, int64_t block, BlockPtr b, uint64_t generation, bool prefetched)
+{
+	const size_t size = b->length * sizeof (Sample);
+
+	Glib::Threads::Mutex::Lock lm (_lock);
+
+	if (size > _budget.load ()) {
+		return;
+	}
+
+	Generations::const_iterator g = _generations.find (src);
+	if (generation != (g == _generations.end () ? 0 : g->second)) {
+		/* the source was modified while the block was read */
+		return;
+	}
+
+	Key key (src, block);
+
+	if (_index.find (key) != _index.end ()) {
+		/* another thread loaded it concurrently */
+		return;
+	}
+
+	_lru.push_front (std::make_pair (key, b));
+	_index[key] = _lru.begin ();
+	_bytes += size;
+
+	if (prefetched) {
+		++_stats.prefetched;
+	}
+
+	evict_to (_budget.load ());
+}
+
+void
+AudioBlockCache::drop (AudioSource const* src)
+{
+	Glib::Threads::Mutex::Lock lm (_lock);
+	++_generations[src];
+	drop_locked (src);
+}
+
+void
+AudioBlockCache::forget (AudioSource const* src)
+{
+	Glib::Threads::Mutex::Lock lm (_lock);
+	_generations.erase (src);
+	drop_locked (src);
+}
+
+void
+AudioBlockCache::drop_locked (AudioSource const* src)
+{
+	/* _lock must be held */
+	Index::iterator i = _index.lower_bound (Key (src, std::numeric_limits<int64_t>::min ()));
+	while (i != _index.end () && i->first.first == src) {
+		_bytes -= i->second->second->length * sizeof (Sample);
+		_lru.erase (i->second);
+		_index.erase (i++);
+	}
+}
+
+void
+AudioBlockCache::clear ()
+{
+	Glib::Threads::Mutex::Lock lm (_lock);
+	_lru.clear ();
+	_index.clear ();
+	_bytes = 0;
+}
+
+AudioBlockCache::Stats
+AudioBlockCache::stats () const
+{
+	Glib::Threads::Mutex::Lock lm (_lock);
+	Stats s (_stats);
+	s.bytes  = _bytes;
+	s.budget = _budget.load ();
+	return s;
+}
+
+void
+AudioBlockCache::reset_stats ()
+{
+	Glib::Threads::Mutex::Lock lm (_lock);
+	_stats = Stats ();
+}
+
+void
+AudioBlockCache::prefetch (boost::shared_ptr<AudioFileSource> src, samplepos_t start, samplecnt_t cnt)
+{
+	if (!enabled () || cnt <= 0) {
+		return;
+	}
+	Glib::Threads::Mutex::Lock lm (_queue_lock);
+	_queue.push_back (PrefetchRequest (src, start, cnt));
+	_queue_cond.signal ();
+}
+
+void
+AudioBlockCache::prefetch_thread ()
+{
+	SessionEvent::create_per_thread_pool ("AudioPrefetch", 64);
+
+	_queue_lock.lock ();
+
+	while (true) {
+		if (_queue.empty () && _thread_run) {
+			_queue_cond.wait (_queue_lock);
+		}
+
+		if (!_thread_run) {
+			break;
+		}
+
+		if (_queue.empty ()) {
+			continue;
+		}
+
+		PrefetchRequest req (_queue.front ());
+		_queue.pop_front ();
+		_queue_lock.unlock ();
+
+		boost::shared_ptr<AudioFileSource> src (req.source.lock ());
+		if (src) {
+			src->prefetch (req.start, req.cnt);
+		}
+
+		_queue_lock.lock ();
+	}
+
+	_queue_lock.unlock ();
+}
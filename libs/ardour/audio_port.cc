@@ -29,6 +29,7 @@
 #include "ardour/data_type.h"
 #include "ardour/port_engine.h"
 #include "ardour/rc_configuration.h"
+#include "ardour/runtime_functions.h"
 
 using namespace ARDOUR;
 using namespace std;
@@ -40,6 +41,7 @@ AudioPort::AudioPort (const std::string& name, PortFlags flags)
 	: Port (name, DataType::AUDIO, flags)
 	, _buffer (new AudioBuffer (0))
 	, _data (0)
+	, _resampled_input (false)
 {
 	assert (name.find_first_of (':') == string::npos);
 	_src.setup (_resampler_quality);
@@ -67,6 +69,9 @@ AudioPort::cycle_start (pframes_t nframes)
 
 	if (sends_output()) {
 		_buffer->prepare ();
+	} else if (_resampled_input) {
+		/* data was already copied by PortManager::cycle_start */
+		_resampled_input = false;
 	} else if (!externally_connected ()) {
 		/* ardour internal port, just silence input, don't resample */
 		// TODO reset resampler only once
@@ -87,6 +92,17 @@ AudioPort::cycle_start (pframes_t nframes)
 	}
 }
 
+void
+AudioPort::set_resampled_input (Sample const* data)
+{
+	/* The external source was resampled once for all ports connected to it.
+	 * Our own resampler is not used meanwhile, and only catches up when
+	 * the connection changes (which is not click-free to begin with).
+	 */
+	copy_vector (_data, data, _cycle_nframes);
+	_resampled_input = true;
+}
+
 void
 AudioPort::cycle_end (pframes_t nframes)
 {
@@ -24,6 +24,8 @@
 #include "libardour-config.h"
 #endif
 
+#include <algorithm>
+#include <cstring>
 #include <vector>
 
 #include <sys/time.h>
@@ -162,6 +164,9 @@ AudioFileSource::AudioFileSource (Session& s, const XMLNode& node, bool must_exi
 AudioFileSource::~AudioFileSource ()
 {
 	DEBUG_TRACE (DEBUG::Destruction, string_compose ("AudioFileSource destructor %1, removable? %2\n", _path, removable()));
+	if (AudioBlockCache::instance ()) {
+		AudioBlockCache::instance ()->forget (this);
+	}
 	if (removable()) {
 		::g_unlink (_path.c_str());
 		::g_unlink (_peakpath.c_str());
@@ -305,6 +310,9 @@ AudioFileSource::set_gain (float g, bool temporarily)
 		return;
 	}
 	_gain = g;
+	if (AudioBlockCache::instance ()) {
+		AudioBlockCache::instance ()->drop (this);
+	}
 	if (temporarily) {
 		return;
 	}
@@ -312,6 +320,90 @@ AudioFileSource::set_gain (float g, bool temporarily)
 	setup_peakfile ();
 }
 
+bool
+AudioFileSource::cacheable () const
+{
+	/* files that are written to are not cached */
+	return !writable () && AudioBlockCache::instance () && AudioBlockCache::instance ()->enabled ();
+}
+
+AudioBlockCache::BlockPtr
+AudioFileSource::load_block (int64_t block) const
+{
+	const samplepos_t start = block * AudioBlockCache::block_samples;
+	const samplecnt_t cnt   = std::min (AudioBlockCache::block_samples, _length.samples () - start);
+
+	AudioBlockCache::BlockPtr b (new AudioBlockCache::Block (cnt));
+
+	Glib::Threads::Mutex::Lock lm (_lock);
+	if (read_unlocked (b->data, start, cnt) != cnt) {
+		return AudioBlockCache::BlockPtr ();
+	}
+	return b;
+}
+
+samplecnt_t
+AudioFileSource::read (Sample *dst, samplepos_t start, samplecnt_t cnt, int channel) const
+{
+	/* reads beyond the end of the file are left to read_unlocked () */
+	if (!cacheable () || start < 0 || start + cnt > _length.samples ()) {
+		return AudioSource::read (dst, start, cnt, channel);
+	}
+
+	AudioBlockCache*  cache = AudioBlockCache::instance ();
+	const samplecnt_t bs    = AudioBlockCache::block_samples;
+	samplecnt_t       done  = 0;
+
+	while (done < cnt) {
+		const samplepos_t pos   = start + done;
+		const int64_t     block = pos / bs;
+		const samplecnt_t offs  = pos - block * bs;
+		const samplecnt_t n     = std::min (cnt - done, bs - offs);
+
+		AudioBlockCache::BlockPtr b = cache->lookup (this, block);
+
+		if (!b) {
+			const uint64_t gen = cache->generation (this);
+			b = load_block (block);
+			if (!b) {
+				return done + AudioSource::read (dst + done, pos, cnt - done, channel);
+			}
+			cache->insert (this, block, b, gen);
+		}
+
+		assert (offs + n <= b->length);
+		memcpy (dst + done, b->data + offs, sizeof (Sample) * n);
+		done += n;
+	}
+
+	return cnt;
+}
+
+void
+AudioFileSource::prefetch (samplepos_t start, samplecnt_t cnt) const
+{
+	if (!cacheable () || start >= _length.samples ()) {
+		return;
+	}
+
+	AudioBlockCache*  cache = AudioBlockCache::instance ();
+	const samplecnt_t bs    = AudioBlockCache::block_samples;
+	const int64_t     first = std::max<samplepos_t> (0, start) / bs;
+	const int64_t     last  = (std::min (start + cnt, _length.samples ()) - 1) / bs;
+
+	for (int64_t block = first; block <= last; ++block) {
+		if (cache->contains (this, block)) {
+			continue;
+		}
+		const uint64_t gen = cache->generation (this);
+		AudioBlockCache::BlockPtr b = load_block (block);
+		if (!b) {
+			break;
+		}
+		cache->insert (this, block, b, gen, true);
+	}
+}
+
 bool
 AudioFileSource::safe_audio_file_extension(const string& file)
 {
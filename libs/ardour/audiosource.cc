@@ -32,6 +32,7 @@
 #include <fcntl.h>
 #include <float.h>
 #include <cerrno>
+#include <cstring>
 #include <ctime>
 #include <cmath>
 #include <iomanip>
@@ -63,6 +64,7 @@
 #include "ardour/rc_configuration.h"
 #include "ardour/runtime_functions.h"
 #include "ardour/session.h"
+#include "ardour/source_factory.h"
 
 #include "pbd/i18n.h"
 
@@ -79,6 +81,57 @@ bool AudioSource::_build_peakfiles = false;
 
 #define _FPP 256
 
+/* Levels of the peak pyramid, in samples per peak. Each level
+ * reduces the previous one (or the peakfile) by a factor of 16.
+ */
+static const uint32_t    n_pyramid_levels = 2;
+static const samplecnt_t pyramid_fpp[n_pyramid_levels] = { 4096, 65536 };
+
+static const char     peak_pyramid_magic[8] = { 'A', 'R', 'D', 'P', 'E', 'A', 'K', 'P' };
+static const uint32_t peak_pyramid_version  = 1;
+
+struct PeakPyramidHeader {
+	char     magic[8];
+	uint32_t version;
+	uint32_t n_levels;
+	int64_t  length;   ///< length of the audio in samples
+	int64_t  base_fpp; ///< samples per peak of the peakfile
+	int64_t  level_fpp[n_pyramid_levels];
+	int64_t  level_peaks[n_pyramid_levels];
+};
+
+/** Combine every @a ratio consecutive peaks into one */
+struct PeakReducer {
+	PeakReducer (samplecnt_t r, std::vector<PeakData>& p) : ratio (r), n (0), peaks (p) {}
+
+	void add (PeakData const& p)
+	{
+		if (n == 0) {
+			cur = p;
+		} else {
+			cur.min = std::min (cur.min, p.min);
+			cur.max = std::max (cur.max, p.max);
+		}
+		if (++n == ratio) {
+			peaks.push_back (cur);
+			n = 0;
+		}
+	}
+
+	void flush ()
+	{
+		if (n > 0) {
+			peaks.push_back (cur);
+			n = 0;
+		}
+	}
+
+	samplecnt_t            ratio;
+	samplecnt_t            n;
+	PeakData               cur;
+	std::vector<PeakData>& peaks;
+};
+
 AudioSource::AudioSource (Session& s, const string& name)
 	: Source (s, DataType::AUDIO, name)
 	, _peak_byte_max (0)
@@ -92,6 +145,8 @@ AudioSource::AudioSource (Session& s, const string& name)
 	, _last_scale (0.0)
 	, _last_map_off (0)
 	, _last_raw_map_length (0)
+	, _pyramid_checked (false)
+	, _pyramid_queued (false)
 {
 }
 
@@ -108,6 +163,8 @@ AudioSource::AudioSource (Session& s, const XMLNode& node)
 	, _last_scale (0.0)
 	, _last_map_off (0)
 	, _last_raw_map_length (0)
+	, _pyramid_checked (false)
+	, _pyramid_queued (false)
 {
 	if (set_state (node, Stateful::loading_state_version)) {
 		throw failed_constructor();
@@ -212,6 +269,7 @@ AudioSource::rename_peakfile (string newpath)
 	/* caller must hold _lock */
 
 	string oldpath = _peakpath;
+	string oldpyramid = peak_pyramid_path ();
 
 	if (Glib::file_test (oldpath, Glib::FILE_TEST_EXISTS)) {
 		if (g_rename (oldpath.c_str(), newpath.c_str()) != 0) {
@@ -222,6 +280,14 @@ AudioSource::rename_peakfile (string newpath)
 
 	_peakpath = newpath;
 
+	if (Glib::file_test (oldpyramid, Glib::FILE_TEST_EXISTS)) {
+		if (g_rename (oldpyramid.c_str(), peak_pyramid_path ().c_str()) != 0) {
+			/* it will be rebuilt when needed */
+			::g_unlink (oldpyramid.c_str());
+		}
+	}
+	invalidate_peak_pyramid ();
+
 	return 0;
 }
 
@@ -232,6 +298,7 @@ AudioSource::initialize_peakfile (const string& audio_path, const bool in_sessio
 	GStatBuf statbuf;
 
 	_peakpath = construct_peak_filepath (audio_path, in_session);
+	invalidate_peak_pyramid ();
 
 	if (!empty() && !Glib::file_test (_peakpath.c_str(), Glib::FILE_TEST_EXISTS)) {
 		string oldpeak = construct_peak_filepath (audio_path, in_session, true);
@@ -432,6 +499,28 @@ AudioSource::read_peaks_with_fpp (PeakData *peaks, samplecnt_t npeaks, samplepos
 		}
 	}
 
+	if (samples_per_file_peak == _FPP && samples_per_visual_peak >= pyramid_fpp[0] && npeaks != cnt) {
+		/* zoomed out: use the coarsest level of the peak pyramid
+		 * that still has at least one peak per visual peak.
+		 * Old peakfiles are upgraded in the background, meanwhile
+		 * the peakfile is used.
+		 */
+		if (!load_peak_pyramid ()) {
+			queue_peak_pyramid ();
+		} else {
+			PeakLevel const* level = 0;
+			for (std::vector<PeakLevel>::const_iterator l = _pyramid.begin (); l != _pyramid.end (); ++l) {
+				if (l->fpp <= samples_per_visual_peak) {
+					level = &(*l);
+				}
+			}
+			if (level && read_pyramid_peaks (*level, peaks, npeaks, start, cnt, samples_per_visual_peak) == 0) {
+				DEBUG_TRACE (DEBUG::Peaks, string_compose ("PYRAMID PEAKS @ %1 spp\n", level->fpp));
+				return 0;
+			}
+		}
+	}
+
 	ScopedFileDescriptor sfd (g_open (_peakpath.c_str(), O_RDONLY, 0444));
 
 	if (sfd < 0) {
@@ -774,6 +863,14 @@ AudioSource::build_peaks_from_scratch ()
 		_peaks_built = false;
 		boost::scoped_array<Sample> buf(new Sample[bufsize]);
 
+		/* the peak pyramid is computed in the same pass.
+		 * Reads are aligned to the first level's samples-per-peak.
+		 */
+		assert (bufsize % pyramid_fpp[0] == 0);
+		std::vector<PeakData> levels[n_pyramid_levels];
+		PeakReducer           reducer (pyramid_fpp[1] / pyramid_fpp[0], levels[1]);
+		invalidate_peak_pyramid ();
+
 		while (cnt) {
 
 			samplecnt_t samples_to_read = min (bufsize, cnt);
@@ -798,6 +895,17 @@ AudioSource::build_peaks_from_scratch ()
 				break;
 			}
 
+			for (samplecnt_t off = 0; off < samples_read; off += pyramid_fpp[0]) {
+				const samplecnt_t n = min (pyramid_fpp[0], samples_read - off);
+				PeakData p;
+				p.min = p.max = buf[off];
+				if (n > 1) {
+					ARDOUR::find_peaks (buf.get() + off + 1, n - 1, &p.min, &p.max);
+				}
+				levels[0].push_back (p);
+				reducer.add (p);
+			}
+
 			current_sample += samples_read;
 			cnt -= samples_read;
 
@@ -807,6 +915,8 @@ AudioSource::build_peaks_from_scratch ()
 		if (cnt == 0) {
 			/* success */
 			truncate_peakfile();
+			reducer.flush ();
+			write_peak_pyramid (levels);
 		}
 
 		done_with_peakfile_writes ((cnt == 0));
@@ -834,7 +944,9 @@ AudioSource::close_peakfile ()
 	}
 	if (!_peakpath.empty()) {
 		::g_unlink (_peakpath.c_str());
+		::g_unlink (peak_pyramid_path ().c_str());
 	}
+	invalidate_peak_pyramid ();
 	_peaks_built = false;
 	return 0;
 }
@@ -871,6 +983,10 @@ AudioSource::done_with_peakfile_writes (bool done)
 	close (_peakfile_fd);
 	_peakfile_fd = -1;
 
+	/* peak data may have changed, the pyramid is checked and if needed rebuilt when next used */
+	_pyramid_checked = false;
+	_pyramid_queued  = false;
+
 	if (done) {
 		Glib::Threads::Mutex::Lock lm (_peaks_ready_lock);
 		_peaks_built = true;
@@ -1098,6 +1214,292 @@ AudioSource::truncate_peakfile ()
 	}
 }
 
+std::string
+AudioSource::peak_pyramid_path () const
+{
+	if (_peakpath.empty ()) {
+		return std::string ();
+	}
+	return _peakpath + X_(".pyr");
+}
+
+void
+AudioSource::invalidate_peak_pyramid ()
+{
+	_pyramid_checked = false;
+	_pyramid_queued  = false;
+	_pyramid.clear ();
+}
+
+/** Check if a valid peak pyramid file exists for the current peak data.
+ * _lock MUST be held by caller.
+ */
+bool
+AudioSource::load_peak_pyramid () const
+{
+	if (_pyramid_checked) {
+		return !_pyramid.empty ();
+	}
+
+	_pyramid_checked = true;
+	_pyramid.clear ();
+
+	const std::string path = peak_pyramid_path ();
+	if (path.empty ()) {
+		return false;
+	}
+
+	ScopedFileDescriptor sfd (g_open (path.c_str(), O_RDONLY, 0444));
+	if (sfd < 0) {
+		return false;
+	}
+
+	PeakPyramidHeader hdr;
+	if (::read (sfd, &hdr, sizeof (hdr)) != sizeof (hdr)) {
+		return false;
+	}
+
+	if (memcmp (hdr.magic, peak_pyramid_magic, sizeof (hdr.magic)) || hdr.version != peak_pyramid_version
+	    || hdr.n_levels != n_pyramid_levels || hdr.base_fpp != _FPP || hdr.length != _length.samples ()) {
+		DEBUG_TRACE (DEBUG::Peaks, string_compose ("Peak pyramid %1 is outdated\n", path));
+		return false;
+	}
+
+	off_t offset = sizeof (hdr);
+	for (uint32_t l = 0; l < n_pyramid_levels; ++l) {
+		if (hdr.level_fpp[l] != pyramid_fpp[l] || hdr.level_peaks[l] != (hdr.length + pyramid_fpp[l] - 1) / pyramid_fpp[l]) {
+			_pyramid.clear ();
+			return false;
+		}
+		_pyramid.push_back (PeakLevel (hdr.level_fpp[l], offset, hdr.level_peaks[l]));
+		offset += hdr.level_peaks[l] * sizeof (PeakData);
+	}
+
+	GStatBuf statbuf;
+	if (g_stat (path.c_str(), &statbuf) != 0 || statbuf.st_size < offset) {
+		_pyramid.clear ();
+		return false;
+	}
+
+	return true;
+}
+
+/** Write the peak pyramid file, @a levels holds the peaks of each level.
+ * _lock MUST be held by caller.
+ */
+int
+AudioSource::write_peak_pyramid (std::vector<PeakData> const* levels) const
+{
+	const std::string path = peak_pyramid_path ();
+	if (path.empty () || _session.deletion_in_progress () || _session.peaks_cleanup_in_progres ()) {
+		return -1;
+	}
+
+	PeakPyramidHeader hdr;
+	memset (&hdr, 0, sizeof (hdr));
+	memcpy (hdr.magic, peak_pyramid_magic, sizeof (hdr.magic));
+	hdr.version  = peak_pyramid_version;
+	hdr.n_levels = n_pyramid_levels;
+	hdr.length   = _length.samples ();
+	hdr.base_fpp = _FPP;
+
+	for (uint32_t l = 0; l < n_pyramid_levels; ++l) {
+		hdr.level_fpp[l]   = pyramid_fpp[l];
+		hdr.level_peaks[l] = levels[l].size ();
+		if (hdr.level_peaks[l] != (hdr.length + pyramid_fpp[l] - 1) / pyramid_fpp[l]) {
+			return -1;
+		}
+	}
+
+	/* write to a temporary file and rename, so that readers never see a partial file */
+	const std::string tmp = path + X_(".tmp");
+	int fd = g_open (tmp.c_str(), O_CREAT|O_TRUNC|O_WRONLY, 0664);
+	if (fd < 0) {
+		return -1;
+	}
+
+	bool ok = ::write (fd, &hdr, sizeof (hdr)) == sizeof (hdr);
+	for (uint32_t l = 0; ok && l < n_pyramid_levels; ++l) {
+		const ssize_t bytes = levels[l].size () * sizeof (PeakData);
+		ok = bytes == 0 || ::write (fd, &levels[l][0], bytes) == bytes;
+	}
+	close (fd);
+
+	if (!ok || g_rename (tmp.c_str(), path.c_str()) != 0) {
+		::g_unlink (tmp.c_str());
+		return -1;
+	}
+
+	DEBUG_TRACE (DEBUG::Peaks, string_compose ("Wrote peak pyramid %1\n", path));
+	_pyramid_checked = false;
+	return 0;
+}
+
+/** Schedule the peak pyramid to be built from the peakfile.
+ * _lock MUST be held by caller.
+ */
+void
+AudioSource::queue_peak_pyramid () const
+{
+	if (_pyramid_queued || !_peaks_built || writable () || _peakpath.empty ()) {
+		return;
+	}
+
+	_pyramid_queued = true;
+
+	boost::shared_ptr<AudioSource> as;
+	try {
+		as = boost::dynamic_pointer_cast<AudioSource> (boost::const_pointer_cast<Source> (shared_from_this ()));
+	} catch (boost::bad_weak_ptr const&) {
+		return;
+	}
+
+	if (as) {
+		SourceFactory::queue_peak_pyramid (as);
+	}
+}
+
+bool
+AudioSource::has_peak_pyramid () const
+{
+	Glib::Threads::Mutex::Lock lm (_lock);
+	return load_peak_pyramid ();
+}
+
+int
+AudioSource::build_peak_pyramid ()
+{
+	std::string peakpath;
+	samplecnt_t length;
+
+	{
+		Glib::Threads::Mutex::Lock lm (_lock);
+		if (!_peaks_built || writable () || _peakpath.empty ()) {
+			return -1;
+		}
+		peakpath = _peakpath;
+		length   = _length.samples ();
+	}
+
+	/* the peakfile of a read-only source does not change,
+	 * read it without holding _lock.
+	 */
+	const samplecnt_t n_peaks = (length + _FPP - 1) / _FPP;
+
+	ScopedFileDescriptor sfd (g_open (peakpath.c_str(), O_RDONLY, 0444));
+	if (sfd < 0 || n_peaks == 0) {
+		return -1;
+	}
+
+	DEBUG_TRACE (DEBUG::Peaks, string_compose ("Upgrade peakfile %1 with pyramid\n", peakpath));
+
+	std::vector<PeakData> levels[n_pyramid_levels];
+	PeakReducer           r0 (pyramid_fpp[0] / _FPP, levels[0]);
+	PeakReducer           r1 (pyramid_fpp[1] / pyramid_fpp[0], levels[1]);
+
+	const samplecnt_t chunksize = 65536;
+	boost::scoped_array<PeakData> staging (new PeakData[chunksize]);
+
+	for (samplecnt_t done = 0; done < n_peaks;) {
+		if (_session.deletion_in_progress () || _session.peaks_cleanup_in_progres ()) {
+			return -1;
+		}
+		const samplecnt_t n = min (chunksize, n_peaks - done);
+		if (::read (sfd, staging.get(), n * sizeof (PeakData)) != (ssize_t) (n * sizeof (PeakData))) {
+			/* short peakfile, keep using it as-is */
+			return -1;
+		}
+		for (samplecnt_t i = 0; i < n; ++i) {
+			const size_t before = levels[0].size ();
+			r0.add (staging[i]);
+			if (levels[0].size () != before) {
+				r1.add (levels[0].back ());
+			}
+		}
+		done += n;
+	}
+
+	if (r0.n > 0) {
+		r0.flush ();
+		r1.add (levels[0].back ());
+	}
+	r1.flush ();
+
+	Glib::Threads::Mutex::Lock lm (_lock);
+
+	if (!_peaks_built || peakpath != _peakpath || length != _length.samples ()) {
+		/* peaks were rebuilt or renamed meanwhile */
+		return -1;
+	}
+
+	return write_peak_pyramid (levels);
+}
+
+/** Read peaks from a level of the peak pyramid, reducing them to
+ * @a samples_per_visual_peak. _lock MUST be held by caller.
+ */
+int
+AudioSource::read_pyramid_peaks (PeakLevel const& level, PeakData* peaks, samplecnt_t npeaks, samplepos_t start, samplecnt_t cnt, double samples_per_visual_peak) const
+{
+	const samplepos_t end = min (start + cnt, _length.samples ());
+
+	if (start >= end) {
+		memset (peaks, 0, sizeof (PeakData) * npeaks);
+		return 0;
+	}
+
+	const samplepos_t first = start / level.fpp;
+	const samplepos_t last  = min (level.n_peaks, (end + level.fpp - 1) / level.fpp);
+
+	if (first >= last) {
+		memset (peaks, 0, sizeof (PeakData) * npeaks);
+		return 0;
+	}
+
+	const samplecnt_t n_stored = last - first;
+	boost::scoped_array<PeakData> staging (new PeakData[n_stored]);
+
+	ScopedFileDescriptor sfd (g_open (peak_pyramid_path ().c_str(), O_RDONLY, 0444));
+	if (sfd < 0) {
+		return -1;
+	}
+
+	const off_t offset = level.offset + first * sizeof (PeakData);
+	if (lseek (sfd, offset, SEEK_SET) != offset) {
+		return -1;
+	}
+	if (::read (sfd, staging.get(), n_stored * sizeof (PeakData)) != (ssize_t) (n_stored * sizeof (PeakData))) {
+		return -1;
+	}
+
+	for (samplecnt_t i = 0; i < npeaks; ++i) {
+		const double s0 = start + i * samples_per_visual_peak;
+		const double s1 = std::min ((double) end, s0 + samples_per_visual_peak);
+
+		if (s0 >= end) {
+			peaks[i].min = peaks[i].max = 0;
+			continue;
+		}
+
+		samplepos_t p0 = (samplepos_t) floor (s0 / level.fpp) - first;
+		samplepos_t p1 = (samplepos_t) ceil (s1 / level.fpp) - first;
+
+		p0 = max ((samplepos_t) 0, min (p0, n_stored - 1));
+		p1 = max (p0 + 1, min (p1, n_stored));
+
+		PeakData::PeakDatum xmin = staging[p0].min;
+		PeakData::PeakDatum xmax = staging[p0].max;
+		for (samplepos_t p = p0 + 1; p < p1; ++p) {
+			xmin = min (xmin, staging[p].min);
+			xmax = max (xmax, staging[p].max);
+		}
+		peaks[i].min = xmin;
+		peaks[i].max = xmax;
+	}
+
+	return 0;
+}
+
 samplecnt_t
 AudioSource::available_peaks (double zoom_factor) const
 {
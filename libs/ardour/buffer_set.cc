@@ -31,6 +31,7 @@
 #include "pbd/compose.h"
 #include "pbd/failed_constructor.h"
 
+#include "ardour/audio_buffer.h"
 #include "ardour/buffer.h"
 #include "ardour/buffer_set.h"
 #include "ardour/debug.h"
@@ -471,6 +472,33 @@ BufferSet::merge_from (const BufferSet& in, samplecnt_t nframes)
 	}
 }
 
+/** Like merge_from(), and additionally compute the absolute peak of
+ * each resulting audio buffer while mixing (fused mix-and-meter).
+ *
+ * @param audio_peaks array to store peaks of the merged audio buffers
+ * @param n_peaks size of @a audio_peaks
+ * @return number of peaks that were stored in @a audio_peaks
+ */
+uint32_t
+BufferSet::merge_from_with_peaks (const BufferSet& in, samplecnt_t nframes, float* audio_peaks, uint32_t n_peaks)
+{
+	uint32_t n = 0;
+
+	for (DataType::iterator t = DataType::begin(); t != DataType::end(); ++t) {
+		BufferSet::iterator o = begin(*t);
+		for (BufferSet::const_iterator i = in.begin(*t); i != in.end(*t) && o != end (*t); ++i, ++o) {
+			if (*t == DataType::AUDIO && n < n_peaks) {
+				AudioBuffer& ab (static_cast<AudioBuffer&> (*o));
+				audio_peaks[n++] = ab.accumulate_from_with_peak (static_cast<AudioBuffer const&> (*i), nframes, 0);
+			} else {
+				o->merge_from (*i, nframes);
+			}
+		}
+	}
+
+	return n;
+}
+
 void
 BufferSet::silence (samplecnt_t nframes, samplecnt_t offset)
 {
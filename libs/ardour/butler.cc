@@ -28,6 +28,10 @@
 #include <poll.h>
 #endif
 
+#include <algorithm>
+
+#include <boost/bind.hpp>
+
 #include "pbd/error.h"
 #include "pbd/pthread_utils.h"
 
@@ -39,6 +43,7 @@
 #include "ardour/disk_io.h"
 #include "ardour/disk_reader.h"
 #include "ardour/io.h"
+#include "ardour/io_tasklist.h"
 #include "ardour/session.h"
 #include "ardour/track.h"
 #include "ardour/auditioner.h"
@@ -58,8 +63,10 @@ Butler::Butler(Session& s)
 	, _midi_buffer_size(0)
 	, pool_trash(16)
 	, _xthread (true)
+	, _io_tasklist (0)
 {
 	g_atomic_int_set (&should_do_transport_work, 0);
+	g_atomic_int_set (&_io_threads_changed, 1);
 	SessionEvent::pool->set_trash (&pool_trash);
 
 	/* catch future changes to parameters */
@@ -113,6 +120,9 @@ Butler::config_changed (std::string p)
 			_audio_playback_buffer_size = audio_playback_buffer_size;
 			_session.adjust_playback_buffering ();
 		}
+	} else if (p == "disk-io-threads") {
+		/* picked up by the butler thread before the next refill */
+		g_atomic_int_set (&_io_threads_changed, 1);
 	}
 }
 
@@ -158,7 +168,111 @@ Butler::terminate_thread ()
                 DEBUG_TRACE (DEBUG::Butler, string_compose ("%1: ask butler to quit @ %2\n", DEBUG_THREAD_SELF, g_get_monotonic_time()));
 		queue_request (Request::Quit);
 		pthread_join (thread, &status);
+		have_thread = false;
 	}
+	delete _io_tasklist;
+	_io_tasklist = 0;
+	g_atomic_int_set (&_io_threads_changed, 1);
+}
+
+void
+Butler::reset_io_tasklist ()
+{
+	delete _io_tasklist;
+	_io_tasklist = 0;
+
+	const uint32_t n_threads = IOTaskList::n_threads_for (Config->get_disk_io_threads ());
+	if (n_threads > 1) {
+		_io_tasklist = new IOTaskList (n_threads);
+	}
+	DEBUG_TRACE (DEBUG::Butler, string_compose ("butler uses %1 disk I/O thread(s)\n", _io_tasklist ? _io_tasklist->n_threads () : 1));
+}
+
+/** Refill the playback buffers of all active tracks.
+ *
+ * Tracks with the least amount of buffered data are refilled first,
+ * so that after a locate, or when the disk cannot keep up, the tracks
+ * that are closest to an underrun are served first. If additional I/O
+ * threads are available, tracks are refilled in parallel.
+ *
+ * @return true if there is more disk work to do
+ */
+bool
+Butler::refill_tracks (RouteList const& rl)
+{
+	if (transport_work_requested () || !should_run) {
+		return false;
+	}
+
+	_refill_jobs.clear ();
+
+	for (RouteList::const_iterator i = rl.begin(); i != rl.end(); ++i) {
+
+		boost::shared_ptr<Track> tr = boost::dynamic_pointer_cast<Track> (*i);
+
+		if (!tr) {
+			continue;
+		}
+
+		boost::shared_ptr<IO> io = tr->input ();
+
+		if (io && !io->active()) {
+			/* don't read inactive tracks */
+			continue;
+		}
+
+		_refill_jobs.push_back (RefillJob (tr, tr->playback_buffer_load ()));
+	}
+
+	/* retain route order for tracks with equal buffer load */
+	std::stable_sort (_refill_jobs.begin (), _refill_jobs.end (), emptiest_first);
+
+	if (_io_tasklist) {
+		for (std::vector<RefillJob>::iterator j = _refill_jobs.begin (); j != _refill_jobs.end (); ++j) {
+			_io_tasklist->push_back (boost::bind (&Butler::refill_track, this, &(*j)));
+		}
+		_io_tasklist->process ();
+	} else {
+		for (std::vector<RefillJob>::iterator j = _refill_jobs.begin (); j != _refill_jobs.end (); ++j) {
+			refill_track (&(*j));
+		}
+	}
+
+	bool disk_work_outstanding = false;
+
+	for (std::vector<RefillJob>::const_iterator j = _refill_jobs.begin (); j != _refill_jobs.end (); ++j) {
+		switch (j->result) {
+			case 0:
+				break;
+
+			case 1:
+				DEBUG_TRACE (DEBUG::Butler, string_compose ("\ttrack refill unfinished %1\n", j->track->name()));
+				disk_work_outstanding = true;
+				break;
+
+			default:
+				error << string_compose(_("Butler read ahead failure on dstream %1"), j->track->name()) << endmsg;
+				std::cerr << string_compose(_("Butler read ahead failure on dstream %1"), j->track->name()) << std::endl;
+				break;
+		}
+	}
+
+	/* do not hold references to tracks until the next refill */
+	_refill_jobs.clear ();
+
+	return disk_work_outstanding;
+}
+
+/* called from the butler thread or a disk I/O thread */
+void
+Butler::refill_track (RefillJob* job)
+{
+	if (transport_work_requested () || !should_run) {
+		/* we didn't get to this track */
+		job->result = 1;
+		return;
+	}
+	job->result = job->track->do_refill ();
 }
 
 void *
@@ -175,7 +289,6 @@ Butler::thread_work ()
 	uint32_t err = 0;
 
 	bool disk_work_outstanding = false;
-	RouteList::iterator i;
 
 	while (true) {
 		DEBUG_TRACE (DEBUG::Butler, string_compose ("%1 butler main loop, disk work outstanding ? %2 @ %3\n", DEBUG_THREAD_SELF, disk_work_outstanding, g_get_monotonic_time()));
@@ -213,6 +326,8 @@ Butler::thread_work ()
 
 		Temporal::TempoMap::fetch ();
 
+		_session.reprioritize_process_graph ();
+
 	  restart:
 		DEBUG_TRACE (DEBUG::Butler, "at restart for disk work\n");
 		disk_work_outstanding = false;
@@ -250,46 +365,13 @@ Butler::thread_work ()
 		RouteList rl_with_auditioner = *rl;
 		rl_with_auditioner.push_back (_session.the_auditioner());
 
-		DEBUG_TRACE (DEBUG::Butler, string_compose ("butler starts refill loop, twr = %1\n", transport_work_requested()));
-
-		for (i = rl_with_auditioner.begin(); !transport_work_requested() && should_run && i != rl_with_auditioner.end(); ++i) {
-
-			boost::shared_ptr<Track> tr = boost::dynamic_pointer_cast<Track> (*i);
-
-			if (!tr) {
-				continue;
-			}
-
-			boost::shared_ptr<IO> io = tr->input ();
-
-			if (io && !io->active()) {
-				/* don't read inactive tracks */
-				// DEBUG_TRACE (DEBUG::Butler, string_compose ("butler skips inactive track %1\n", tr->name()));
-				continue;
-			}
-			// DEBUG_TRACE (DEBUG::Butler, string_compose ("butler refills %1, playback load = %2\n", tr->name(), tr->playback_buffer_load()));
-			switch (tr->do_refill ()) {
-			case 0:
-				//DEBUG_TRACE (DEBUG::Butler, string_compose ("\ttrack refill done %1\n", tr->name()));
-				break;
-
-			case 1:
-				DEBUG_TRACE (DEBUG::Butler, string_compose ("\ttrack refill unfinished %1\n", tr->name()));
-				disk_work_outstanding = true;
-				break;
-
-			default:
-				error << string_compose(_("Butler read ahead failure on dstream %1"), (*i)->name()) << endmsg;
-                                std::cerr << string_compose(_("Butler read ahead failure on dstream %1"), (*i)->name()) << std::endl;
-				break;
-			}
-
+		if (g_atomic_int_compare_and_exchange (&_io_threads_changed, 1, 0)) {
+			reset_io_tasklist ();
 		}
 
-		if (i != rl_with_auditioner.begin() && i != rl_with_auditioner.end()) {
-			/* we didn't get to all the streams */
-			disk_work_outstanding = true;
-		}
+		DEBUG_TRACE (DEBUG::Butler, string_compose ("butler starts refill loop, twr = %1\n", transport_work_requested()));
+
+		disk_work_outstanding = refill_tracks (rl_with_auditioner);
 
 		if (!err && transport_work_requested()) {
 			DEBUG_TRACE (DEBUG::Butler, "transport work requested during refill, back to restart\n");
@@ -17,6 +17,11 @@
  */
 
 #include <assert.h>
+#include <map>
+
+#include <glibmm/threads.h>
+
+#include <boost/weak_ptr.hpp>
 
 #include "pbd/error.h"
 #include "pbd/pthread_utils.h"
@@ -39,6 +44,61 @@ using namespace ARDOUR;
 using namespace ARDOUR::DSP;
 using namespace ArdourZita;
 
+/* Frequency-domain IR data, shared by all instances that use an IR
+ * with identical content and partitioning. Each entry is an unstarted
+ * Convproc holding the IR as single input -> output pair.
+ */
+typedef std::map<std::string, boost::weak_ptr<Convproc> > SharedIRMap;
+
+static SharedIRMap          _shared_irs;
+static Glib::Threads::Mutex _shared_irs_lock;
+
+static uint64_t
+ir_hash (float const* data, uint32_t n)
+{
+	/* FNV-1a */
+	uint64_t             h = 0xcbf29ce484222325ULL;
+	uint8_t const* const p = (uint8_t const*)data;
+	for (size_t i = 0; i < n * sizeof (float); ++i) {
+		h = (h ^ p[i]) * 0x100000001b3ULL;
+	}
+	return h;
+}
+
+static boost::shared_ptr<Convproc>
+shared_ir (std::string const& key, float* ir, uint32_t ir_delay, uint32_t ir_len,
+           uint32_t n_in, uint32_t n_out, uint32_t max_size, uint32_t quantum, uint32_t n_part)
+{
+	Glib::Threads::Mutex::Lock lm (_shared_irs_lock);
+
+	SharedIRMap::iterator i = _shared_irs.find (key);
+	if (i != _shared_irs.end ()) {
+		boost::shared_ptr<Convproc> cp = i->second.lock ();
+		if (cp) {
+			return cp;
+		}
+	}
+
+	/* drop entries that are no longer used */
+	for (i = _shared_irs.begin (); i != _shared_irs.end ();) {
+		if (i->second.expired ()) {
+			_shared_irs.erase (i++);
+		} else {
+			++i;
+		}
+	}
+
+	boost::shared_ptr<Convproc> cp (new Convproc);
+
+	if (cp->configure (n_in, n_out, max_size, quantum, quantum, n_part, 0)
+	    || cp->impdata_create (0, 0, 1, ir, ir_delay, ir_delay + ir_len)) {
+		return boost::shared_ptr<Convproc> ();
+	}
+
+	_shared_irs[key] = cp;
+	return cp;
+}
+
 Convolution::Convolution (Session& session, uint32_t n_in, uint32_t n_out)
     : SessionHandleRef (session)
     , _n_samples (0)
@@ -86,6 +146,7 @@ Convolution::restart ()
 	_convproc.stop_process ();
 	_convproc.cleanup ();
 	_convproc.set_options (0);
+	_shared_ir.clear ();
 
 	uint32_t n_part;
 
@@ -116,45 +177,65 @@ Convolution::restart ()
 	    /*Convproc::MAXPART*/ n_part,
 	    /*density 0 = auto, i/o dependent */ 0);
 
+	std::map<std::pair<uint32_t, uint32_t>, int> n_per_io;
+
 	for (std::vector<ImpData>::const_iterator i = _impdata.begin (); i != _impdata.end (); ++i) {
+		++n_per_io[std::make_pair (i->c_in, i->c_out)];
+	}
+
+	for (std::vector<ImpData>::const_iterator i = _impdata.begin (); i != _impdata.end () && rv == 0; ++i) {
 		uint32_t pos = 0;
 
 		const float    ir_gain  = i->gain;
 		const uint32_t ir_delay = i->delay;
-		const uint32_t ir_len   = i->readable_length_samples ();
+		const uint32_t ir_len   = std::min (_max_size, (uint32_t)i->readable_length_samples ());
 
-		while (true) {
-			float ir[8192];
+		std::vector<float> ir (ir_len);
 
+		while (pos < ir_len) {
 			samplecnt_t to_read = std::min ((uint32_t)8192, ir_len - pos);
-			samplecnt_t ns      = i->read (ir, pos, to_read);
+			samplecnt_t ns      = i->read (&ir[pos], pos, to_read);
 
 			if (ns == 0) {
 				break;
 			}
 
 			if (ir_gain != 1.f) {
-				for (samplecnt_t i = 0; i < ns; ++i) {
-					ir[i] *= ir_gain;
+				for (samplecnt_t n = 0; n < ns; ++n) {
+					ir[pos + n] *= ir_gain;
 				}
 			}
 
-			rv = _convproc.impdata_create (
-			    /*i/o map */ i->c_in, i->c_out,
-			    /*stride, de-interleave */ 1,
-			    ir,
-			    ir_delay + pos, ir_delay + pos + ns);
-
-			if (rv != 0) {
-				break;
-			}
-
 			pos += ns;
+		}
 
-			if (pos == _max_size) {
-				break;
+		if (pos == 0) {
+			continue;
+		}
+
+		/* The same IR is often used by many instances (several tracks or
+		 * buses with the same reverb, or the same IR for L and R).
+		 * Only a single copy of its frequency-domain data is computed,
+		 * unless several IRs are combined for the same i/o pair.
+		 */
+		if (n_per_io[std::make_pair (i->c_in, i->c_out)] == 1) {
+			const std::string key = string_compose ("%1:%2:%3:%4:%5:%6:%7:%8",
+			                                        _n_inputs, _n_outputs, _max_size, _n_samples, n_part,
+			                                        ir_delay, pos, ir_hash (&ir[0], pos));
+
+			boost::shared_ptr<Convproc> cp = shared_ir (key, &ir[0], ir_delay, pos, _n_inputs, _n_outputs, _max_size, _n_samples, n_part);
+
+			if (cp && 0 == _convproc.impdata_link (i->c_in, i->c_out, *cp, 0, 0)) {
+				_shared_ir.push_back (cp);
+				continue;
 			}
 		}
+
+		rv = _convproc.impdata_create (
+		    /*i/o map */ i->c_in, i->c_out,
+		    /*stride, de-interleave */ 1,
+		    &ir[0],
+		    ir_delay, ir_delay + pos);
 	}
 
 	if (rv == 0) {
@@ -314,10 +395,10 @@ Convolver::Convolver (
 }
 
 void
-Convolver::run_mono_buffered (float* buf, uint32_t n_samples)
+Convolution::run_mono_buffered (float* buf, uint32_t n_samples)
 {
 	assert (_convproc.state () == Convproc::ST_PROC);
-	assert (_irc == Mono);
+	assert (_n_inputs == 1 && _n_outputs == 1);
 
 	uint32_t done   = 0;
 	uint32_t remain = n_samples;
@@ -343,10 +424,10 @@ Convolver::run_mono_buffered (float* buf, uint32_t n_samples)
 }
 
 void
-Convolver::run_stereo_buffered (float* left, float* right, uint32_t n_samples)
+Convolution::run_stereo_buffered (float* left, float* right, uint32_t n_samples)
 {
 	assert (_convproc.state () == Convproc::ST_PROC);
-	assert (_irc != Mono);
+	assert (_n_inputs <= 2 && _n_outputs == 2);
 
 	uint32_t done   = 0;
 	uint32_t remain = n_samples;
@@ -355,7 +436,7 @@ Convolver::run_stereo_buffered (float* left, float* right, uint32_t n_samples)
 		uint32_t ns = std::min (remain, _n_samples - _offset);
 
 		memcpy (&_convproc.inpdata (0)[_offset], &left[done], sizeof (float) * ns);
-		if (_irc >= Stereo) {
+		if (_n_inputs > 1) {
 			memcpy (&_convproc.inpdata (1)[_offset], &right[done], sizeof (float) * ns);
 		}
 		memcpy (&left[done],  &_convproc.outdata (0)[_offset], sizeof (float) * ns);
@@ -373,10 +454,10 @@ Convolver::run_stereo_buffered (float* left, float* right, uint32_t n_samples)
 }
 
 void
-Convolver::run_mono_no_latency (float* buf, uint32_t n_samples)
+Convolution::run_mono_no_latency (float* buf, uint32_t n_samples)
 {
 	assert (_convproc.state () == Convproc::ST_PROC);
-	assert (_irc == Mono);
+	assert (_n_inputs == 1 && _n_outputs == 1);
 
 	uint32_t done   = 0;
 	uint32_t remain = n_samples;
@@ -405,10 +486,10 @@ Convolver::run_mono_no_latency (float* buf, uint32_t n_samples)
 }
 
 void
-Convolver::run_stereo_no_latency (float* left, float* right, uint32_t n_samples)
+Convolution::run_stereo_no_latency (float* left, float* right, uint32_t n_samples)
 {
 	assert (_convproc.state () == Convproc::ST_PROC);
-	assert (_irc != Mono);
+	assert (_n_inputs <= 2 && _n_outputs == 2);
 
 	uint32_t done   = 0;
 	uint32_t remain = n_samples;
@@ -420,7 +501,7 @@ Convolver::run_stereo_no_latency (float* left, float* right, uint32_t n_samples)
 		uint32_t ns = std::min (remain, _n_samples - _offset);
 
 		memcpy (&_convproc.inpdata (0)[_offset], &left[done], sizeof (float) * ns);
-		if (_irc >= Stereo) {
+		if (_n_inputs > 1) {
 			memcpy (&_convproc.inpdata (1)[_offset], &right[done], sizeof (float) * ns);
 		}
 
@@ -27,6 +27,7 @@
 #include "pbd/enum_convert.h"
 
 #include "ardour/amp.h"
+#include "ardour/audio_buffer.h"
 #include "ardour/audioengine.h"
 #include "ardour/buffer_set.h"
 #include "ardour/debug.h"
@@ -61,6 +62,8 @@ Delivery::Delivery (Session& s, boost::shared_ptr<IO> io, boost::shared_ptr<Pann
 	, _role (r)
 	, _output_buffers (new BufferSet())
 	, _current_gain (GAIN_COEFF_ZERO)
+	, _compute_output_peaks (false)
+	, _n_output_peaks (0)
 	, _no_outs_cuz_we_no_monitor (false)
 	, _mute_master (mm)
 	, _no_panner_reset (false)
@@ -85,6 +88,8 @@ Delivery::Delivery (Session& s, boost::shared_ptr<Pannable> pannable, boost::sha
 	, _role (r)
 	, _output_buffers (new BufferSet())
 	, _current_gain (GAIN_COEFF_ZERO)
+	, _compute_output_peaks (false)
+	, _n_output_peaks (0)
 	, _no_outs_cuz_we_no_monitor (false)
 	, _mute_master (mm)
 	, _no_panner_reset (false)
@@ -231,6 +236,10 @@ Delivery::configure_io (ChanCount in, ChanCount out)
 		return false;
 	}
 
+	if (_compute_output_peaks) {
+		_output_peaks.resize (_output ? _output->n_ports ().n_audio () : 0);
+	}
+
 	reset_panner ();
 
 	return true;
@@ -241,6 +250,8 @@ Delivery::run (BufferSet& bufs, samplepos_t start_sample, samplepos_t end_sample
 {
 	assert (_output);
 
+	_n_output_peaks = 0;
+
 	if (!check_active()) {
 		_output->silence (nframes);
 		return;
@@ -323,7 +334,11 @@ Delivery::run (BufferSet& bufs, samplepos_t start_sample, samplepos_t end_sample
 		*/
 
 		if (bufs.count().n_audio() > 0) {
-			_output->copy_to_outputs (bufs, DataType::AUDIO, nframes, 0);
+			if (_compute_output_peaks) {
+				_n_output_peaks = copy_to_outputs_with_peaks (bufs, nframes);
+			} else {
+				_output->copy_to_outputs (bufs, DataType::AUDIO, nframes, 0);
+			}
 		}
 
 		for (DataType::iterator t = DataType::begin(); t != DataType::end(); ++t) {
@@ -355,6 +370,36 @@ Delivery::run (BufferSet& bufs, samplepos_t start_sample, samplepos_t end_sample
 	}
 }
 
+/** Like IO::copy_to_outputs() for audio, but also compute the absolute
+ * peak of each port buffer while copying.
+ * @return number of peaks stored in _output_peaks
+ */
+uint32_t
+Delivery::copy_to_outputs_with_peaks (BufferSet& bufs, pframes_t nframes)
+{
+	PortSet&       ports (_output->ports ());
+	const uint32_t n_bufs = bufs.count ().n_audio ();
+	uint32_t       b      = 0;
+	uint32_t       n      = 0;
+
+	assert (n_bufs > 0);
+
+	for (PortSet::iterator o = ports.begin (DataType::AUDIO); o != ports.end (DataType::AUDIO); ++o) {
+		AudioBuffer& port_buffer (static_cast<AudioBuffer&> (o->get_buffer (nframes)));
+		if (n < _output_peaks.size ()) {
+			_output_peaks[n++] = port_buffer.read_from_with_gain_and_peak (bufs.get_audio (b), nframes, GAIN_COEFF_UNITY, 0);
+		} else {
+			port_buffer.read_from (bufs.get_audio (b), nframes);
+		}
+		/* copy buffers 1:1, and the last buffer to any extra outputs */
+		if (b + 1 < n_bufs) {
+			++b;
+		}
+	}
+
+	return n;
+}
+
 XMLNode&
 Delivery::state ()
 {
@@ -21,6 +21,7 @@
 
 #include "pbd/enumwriter.h"
 #include "pbd/memento_command.h"
+#include "pbd/microseconds.h"
 #include "pbd/playback_buffer.h"
 
 #include "temporal/range.h"
@@ -57,6 +58,13 @@ DiskReader::Declicker DiskReader::loop_declick_in;
 DiskReader::Declicker DiskReader::loop_declick_out;
 samplecnt_t           DiskReader::loop_fade_length (0);
 
+/* working buffers of additional disk I/O threads */
+static thread_local bool        _thread_use_buffers    = false;
+static thread_local samplecnt_t _thread_buffer_size    = 0;
+static thread_local Sample*     _thread_sum_buffer     = 0;
+static thread_local Sample*     _thread_mixdown_buffer = 0;
+static thread_local gain_t*     _thread_gain_buffer    = 0;
+
 DiskReader::DiskReader (Session& s, Track& t, string const& str,  Temporal::TimeDomain td, DiskIOProcessor::Flag f)
 	: DiskIOProcessor (s, t, X_("player:") + str, f, td)
 	, overwrite_sample (0)
@@ -146,6 +154,49 @@ DiskReader::free_working_buffers ()
 	_gain_buffer    = 0;
 }
 
+void
+DiskReader::allocate_thread_working_buffers ()
+{
+	/* A refill never reads more than the playback buffer's write-space,
+	 * so unlike the butler's buffers (see allocate_working_buffers())
+	 * these are not sized for the largest possible read, but grown
+	 * as needed by ensure_thread_working_buffers().
+	 */
+	_thread_use_buffers = true;
+}
+
+void
+DiskReader::free_thread_working_buffers ()
+{
+	delete[] _thread_sum_buffer;
+	delete[] _thread_mixdown_buffer;
+	delete[] _thread_gain_buffer;
+	_thread_sum_buffer     = 0;
+	_thread_mixdown_buffer = 0;
+	_thread_gain_buffer    = 0;
+	_thread_buffer_size    = 0;
+	_thread_use_buffers    = false;
+}
+
+static void
+ensure_thread_working_buffers (samplecnt_t size)
+{
+	/* 4MB reads, or 2M samples using 16 bit samples, see refill_audio() */
+	size = std::min (size, (samplecnt_t) 2 * 1048576);
+
+	if (size <= _thread_buffer_size) {
+		return;
+	}
+
+	delete[] _thread_sum_buffer;
+	delete[] _thread_mixdown_buffer;
+	delete[] _thread_gain_buffer;
+	_thread_sum_buffer     = new Sample[size];
+	_thread_mixdown_buffer = new Sample[size];
+	_thread_gain_buffer    = new gain_t[size];
+	_thread_buffer_size    = size;
+}
+
 samplecnt_t
 DiskReader::default_chunk_samples ()
 {
@@ -1093,7 +1144,78 @@ int
 DiskReader::do_refill ()
 {
 	const bool reversed = !_session.transport_will_roll_forwards ();
-	return refill (_sum_buffer, _mixdown_buffer, _gain_buffer, 0, reversed);
+
+	samplecnt_t buffered = 0;
+	samplecnt_t bufsize  = 0;
+	bool        timed    = false;
+
+	{
+		boost::shared_ptr<ChannelList> c = channels.reader ();
+		if (!c->empty ()) {
+			/* only time refills that are going to read data */
+			buffered = c->front ()->rbuf->read_space ();
+			bufsize  = c->front ()->rbuf->bufsize ();
+			timed    = c->front ()->rbuf->write_space () >= _chunk_samples;
+		}
+	}
+
+	const microseconds_t t0 = timed ? get_microseconds () : 0;
+	int                  rv;
+
+	if (_thread_use_buffers) {
+		ensure_thread_working_buffers (bufsize);
+	}
+
+	if (_thread_sum_buffer) {
+		rv = refill (_thread_sum_buffer, _thread_mixdown_buffer, _thread_gain_buffer, 0, reversed);
+	} else {
+		rv = refill (_sum_buffer, _mixdown_buffer, _gain_buffer, 0, reversed);
+	}
+
+	if (timed && rv >= 0) {
+		update_refill_stats (get_microseconds () - t0, buffered);
+	}
+	return rv;
+}
+
+void
+DiskReader::update_refill_stats (int64_t elapsed, samplecnt_t buffered)
+{
+	const bool   rolling  = _session.transport_rolling ();
+	const double headroom = buffered / (double)_session.sample_rate () - elapsed * 1e-6;
+
+	{
+		Glib::Threads::Mutex::Lock lm (_refill_stats_lock);
+		RefillStats& s (_refill_stats);
+		s.last = elapsed;
+		s.max  = std::max (s.max, elapsed);
+		s.avg  = s.count == 0 ? elapsed : s.avg + .1 * (elapsed - s.avg);
+		if (rolling) {
+			if (s.rolling == 0 || headroom < s.min_headroom) {
+				s.min_headroom = headroom;
+			}
+			++s.rolling;
+		}
+		++s.count;
+	}
+
+	if (rolling && elapsed * 2e-6 > buffered / (double)_session.sample_rate ()) {
+		DEBUG_TRACE (DEBUG::Butler, string_compose ("%1: refill took %2 us, headroom %3 sec\n", name (), elapsed, headroom));
+	}
+}
+
+RefillStats
+DiskReader::refill_stats () const
+{
+	Glib::Threads::Mutex::Lock lm (_refill_stats_lock);
+	return _refill_stats;
+}
+
+void
+DiskReader::reset_refill_stats ()
+{
+	Glib::Threads::Mutex::Lock lm (_refill_stats_lock);
+	_refill_stats = RefillStats ();
 }
 
 int
@@ -1119,7 +1241,9 @@ DiskReader::refill (Sample* sum_buffer, Sample* mixdown_buffer, float* gain_buff
 	 * is called, _last_read_reversed is set correctly.
 	 */
 
-	if (refill_audio (sum_buffer, mixdown_buffer, gain_buffer, fill_level, reversed)) {
+	int ret = refill_audio (sum_buffer, mixdown_buffer, gain_buffer, fill_level, reversed);
+
+	if (ret < 0) {
 		return -1;
 	}
 
@@ -1127,7 +1251,8 @@ DiskReader::refill (Sample* sum_buffer, Sample* mixdown_buffer, float* gain_buff
 		rt_midibuffer ()->reverse ();
 	}
 
-	return 0;
+	/* 1: there is more data to read, the butler will call again */
+	return ret;
 }
 
 /** Get some more data from disk and put it in our channels' bufs,
@@ -74,6 +74,46 @@ ARDOUR::DSP::peaks (const float *data, float &min, float &max, uint32_t n_sample
 	ARDOUR::find_peaks (data, n_samples, &min, &max);
 }
 
+void
+ARDOUR::DSP::gain_ramp (float *data, const float g0, const float g1, const uint32_t n_samples) {
+	if (g0 == g1) {
+		ARDOUR::apply_gain_to_buffer (data, n_samples, g0);
+		return;
+	}
+	const float dg = (g1 - g0) / n_samples;
+	for (uint32_t i = 0; i < n_samples; ++i) {
+		data[i] *= g0 + i * dg;
+	}
+}
+
+void
+ARDOUR::DSP::mix_ramp (float *dst, const float *src, const float g0, const float g1, const uint32_t n_samples) {
+	if (g0 == g1) {
+		ARDOUR::mix_buffers_with_gain (dst, src, n_samples, g0);
+		return;
+	}
+	const float dg = (g1 - g0) / n_samples;
+	for (uint32_t i = 0; i < n_samples; ++i) {
+		dst[i] += src[i] * (g0 + i * dg);
+	}
+}
+
+void
+ARDOUR::DSP::xfade (float *data, const float *other, const uint32_t n_samples, bool equal_power) {
+	const float dx = 1.f / n_samples;
+	if (equal_power) {
+		for (uint32_t i = 0; i < n_samples; ++i) {
+			const float x = i * dx;
+			data[i] = data[i] * sqrtf (1.f - x) + other[i] * sqrtf (x);
+		}
+	} else {
+		for (uint32_t i = 0; i < n_samples; ++i) {
+			const float x = i * dx;
+			data[i] += (other[i] - data[i]) * x;
+		}
+	}
+}
+
 void
 ARDOUR::DSP::process_map (BufferSet* bufs, const ChanCount& n_out, const ChanMapping& in_map, const ChanMapping& out_map, pframes_t nframes, samplecnt_t offset)
 {
@@ -333,6 +373,155 @@ Biquad::dB_at_freq (float freq) const
 }
 
 
+BiquadCascade::BiquadCascade (double samplerate, uint32_t n_stages, uint32_t n_channels)
+	: _n_stages (n_stages)
+	, _n_channels (n_channels)
+	, _filters (n_stages * n_channels, Biquad (samplerate))
+{
+}
+
+void
+BiquadCascade::run (uint32_t channel, float *data, const uint32_t n_samples)
+{
+	if (channel >= _n_channels) {
+		return;
+	}
+	/* process one stage at a time, the filter state stays in registers */
+	std::vector<Biquad>::iterator f = _filters.begin () + channel * _n_stages;
+	for (uint32_t s = 0; s < _n_stages; ++s, ++f) {
+		f->run (data, n_samples);
+	}
+}
+
+void
+BiquadCascade::compute (uint32_t stage, Biquad::Type t, double freq, double Q, double gain)
+{
+	if (stage >= _n_stages) {
+		return;
+	}
+	for (uint32_t c = 0; c < _n_channels; ++c) {
+		_filters[c * _n_stages + stage].compute (t, freq, Q, gain);
+	}
+}
+
+void
+BiquadCascade::configure (uint32_t stage, double a1, double a2, double b0, double b1, double b2)
+{
+	if (stage >= _n_stages) {
+		return;
+	}
+	for (uint32_t c = 0; c < _n_channels; ++c) {
+		_filters[c * _n_stages + stage].configure (a1, a2, b0, b1, b2);
+	}
+}
+
+float
+BiquadCascade::dB_at_freq (float freq) const
+{
+	float rv = 0;
+	for (uint32_t s = 0; s < _n_stages && _n_channels > 0; ++s) {
+		rv += _filters[s].dB_at_freq (freq);
+	}
+	return std::min (120.f, std::max(-120.f, rv));
+}
+
+void
+BiquadCascade::reset ()
+{
+	for (std::vector<Biquad>::iterator f = _filters.begin (); f != _filters.end (); ++f) {
+		f->reset ();
+	}
+}
+
+EnvelopeFollower::EnvelopeFollower (double samplerate, float attack, float release)
+	: _rate (samplerate)
+	, _env (0)
+{
+	set_attack (attack);
+	set_release (release);
+}
+
+void
+EnvelopeFollower::set_attack (float ms)
+{
+	_att = 1.f - expf (-1000.f / (std::max (0.01f, ms) * _rate));
+}
+
+void
+EnvelopeFollower::set_release (float ms)
+{
+	_rel = 1.f - expf (-1000.f / (std::max (0.01f, ms) * _rate));
+}
+
+void
+EnvelopeFollower::run (const float *data, float *env, const uint32_t n_samples)
+{
+	// localize variables
+	const float att = _att;
+	const float rel = _rel;
+	float e = _env;
+	for (uint32_t i = 0; i < n_samples; ++i) {
+		const float x = fabsf (data[i]);
+		e += (x > e ? att : rel) * (x - e);
+		env[i] = e;
+	}
+	_env = e;
+	if (!isfinite_local (_env)) { _env = 0; }
+	else if (!boost::math::isnormal (_env)) { _env = 0; }
+}
+
+float
+EnvelopeFollower::process (const float *data, const uint32_t n_samples)
+{
+	const float att = _att;
+	const float rel = _rel;
+	float e = _env;
+	for (uint32_t i = 0; i < n_samples; ++i) {
+		const float x = fabsf (data[i]);
+		e += (x > e ? att : rel) * (x - e);
+	}
+	_env = e;
+	if (!isfinite_local (_env)) { _env = 0; }
+	else if (!boost::math::isnormal (_env)) { _env = 0; }
+	return _env;
+}
+
+Resampler::Resampler (double ratio, uint32_t quality)
+	: _ratio (std::max (0.02, std::min (16.0, ratio)))
+{
+	const uint32_t hlen = std::max (8U, std::min (96U, quality));
+	/* VMResampler's default cutoff is the source's Nyquist frequency,
+	 * when downsampling it has to be below the target's to avoid aliasing.
+	 */
+	_src.setup (hlen, (1.0 - 2.6 / hlen) * std::min (1.0, _ratio));
+	_ratio = _src.set_rratio (_ratio);
+	reset ();
+}
+
+uint32_t
+Resampler::process (const float *in, const uint32_t n_in, float *out, const uint32_t n_out)
+{
+	_src.inp_data  = const_cast<float*> (in);
+	_src.inp_count = n_in;
+	_src.out_data  = out;
+	_src.out_count = n_out;
+	_src.process ();
+	return n_out - _src.out_count;
+}
+
+uint32_t
+Resampler::latency () const
+{
+	return _src.inpsize () / 2 - 1;
+}
+
+void
+Resampler::reset ()
+{
+	_src.reset ();
+	_src.set_rratio (_ratio);
+}
+
 Glib::Threads::Mutex FFTSpectrum::fft_planner_lock;
 
 FFTSpectrum::FFTSpectrum (uint32_t window_size, double rate)
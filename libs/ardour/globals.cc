@@ -96,6 +96,7 @@
 #include "LuaBridge/LuaBridge.h"
 
 #include "ardour/analyser.h"
+#include "ardour/audio_block_cache.h"
 #include "ardour/audio_backend.h"
 #include "ardour/audio_library.h"
 #include "ardour/audioengine.h"
@@ -155,6 +156,16 @@ mix_buffers_with_gain_t ARDOUR::mix_buffers_with_gain = 0;
 mix_buffers_no_gain_t   ARDOUR::mix_buffers_no_gain   = 0;
 copy_vector_t           ARDOUR::copy_vector           = 0;
 
+apply_gain_ramp_to_buffer_t   ARDOUR::apply_gain_ramp_to_buffer   = 0;
+apply_gain_vector_to_buffer_t ARDOUR::apply_gain_vector_to_buffer = 0;
+invert_buffer_t               ARDOUR::invert_buffer               = 0;
+interleave_buffer_t           ARDOUR::interleave_buffer           = 0;
+deinterleave_buffer_t         ARDOUR::deinterleave_buffer         = 0;
+
+mix_buffers_no_gain_and_peak_t   ARDOUR::mix_buffers_no_gain_and_peak   = 0;
+mix_buffers_with_gain_and_peak_t ARDOUR::mix_buffers_with_gain_and_peak = 0;
+copy_vector_with_gain_and_peak_t ARDOUR::copy_vector_with_gain_and_peak = 0;
+
 PBD::Signal1<void, std::string>                    ARDOUR::BootMessage;
 PBD::Signal3<void, std::string, std::string, bool> ARDOUR::PluginScanMessage;
 PBD::Signal1<void, int>                            ARDOUR::PluginScanTimeout;
@@ -191,8 +202,34 @@ setup_hardware_optimization (bool try_optimization)
 		FPU* fpu = FPU::instance ();
 
 #if defined(ARCH_X86) && defined(BUILD_SSE_OPTIMIZATIONS)
-		/* We have AVX-optimized code for Windows and Linux */
+		/* We have AVX-optimized code for Windows and Linux, AVX-512 where the compiler supports it */
+
+#ifdef FPU_AVX512F_SUPPORT
+		if (fpu->has_avx512f ()) {
+			info << "Using AVX-512F optimized routines" << endmsg;
+
+			// AVX-512F SET
+			compute_peak          = x86_avx512f_compute_peak;
+			find_peaks            = x86_avx512f_find_peaks;
+			apply_gain_to_buffer  = x86_avx512f_apply_gain_to_buffer;
+			mix_buffers_with_gain = x86_avx512f_mix_buffers_with_gain;
+			mix_buffers_no_gain   = x86_avx512f_mix_buffers_no_gain;
+			copy_vector           = x86_avx512f_copy_vector;
+
+			apply_gain_ramp_to_buffer   = x86_avx512f_apply_gain_ramp_to_buffer;
+			apply_gain_vector_to_buffer = x86_avx512f_apply_gain_vector_to_buffer;
+			invert_buffer               = x86_avx512f_invert_buffer;
+			interleave_buffer           = x86_avx512f_interleave_buffer;
+			deinterleave_buffer         = x86_avx512f_deinterleave_buffer;
+
+			mix_buffers_no_gain_and_peak   = x86_avx512f_mix_buffers_no_gain_and_peak;
+			mix_buffers_with_gain_and_peak = x86_avx512f_mix_buffers_with_gain_and_peak;
+			copy_vector_with_gain_and_peak = x86_avx512f_copy_vector_with_gain_and_peak;
 
+			generic_mix_functions = false;
+
+		} else
+#endif
 #ifdef FPU_AVX_FMA_SUPPORT
 		if (fpu->has_fma ()) {
 			info << "Using AVX and FMA optimized routines" << endmsg;
@@ -205,6 +242,16 @@ setup_hardware_optimization (bool try_optimization)
 			mix_buffers_no_gain   = x86_sse_avx_mix_buffers_no_gain;
 			copy_vector           = x86_sse_avx_copy_vector;
 
+			apply_gain_ramp_to_buffer   = x86_sse_avx_apply_gain_ramp_to_buffer;
+			apply_gain_vector_to_buffer = x86_sse_avx_apply_gain_vector_to_buffer;
+			invert_buffer               = x86_sse_avx_invert_buffer;
+			interleave_buffer           = default_interleave_buffer;
+			deinterleave_buffer         = default_deinterleave_buffer;
+
+			mix_buffers_no_gain_and_peak   = x86_sse_avx_mix_buffers_no_gain_and_peak;
+			mix_buffers_with_gain_and_peak = x86_sse_avx_mix_buffers_with_gain_and_peak;
+			copy_vector_with_gain_and_peak = x86_sse_avx_copy_vector_with_gain_and_peak;
+
 			generic_mix_functions = false;
 
 		} else
@@ -220,6 +267,16 @@ setup_hardware_optimization (bool try_optimization)
 			mix_buffers_no_gain   = x86_sse_avx_mix_buffers_no_gain;
 			copy_vector           = x86_sse_avx_copy_vector;
 
+			apply_gain_ramp_to_buffer   = x86_sse_avx_apply_gain_ramp_to_buffer;
+			apply_gain_vector_to_buffer = x86_sse_avx_apply_gain_vector_to_buffer;
+			invert_buffer               = x86_sse_avx_invert_buffer;
+			interleave_buffer           = default_interleave_buffer;
+			deinterleave_buffer         = default_deinterleave_buffer;
+
+			mix_buffers_no_gain_and_peak   = x86_sse_avx_mix_buffers_no_gain_and_peak;
+			mix_buffers_with_gain_and_peak = x86_sse_avx_mix_buffers_with_gain_and_peak;
+			copy_vector_with_gain_and_peak = x86_sse_avx_copy_vector_with_gain_and_peak;
+
 			generic_mix_functions = false;
 
 		} else if (fpu->has_sse ()) {
@@ -233,6 +290,16 @@ setup_hardware_optimization (bool try_optimization)
 			mix_buffers_no_gain   = x86_sse_mix_buffers_no_gain;
 			copy_vector           = default_copy_vector;
 
+			apply_gain_ramp_to_buffer   = x86_sse_apply_gain_ramp_to_buffer;
+			apply_gain_vector_to_buffer = x86_sse_apply_gain_vector_to_buffer;
+			invert_buffer               = x86_sse_invert_buffer;
+			interleave_buffer           = default_interleave_buffer;
+			deinterleave_buffer         = default_deinterleave_buffer;
+
+			mix_buffers_no_gain_and_peak   = x86_sse_mix_buffers_no_gain_and_peak;
+			mix_buffers_with_gain_and_peak = x86_sse_mix_buffers_with_gain_and_peak;
+			copy_vector_with_gain_and_peak = x86_sse_copy_vector_with_gain_and_peak;
+
 			generic_mix_functions = false;
 		}
 
@@ -248,6 +315,16 @@ setup_hardware_optimization (bool try_optimization)
 			mix_buffers_no_gain   = arm_neon_mix_buffers_no_gain;
 			copy_vector           = arm_neon_copy_vector;
 
+			apply_gain_ramp_to_buffer   = default_apply_gain_ramp_to_buffer;
+			apply_gain_vector_to_buffer = default_apply_gain_vector_to_buffer;
+			invert_buffer               = default_invert_buffer;
+			interleave_buffer           = default_interleave_buffer;
+			deinterleave_buffer         = default_deinterleave_buffer;
+
+			mix_buffers_no_gain_and_peak   = default_mix_buffers_no_gain_and_peak;
+			mix_buffers_with_gain_and_peak = default_mix_buffers_with_gain_and_peak;
+			copy_vector_with_gain_and_peak = default_copy_vector_with_gain_and_peak;
+
 			generic_mix_functions = false;
 		}
 
@@ -261,6 +338,16 @@ setup_hardware_optimization (bool try_optimization)
 			mix_buffers_no_gain   = veclib_mix_buffers_no_gain;
 			copy_vector           = default_copy_vector;
 
+			apply_gain_ramp_to_buffer   = default_apply_gain_ramp_to_buffer;
+			apply_gain_vector_to_buffer = default_apply_gain_vector_to_buffer;
+			invert_buffer               = default_invert_buffer;
+			interleave_buffer           = default_interleave_buffer;
+			deinterleave_buffer         = default_deinterleave_buffer;
+
+			mix_buffers_no_gain_and_peak   = default_mix_buffers_no_gain_and_peak;
+			mix_buffers_with_gain_and_peak = default_mix_buffers_with_gain_and_peak;
+			copy_vector_with_gain_and_peak = default_copy_vector_with_gain_and_peak;
+
 			generic_mix_functions = false;
 
 			info << "Apple VecLib H/W specific optimizations in use" << endmsg;
@@ -280,6 +367,16 @@ setup_hardware_optimization (bool try_optimization)
 		mix_buffers_no_gain   = default_mix_buffers_no_gain;
 		copy_vector           = default_copy_vector;
 
+		apply_gain_ramp_to_buffer   = default_apply_gain_ramp_to_buffer;
+		apply_gain_vector_to_buffer = default_apply_gain_vector_to_buffer;
+		invert_buffer               = default_invert_buffer;
+		interleave_buffer           = default_interleave_buffer;
+		deinterleave_buffer         = default_deinterleave_buffer;
+
+		mix_buffers_no_gain_and_peak   = default_mix_buffers_no_gain_and_peak;
+		mix_buffers_with_gain_and_peak = default_mix_buffers_with_gain_and_peak;
+		copy_vector_with_gain_and_peak = default_copy_vector_with_gain_and_peak;
+
 		info << "No H/W specific optimizations in use" << endmsg;
 	}
 
@@ -626,6 +723,7 @@ ARDOUR::init (bool try_optimization, const char* localedir, bool with_gui)
 
 	SourceFactory::init ();
 	Analyser::init ();
+	AudioBlockCache::init ();
 
 	/* singletons - first object is "it" */
 	(void)PluginManager::instance ();
@@ -651,8 +749,9 @@ ARDOUR::init (bool try_optimization, const char* localedir, bool with_gui)
 	/* the + 4 is a bit of a handwave. i don't actually know
 	   how many more per-thread buffer sets we need above
 	   the h/w concurrency, but its definitely > 1 more.
+	   Process-graph threads and RTTaskList workers each need one.
 	*/
-	BufferManager::init (hardware_concurrency () + 4);
+	BufferManager::init (2 * hardware_concurrency () + 4);
 
 	PannerManager::instance ().discover_panners ();
 
@@ -738,6 +837,7 @@ ARDOUR::cleanup ()
 	delete TriggerBox::worker;
 
 	Analyser::terminate ();
+	AudioBlockCache::terminate ();
 	SourceFactory::terminate ();
 
 	release_dma_latency ();
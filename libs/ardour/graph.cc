@@ -20,6 +20,7 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <algorithm>
 #include <cmath>
 #include <stdio.h>
 
@@ -31,9 +32,11 @@
 #include "temporal/tempo.h"
 
 #include "ardour/audioengine.h"
+#include "ardour/butler.h"
 #include "ardour/debug.h"
 #include "ardour/graph.h"
 #include "ardour/process_thread.h"
+#include "ardour/rc_configuration.h"
 #include "ardour/route.h"
 #include "ardour/session.h"
 #include "ardour/types.h"
@@ -59,20 +62,48 @@ alloc_allowed ()
 
 #define g_atomic_uint_get(x) static_cast<guint> (g_atomic_int_get (x))
 
+namespace {
+/** Sort nodes by descending critical-path length */
+struct CriticalPathSorter {
+	CriticalPathSorter (int chain)
+		: _chain (chain)
+	{}
+
+	bool operator() (node_ptr_t const& a, node_ptr_t const& b) const
+	{
+		return a->critical_path (_chain) > b->critical_path (_chain);
+	}
+
+	int _chain;
+};
+}
+
+/* work-stealing scheduler state of the calling process thread:
+ * the index into Graph::_worker_queues, and a node that was
+ * made ready by the node this thread just finished, which
+ * is run next on the same thread (while its buffers are still hot).
+ */
+static thread_local guint      _graph_worker_id    = 0;
+static thread_local GraphNode* _graph_continuation = 0;
+
 Graph::Graph (Session& session)
 	: SessionHandleRef (session)
 	, _execution_sem ("graph_execution", 0)
 	, _callback_start_sem ("graph_start", 0)
 	, _callback_done_sem ("graph_done", 0)
+	, _work_stealing (false)
 	, _graph_empty (true)
 	, _current_chain (0)
 	, _pending_chain (0)
 	, _setup_chain (1)
+	, _next_priority_check (0)
 {
+	g_atomic_int_set (&_reprioritize, 0);
 	g_atomic_int_set (&_terminal_refcnt, 0);
 	g_atomic_int_set (&_terminate, 0);
 	g_atomic_int_set (&_n_workers, 0);
 	g_atomic_int_set (&_idle_thread_cnt, 0);
+	g_atomic_int_set (&_pending_wakeups, 0);
 	g_atomic_int_set (&_trigger_queue_size, 0);
 
 	_n_terminal_nodes[0] = 0;
@@ -93,6 +124,29 @@ Graph::Graph (Session& session)
 #endif
 }
 
+Graph::~Graph ()
+{
+	free_worker_queues ();
+}
+
+void
+Graph::allocate_worker_queues (uint32_t num_threads)
+{
+	free_worker_queues ();
+	for (uint32_t i = 0; i < num_threads; ++i) {
+		_worker_queues.push_back (new MPMCQueue<GraphNode*> (1024));
+	}
+}
+
+void
+Graph::free_worker_queues ()
+{
+	for (std::vector<MPMCQueue<GraphNode*>*>::iterator i = _worker_queues.begin (); i != _worker_queues.end (); ++i) {
+		delete *i;
+	}
+	_worker_queues.clear ();
+}
+
 void
 Graph::engine_stopped ()
 {
@@ -128,6 +182,9 @@ Graph::reset_thread_list ()
 		drop_threads ();
 	}
 
+	/* one queue per process-thread, used by the work-stealing scheduler */
+	allocate_worker_queues (num_threads);
+
 	/* Allow threads to run */
 	g_atomic_int_set (&_terminate, 0);
 
@@ -158,6 +215,9 @@ Graph::session_going_away ()
 	_init_trigger_list[1].clear ();
 	g_atomic_int_set (&_trigger_queue_size, 0);
 	_trigger_queue.clear ();
+	for (std::vector<MPMCQueue<GraphNode*>*>::iterator i = _worker_queues.begin (); i != _worker_queues.end (); ++i) {
+		(*i)->clear ();
+	}
 }
 
 void
@@ -213,6 +273,7 @@ Graph::clear_other_chain ()
 		if (_setup_chain != _pending_chain) {
 			for (node_list_t::iterator ni = _nodes_rt[_setup_chain].begin (); ni != _nodes_rt[_setup_chain].end (); ++ni) {
 				(*ni)->_activation_set[_setup_chain].clear ();
+				(*ni)->_activation_list[_setup_chain].clear ();
 			}
 
 			_nodes_rt[_setup_chain].clear ();
@@ -243,6 +304,10 @@ Graph::swap_process_chain ()
 			_trigger_queue.clear ();
 			/* ensure that all nodes can be queued */
 			_trigger_queue.reserve (_nodes_rt[_current_chain].size ());
+			for (std::vector<MPMCQueue<GraphNode*>*>::iterator i = _worker_queues.begin (); i != _worker_queues.end (); ++i) {
+				(*i)->clear ();
+				(*i)->reserve (_nodes_rt[_current_chain].size ());
+			}
 			g_atomic_int_set (&_trigger_queue_size, 0);
 			_cleanup_cond.signal ();
 		}
@@ -262,6 +327,9 @@ Graph::prep ()
 			_current_chain = _pending_chain;
 			/* ensure that all nodes can be queued */
 			_trigger_queue.reserve (_nodes_rt[_current_chain].size ());
+			for (std::vector<MPMCQueue<GraphNode*>*>::iterator i = _worker_queues.begin (); i != _worker_queues.end (); ++i) {
+				(*i)->reserve (_nodes_rt[_current_chain].size ());
+			}
 			assert (g_atomic_uint_get (&_trigger_queue_size) == 0);
 			_cleanup_cond.signal ();
 		}
@@ -272,10 +340,28 @@ Graph::prep ()
 
 	int chain = _current_chain;
 
+	/* Once per second, check if the node execution times changed
+	 * since the priorities were computed, and if so, have the butler
+	 * update them.
+	 */
+	int64_t const now      = g_get_monotonic_time ();
+	bool const    check    = now > _next_priority_check && !g_atomic_int_get (&_reprioritize);
+	bool          outdated = false;
+
 	node_list_t::iterator i;
 	for (i = _nodes_rt[chain].begin (); i != _nodes_rt[chain].end (); ++i) {
 		(*i)->prep (chain);
 		_graph_empty = false;
+		if (check && !outdated) {
+			outdated = priority_outdated (i->get (), chain);
+		}
+	}
+
+	if (check) {
+		_next_priority_check = now + 1000000;
+		if (outdated && g_atomic_int_compare_and_exchange (&_reprioritize, 0, 1)) {
+			_session.butler ()->summon ();
+		}
 	}
 
 	assert (g_atomic_uint_get (&_trigger_queue_size) == 0);
@@ -283,6 +369,23 @@ Graph::prep ()
 
 	g_atomic_int_set (&_terminal_refcnt, _n_terminal_nodes[chain]);
 
+	/* All worker threads are idle at this point, it is safe to
+	 * switch the scheduler mode.
+	 */
+	_work_stealing = Config->get_graph_work_stealing () && _worker_queues.size () > 1;
+	g_atomic_int_set (&_pending_wakeups, 0);
+
+	if (_work_stealing) {
+		/* Distribute the initial nodes round-robin over all worker queues */
+		size_t n_queues = _worker_queues.size ();
+		size_t n        = 0;
+		for (i = _init_trigger_list[chain].begin (); i != _init_trigger_list[chain].end (); ++i, ++n) {
+			g_atomic_int_inc (&_trigger_queue_size);
+			_worker_queues[n % n_queues]->push_back (i->get ());
+		}
+		return;
+	}
+
 	/* Trigger the initial nodes for processing, which are the ones at the `input' end */
 	for (i = _init_trigger_list[chain].begin (); i != _init_trigger_list[chain].end (); i++) {
 		g_atomic_int_inc (&_trigger_queue_size);
@@ -293,8 +396,25 @@ Graph::prep ()
 void
 Graph::trigger (GraphNode* n)
 {
+	if (!_work_stealing) {
+		g_atomic_int_inc (&_trigger_queue_size);
+		_trigger_queue.push_back (n);
+		return;
+	}
+
+	/* The first node that becomes ready is run next by the
+	 * calling thread, which just processed one of its inputs.
+	 */
+	if (!_graph_continuation) {
+		_graph_continuation = n;
+		return;
+	}
+
+	/* Others are queued locally, idle threads can steal them.
+	 * Idle threads are woken up by run_one_stealing().
+	 */
 	g_atomic_int_inc (&_trigger_queue_size);
-	_trigger_queue.push_back (n);
+	_worker_queues[_graph_worker_id]->push_back (n);
 }
 
 /** Called when a node at the `output' end of the chain (ie one that has no-one to feed)
@@ -376,6 +496,7 @@ Graph::rechain (boost::shared_ptr<RouteList> routelist, GraphEdges const& edges)
 	for (RouteList::iterator ri = routelist->begin (); ri != routelist->end (); ri++) {
 		(*ri)->_init_refcount[chain] = 0;
 		(*ri)->_activation_set[chain].clear ();
+		(*ri)->_activation_list[chain].clear ();
 		_nodes_rt[chain].push_back (*ri);
 	}
 
@@ -416,10 +537,106 @@ Graph::rechain (boost::shared_ptr<RouteList> routelist, GraphEdges const& edges)
 		}
 	}
 
+	prioritize (chain);
+
 	_pending_chain = chain;
 	dump (chain);
 }
 
+/** Compute critical-path priorities, so that nodes at the start of
+ *  the most expensive dependency chains are dispatched first.
+ */
+void
+Graph::prioritize (int chain)
+{
+	std::set<GraphNode*> done;
+	for (node_list_t::iterator ni = _nodes_rt[chain].begin (); ni != _nodes_rt[chain].end (); ++ni) {
+		compute_critical_path (ni->get (), chain, done);
+	}
+
+	CriticalPathSorter cps (chain);
+	for (node_list_t::iterator ni = _nodes_rt[chain].begin (); ni != _nodes_rt[chain].end (); ++ni) {
+		node_list_t& al ((*ni)->_activation_list[chain]);
+		al.assign ((*ni)->_activation_set[chain].begin (), (*ni)->_activation_set[chain].end ());
+		al.sort (cps);
+	}
+	_init_trigger_list[chain].sort (cps);
+}
+
+/** @return true if the execution time of the given node changed by
+ *  more than 50% and 20 usec since its priority was computed.
+ */
+bool
+Graph::priority_outdated (GraphNode const* n, int chain) const
+{
+	float const then  = n->_prioritized_exec_time[chain];
+	float const delta = fabsf (n->exec_time () - then);
+	return delta > 20.f && delta > 0.5f * then;
+}
+
+/** Recompute the priorities of the current chain with the current
+ *  execution times. The re-sorted copy becomes the pending chain,
+ *  which the process thread swaps in. Called by the butler when
+ *  the process thread noticed that the execution times drifted.
+ */
+void
+Graph::reprioritize ()
+{
+	if (!g_atomic_int_get (&_reprioritize)) {
+		return;
+	}
+
+	Glib::Threads::Mutex::Lock ls (_swap_mutex);
+
+	if (_setup_chain == _pending_chain) {
+		/* a new chain is waiting to be swapped in, try again later */
+		return;
+	}
+
+	int const chain = _setup_chain;
+	int const cur   = _current_chain;
+
+	_nodes_rt[chain]          = _nodes_rt[cur];
+	_init_trigger_list[chain] = _init_trigger_list[cur];
+	_n_terminal_nodes[chain]  = _n_terminal_nodes[cur];
+
+	for (node_list_t::iterator ni = _nodes_rt[chain].begin (); ni != _nodes_rt[chain].end (); ++ni) {
+		(*ni)->_init_refcount[chain] = (*ni)->_init_refcount[cur];
+		(*ni)->_activation_set[chain] = (*ni)->_activation_set[cur];
+	}
+
+	prioritize (chain);
+
+	_pending_chain = chain;
+	g_atomic_int_set (&_reprioritize, 0);
+
+	DEBUG_TRACE (DEBUG::Graph, string_compose ("Graph::reprioritize chain %1\n", chain));
+}
+
+/** Compute the length of the most expensive path from the given node
+ *  to a terminal node, using the average execution time of each node.
+ */
+float
+Graph::compute_critical_path (GraphNode* n, int chain, std::set<GraphNode*>& done)
+{
+	if (done.find (n) != done.end ()) {
+		return n->_critical_path[chain];
+	}
+
+	float downstream = 0;
+	for (node_set_t::const_iterator ai = n->_activation_set[chain].begin (); ai != n->_activation_set[chain].end (); ++ai) {
+		downstream = std::max (downstream, compute_critical_path (ai->get (), chain, done));
+	}
+
+	/* nodes that were not yet processed count as 1 usec,
+	 * so that the number of dependent nodes is taken into account.
+	 */
+	n->_prioritized_exec_time[chain] = n->exec_time ();
+	n->_critical_path[chain] = std::max (1.f, n->exec_time ()) + downstream;
+	done.insert (n);
+	return n->_critical_path[chain];
+}
+
 /** Called by both the main thread and all helpers. */
 void
 Graph::run_one ()
@@ -430,6 +647,11 @@ Graph::run_one ()
 		return;
 	}
 
+	if (_work_stealing) {
+		run_one_stealing ();
+		return;
+	}
+
 	if (_trigger_queue.pop_front (to_run)) {
 		/* Wake up idle threads, but at most as many as there's
 		 * work in the trigger queue that can be processed by
@@ -473,11 +695,120 @@ Graph::run_one ()
 	DEBUG_TRACE (DEBUG::ProcessThreads, string_compose ("%1 has finished run_one()\n", pthread_name ()));
 }
 
+/** Pop a node from the calling thread's own queue, or steal one from another worker */
+GraphNode*
+Graph::pop_or_steal ()
+{
+	GraphNode* n        = NULL;
+	guint      n_queues = _worker_queues.size ();
+
+	if (_worker_queues[_graph_worker_id]->pop_front (n)) {
+		return n;
+	}
+
+	for (guint i = 1; i < n_queues; ++i) {
+		if (_worker_queues[(_graph_worker_id + i) % n_queues]->pop_front (n)) {
+			DEBUG_TRACE (DEBUG::ProcessThreads, string_compose ("%1 stole work from queue %2\n", pthread_name (), (_graph_worker_id + i) % n_queues));
+			return n;
+		}
+	}
+	return NULL;
+}
+
+/** Reserve up to \p n idle threads to be woken up.
+ *
+ * An idle thread that was already signalled remains idle until
+ * it is scheduled, count those so that the same idle thread is
+ * not signalled repeatedly.
+ *
+ * @return number of threads the caller has to signal
+ */
+guint
+Graph::claim_idle_threads (guint n)
+{
+	while (n > 0) {
+		guint pending  = g_atomic_uint_get (&_pending_wakeups);
+		guint idle_cnt = g_atomic_uint_get (&_idle_thread_cnt);
+		if (idle_cnt <= pending) {
+			return 0;
+		}
+		guint claim = std::min (idle_cnt - pending, n);
+		if (g_atomic_int_compare_and_exchange (&_pending_wakeups, pending, pending + claim)) {
+			return claim;
+		}
+	}
+	return 0;
+}
+
+/** Work-stealing variant of run_one(), called by both the main thread and all helpers. */
+void
+Graph::run_one_stealing ()
+{
+	/* Continue with a node that was triggered by the previous one */
+	GraphNode* to_run    = _graph_continuation;
+	bool       continued = to_run != NULL;
+	_graph_continuation  = NULL;
+
+	if (!to_run) {
+		to_run = pop_or_steal ();
+	}
+
+	if (to_run) {
+		/* This is the only place that wakes up idle threads:
+		 * at most as many as there is queued work that can be
+		 * processed by other threads. A popped node is still
+		 * included in _trigger_queue_size, a continuation never is.
+		 */
+		guint work_avail = g_atomic_uint_get (&_trigger_queue_size);
+		if (!continued && work_avail > 0) {
+			--work_avail;
+		}
+		guint wakeup = claim_idle_threads (work_avail);
+
+		for (guint i = 0; i < wakeup; ++i) {
+			_execution_sem.signal ();
+		}
+	}
+
+	if (continued) {
+		to_run->run (_current_chain);
+		return;
+	}
+
+	while (!to_run) {
+		/* Wait for work, fall asleep */
+		g_atomic_int_inc (&_idle_thread_cnt);
+		assert (g_atomic_uint_get (&_idle_thread_cnt) <= g_atomic_uint_get (&_n_workers));
+
+		_execution_sem.wait ();
+
+		if (g_atomic_int_get (&_terminate)) {
+			return;
+		}
+
+		g_atomic_int_dec_and_test (&_idle_thread_cnt);
+
+		/* release the claim that woke this thread up */
+		guint pending = g_atomic_uint_get (&_pending_wakeups);
+		while (pending > 0 && !g_atomic_int_compare_and_exchange (&_pending_wakeups, pending, pending - 1)) {
+			pending = g_atomic_uint_get (&_pending_wakeups);
+		}
+
+		/* Try to find some work to do */
+		to_run = pop_or_steal ();
+	}
+
+	g_atomic_int_dec_and_test (&_trigger_queue_size);
+	to_run->run (_current_chain);
+}
+
 void
 Graph::helper_thread ()
 {
-	g_atomic_int_inc (&_n_workers);
-	guint id = g_atomic_uint_get (&_n_workers);
+	guint id = g_atomic_int_add (&_n_workers, 1) + 1;
+
+	_graph_worker_id    = id;
+	_graph_continuation = NULL;
 
 	/* This is needed for ARDOUR::Session requests called from rt-processors
 	 * in particular Lua scripts may do cross-thread calls */
@@ -524,6 +855,9 @@ Graph::main_thread ()
 	}
 	resume_rt_malloc_checks ();
 
+	_graph_worker_id    = 0;
+	_graph_continuation = NULL;
+
 	pt->get_buffers ();
 
 	/* Wait for initial process callback */
@@ -569,22 +903,21 @@ Graph::dump (int chain) const
 {
 #ifndef NDEBUG
 	node_list_t::const_iterator ni;
-	node_set_t::const_iterator  ai;
 
 	chain = _pending_chain;
 
 	DEBUG_TRACE (DEBUG::Graph, "--------------------------------------------Graph dump:\n");
 	for (ni = _nodes_rt[chain].begin (); ni != _nodes_rt[chain].end (); ni++) {
 		boost::shared_ptr<Route> rp = boost::dynamic_pointer_cast<Route> (*ni);
-		DEBUG_TRACE (DEBUG::Graph, string_compose ("GraphNode: %1  refcount: %2\n", rp->name ().c_str (), (*ni)->_init_refcount[chain]));
-		for (ai = (*ni)->_activation_set[chain].begin (); ai != (*ni)->_activation_set[chain].end (); ai++) {
+		DEBUG_TRACE (DEBUG::Graph, string_compose ("GraphNode: %1  refcount: %2 exec: %3 us critical-path: %4 us\n", rp->name ().c_str (), (*ni)->_init_refcount[chain], (*ni)->exec_time (), (*ni)->_critical_path[chain]));
+		for (node_list_t::const_iterator ai = (*ni)->_activation_list[chain].begin (); ai != (*ni)->_activation_list[chain].end (); ai++) {
 			DEBUG_TRACE (DEBUG::Graph, string_compose ("  triggers: %1\n", boost::dynamic_pointer_cast<Route> (*ai)->name ().c_str ()));
 		}
 	}
 
-	DEBUG_TRACE (DEBUG::Graph, "------------- trigger list:\n");
+	DEBUG_TRACE (DEBUG::Graph, "------------- trigger list (dispatch order):\n");
 	for (ni = _init_trigger_list[chain].begin (); ni != _init_trigger_list[chain].end (); ni++) {
-		DEBUG_TRACE (DEBUG::Graph, string_compose ("GraphNode: %1  refcount: %2\n", boost::dynamic_pointer_cast<Route> (*ni)->name ().c_str (), (*ni)->_init_refcount[chain]));
+		DEBUG_TRACE (DEBUG::Graph, string_compose ("GraphNode: %1  refcount: %2 critical-path: %3 us\n", boost::dynamic_pointer_cast<Route> (*ni)->name ().c_str (), (*ni)->_init_refcount[chain], (*ni)->_critical_path[chain]));
 	}
 
 	DEBUG_TRACE (DEBUG::Graph, string_compose ("final activation refcount: %1\n", _n_terminal_nodes[chain]));
@@ -614,6 +947,7 @@ Graph::plot (std::string const& file_name) const
 		} else if ((*ni)->_activation_set[chain].size() == 0) {
 				ss << "  \"" << sn << "\"[style=filled,fillcolor=aquamarine2];\n";
 		}
+		ss << "  \"" << sn << "\"[label=\"" << sn << "\\n" << string_compose ("exec: %1 us, critical-path: %2 us", (int)(*ni)->exec_time (), (int)(*ni)->_critical_path[chain]) << "\"];\n";
 		for (ai = (*ni)->_activation_set[chain].begin (); ai != (*ni)->_activation_set[chain].end (); ai++) {
 			boost::shared_ptr<Route> dr = boost::dynamic_pointer_cast<Route> (*ai);
 			std::string dn = string_compose ("%1 (%2)", dr->name (), (*ai)->_init_refcount[chain]);
@@ -628,6 +962,19 @@ Graph::plot (std::string const& file_name) const
 			}
 		}
 	}
+
+	/* Dispatch order of the initial nodes */
+	int n = 0;
+	ss << "  subgraph cluster_schedule {\n";
+	ss << "    label = \"initial dispatch order\";\n";
+	for (ni = _init_trigger_list[chain].begin (); ni != _init_trigger_list[chain].end (); ni++, ++n) {
+		boost::shared_ptr<Route> sr = boost::dynamic_pointer_cast<Route> (*ni);
+		ss << "    \"sched_" << n << "\"[shape=box,label=\"" << n + 1 << ": " << sr->name () << "\"];\n";
+		if (n > 0) {
+			ss << "    \"sched_" << n - 1 << "\" -> \"sched_" << n << "\"\n";
+		}
+	}
+	ss << "  }\n";
 	ss << "}\n";
 
 	GError *err = NULL;
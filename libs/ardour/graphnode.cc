@@ -26,8 +26,11 @@ using namespace ARDOUR;
 
 GraphNode::GraphNode (boost::shared_ptr<Graph> graph)
 	: _graph (graph)
+	, _exec_time (0)
 {
 	g_atomic_int_set (&_refcount, 0);
+	_critical_path[0] = _critical_path[1] = 0;
+	_prioritized_exec_time[0] = _prioritized_exec_time[1] = 0;
 }
 
 GraphNode::~GraphNode ()
@@ -56,14 +59,30 @@ GraphNode::trigger ()
 	}
 }
 
+void
+GraphNode::run (int chain)
+{
+	PBD::microseconds_t t0 = PBD::get_microseconds ();
+	process ();
+	PBD::microseconds_t t1 = PBD::get_microseconds ();
+
+	/* timers may fail or be per CPU, ignore bogus values */
+	if (t1 > t0) {
+		_exec_time += 0.05f * ((float)(t1 - t0) - _exec_time);
+	}
+
+	finish (chain);
+}
+
 void
 GraphNode::finish (int chain)
 {
-	node_set_t::iterator i;
-	bool                 feeds = false;
+	node_list_t::iterator i;
+	bool                  feeds = false;
 
-	/* Notify downstream nodes that depend on this node */
-	for (i = _activation_set[chain].begin (); i != _activation_set[chain].end (); ++i) {
+	/* Notify downstream nodes that depend on this node,
+	 * the ones with the longest remaining path first */
+	for (i = _activation_list[chain].begin (); i != _activation_list[chain].end (); ++i) {
 		(*i)->trigger ();
 		feeds = true;
 	}
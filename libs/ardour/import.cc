@@ -34,18 +34,22 @@
 #include <time.h>
 #include <stdint.h>
 
+#include <atomic>
+
 #include <sndfile.h>
 #include <samplerate.h>
 
 #include "pbd/gstdio_compat.h"
 #include <glibmm.h>
 
+#include <boost/bind.hpp>
 #include <boost/scoped_array.hpp>
 #include <boost/scoped_ptr.hpp>
 #include <boost/shared_array.hpp>
 
 #include "pbd/basename.h"
 #include "pbd/convert.h"
+#include "pbd/cpus.h"
 
 #include "evoral/SMF.h"
 
@@ -55,6 +59,7 @@
 #include "ardour/audioregion.h"
 #include "ardour/ffmpegfileimportable.h"
 #include "ardour/import_status.h"
+#include "ardour/io_tasklist.h"
 #include "ardour/midi_region.h"
 #include "ardour/midi_source.h"
 #include "ardour/mp3fileimportable.h"
@@ -252,43 +257,156 @@ compose_status_message (const string& path,
 	return string_compose (_("Copying %1"), Glib::path_get_basename (path));
 }
 
+namespace {
+
+/** Overall progress of the audio files of an import, shared by all workers */
+struct ImportProgress {
+	ImportProgress (ImportStatus& s, uint32_t n, double work, double decode, int64_t bytes)
+		: status (s)
+		, base (s.current)
+		, n_files (n)
+		, total_work (std::max (1.0, work))
+		, total_decode (std::max (1.0, decode))
+		, input_bytes (bytes)
+		, start_time (g_get_monotonic_time ())
+		, work_done (0)
+		, decoded (0)
+		, files_done (0)
+	{
+		publishing.clear ();
+	}
+
+	void add (samplecnt_t n, bool decode)
+	{
+		work_done.fetch_add (n);
+		if (decode) {
+			decoded.fetch_add (n);
+		}
+		publish ();
+	}
+
+	void file_done ()
+	{
+		files_done.fetch_add (1);
+		publish ();
+	}
+
+	/* Update the status from the current totals. Only one worker at a
+	 * time does so, the others skip it: the update in progress, or the
+	 * next one, includes their work. Since the totals only grow, no
+	 * update reports less work done than an earlier one.
+	 */
+	void publish ()
+	{
+		if (publishing.test_and_set (std::memory_order_acquire)) {
+			return;
+		}
+
+		const int64_t  w    = work_done.load ();
+		const int64_t  d    = decoded.load ();
+		const uint32_t done = files_done.load ();
+		const double   f    = std::min (1.0, w / total_work);
+
+		status.current  = base + done;
+		status.progress = std::max (0.0, std::min (1.0, f * n_files - done));
+
+		const int64_t elapsed = g_get_monotonic_time () - start_time;
+		if (elapsed > 0) {
+			/* bytes per microsecond == MB/s */
+			status.throughput = input_bytes * (d / total_decode) / elapsed;
+		}
+
+		publishing.clear (std::memory_order_release);
+	}
+
+	ImportStatus& status;
+	uint32_t      base;
+	uint32_t      n_files;
+	double        total_work;
+	double        total_decode;
+	int64_t       input_bytes;
+	int64_t       start_time;
+
+	std::atomic<int64_t>  work_done;
+	std::atomic<int64_t>  decoded;
+	std::atomic<uint32_t> files_done;
+	std::atomic_flag      publishing;
+};
+
+struct AudioImportJob {
+	std::string                             path;
+	boost::shared_ptr<ImportableSource>     source;
+	std::vector<boost::shared_ptr<Source> > newfiles;
+	bool                                    normalize;
+};
+
+}
+
+/* de-interleave and apply gain */
+static void
+deinterleave (float const* src, Sample** dst, uint32_t channels, samplecnt_t nframes, float gain)
+{
+	if (channels == 1) {
+		copy_vector (dst[0], src, nframes);
+	} else if (channels == 2) {
+		Sample* l = dst[0];
+		Sample* r = dst[1];
+		for (samplecnt_t n = 0; n < nframes; ++n) {
+			l[n] = src[2 * n];
+			r[n] = src[2 * n + 1];
+		}
+	} else {
+		/* read the source sequentially */
+		for (samplecnt_t n = 0; n < nframes; ++n, src += channels) {
+			for (uint32_t chn = 0; chn < channels; ++chn) {
+				dst[chn][n] = src[chn];
+			}
+		}
+	}
+
+	if (gain != 1) {
+		for (uint32_t chn = 0; chn < channels; ++chn) {
+			apply_gain_to_buffer (dst[chn], nframes, gain);
+		}
+	}
+}
+
 static void
 write_audio_data_to_new_files (ImportableSource* source, ImportStatus& status,
-                               vector<boost::shared_ptr<Source> >& newfiles)
+                               vector<boost::shared_ptr<Source> >& newfiles,
+                               bool normalize, ImportProgress& progress)
 {
 	const samplecnt_t nframes = ResampledImportableSource::blocksize;
 	boost::shared_ptr<AudioFileSource> afs;
 	uint32_t channels = source->channels();
 	if (channels == 0) {
+		progress.file_done ();
 		return;
 	}
 
 	boost::scoped_array<float> data(new float[nframes * channels]);
 	vector<boost::shared_array<Sample> > channel_data;
+	vector<Sample*> channel_ptr;
 
 	for (uint32_t n = 0; n < channels; ++n) {
 		channel_data.push_back(boost::shared_array<Sample>(new Sample[nframes]));
+		channel_ptr.push_back (channel_data.back ().get ());
 	}
 
 	float gain = 1;
+	FILE* spill = 0;
 
-	boost::shared_ptr<AudioSource> s = boost::dynamic_pointer_cast<AudioSource> (newfiles[0]);
-	assert (s);
-
-	status.progress = 0.0f;
-	float progress_multiplier = 1;
-	float progress_base = 0;
-	const float progress_length = source->ratio() * source->length();
-
-	if (!source->clamped_at_unity() && s->clamped_at_unity()) {
+	if (normalize) {
 
 		/* The source we are importing from can return sample values with a magnitude greater than 1,
 		   and the file we are writing the imported data to cannot handle such values.  Compute the gain
 		   factor required to normalize the input sources to have a magnitude of less than 1.
+
+		   The decoded data is kept in a temporary file, so that the source is only decoded once.
 		*/
 
 		float peak = 0;
-		uint32_t read_count = 0;
+		spill = tmpfile ();
 
 		while (!status.cancel) {
 			samplecnt_t const nread = source->read (data.get(), nframes * channels);
@@ -298,8 +416,13 @@ write_audio_data_to_new_files (ImportableSource* source, ImportStatus& status,
 
 			peak = compute_peak (data.get(), nread, peak);
 
-			read_count += nread / channels;
-			status.progress = 0.5 * read_count / progress_length;
+			if (spill && fwrite (data.get (), sizeof (float), nread, spill) != (size_t) nread) {
+				/* out of temp space, decode again below */
+				fclose (spill);
+				spill = 0;
+			}
+
+			progress.add (nread / channels, true);
 		}
 
 		if (peak >= 1) {
@@ -307,20 +430,25 @@ write_audio_data_to_new_files (ImportableSource* source, ImportStatus& status,
 			gain = (1 - FLT_EPSILON) / peak;
 		}
 
-		source->seek (0);
-		progress_multiplier = 0.5;
-		progress_base = 0.5;
+		if (spill) {
+			rewind (spill);
+		} else {
+			source->seek (0);
+		}
 	}
 
-	samplecnt_t read_count = 0;
-
 	while (!status.cancel) {
 
 		samplecnt_t nread, nfread;
-		uint32_t x;
 		uint32_t chn;
 
-		if ((nread = source->read (data.get(), nframes * channels)) == 0) {
+		if (spill) {
+			nread = fread (data.get (), sizeof (float), nframes * channels, spill);
+		} else {
+			nread = source->read (data.get(), nframes * channels);
+		}
+
+		if (nread == 0) {
 #ifdef PLATFORM_WINDOWS
 			/* Flush the data once we've finished importing the file. Windows can  */
 			/* cache the data for very long periods of time (perhaps not writing   */
@@ -332,34 +460,67 @@ write_audio_data_to_new_files (ImportableSource* source, ImportStatus& status,
 			break;
 		}
 
-		if (gain != 1) {
-			/* here is the gain fix for out-of-range sample values that we computed earlier */
-			apply_gain_to_buffer (data.get(), nread, gain);
-		}
-
 		nfread = nread / channels;
 
-		/* de-interleave */
+		/* de-interleave, and apply the gain fix for out-of-range sample values that we computed earlier */
 
-		for (chn = 0; chn < channels; ++chn) {
+		deinterleave (data.get (), &channel_ptr[0], channels, nfread, gain);
 
-			samplecnt_t n;
-			for (x = chn, n = 0; n < nfread; x += channels, ++n) {
-				channel_data[chn][n] = (Sample) data[x];
-			}
-		}
-
-		/* flush to disk */
+		/* flush to disk, this also computes the peak-data */
 
 		for (chn = 0; chn < channels; ++chn) {
 			if ((afs = boost::dynamic_pointer_cast<AudioFileSource>(newfiles[chn])) != 0) {
-				afs->write (channel_data[chn].get(), nfread);
+				afs->write (channel_ptr[chn], nfread);
 			}
 		}
 
-		read_count += nfread;
-		status.progress = progress_base + progress_multiplier * read_count / progress_length;
+		progress.add (nfread, !normalize);
+	}
+
+	if (spill) {
+		fclose (spill);
+	}
+
+	progress.file_done ();
+}
+
+/* Write all audio files, independent files are processed in parallel */
+static void
+write_audio_files (vector<AudioImportJob>& jobs, ImportStatus& status, samplecnt_t session_rate)
+{
+	double  work   = 0;
+	double  decode = 0;
+	int64_t bytes  = 0;
+
+	for (vector<AudioImportJob>::const_iterator j = jobs.begin (); j != jobs.end (); ++j) {
+		const double len = j->source->ratio () * j->source->length ();
+		decode += len;
+		work   += j->normalize ? 2 * len : len;
+
+		GStatBuf sb;
+		if (g_stat (j->path.c_str (), &sb) == 0) {
+			bytes += sb.st_size;
+		}
+	}
+
+	ImportProgress progress (status, jobs.size (), work, decode, bytes);
+
+	if (jobs.size () == 1) {
+		AudioImportJob& j (jobs.front ());
+		status.doing_what = compose_status_message (j.path, j.source->samplerate (), session_rate, status.current, status.total);
+		write_audio_data_to_new_files (j.source.get (), status, j.newfiles, j.normalize, progress);
+	} else {
+		status.doing_what = string_compose (_("Importing %1 files"), jobs.size ());
+
+		IOTaskList pool (std::min<uint32_t> (jobs.size (), PBD::hardware_concurrency ()));
+		for (vector<AudioImportJob>::iterator j = jobs.begin (); j != jobs.end (); ++j) {
+			pool.push_back (boost::bind (&write_audio_data_to_new_files, j->source.get (), boost::ref (status), boost::ref (j->newfiles), j->normalize, boost::ref (progress)));
+		}
+		pool.process ();
 	}
+
+	status.current  = progress.base + jobs.size ();
+	status.progress = 0;
 }
 
 static void
@@ -597,12 +758,15 @@ Session::import_files (ImportStatus& status)
 {
 	typedef vector<boost::shared_ptr<Source> > Sources;
 	Sources all_new_sources;
+	vector<size_t> source_path; // index of the path each of all_new_sources was imported from
 	boost::shared_ptr<AudioFileSource> afs;
 	boost::shared_ptr<SMFSource> smfs;
 	uint32_t num_channels = 0;
 	vector<string> smf_names;
+	vector<AudioImportJob> audio_jobs;
 
 	status.sources.clear ();
+	status.throughput = 0;
 
 	for (vector<string>::const_iterator p = status.paths.begin(); p != status.paths.end() && !status.cancel; ++p) {
 
@@ -705,6 +869,7 @@ Session::import_files (ImportStatus& status)
 
 		// copy on cancel/failure so that any files that were created will be removed below
 		std::copy (newfiles.begin(), newfiles.end(), std::back_inserter(all_new_sources));
+		source_path.insert (source_path.end (), newfiles.size (), p - status.paths.begin ());
 
 		if (status.cancel) {
 			break;
@@ -716,10 +881,17 @@ Session::import_files (ImportStatus& status)
 			}
 		}
 
-		if (source) { // audio
-			status.doing_what = compose_status_message (*p, source->samplerate(),
-			                                            sample_rate(), status.current, status.total);
-			write_audio_data_to_new_files (source.get(), status, newfiles);
+		if (source) { // audio, written below
+			boost::shared_ptr<AudioSource> as = boost::dynamic_pointer_cast<AudioSource> (newfiles[0]);
+			assert (as);
+
+			AudioImportJob job;
+			job.path      = *p;
+			job.source    = source;
+			job.newfiles  = newfiles;
+			job.normalize = !source->clamped_at_unity () && as->clamped_at_unity ();
+			audio_jobs.push_back (job);
+			continue;
 		} else if (smf_reader) { // midi
 			status.doing_what = string_compose(_("Loading MIDI file %1"), *p);
 			write_midi_data_to_new_files (smf_reader.get(), status, newfiles, status.split_midi_channels);
@@ -729,6 +901,10 @@ Session::import_files (ImportStatus& status)
 		status.progress = 0;
 	}
 
+	if (!status.cancel && !audio_jobs.empty ()) {
+		write_audio_files (audio_jobs, status, sample_rate ());
+	}
+
 	if (!status.cancel) {
 		struct tm* now;
 		time_t xnow;
@@ -771,6 +947,7 @@ Session::import_files (ImportStatus& status)
 			/* don't create tracks for empty MIDI sources (channels) */
 
 			if ((smfs = boost::dynamic_pointer_cast<SMFSource>(*x)) != 0 && smfs->is_empty()) {
+				source_path.erase (source_path.begin () + (x - all_new_sources.begin ()));
 				x = all_new_sources.erase(x);
 			} else {
 				++x;
@@ -778,6 +955,11 @@ Session::import_files (ImportStatus& status)
 		}
 
 		std::copy (all_new_sources.begin(), all_new_sources.end(), std::back_inserter(status.sources));
+
+		status.path_sources.assign (status.paths.size (), SourceList ());
+		for (size_t n = 0; n < all_new_sources.size (); ++n) {
+			status.path_sources[source_path[n]].push_back (all_new_sources[n]);
+		}
 	} else {
 		try {
 			std::for_each (all_new_sources.begin(), all_new_sources.end(), remove_file_source);
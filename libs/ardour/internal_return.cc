@@ -23,6 +23,7 @@
 
 #include "ardour/internal_return.h"
 #include "ardour/internal_send.h"
+#include "ardour/meter.h"
 #include "ardour/route.h"
 
 using namespace std;
@@ -47,13 +48,36 @@ InternalReturn::run (BufferSet& bufs, samplepos_t /*start_sample*/, samplepos_t
 		return;
 	}
 
+	/* If the meter follows directly, the last send to be mixed
+	 * also provides the peak of the resulting buffers.
+	 */
+	InternalSend* last = 0;
+	if (_fused_meter && _fused_meter->active () && !_fused_peaks.empty ()) {
+		for (list<InternalSend*>::iterator i = _sends.begin(); i != _sends.end(); ++i) {
+			if ((*i)->active () && (!(*i)->source_route() || (*i)->source_route()->active())) {
+				last = *i;
+			}
+		}
+	}
+
 	for (list<InternalSend*>::iterator i = _sends.begin(); i != _sends.end(); ++i) {
 		if ((*i)->active () && (!(*i)->source_route() || (*i)->source_route()->active())) {
-			bufs.merge_from ((*i)->get_buffers(), nframes);
+			if (*i == last) {
+				uint32_t n = bufs.merge_from_with_peaks ((*i)->get_buffers(), nframes, &_fused_peaks[0], _fused_peaks.size ());
+				_fused_meter->set_input_peaks (&_fused_peaks[0], n);
+			} else {
+				bufs.merge_from ((*i)->get_buffers(), nframes);
+			}
 		}
 	}
 }
 
+void
+InternalReturn::set_fused_meter (boost::shared_ptr<PeakMeter> meter)
+{
+	_fused_meter = meter;
+}
+
 void
 InternalReturn::add_send (InternalSend* send)
 {
@@ -98,6 +122,7 @@ InternalReturn::can_support_io_configuration (const ChanCount& in, ChanCount& ou
 bool
 InternalReturn::configure_io (ChanCount in, ChanCount out)
 {
+	_fused_peaks.resize (in.n_audio ());
 	Processor::configure_io (in, out);
 	return true;
 }
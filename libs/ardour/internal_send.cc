@@ -220,7 +220,47 @@ InternalSend::run (BufferSet& bufs, samplepos_t start_sample, samplepos_t end_sa
 	 * in-place, which a send must never do.
 	 */
 
-	if (_panshell && !_panshell->bypassed () && role () != Listen) {
+	/* main gain control: * mute & bypass/enable */
+	gain_t tgain = target_gain ();
+	gain_t fader_gain;
+
+	/* we were quiet last time, and we're still supposed to be quiet.
+	 * The cycle is not processed (see below), nor is gain automation.
+	 */
+	const bool quiet = tgain == _current_gain && tgain == GAIN_COEFF_ZERO;
+
+	if (!quiet) {
+		_amp->set_gain_automation_buffer (_session.send_gain_automation_buffer ());
+		_amp->setup_gain_automation (start_sample, end_sample, nframes);
+	}
+
+	/* If neither the send nor the fader gain changes during this cycle,
+	 * copy, apply gain and compute the meter's peaks in a single pass.
+	 */
+	const bool fused = !quiet && !(_panshell && !_panshell->bypassed ()) && role () != Listen
+	                   && tgain == _current_gain
+	                   && bufs.count ().n_midi () == 0 && mixbufs.count ().n_audio () <= _send_peaks.size ()
+	                   && _amp->constant_gain (fader_gain);
+
+	if (fused) {
+		const gain_t g = tgain * fader_gain;
+		uint32_t     n = 0;
+
+		BufferSet::audio_iterator i = bufs.audio_begin ();
+		for (BufferSet::audio_iterator o = mixbufs.audio_begin (); o != mixbufs.audio_end (); ++o, ++n) {
+			if (i == bufs.audio_end ()) {
+				o->silence (nframes);
+				_send_peaks[n] = 0;
+			} else {
+				_send_peaks[n] = o->read_from_with_gain_and_peak (*i, nframes, g, 0);
+				++i;
+			}
+		}
+		for (BufferSet::iterator o = mixbufs.begin (DataType::MIDI); o != mixbufs.end (DataType::MIDI); ++o) {
+			o->silence (nframes, 0);
+		}
+
+	} else if (_panshell && !_panshell->bypassed () && role () != Listen) {
 		if (mixbufs.count ().n_audio () > 0) {
 			_panshell->run (bufs, mixbufs, start_sample, end_sample, nframes);
 		}
@@ -304,10 +344,10 @@ InternalSend::run (BufferSet& bufs, samplepos_t start_sample, samplepos_t end_sa
 		}
 	}
 
-	/* main gain control: * mute & bypass/enable */
-	gain_t tgain = target_gain ();
-
-	if (tgain != _current_gain) {
+	if (fused) {
+		/* send and fader gain have already been applied */
+		_amp->constant_gain_applied (fader_gain);
+	} else if (tgain != _current_gain) {
 		/* target gain has changed, fade in/out */
 		_current_gain = Amp::apply_gain (mixbufs, _session.nominal_sample_rate (), nframes, _current_gain, tgain);
 	} else if (tgain == GAIN_COEFF_ZERO) {
@@ -321,9 +361,9 @@ InternalSend::run (BufferSet& bufs, samplepos_t start_sample, samplepos_t end_sa
 	}
 
 	/* apply fader gain automation */
-	_amp->set_gain_automation_buffer (_session.send_gain_automation_buffer ());
-	_amp->setup_gain_automation (start_sample, end_sample, nframes);
-	_amp->run (mixbufs, start_sample, end_sample, speed, nframes, true);
+	if (!fused) {
+		_amp->run (mixbufs, start_sample, end_sample, speed, nframes, true);
+	}
 
 	_send_delay->run (mixbufs, start_sample, end_sample, speed, nframes, true);
 
@@ -332,6 +372,9 @@ InternalSend::run (BufferSet& bufs, samplepos_t start_sample, samplepos_t end_sa
 		if (_amp->gain_control ()->get_value () == GAIN_COEFF_ZERO) {
 			_meter->reset ();
 		} else {
+			if (fused && _send_delay->delay () == 0 && !_send_peaks.empty ()) {
+				_meter->set_input_peaks (&_send_peaks[0], mixbufs.count ().n_audio ());
+			}
 			_meter->run (mixbufs, start_sample, end_sample, speed, nframes, true);
 		}
 	}
@@ -348,6 +391,7 @@ InternalSend::ensure_mixbufs ()
 		size_t size = (*t == DataType::MIDI) ? _session.engine ().raw_buffer_size (*t) : _session.get_block_size ();
 		mixbufs.ensure_buffers (*t, _send_to->internal_return ()->input_streams ().get (*t), size);
 	}
+	_send_peaks.resize (_send_to->internal_return ()->input_streams ().n_audio ());
 }
 
 int
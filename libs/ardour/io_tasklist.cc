@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2026 The Ardour Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+
+#include "pbd/cpus.h"
+#include "pbd/error.h"
+#include "pbd/pthread_utils.h"
+
+#include "temporal/tempo.h"
+
+#include "ardour/disk_reader.h"
+#include "ardour/io_tasklist.h"
+#include "ardour/session_event.h"
+
+#include "pbd/i18n.h"
+
+using namespace ARDOUR;
+
+IOTaskList::IOTaskList (uint32_t n_threads)
+	: _next_task (0)
+	, _terminate (false)
+	, _exec_sem ("io thread exec", 0)
+	, _idle_sem ("io thread idle", 0)
+{
+	for (uint32_t i = 1; i < n_threads; ++i) {
+		pthread_t thread_id;
+		if (pthread_create_and_store ("I/O worker", &thread_id, _worker_thread, this)) {
+			PBD::error << _("Cannot create I/O worker thread") << endmsg;
+			break;
+		}
+		_threads.push_back (thread_id);
+	}
+}
+
+IOTaskList::~IOTaskList ()
+{
+	_terminate.store (true);
+	for (size_t i = 0; i < _threads.size (); ++i) {
+		_exec_sem.signal ();
+	}
+	for (std::vector<pthread_t>::const_iterator i = _threads.begin (); i != _threads.end (); ++i) {
+		pthread_join (*i, NULL);
+	}
+}
+
+uint32_t
+IOTaskList::n_threads_for (int32_t pref)
+{
+	if (pref > 0) {
+		return pref;
+	}
+	/* automatic: half the available cores, reads are mostly waiting for I/O
+	 * and should not compete with DSP threads.
+	 */
+	return std::max<uint32_t> (1, std::min<uint32_t> (8, PBD::hardware_concurrency () / 2));
+}
+
+void
+IOTaskList::push_back (boost::function<void ()> fn)
+{
+	_tasks.push_back (fn);
+}
+
+/*static*/ void*
+IOTaskList::_worker_thread (void* arg)
+{
+	IOTaskList* d = static_cast<IOTaskList*> (arg);
+	pthread_set_name ("IOTaskList");
+	SessionEvent::create_per_thread_pool ("IOTaskList", 64);
+	d->io_thread ();
+	pthread_exit (0);
+	return 0;
+}
+
+void
+IOTaskList::run_tasks ()
+{
+	const uint32_t n_tasks = _tasks.size ();
+	uint32_t       idx;
+	while ((idx = _next_task.fetch_add (1)) < n_tasks) {
+		_tasks[idx] ();
+	}
+}
+
+void
+IOTaskList::io_thread ()
+{
+	DiskReader::allocate_thread_working_buffers ();
+
+	while (true) {
+		_exec_sem.wait ();
+		if (_terminate.load ()) {
+			break;
+		}
+		Temporal::TempoMap::fetch ();
+		run_tasks ();
+		_idle_sem.signal ();
+	}
+
+	DiskReader::free_thread_working_buffers ();
+}
+
+void
+IOTaskList::process ()
+{
+	const uint32_t n_tasks = _tasks.size ();
+
+	if (n_tasks == 0) {
+		return;
+	}
+
+	_next_task.store (0);
+
+	/* wake up as many workers as are useful, the calling thread participates */
+	const uint32_t n_wakeup = std::min<uint32_t> (_threads.size (), n_tasks - 1);
+	for (uint32_t i = 0; i < n_wakeup; ++i) {
+		_exec_sem.signal ();
+	}
+
+	run_tasks ();
+
+	for (uint32_t i = 0; i < n_wakeup; ++i) {
+		_idle_sem.wait ();
+	}
+
+	_tasks.clear ();
+}
@@ -2772,6 +2772,9 @@ LuaBindings::common (lua_State* L)
 		.addFunction ("log_meter_coeff", &DSP::log_meter_coeff)
 		.addFunction ("process_map", &DSP::process_map)
 		.addRefFunction ("peaks", &DSP::peaks)
+		.addFunction ("gain_ramp", &DSP::gain_ramp)
+		.addFunction ("mix_ramp", &DSP::mix_ramp)
+		.addFunction ("xfade", &DSP::xfade)
 
 		.beginClass <DSP::LowPass> ("LowPass")
 		.addConstructor <void (*) (double, float)> ()
@@ -2788,6 +2791,32 @@ LuaBindings::common (lua_State* L)
 		.addFunction ("reset", &DSP::Biquad::reset)
 		.addFunction ("dB_at_freq", &DSP::Biquad::dB_at_freq)
 		.endClass ()
+		.beginClass <DSP::BiquadCascade> ("BiquadCascade")
+		.addConstructor <void (*) (double, uint32_t, uint32_t)> ()
+		.addFunction ("run", &DSP::BiquadCascade::run)
+		.addFunction ("compute", &DSP::BiquadCascade::compute)
+		.addFunction ("configure", &DSP::BiquadCascade::configure)
+		.addFunction ("reset", &DSP::BiquadCascade::reset)
+		.addFunction ("dB_at_freq", &DSP::BiquadCascade::dB_at_freq)
+		.addFunction ("n_stages", &DSP::BiquadCascade::n_stages)
+		.addFunction ("n_channels", &DSP::BiquadCascade::n_channels)
+		.endClass ()
+		.beginClass <DSP::EnvelopeFollower> ("EnvelopeFollower")
+		.addConstructor <void (*) (double, float, float)> ()
+		.addFunction ("run", &DSP::EnvelopeFollower::run)
+		.addFunction ("process", &DSP::EnvelopeFollower::process)
+		.addFunction ("set_attack", &DSP::EnvelopeFollower::set_attack)
+		.addFunction ("set_release", &DSP::EnvelopeFollower::set_release)
+		.addFunction ("value", &DSP::EnvelopeFollower::value)
+		.addFunction ("reset", &DSP::EnvelopeFollower::reset)
+		.endClass ()
+		.beginClass <DSP::Resampler> ("Resampler")
+		.addConstructor <void (*) (double, uint32_t)> ()
+		.addFunction ("process", &DSP::Resampler::process)
+		.addFunction ("latency", &DSP::Resampler::latency)
+		.addFunction ("ratio", &DSP::Resampler::ratio)
+		.addFunction ("reset", &DSP::Resampler::reset)
+		.endClass ()
 		.beginClass <DSP::FFTSpectrum> ("FFTSpectrum")
 		.addConstructor <void (*) (uint32_t, double)> ()
 		.addFunction ("set_data_hann", &DSP::FFTSpectrum::set_data_hann)
@@ -2816,6 +2845,10 @@ LuaBindings::common (lua_State* L)
 		.addFunction ("latency", &ARDOUR::DSP::Convolution::latency)
 		.addFunction ("n_inputs", &ARDOUR::DSP::Convolution::n_inputs)
 		.addFunction ("n_outputs", &ARDOUR::DSP::Convolution::n_outputs)
+		.addFunction ("run_mono_buffered", &ARDOUR::DSP::Convolution::run_mono_buffered)
+		.addFunction ("run_stereo_buffered", &ARDOUR::DSP::Convolution::run_stereo_buffered)
+		.addFunction ("run_mono_no_latency", &ARDOUR::DSP::Convolution::run_mono_no_latency)
+		.addFunction ("run_stereo_no_latency", &ARDOUR::DSP::Convolution::run_stereo_no_latency)
 		.endClass ()
 
 		.beginClass <DSP::Convolver::IRSettings> ("IRSettings")
@@ -2830,10 +2863,6 @@ LuaBindings::common (lua_State* L)
 
 		.deriveClass <DSP::Convolver, DSP::Convolution> ("Convolver")
 		.addConstructor <void (*) (Session&, std::string const&, DSP::Convolver::IRChannelConfig, DSP::Convolver::IRSettings)> ()
-		.addFunction ("run_mono_buffered", &ARDOUR::DSP::Convolver::run_mono_buffered)
-		.addFunction ("run_stereo_buffered", &ARDOUR::DSP::Convolver::run_stereo_buffered)
-		.addFunction ("run_mono_no_latency", &ARDOUR::DSP::Convolver::run_mono_no_latency)
-		.addFunction ("run_stereo_no_latency", &ARDOUR::DSP::Convolver::run_stereo_no_latency)
 		.endClass ()
 
 		/* DSP enums */
@@ -19,12 +19,19 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <algorithm>
+#include <cstring>
+
 #include <glib.h>
 #include <glibmm/miscutils.h>
 #include <glibmm/fileutils.h>
+#include <glibmm/threads.h>
 
+#include "pbd/g_atomic_compat.h"
 #include "pbd/gstdio_compat.h"
 #include "pbd/pthread_utils.h"
+#include "pbd/spinlock.h"
+#include "pbd/unwind.h"
 
 #include "ardour/audio_buffer.h"
 #include "ardour/buffer_set.h"
@@ -43,13 +50,321 @@
 using namespace ARDOUR;
 using namespace PBD;
 
+/* max memory per instance */
+static const size_t lua_mempool_size = 3145728;
+/* max time spent per process-cycle on garbage collection */
+static const int64_t lua_gc_budget_us = 25;
+
+/* compiled scripts, shared by all instances of the same script */
+static Glib::Threads::Mutex _bytecode_lock;
+static std::map<std::string, std::string> _bytecode_cache;
+
+#ifdef USE_TLSF
+/* TLSF arenas are shared by several LuaProc instances. Few scripts
+ * come close to the quota: the bindings and a typical script use about
+ * 1.2 MB. An instance is admitted to an arena by its expected use (the
+ * quota divided by lua_overcommit), or by the most it ever used, if
+ * that is more. Arenas are added as needed.
+ *
+ * Should an arena run out of memory regardless, the instance continues
+ * in another arena. A process thread cannot add an arena; it uses a
+ * small per instance reserve, and finally fails the allocation, which
+ * makes Lua complete a garbage collection cycle and retry.
+ *
+ * The arena is locked by whatever thread runs the script, which may
+ * be a GUI or butler thread (dsp_init, presets, inline-display).
+ * A process thread never waits for the lock, since the holder may
+ * have been preempted. It uses the reserve instead, and frees arena
+ * memory once the lock is available.
+ */
+static const size_t lua_arena_size = 8388608;
+/* space for TLSF's own data and fragmentation */
+static const size_t lua_arena_capacity = lua_arena_size - lua_arena_size / 16;
+static const size_t lua_overcommit = 2;
+static const size_t lua_reserve_size = 16384;
+static const size_t lua_max_deferred = 256;
+
+struct LuaProc::SharedPool::Arena {
+	Arena () : pool ("LuaProc", lua_arena_size), users (0) {
+		g_atomic_int_set (&charged, 0);
+	}
+
+	PBD::TLSF         pool;
+	PBD::spinlock_t   lock;
+	GATOMIC_QUAL gint charged; // expected or peak use of the instances admitted here
+	size_t            users;   // instances with memory in this arena, protected by _arena_lock
+};
+
+Glib::Threads::Mutex LuaProc::SharedPool::_arena_lock;
+std::vector<LuaProc::SharedPool::Arena*> LuaProc::SharedPool::_arenas;
+
+/* memory used by a TLSF block, including its header */
+static size_t
+arena_block_size (size_t size)
+{
+	const size_t align = 2 * sizeof (void*);
+	if (size == 0) {
+		return 0;
+	}
+	return ((std::max (size, align) + align - 1) & ~(align - 1)) + align;
+}
+
+LuaProc::SharedPool::SharedPool (std::string const& name, size_t quota)
+	: _name (name)
+	, _used (0)
+	, _quota (std::min (quota, lua_arena_capacity))
+	, _charged (_quota / lua_overcommit)
+	, _realtime (false)
+	, _reserve (name, lua_reserve_size)
+{
+	_deferred.reserve (lua_max_deferred);
+	_pools.reserve (4);
+
+	Glib::Threads::Mutex::Lock lm (_arena_lock);
+	Arena* a = find_arena (_charged, _pools);
+	g_atomic_int_add (&a->charged, (gint) _charged);
+	++a->users;
+	_pools.push_back (a);
+}
+
+LuaProc::SharedPool::~SharedPool ()
+{
+	/* the lua_State is closed at this point, all memory was returned */
+	assert (_used == 0);
+	Glib::Threads::Mutex::Lock lm (_arena_lock);
+	g_atomic_int_add (&_pools.front ()->charged, - (gint) _charged);
+	for (std::vector<Arena*>::const_iterator i = _pools.begin (); i != _pools.end (); ++i) {
+		Arena* a = *i;
+		{
+			SpinLock sl (a->lock);
+			free_deferred (a);
+		}
+		if (--a->users == 0) {
+			_arenas.erase (std::find (_arenas.begin (), _arenas.end (), a));
+			delete a;
+		}
+	}
+}
+
+/* called with _arena_lock held */
+LuaProc::SharedPool::Arena*
+LuaProc::SharedPool::find_arena (size_t size, std::vector<Arena*> const& exclude)
+{
+	for (std::vector<Arena*>::const_iterator i = _arenas.begin (); i != _arenas.end (); ++i) {
+		if (std::find (exclude.begin (), exclude.end (), *i) != exclude.end ()) {
+			continue;
+		}
+		if ((size_t) g_atomic_int_get (&(*i)->charged) + size <= lua_arena_capacity) {
+			return *i;
+		}
+	}
+	Arena* a = new Arena ();
+	_arenas.push_back (a);
+	return a;
+}
+
+bool
+LuaProc::SharedPool::arena_full () const
+{
+	return (size_t) g_atomic_int_get (&_pools.front ()->charged) > lua_arena_capacity;
+}
+
+void*
+LuaProc::SharedPool::lalloc (void* p, void* ptr, size_t oldsize, size_t newsize)
+{
+	SharedPool* self = static_cast<SharedPool*> (p);
+	if (!ptr) {
+		/* lua passes the object type as oldsize for new allocations */
+		oldsize = 0;
+	}
+	size_t const oldcost = arena_block_size (oldsize);
+	size_t const newcost = arena_block_size (newsize);
+	if (newcost > oldcost && self->_used + newcost - oldcost > self->_quota) {
+		return NULL;
+	}
+	void* rv = self->realloc (ptr, oldsize, newsize);
+	if (rv || newsize == 0) {
+		self->_used += newcost - oldcost;
+		self->charge ();
+	}
+	return rv;
+}
+
+/* account the peak use to the arena the instance was admitted to */
+void
+LuaProc::SharedPool::charge ()
+{
+	if (_used > _charged) {
+		g_atomic_int_add (&_pools.front ()->charged, (gint) (_used - _charged));
+		_charged = _used;
+	}
+}
+
+LuaProc::SharedPool::Arena*
+LuaProc::SharedPool::owner (void const* ptr) const
+{
+	for (std::vector<Arena*>::const_iterator i = _pools.begin (); i != _pools.end (); ++i) {
+		if ((*i)->pool.owns (ptr)) {
+			return *i;
+		}
+	}
+	assert (0);
+	return 0;
+}
+
+/* called with the lock of @a a held */
+void
+LuaProc::SharedPool::free_deferred (Arena* a)
+{
+	std::vector<void*>::iterator k = _deferred.begin ();
+	for (std::vector<void*>::iterator i = _deferred.begin (); i != _deferred.end (); ++i) {
+		if (a->pool.owns (*i)) {
+			a->pool.free (*i);
+		} else {
+			*k++ = *i;
+		}
+	}
+	_deferred.erase (k, _deferred.end ());
+}
+
+void
+LuaProc::SharedPool::free_later (void* ptr)
+{
+	if (_deferred.size () < lua_max_deferred) {
+		_deferred.push_back (ptr);
+		return;
+	}
+	/* last resort */
+	Arena* a = owner (ptr);
+	SpinLock sl (a->lock);
+	free_deferred (a);
+	a->pool.free (ptr);
+}
+
+void*
+LuaProc::SharedPool::allocate (size_t size)
+{
+	void* rv;
+	bool  busy = false;
+
+	for (std::vector<Arena*>::const_iterator i = _pools.begin (); i != _pools.end (); ++i) {
+		Arena* a = *i;
+		if (!_realtime) {
+			a->lock.lock ();
+		} else if (!a->lock.try_lock ()) {
+			busy = true;
+			continue;
+		}
+		free_deferred (a);
+		rv = a->pool.malloc (size);
+		a->lock.unlock ();
+		if (rv) {
+			return rv;
+		}
+	}
+
+	if (_realtime) {
+		if ((rv = _reserve.malloc (size)) || !busy) {
+			return rv;
+		}
+		/* last resort */
+		for (std::vector<Arena*>::const_iterator i = _pools.begin (); i != _pools.end (); ++i) {
+			SpinLock sl ((*i)->lock);
+			free_deferred (*i);
+			if ((rv = (*i)->pool.malloc (size))) {
+				return rv;
+			}
+		}
+		return NULL;
+	}
+
+	/* all arenas used by this instance are full, continue in another one */
+	Glib::Threads::Mutex::Lock lm (_arena_lock);
+	while (true) {
+		Arena* a = find_arena (size, _pools);
+		++a->users;
+		_pools.push_back (a);
+		SpinLock sl (a->lock);
+		if ((rv = a->pool.malloc (size)) || a->users == 1) {
+			/* a new arena can hold any block up to the quota */
+			return rv;
+		}
+	}
+}
+
+void*
+LuaProc::SharedPool::realloc (void* ptr, size_t oldsize, size_t newsize)
+{
+	void* rv;
+
+	if (!ptr) {
+		return newsize > 0 ? allocate (newsize) : NULL;
+	}
+
+	if (_reserve.owns (ptr)) {
+		/* this instance is the only user of the reserve */
+		rv = _reserve.realloc (ptr, newsize);
+		if (rv || newsize == 0) {
+			return rv;
+		}
+		/* the reserve is full, move to an arena */
+		if ((rv = allocate (newsize))) {
+			memcpy (rv, ptr, std::min (oldsize, newsize));
+			_reserve.free (ptr);
+		}
+		return rv;
+	}
+
+	Arena* a = owner (ptr);
+
+	if (!_realtime) {
+		a->lock.lock ();
+	} else if (!a->lock.try_lock ()) {
+		/* The arena is busy, don't wait in the process thread */
+		if (newsize == 0) {
+			free_later (ptr);
+			return NULL;
+		}
+		if (newsize <= oldsize) {
+			/* keep the block */
+			return ptr;
+		}
+		if ((rv = allocate (newsize))) {
+			memcpy (rv, ptr, oldsize);
+			free_later (ptr);
+		}
+		return rv;
+	}
+
+	free_deferred (a);
+	rv = a->pool.realloc (ptr, newsize);
+	a->lock.unlock ();
+
+	if (rv || newsize == 0) {
+		return rv;
+	}
+
+	/* the arena is full, move the block */
+	if ((rv = allocate (newsize))) {
+		memcpy (rv, ptr, std::min (oldsize, newsize));
+		if (!_realtime) {
+			SpinLock sl (a->lock);
+			a->pool.free (ptr);
+		} else {
+			free_later (ptr);
+		}
+	}
+	return rv;
+}
+#endif
+
 LuaProc::LuaProc (AudioEngine& engine,
                   Session& session,
                   const std::string &script)
 	: Plugin (engine, session)
-	, _mempool ("LuaProc", 3145728)
+	, _mempool ("LuaProc", lua_mempool_size)
 #ifdef USE_TLSF
-	, lua (lua_newstate (&PBD::TLSF::lalloc, &_mempool))
+	, lua (lua_newstate (&SharedPool::lalloc, &_mempool))
 #elif defined USE_MALLOC
 	, lua ()
 #else
@@ -68,6 +383,8 @@ LuaProc::LuaProc (AudioEngine& engine,
 	, _configured (false)
 	, _has_midi_input (false)
 	, _has_midi_output (false)
+	, _gc_threshold (0)
+	, _gc_pending (false)
 {
 	init ();
 
@@ -81,9 +398,9 @@ LuaProc::LuaProc (AudioEngine& engine,
 
 LuaProc::LuaProc (const LuaProc &other)
 	: Plugin (other)
-	, _mempool ("LuaProc", 3145728)
+	, _mempool ("LuaProc", lua_mempool_size)
 #ifdef USE_TLSF
-	, lua (lua_newstate (&PBD::TLSF::lalloc, &_mempool))
+	, lua (lua_newstate (&SharedPool::lalloc, &_mempool))
 #elif defined USE_MALLOC
 	, lua ()
 #else
@@ -102,6 +419,8 @@ LuaProc::LuaProc (const LuaProc &other)
 	, _configured (false)
 	, _has_midi_input (false)
 	, _has_midi_output (false)
+	, _gc_threshold (0)
+	, _gc_pending (false)
 {
 	init ();
 
@@ -235,7 +554,24 @@ LuaProc::load_script ()
 	}
 
 	lua_State* L = lua.getState ();
-	lua.do_command (_script);
+
+	std::string bytecode;
+	{
+		Glib::Threads::Mutex::Lock lm (_bytecode_lock);
+		std::map<std::string, std::string>::const_iterator i = _bytecode_cache.find (_script);
+		if (i != _bytecode_cache.end ()) {
+			bytecode = i->second;
+		}
+	}
+	if (bytecode.empty ()) {
+		if (0 == lua.do_chunk (_script, bytecode) && !bytecode.empty ()) {
+			Glib::Threads::Mutex::Lock lm (_bytecode_lock);
+			_bytecode_cache[_script] = bytecode;
+		}
+	} else {
+		/* skip parsing and compiling the script */
+		lua.do_chunk (_script, bytecode);
+	}
 
 	// check if script has a DSP callback
 	luabridge::LuaRef lua_dsp_run = luabridge::getGlobal (L, "dsp_run");
@@ -390,9 +726,51 @@ LuaProc::load_script ()
 	luabridge::push <float *> (L, _control_data);
 	lua_setglobal (L, "CtrlPorts");
 
+	/* from here on, garbage is only collected by collect_garbage_rt(),
+	 * never as side-effect of an allocation during dsp_run()
+	 */
+	lua.collect_garbage ();
+	lua.stop_auto_gc ();
+	int const live = lua_gc (L, LUA_GCCOUNT, 0);
+	_gc_threshold = live + std::max (live / 2, 64);
+
 	return false; // no error
 }
 
+/* Called once per process cycle. A GC cycle is started once the heap
+ * grew by 50% since the last one completed, and is then advanced in
+ * small increments for at most lua_gc_budget_us per process cycle.
+ * When the instance or its arena is about to run out of memory, the
+ * GC cycle is completed regardless of the budget.
+ */
+void
+LuaProc::collect_garbage_rt ()
+{
+	lua_State* L    = lua.getState ();
+	int const  used = lua_gc (L, LUA_GCCOUNT, 0); // kB
+
+	if (!_gc_pending && used < _gc_threshold) {
+		return;
+	}
+	_gc_pending = true;
+
+#ifdef USE_TLSF
+	bool const urgent = used > (int)(lua_mempool_size / 1024) * 3 / 4 || _mempool.arena_full ();
+#else
+	bool const urgent = used > (int)(lua_mempool_size / 1024) * 3 / 4;
+#endif
+	int64_t const deadline = g_get_monotonic_time () + lua_gc_budget_us;
+
+	do {
+		if (lua.collect_garbage_step ()) {
+			int const live = lua_gc (L, LUA_GCCOUNT, 0);
+			_gc_threshold = live + std::max (live / 2, 64);
+			_gc_pending   = false;
+			break;
+		}
+	} while (urgent || g_get_monotonic_time () < deadline);
+}
+
 bool
 LuaProc::match_variable_io (ChanCount& in, ChanCount& aux_in, ChanCount& out)
 {
@@ -662,6 +1040,10 @@ LuaProc::connect_and_run (BufferSet& bufs,
 	// This is needed for ARDOUR::Session requests :(
 	assert (SessionEvent::has_per_thread_pool ());
 
+#ifdef USE_TLSF
+	PBD::Unwinder<bool> uw (_mempool.realtime (), true);
+#endif
+
 	uint32_t const n = parameter_count ();
 	for (uint32_t i = 0; i < n; ++i) {
 		if (parameter_is_control (i) && parameter_is_input (i)) {
@@ -793,7 +1175,7 @@ LuaProc::connect_and_run (BufferSet& bufs,
 	int64_t t1 = g_get_monotonic_time ();
 #endif
 
-	lua.collect_garbage_step ();
+	collect_garbage_rt ();
 #ifdef WITH_LUAPROC_STATS
 	if (++_stats_cnt > 0) {
 		int64_t t2 = g_get_monotonic_time ();
@@ -52,6 +52,8 @@ PeakMeter::PeakMeter (Session& s, const std::string& name)
 	_pending_active = true;
 	_meter_type     = MeterPeak;
 	_bufcnt         = 0;
+	_input_peaks    = 0;
+	_n_input_peaks  = 0;
 
 	g_atomic_int_set (&_reset_dpm, 1);
 	g_atomic_int_set (&_reset_max, 1);
@@ -92,6 +94,12 @@ PeakMeter::display_name () const
 void
 PeakMeter::run (BufferSet& bufs, samplepos_t /*start_sample*/, samplepos_t /*end_sample*/, double /*speed*/, pframes_t nframes, bool)
 {
+	/* peaks provided by the previous processor are only valid for this cycle */
+	float const* const input_peaks   = _input_peaks;
+	const uint32_t     n_input_peaks = _n_input_peaks;
+	_input_peaks   = 0;
+	_n_input_peaks = 0;
+
 	if (!check_active()) {
 		return;
 	}
@@ -147,7 +155,12 @@ PeakMeter::run (BufferSet& bufs, samplepos_t /*start_sample*/, samplepos_t /*end
 		if (bufs.get_audio (i).silent ()) {
 			_peak_buffer[n] = 0;
 		} else {
-			_peak_buffer[n]     = compute_peak (bufs.get_audio (i).data (), nframes, _peak_buffer[n]);
+			if (i < n_input_peaks) {
+				/* computed while mixing, see set_input_peaks () */
+				_peak_buffer[n] = std::max (input_peaks[i], _peak_buffer[n]);
+			} else {
+				_peak_buffer[n] = compute_peak (bufs.get_audio (i).data (), nframes, _peak_buffer[n]);
+			}
 			_peak_buffer[n]     = std::min (_peak_buffer[n], 100.f); // cut off at +40dBFS for falloff.
 			_max_peak_signal[n] = std::max (_peak_buffer[n], _max_peak_signal[n]);
 		}
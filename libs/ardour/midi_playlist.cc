@@ -29,6 +29,7 @@
 #include "evoral/Control.h"
 
 #include "ardour/debug.h"
+#include "ardour/midi_channel_filter.h"
 #include "ardour/midi_model.h"
 #include "ardour/midi_playlist.h"
 #include "ardour/midi_region.h"
@@ -49,6 +50,10 @@ using namespace std;
 MidiPlaylist::MidiPlaylist (Session& session, const XMLNode& node, bool hidden)
 	: Playlist (session, node, DataType::MIDI, hidden)
 	, _note_mode(Sustained)
+	, _next_render_tag (1)
+	, _rendered_channel_mode (AllChannels)
+	, _rendered_channel_mask (0xffff)
+	, _full_render_pending (true)
 {
 #ifndef NDEBUG
 	XMLProperty const * prop = node.property("type");
@@ -67,12 +72,20 @@ MidiPlaylist::MidiPlaylist (Session& session, const XMLNode& node, bool hidden)
 MidiPlaylist::MidiPlaylist (Session& session, string name, bool hidden)
 	: Playlist (session, name, DataType::MIDI, hidden)
 	, _note_mode(Sustained)
+	, _next_render_tag (1)
+	, _rendered_channel_mode (AllChannels)
+	, _rendered_channel_mask (0xffff)
+	, _full_render_pending (true)
 {
 }
 
 MidiPlaylist::MidiPlaylist (boost::shared_ptr<const MidiPlaylist> other, string name, bool hidden)
 	: Playlist (other, name, hidden)
 	, _note_mode(other->_note_mode)
+	, _next_render_tag (1)
+	, _rendered_channel_mode (AllChannels)
+	, _rendered_channel_mask (0xffff)
+	, _full_render_pending (true)
 {
 }
 
@@ -83,6 +96,10 @@ MidiPlaylist::MidiPlaylist (boost::shared_ptr<const MidiPlaylist> other,
                             bool                                  hidden)
 	: Playlist (other, start, dur, name, hidden)
 	, _note_mode(other->_note_mode)
+	, _next_render_tag (1)
+	, _rendered_channel_mode (AllChannels)
+	, _rendered_channel_mask (0xffff)
+	, _full_render_pending (true)
 {
 }
 
@@ -284,16 +301,57 @@ MidiPlaylist::contained_automation()
 	return ret;
 }
 
+/* EventSink that writes into an RTMidiBuffer, tagging each event */
+struct TaggedRenderSink : public Evoral::EventSink<samplepos_t> {
+	TaggedRenderSink (RTMidiBuffer& b, uint32_t t) : buf (b), tag (t) {}
+
+	uint32_t write (samplepos_t time, Evoral::EventType type, uint32_t size, const uint8_t* data) {
+		return buf.write (time, type, size, data, tag);
+	}
+
+	RTMidiBuffer& buf;
+	uint32_t      tag;
+};
+
 void
-MidiPlaylist::render (MidiChannelFilter* filter)
+MidiPlaylist::set_note_mode (NoteMode m)
+{
+	_note_mode = m;
+
+	Glib::Threads::Mutex::Lock lm (_dirty_lock);
+	_full_render_pending = true;
+}
+
+bool
+MidiPlaylist::region_changed (const PBD::PropertyChange& what_changed, boost::shared_ptr<Region> region)
 {
-	typedef pair<MidiNoteTracker*,samplepos_t> TrackerInfo;
+	/* Playlist::region_changed() ignores changes while loading state or
+	 * flushing notifications, but they still need to be rendered.
+	 */
+
+	PropertyChange render_interests;
+
+	render_interests.add (Properties::contents);
+	render_interests.add (Properties::start);
+	render_interests.add (Properties::length);
+	render_interests.add (Properties::muted);
+
+	if (what_changed.contains (render_interests)) {
+		Glib::Threads::Mutex::Lock lm (_dirty_lock);
+		_dirty_regions.insert (region->id ());
+	}
+
+	return Playlist::region_changed (what_changed, region);
+}
 
+void
+MidiPlaylist::render (MidiChannelFilter* filter)
+{
 	Playlist::RegionReadLock rl (this);
 
 	DEBUG_TRACE (DEBUG::MidiPlaylistIO, string_compose ("---- MidiPlaylist::render (regions: %1)-----\n", regions.size()));
 
-	std::vector< boost::shared_ptr<Region> > regs;
+	RenderList regs;
 
 	for (RegionList::iterator i = regions.begin(); i != regions.end(); ++i) {
 
@@ -310,31 +368,209 @@ MidiPlaylist::render (MidiChannelFilter* filter)
 		regs.push_back (*i);
 	}
 
+	bool full;
+	std::set<PBD::ID> dirty;
+
+	{
+		Glib::Threads::Mutex::Lock lm (_dirty_lock);
+		full = _full_render_pending;
+		_full_render_pending = false;
+		dirty.swap (_dirty_regions);
+	}
+
+	/* Anything that changes how every region is rendered requires
+	 * starting over.
+	 */
+
+	const ChannelMode channel_mode = filter ? filter->get_channel_mode () : AllChannels;
+	const uint16_t    channel_mask = filter ? filter->get_channel_mask () : 0xffff;
+
+	if (channel_mode != _rendered_channel_mode || channel_mask != _rendered_channel_mask) {
+		_rendered_channel_mode = channel_mode;
+		_rendered_channel_mask = channel_mask;
+		full = true;
+	}
+
+	Temporal::TempoMap::SharedPtr tmap (Temporal::TempoMap::use());
+
+	if (tmap != _rendered_tempo_map) {
+		_rendered_tempo_map = tmap;
+		full = true;
+	}
+
+	if (_rendered.reversed()) {
+		full = true;
+	}
+
+	if (full || !render_changed (regs, dirty, filter)) {
+		render_all (regs, filter);
+	}
+
+	DEBUG_TRACE (DEBUG::MidiPlaylistIO, string_compose ("---- End MidiPlaylist::render, events: %1\n", _rendered.size()));
+}
+
+/** Splice only those regions that were added, removed, moved, trimmed or
+ *  edited since the last render into _rendered. Each region is rendered
+ *  without holding the buffer's write lock, which is then only taken for
+ *  the splices themselves.
+ *
+ *  @return false if a full render would be cheaper (or is required).
+ */
+bool
+MidiPlaylist::render_changed (RenderList const & regs, std::set<PBD::ID> const & dirty, MidiChannelFilter* filter)
+{
+	if (_rendered_regions.empty()) {
+		return false;
+	}
+
+	RenderedRegions now;
+	std::vector<boost::shared_ptr<MidiRegion> > changed;
+	std::vector<RenderedRegion> removed;
+
+	for (RenderList::const_iterator i = regs.begin(); i != regs.end(); ++i) {
+
+		boost::shared_ptr<MidiRegion> mr = boost::dynamic_pointer_cast<MidiRegion>(*i);
+
+		if (!mr) {
+			continue;
+		}
+
+		RenderedRegion rr;
+
+		rr.start = mr->position().samples();
+		rr.end = mr->end().samples();
+		rr.source_start = mr->start();
+		rr.model = mr->model().get();
+
+		RenderedRegions::const_iterator prev = _rendered_regions.find (mr->id());
+
+		if (prev == _rendered_regions.end()) {
+			rr.tag = _next_render_tag++;
+			changed.push_back (mr);
+		} else {
+			rr.tag = prev->second.tag;
+			if (dirty.find (mr->id()) != dirty.end() ||
+			    rr.start != prev->second.start ||
+			    rr.end != prev->second.end ||
+			    rr.source_start != prev->second.source_start ||
+			    rr.model != prev->second.model) {
+				changed.push_back (mr);
+			}
+		}
+
+		now.insert (make_pair (mr->id(), rr));
+	}
+
+	for (RenderedRegions::const_iterator r = _rendered_regions.begin(); r != _rendered_regions.end(); ++r) {
+		if (now.find (r->first) == now.end()) {
+			removed.push_back (r->second);
+		}
+	}
+
+	if (changed.empty() && removed.empty()) {
+		DEBUG_TRACE (DEBUG::MidiPlaylistIO, "\tnothing changed\n");
+		return true;
+	}
+
+	/* every splice moves the rest of the buffer, so past some point
+	 * starting from scratch is faster.
+	 */
+
+	if (changed.size() + removed.size() > std::max ((size_t) 8, now.size() / 4)) {
+		return false;
+	}
+
+	DEBUG_TRACE (DEBUG::MidiPlaylistIO, string_compose ("\tsplicing %1 changed and %2 removed regions\n", changed.size(), removed.size()));
+
+	std::vector<boost::shared_ptr<RTMidiBuffer> > rendered;
+
+	for (std::vector<boost::shared_ptr<MidiRegion> >::const_iterator i = changed.begin(); i != changed.end(); ++i) {
+		boost::shared_ptr<RTMidiBuffer> buf (new RTMidiBuffer);
+		DEBUG_TRACE (DEBUG::MidiPlaylistIO, string_compose ("render from %1\n", (*i)->name()));
+		(*i)->render (*buf, 0, _note_mode, filter);
+		rendered.push_back (buf);
+	}
+
+	RTMidiBuffer nothing;
+
+	/* RAII */
+	RTMidiBuffer::WriteProtectRender wpr (_rendered);
+	wpr.acquire ();
+
+	for (std::vector<RenderedRegion>::const_iterator r = removed.begin(); r != removed.end(); ++r) {
+		_rendered.splice (nothing, r->tag, r->start, r->end);
+	}
+
+	for (size_t n = 0; n < changed.size(); ++n) {
+
+		RenderedRegion const & rr (now[changed[n]->id()]);
+		RenderedRegions::const_iterator prev = _rendered_regions.find (changed[n]->id());
+
+		samplepos_t start = rr.start;
+		samplepos_t end = rr.end;
+
+		if (prev != _rendered_regions.end()) {
+			/* remove anything left from where the region used to be */
+			start = std::min (start, prev->second.start);
+			end = std::max (end, prev->second.end);
+		}
+
+		_rendered.splice (*rendered[n], rr.tag, start, end);
+	}
+
+	_rendered_regions.swap (now);
+
+	return true;
+}
+
+void
+MidiPlaylist::render_all (RenderList const & regs, MidiChannelFilter* filter)
+{
+	/* Assign a tag to each region, keeping those already known */
+
+	RenderedRegions now;
+
+	for (RenderList::const_iterator i = regs.begin(); i != regs.end(); ++i) {
+
+		boost::shared_ptr<MidiRegion> mr = boost::dynamic_pointer_cast<MidiRegion>(*i);
+
+		if (!mr) {
+			continue;
+		}
+
+		RenderedRegion rr;
+		RenderedRegions::const_iterator prev = _rendered_regions.find (mr->id());
+
+		rr.tag = (prev == _rendered_regions.end()) ? _next_render_tag++ : prev->second.tag;
+		rr.start = mr->position().samples();
+		rr.end = mr->end().samples();
+		rr.source_start = mr->start();
+		rr.model = mr->model().get();
+
+		now.insert (make_pair (mr->id(), rr));
+	}
+
 	/* If we are reading from a single region, we can read directly into _rendered.  Otherwise,
 	   we read into a temporarily list, sort it, then write that to _rendered.
 	*/
 	Evoral::EventList<samplepos_t>  evlist;
-	Evoral::EventSink<samplepos_t>* tgt;
 
 	/* RAII */
 	RTMidiBuffer::WriteProtectRender wpr (_rendered);
 
-	if (regs.empty()) {
+	if (now.empty()) {
 		wpr.acquire ();
 		_rendered.clear ();
 	} else {
 
-		if (regs.size() == 1) {
-			tgt = &_rendered;
+		DEBUG_TRACE (DEBUG::MidiPlaylistIO, string_compose ("\t%1 regions to read, direct: %2\n", now.size(), (now.size() == 1)));
+
+		if (now.size() == 1) {
 			wpr.acquire ();
 			_rendered.clear ();
-		} else {
-			tgt = &evlist;
 		}
 
-		DEBUG_TRACE (DEBUG::MidiPlaylistIO, string_compose ("\t%1 regions to read, direct: %2\n", regs.size(), (regs.size() == 1)));
-
-		for (vector<boost::shared_ptr<Region> >::iterator i = regs.begin(); i != regs.end(); ++i) {
+		for (RenderList::const_iterator i = regs.begin(); i != regs.end(); ++i) {
 
 			boost::shared_ptr<MidiRegion> mr = boost::dynamic_pointer_cast<MidiRegion>(*i);
 
@@ -342,8 +578,24 @@ MidiPlaylist::render (MidiChannelFilter* filter)
 				continue;
 			}
 
+			const uint32_t tag = now[mr->id()].tag;
+
 			DEBUG_TRACE (DEBUG::MidiPlaylistIO, string_compose ("render from %1\n", mr->name()));
-			mr->render (*tgt, 0, _note_mode, filter);
+
+			if (now.size() == 1) {
+				TaggedRenderSink sink (_rendered, tag);
+				mr->render (sink, 0, _note_mode, filter);
+			} else {
+				/* the event ID carries the tag until the events are
+				 * written to _rendered below.
+				 */
+				Evoral::EventList<samplepos_t> region_events;
+				mr->render (region_events, 0, _note_mode, filter);
+				for (Evoral::EventList<samplepos_t>::iterator e = region_events.begin(); e != region_events.end(); ++e) {
+					(*e)->set_id (tag);
+				}
+				evlist.splice (evlist.end(), region_events);
+			}
 		}
 
 		if (!evlist.empty()) {
@@ -358,15 +610,18 @@ MidiPlaylist::render (MidiChannelFilter* filter)
 
 			for (Evoral::EventList<samplepos_t>::iterator e = evlist.begin(); e != evlist.end(); ++e) {
 				Evoral::Event<samplepos_t>* ev (*e);
-				_rendered.write (ev->time(), ev->event_type(), ev->size(), ev->buffer());
+				_rendered.write (ev->time(), ev->event_type(), ev->size(), ev->buffer(), ev->id());
 				delete ev;
 			}
+		} else if (now.size() > 1) {
+			wpr.acquire ();
+			_rendered.clear ();
 		}
 	}
 
 	/* no need to release - RAII with WriteProtectRender takes care of it */
 
-	DEBUG_TRACE (DEBUG::MidiPlaylistIO, string_compose ("---- End MidiPlaylist::render, events: %1\n", _rendered.size()));
+	_rendered_regions.swap (now);
 }
 
 RTMidiBuffer*
@@ -145,6 +145,83 @@ default_copy_vector (ARDOUR::Sample * dst, const ARDOUR::Sample * src, pframes_t
 	memcpy(dst, src, nframes*sizeof(ARDOUR::Sample));
 }
 
+float
+default_apply_gain_ramp_to_buffer (ARDOUR::Sample * buf, pframes_t nframes, float initial, float target, float coeff)
+{
+	float g = initial;
+	for (pframes_t i = 0; i < nframes; ++i) {
+		buf[i] *= g;
+		g += coeff * (target - g);
+	}
+	return g;
+}
+
+void
+default_apply_gain_vector_to_buffer (ARDOUR::Sample * buf, const ARDOUR::gain_t * gain, pframes_t nframes)
+{
+	for (pframes_t i = 0; i < nframes; ++i) {
+		buf[i] *= gain[i];
+	}
+}
+
+void
+default_invert_buffer (ARDOUR::Sample * buf, pframes_t nframes)
+{
+	for (pframes_t i = 0; i < nframes; ++i) {
+		buf[i] = -buf[i];
+	}
+}
+
+void
+default_interleave_buffer (ARDOUR::Sample * dst, const ARDOUR::Sample * src, pframes_t nframes, uint32_t chn, uint32_t n_chn)
+{
+	dst += chn;
+	for (pframes_t i = 0; i < nframes; ++i) {
+		*dst = src[i];
+		dst += n_chn;
+	}
+}
+
+void
+default_deinterleave_buffer (ARDOUR::Sample * dst, const ARDOUR::Sample * src, pframes_t nframes, uint32_t chn, uint32_t n_chn)
+{
+	src += chn;
+	for (pframes_t i = 0; i < nframes; ++i) {
+		dst[i] = *src;
+		src += n_chn;
+	}
+}
+
+float
+default_mix_buffers_no_gain_and_peak (ARDOUR::Sample * dst, const ARDOUR::Sample * src, pframes_t nframes, float current)
+{
+	for (pframes_t i = 0; i < nframes; ++i) {
+		dst[i] += src[i];
+		current = f_max (current, fabsf (dst[i]));
+	}
+	return current;
+}
+
+float
+default_mix_buffers_with_gain_and_peak (ARDOUR::Sample * dst, const ARDOUR::Sample * src, pframes_t nframes, float gain, float current)
+{
+	for (pframes_t i = 0; i < nframes; ++i) {
+		dst[i] += src[i] * gain;
+		current = f_max (current, fabsf (dst[i]));
+	}
+	return current;
+}
+
+float
+default_copy_vector_with_gain_and_peak (ARDOUR::Sample * dst, const ARDOUR::Sample * src, pframes_t nframes, float gain, float current)
+{
+	for (pframes_t i = 0; i < nframes; ++i) {
+		dst[i] = src[i] * gain;
+		current = f_max (current, fabsf (dst[i]));
+	}
+	return current;
+}
+
 #if defined (__APPLE__) && defined (BUILD_VECLIB_OPTIMIZATIONS)
 #include <Accelerate/Accelerate.h>
 
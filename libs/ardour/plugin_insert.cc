@@ -29,6 +29,7 @@
 #include <string>
 
 #include "pbd/failed_constructor.h"
+#include "pbd/microseconds.h"
 #include "pbd/xml++.h"
 #include "pbd/types_convert.h"
 
@@ -43,6 +44,7 @@
 #include "ardour/plugin.h"
 #include "ardour/plugin_insert.h"
 #include "ardour/port.h"
+#include "ardour/rt_tasklist.h"
 
 #ifdef WINDOWS_VST_SUPPORT
 #include "ardour/windows_vst_plugin.h"
@@ -90,6 +92,9 @@ PluginInsert::PluginInsert (Session& s, Temporal::TimeDomain td, boost::shared_p
 	, _latency_changed (false)
 	, _bypass_port (UINT32_MAX)
 	, _inverted_bypass_enable (false)
+	, _parallel_ok (false)
+	, _run_parallel (false)
+	, _instance_failed (false)
 {
 	g_atomic_int_set (&_stat_reset, 0);
 	g_atomic_int_set (&_flush, 0);
@@ -1103,6 +1108,46 @@ PluginInsert::connect_and_run (BufferSet& bufs, samplepos_t start, samplepos_t e
 				}
 			}
 		}
+	} else if (_parallel_ok && bufs.count ().n_midi () == 0 && _instance_dsp.size () == _plugins.size () && Config->get_parallel_replicated_plugins ()) {
+		/* in-place processing of replicated instances, each
+		 * instance only uses its own buffers (see check_parallel) */
+		InstanceCycle ic = { &bufs, &in_map, &out_map, start, end, speed, nframes, offset };
+		_instance_cycle = ic;
+		_instance_failed.store (false);
+
+		boost::shared_ptr<RTTaskList> tl;
+		if (_run_parallel) {
+			tl = _session.rt_tasklist ();
+		}
+
+		if (tl && tl->try_acquire ()) {
+			for (uint32_t pc = 0; pc < _plugins.size (); ++pc) {
+				tl->push_back (boost::bind (&PluginInsert::run_instance, this, pc));
+			}
+			tl->process ();
+			tl->release ();
+		} else {
+			/* the task list is in use by another route, or the
+			 * instances are too cheap to be worth the overhead */
+			for (uint32_t pc = 0; pc < _plugins.size (); ++pc) {
+				run_instance (pc);
+			}
+		}
+
+		/* go parallel above the threshold, fall back to serial
+		 * processing below half of it */
+		float dsp = 0;
+		for (std::vector<float>::const_iterator i = _instance_dsp.begin (); i != _instance_dsp.end (); ++i) {
+			dsp += *i;
+		}
+		dsp /= _instance_dsp.size ();
+		const float threshold = Config->get_parallel_plugin_threshold ();
+		_run_parallel = dsp > (_run_parallel ? .5f * threshold : threshold);
+
+		if (_instance_failed.load ()) {
+			deactivate ();
+		}
+		inplace_silence_unconnected (bufs, _out_map, nframes, offset);
 	} else {
 		/* in-place processing */
 		uint32_t pc = 0;
@@ -1148,6 +1193,27 @@ PluginInsert::connect_and_run (BufferSet& bufs, samplepos_t start, samplepos_t e
 	}
 }
 
+/** Run a single replicated instance in-place, called from connect_and_run ()
+ * either directly or from a RTTaskList worker thread.
+ */
+void
+PluginInsert::run_instance (uint32_t pc)
+{
+	InstanceCycle const& ic (_instance_cycle);
+
+	const PBD::microseconds_t t0 = PBD::get_microseconds ();
+
+	if (_plugins[pc]->connect_and_run (*ic.bufs, ic.start, ic.end, ic.speed, ic.in_map->p (pc), ic.out_map->p (pc), ic.nframes, ic.offset)) {
+		_instance_failed.store (true);
+	}
+
+	const PBD::microseconds_t t1 = PBD::get_microseconds ();
+	if (t1 > t0) {
+		/* moving average, each slot is only written by the thread running the instance */
+		_instance_dsp[pc] += .05f * ((float)(t1 - t0) - _instance_dsp[pc]);
+	}
+}
+
 void
 PluginInsert::bypass (BufferSet& bufs, pframes_t nframes)
 {
@@ -1666,6 +1732,7 @@ PluginInsert::mapping_changed ()
 {
 	PluginMapChanged (); /* EMIT SIGNAL */
 	_no_inplace = check_inplace ();
+	_parallel_ok = check_parallel ();
 	_session.set_dirty();
 }
 
@@ -1756,6 +1823,57 @@ PluginInsert::check_inplace ()
 	return !inplace_ok; // no-inplace
 }
 
+/** Check if replicated instances can be processed concurrently.
+ *
+ * This requires in-place processing, and that no instance writes
+ * to a buffer which is used by any other instance.
+ */
+bool
+PluginInsert::check_parallel () const
+{
+	if (_match.method != Replicate || get_count () < 2 || _no_inplace) {
+		return false;
+	}
+
+	if (natural_input_streams ().n_midi () > 0 || natural_output_streams ().n_midi () > 0) {
+		return false;
+	}
+
+	std::map<uint32_t, uint32_t> writer; // buffer-idx -> instance
+
+	for (uint32_t pc = 0; pc < get_count (); ++pc) {
+		for (uint32_t out = 0; out < natural_output_streams ().n_audio (); ++out) {
+			bool valid;
+			uint32_t idx = _out_map.p (pc).get (DataType::AUDIO, out, &valid);
+			if (!valid) {
+				continue;
+			}
+			std::map<uint32_t, uint32_t>::const_iterator w = writer.find (idx);
+			if (w != writer.end () && w->second != pc) {
+				return false;
+			}
+			writer[idx] = pc;
+		}
+	}
+
+	for (uint32_t pc = 0; pc < get_count (); ++pc) {
+		for (uint32_t in = 0; in < natural_input_streams ().n_audio (); ++in) {
+			bool valid;
+			uint32_t idx = _in_map.p (pc).get (DataType::AUDIO, in, &valid);
+			if (!valid) {
+				continue;
+			}
+			std::map<uint32_t, uint32_t>::const_iterator w = writer.find (idx);
+			if (w != writer.end () && w->second != pc) {
+				return false;
+			}
+		}
+	}
+
+	DEBUG_TRACE (DEBUG::ChanMapping, string_compose ("%1: replicated instances may run in parallel\n", name()));
+	return true;
+}
+
 bool
 PluginInsert::sanitize_maps ()
 {
@@ -2120,6 +2238,9 @@ PluginInsert::configure_io (ChanCount in, ChanCount out)
 	}
 
 	_no_inplace = check_inplace ();
+	_parallel_ok = check_parallel ();
+	_instance_dsp.assign (get_count (), 0.f);
+	_run_parallel = false;
 
 	/* only the "noinplace_buffers" thread buffers need to be this large,
 	 * this can be optimized. other buffers are fine with
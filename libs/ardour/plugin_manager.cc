@@ -69,6 +69,7 @@
 #include <glibmm/fileutils.h>
 
 #include "pbd/convert.h"
+#include "pbd/cpus.h"
 #include "pbd/file_utils.h"
 #include "pbd/tokenizer.h"
 #include "pbd/whitespace.h"
@@ -189,6 +190,7 @@ PluginManager::PluginManager ()
 	, _cancel_scan_timeout_one (false)
 	, _cancel_scan_timeout_all (false)
 	, _enable_scan_timeout (false)
+	, _n_changed (0)
 {
 	char* s;
 	string lrdf_path;
@@ -354,7 +356,10 @@ PluginManager::~PluginManager()
 bool
 PluginManager::cache_valid () const
 {
-	return Config->get_plugin_cache_version () >= cache_version ();
+	/* _n_changed is counted while indexing, so this does not need to
+	 * look at any plugin module.
+	 */
+	return Config->get_plugin_cache_version () >= cache_version () && _n_changed == 0;
 }
 
 uint32_t
@@ -465,6 +470,8 @@ PluginManager::refresh (bool cache_only)
 	}
 
 	load_scanlog ();
+	load_scan_index ();
+	_n_changed = 0;
 
 	DEBUG_TRACE (DEBUG::PluginManager, "PluginManager::refresh\n");
 	reset_scan_cancel_state ();
@@ -595,7 +602,7 @@ PluginManager::refresh (bool cache_only)
 		}
 	}
 
-	if (!cache_only && !cache_valid () && !cancelled ()) {
+	if (!cache_only && Config->get_plugin_cache_version () < cache_version () && !cancelled ()) {
 		Config->set_plugin_cache_version (cache_version ());
 		Config->save_state();
 	}
@@ -1635,6 +1642,11 @@ PluginManager::vst2_discover (string path, ARDOUR::PluginType type, bool cache_o
 
 	string cache_file = vst2_valid_cache_file (path, false, &is_new);
 
+	if (!cache_file.empty () && module_changed (path)) {
+		/* the plugin was replaced, but the cache file is newer */
+		cache_file = "";
+	}
+
 	if (!cache_only && vst2_scanner_bin_path.empty () && cache_file.empty ()) {
 		/* scan in host context */
 		psle->reset ();
@@ -1649,6 +1661,7 @@ PluginManager::vst2_discover (string path, ARDOUR::PluginType type, bool cache_o
 		}
 		psle->msg (PluginScanLogEntry::OK, string_compose (_("Saved VST2 plugin cache to '%1'"), vst2_cache_file (path)));
 		vst2_whitelist (path);
+		index_module (path);
 		return 0;
 	}
 
@@ -1697,6 +1710,7 @@ PluginManager::vst2_discover (string path, ARDOUR::PluginType type, bool cache_o
 		 * or cache file is invalid (scan needed)
 		 */
 		psle->msg (is_new ? PluginScanLogEntry::New : PluginScanLogEntry::Updated);
+		++_n_changed;
 		return -1;
 	}
 
@@ -1717,6 +1731,7 @@ PluginManager::vst2_discover (string path, ARDOUR::PluginType type, bool cache_o
 	}
 
 	vst2_whitelist (path);
+	index_module (path);
 	psle->set_result (PluginScanLogEntry::OK);
 
 	uint32_t discovered = 0;
@@ -1785,9 +1800,17 @@ PluginManager::windows_vst_discover_from_path (string path, bool cache_only)
 	sort (plugin_objects.begin (), plugin_objects.end ());
 	plugin_objects.erase (unique (plugin_objects.begin (), plugin_objects.end ()), plugin_objects.end ());
 
+	std::set<string> failed;
+	if (!cache_only) {
+		run_scanner_apps (Windows_VST, plugin_objects, failed);
+	}
+
 	size_t n = 1;
 	size_t all_modules = plugin_objects.size ();
 	for (x = plugin_objects.begin(); x != plugin_objects.end (); ++x, ++n) {
+		if (failed.find (*x) != failed.end ()) {
+			continue;
+		}
 		reset_scan_cancel_state (true);
 		ARDOUR::PluginScanMessage (string_compose (_("VST2 (%1 / %2)"), n, all_modules), *x, !cache_only && !cancelled());
 		vst2_discover (*x, Windows_VST, cache_only || cancelled());
@@ -1868,9 +1891,17 @@ PluginManager::mac_vst_discover_from_path (string path, bool cache_only)
 	sort (plugin_objects.begin (), plugin_objects.end ());
 	plugin_objects.erase (unique (plugin_objects.begin (), plugin_objects.end ()), plugin_objects.end ());
 
+	std::set<string> failed;
+	if (!cache_only) {
+		run_scanner_apps (MacVST, plugin_objects, failed);
+	}
+
 	size_t n = 1;
 	size_t all_modules = plugin_objects.size ();
 	for (x = plugin_objects.begin(); x != plugin_objects.end (); ++x, ++n) {
+		if (failed.find (*x) != failed.end ()) {
+			continue;
+		}
 		reset_scan_cancel_state (true);
 		ARDOUR::PluginScanMessage (string_compose (_("VST2 (%1 / %2)"), n, all_modules), *x, !cache_only && !cancelled());
 		vst2_discover (*x, MacVST, cache_only || cancelled());
@@ -1928,9 +1959,17 @@ PluginManager::lxvst_discover_from_path (string path, bool cache_only)
 	sort (plugin_objects.begin (), plugin_objects.end ());
 	plugin_objects.erase (unique (plugin_objects.begin (), plugin_objects.end ()), plugin_objects.end ());
 
+	std::set<string> failed;
+	if (!cache_only) {
+		run_scanner_apps (LXVST, plugin_objects, failed);
+	}
+
 	size_t n = 1;
 	size_t all_modules = plugin_objects.size ();
 	for (x = plugin_objects.begin(); x != plugin_objects.end (); ++x, ++n) {
+		if (failed.find (*x) != failed.end ()) {
+			continue;
+		}
 		reset_scan_cancel_state (true);
 		ARDOUR::PluginScanMessage (string_compose (_("VST2 (%1 / %2)"), n, all_modules), *x, !cache_only && !cancelled());
 		vst2_discover (*x, LXVST, cache_only || cancelled());
@@ -2074,9 +2113,17 @@ PluginManager::vst3_discover_from_path (string const& path, bool cache_only)
 
 	find_paths_matching_filter (plugin_objects, paths, vst3_filter, 0, false, true, true);
 
+	std::set<string> failed;
+	if (!cache_only) {
+		run_scanner_apps (VST3, plugin_objects, failed);
+	}
+
 	size_t n = 1;
 	size_t all_modules = plugin_objects.size ();
 	for (vector<string>::iterator i = plugin_objects.begin(); i != plugin_objects.end (); ++i, ++n) {
+		if (failed.find (*i) != failed.end ()) {
+			continue;
+		}
 		reset_scan_cancel_state (true);
 		ARDOUR::PluginScanMessage (string_compose (_("VST3 (%1 / %2)"), n, all_modules), *i, !cache_only && !cancelled());
 		vst3_discover (*i, cache_only || cancelled ());
@@ -2140,6 +2187,11 @@ PluginManager::vst3_discover (string const& path, bool cache_only)
 
 	string cache_file = vst3_valid_cache_file (module_path, false, &is_new);
 
+	if (!cache_file.empty () && module_changed (module_path)) {
+		/* the plugin was replaced, but the cache file is newer */
+		cache_file = "";
+	}
+
 	if (!cache_only && vst3_scanner_bin_path.empty () && cache_file.empty ()) {
 		/* scan in host context */
 		psle->reset ();
@@ -2153,6 +2205,7 @@ PluginManager::vst3_discover (string const& path, bool cache_only)
 		}
 		psle->msg (PluginScanLogEntry::OK, string_compose (_("Saved VST3 plugin cache to '%1'"), vst3_cache_file (module_path)));
 		vst3_whitelist (module_path);
+		index_module (module_path);
 		return 0;
 	}
 
@@ -2202,6 +2255,7 @@ PluginManager::vst3_discover (string const& path, bool cache_only)
 		 * or cache file is invalid (scan needed)
 		 */
 		psle->msg (is_new ? PluginScanLogEntry::New : PluginScanLogEntry::Updated);
+		++_n_changed;
 		return -1;
 	}
 
@@ -2216,6 +2270,7 @@ PluginManager::vst3_discover (string const& path, bool cache_only)
 	}
 
 	vst3_whitelist (module_path);
+	index_module (module_path);
 	psle->set_result (PluginScanLogEntry::OK);
 
 	for (XMLNodeConstIterator i = tree.root()->children().begin(); i != tree.root()->children().end(); ++i) {
@@ -2301,6 +2356,273 @@ PluginManager::run_vst3_scanner_app (std::string bundle_path, PSLEPtr psle) cons
 
 #endif // VST3_SUPPORT
 
+#if (defined WINDOWS_VST_SUPPORT || defined MACVST_SUPPORT || defined LXVST_SUPPORT || defined VST3_SUPPORT)
+
+namespace {
+
+/* One external scanner process, see PluginManager::run_scanner_apps() */
+struct ScanJob {
+	ScanJob (std::string const& p, std::string const& m, boost::shared_ptr<PluginScanLogEntry> l)
+		: path (p)
+		, module_path (m)
+		, psle (l)
+		, scanner (0)
+		, timeout (0)
+		, notime (true)
+	{}
+
+	~ScanJob ()
+	{
+		connection.disconnect ();
+		delete scanner;
+	}
+
+	std::string                           path;
+	std::string                           module_path;
+	boost::shared_ptr<PluginScanLogEntry> psle;
+	ARDOUR::SystemExec*                   scanner;
+	std::stringstream                     log;
+	PBD::ScopedConnection                 connection;
+	int                                   timeout; /* deciseconds */
+	bool                                  notime;
+};
+
+}
+
+static void scan_job_log (std::string msg, std::stringstream* ss)
+{
+	*ss << msg;
+}
+
+static void
+scan_job_set_blacklisted (PluginType type, std::string const& module_path, bool yn)
+{
+	switch (type) {
+#if (defined WINDOWS_VST_SUPPORT || defined MACVST_SUPPORT || defined LXVST_SUPPORT)
+		case Windows_VST:
+		case LXVST:
+		case MacVST:
+			if (yn) {
+				vst2_blacklist (module_path);
+			} else {
+				vst2_whitelist (module_path);
+			}
+			break;
+#endif
+#ifdef VST3_SUPPORT
+		case VST3:
+			if (yn) {
+				vst3_blacklist (module_path);
+			} else {
+				vst3_whitelist (module_path);
+			}
+			break;
+#endif
+		default:
+			break;
+	}
+}
+
+static std::string
+scan_job_cache_file (PluginType type, std::string const& module_path, bool only_valid)
+{
+	switch (type) {
+#if (defined WINDOWS_VST_SUPPORT || defined MACVST_SUPPORT || defined LXVST_SUPPORT)
+		case Windows_VST:
+		case LXVST:
+		case MacVST:
+			return only_valid ? vst2_valid_cache_file (module_path) : vst2_cache_file (module_path);
+#endif
+#ifdef VST3_SUPPORT
+		case VST3:
+			return only_valid ? vst3_valid_cache_file (module_path) : vst3_cache_file (module_path);
+#endif
+		default:
+			break;
+	}
+	return "";
+}
+
+bool
+PluginManager::needs_external_scan (PluginType type, std::string const& path) const
+{
+	switch (type) {
+#if (defined WINDOWS_VST_SUPPORT || defined MACVST_SUPPORT || defined LXVST_SUPPORT)
+		case Windows_VST:
+		case LXVST:
+		case MacVST:
+			if (vst2_scanner_bin_path.empty () || vst2_is_blacklisted (path)) {
+				return false;
+			}
+			return vst2_valid_cache_file (path).empty () || module_changed (path);
+#endif
+#ifdef VST3_SUPPORT
+		case VST3:
+			{
+				std::string module_path = module_path_vst3 (path);
+				if (vst3_scanner_bin_path.empty () || module_path.empty () || vst3_is_blacklisted (module_path)) {
+					return false;
+				}
+				return vst3_valid_cache_file (module_path).empty () || module_changed (module_path);
+			}
+#endif
+		default:
+			break;
+	}
+	return false;
+}
+
+/* Run the external scanner app for all of @param paths that need to be
+ * (re)scanned, with up to plugin-scan-jobs processes at a time. This only
+ * produces cache files, which vst2_discover() and vst3_discover() then
+ * read as usual. Modules that failed to scan are added to @param failed,
+ * and should not be discovered again.
+ */
+void
+PluginManager::run_scanner_apps (PluginType type, std::vector<std::string> const& paths, std::set<std::string>& failed)
+{
+	uint32_t n_jobs = Config->get_plugin_scan_jobs ();
+	if (n_jobs == 0) {
+		n_jobs = hardware_concurrency ();
+	}
+	if (n_jobs < 2) {
+		return;
+	}
+
+	std::vector<std::string> todo;
+	for (std::vector<std::string>::const_iterator i = paths.begin(); i != paths.end (); ++i) {
+		if (needs_external_scan (type, *i)) {
+			todo.push_back (*i);
+		}
+	}
+
+	if (todo.size () < 2) {
+		/* nothing to gain, scan in vst2/3_discover() */
+		return;
+	}
+
+	const bool        vst3 = (type == VST3);
+	const std::string bin  = vst3 ? vst3_scanner_bin_path : vst2_scanner_bin_path;
+
+	DEBUG_TRACE (DEBUG::PluginManager, string_compose ("Scanning %1 modules with up to %2 concurrent scanner processes\n", todo.size (), n_jobs));
+
+	typedef std::list<boost::shared_ptr<ScanJob> > ScanJobs;
+	ScanJobs running;
+
+	std::vector<std::string>::const_iterator next = todo.begin ();
+	size_t n_done = 0;
+
+	while (next != todo.end () || !running.empty ()) {
+
+		while (running.size () < n_jobs && next != todo.end () && !_cancel_scan_all) {
+
+			std::string const& path = *next++;
+			boost::shared_ptr<ScanJob> job (new ScanJob (path, vst3 ? module_path_vst3 (path) : path, scan_log_entry (type, path)));
+
+			job->psle->reset ();
+			scan_job_set_blacklisted (type, job->module_path, true);
+			if (vst3) {
+				job->psle->msg (PluginScanLogEntry::OK, string_compose ("VST3 module-path '%1'", job->module_path));
+			}
+
+			char **argp= (char**) calloc (5, sizeof (char*));
+			argp[0] = strdup (bin.c_str ());
+			argp[1] = strdup ("-f");
+			if (Config->get_verbose_plugin_scan()) {
+				argp[2] = strdup ("-v");
+			} else {
+				argp[2] = strdup ("-f");
+			}
+			argp[3] = strdup (path.c_str ());
+			argp[4] = 0;
+
+			job->scanner = new ARDOUR::SystemExec (bin, argp);
+			job->scanner->ReadStdout.connect_same_thread (job->connection, boost::bind (&scan_job_log, _1, &job->log));
+
+			if (job->scanner->start (ARDOUR::SystemExec::MergeWithStdin)) {
+				job->psle->msg (PluginScanLogEntry::Error, string_compose (_("Cannot launch VST scanner app '%1': %2"), bin, strerror (errno)));
+				failed.insert (path);
+				++n_done;
+				continue;
+			}
+
+			job->timeout = _enable_scan_timeout ? 1 + Config->get_plugin_scan_timeout() : 0; /* deciseconds */
+			job->notime  = (job->timeout <= 0);
+			running.push_back (job);
+
+			ARDOUR::PluginScanMessage (string_compose (vst3 ? _("VST3 (%1 / %2)") : _("VST2 (%1 / %2)"), n_done + running.size (), todo.size ()), path, !cancelled());
+		}
+
+		if (running.empty ()) {
+			break;
+		}
+
+		/* report the job that is closest to timing out */
+		int timeout = running.front ()->timeout;
+
+		for (ScanJobs::iterator j = running.begin (); j != running.end (); ++j) {
+			ScanJob& job (**j);
+			if (!job.notime && no_timeout ()) {
+				job.notime = true;
+				job.timeout = -1;
+			} else if (job.notime && !no_timeout() && _enable_scan_timeout) {
+				job.notime = false;
+				job.timeout = 1 + Config->get_plugin_scan_timeout ();
+			}
+			if (job.timeout > -864000) {
+				--job.timeout;
+			}
+			if (!job.notime && (timeout <= 0 || job.timeout < timeout)) {
+				timeout = job.timeout;
+			}
+		}
+
+		ARDOUR::PluginScanTimeout (timeout);
+		Glib::usleep (100000);
+
+		for (ScanJobs::iterator j = running.begin (); j != running.end ();) {
+			ScanJob& job (**j);
+
+			if (!job.scanner->is_running ()) {
+				job.psle->msg (PluginScanLogEntry::OK, job.log.str());
+				if (scan_job_cache_file (type, job.module_path, true).empty ()) {
+					job.psle->msg (PluginScanLogEntry::Error, _("Scan Failed."));
+					job.psle->msg (PluginScanLogEntry::Blacklisted);
+					failed.insert (job.path);
+				} else {
+					scan_job_set_blacklisted (type, job.module_path, false);
+					index_module (job.module_path);
+				}
+			} else if (cancelled () || (!job.notime && job.timeout == 0)) {
+				job.scanner->terminate ();
+				job.psle->msg (PluginScanLogEntry::OK, job.log.str());
+				if (cancelled ()) {
+					job.psle->msg (PluginScanLogEntry::New, "Scan was cancelled.");
+				} else {
+					job.psle->msg (PluginScanLogEntry::TimeOut, "Scan Timed Out.");
+				}
+				/* may be partially written */
+				g_unlink (scan_job_cache_file (type, job.module_path, false).c_str ());
+				scan_job_set_blacklisted (type, job.module_path, false);
+				failed.insert (job.path);
+			} else {
+				++j;
+				continue;
+			}
+
+			++n_done;
+			j = running.erase (j);
+		}
+
+		if (_cancel_scan_one) {
+			/* "skip" applies to the modules that were being scanned */
+			reset_scan_cancel_state (true);
+		}
+	}
+}
+
+#endif
+
 PluginManager::PluginStatusType
 PluginManager::get_status (const PluginInfoPtr& pi) const
 {
@@ -3409,4 +3731,82 @@ PluginManager::save_scanlog ()
 	if (!tree.write (path)) {
 		error << string_compose (_("Could not save Plugin Scan Log to %1"), path) << endmsg;
 	}
+
+	save_scan_index ();
+}
+
+void
+PluginManager::load_scan_index ()
+{
+	_scan_index.clear ();
+	std::string path = Glib::build_filename (user_plugin_metadata_dir(), "scan_index");
+	if (!Glib::file_test (path, Glib::FILE_TEST_EXISTS)) {
+		return;
+	}
+
+	XMLTree tree;
+	if (!tree.read (path)) {
+		error << string_compose (_("Cannot load Plugin Scan Index from '%1'."), path) << endmsg;
+		return;
+	}
+
+	for (XMLNodeConstIterator i = tree.root()->children().begin(); i != tree.root()->children().end(); ++i) {
+		std::string module;
+		int64_t     mtime;
+		int64_t     size;
+		if ((*i)->get_property ("path", module) && (*i)->get_property ("mtime", mtime) && (*i)->get_property ("size", size)) {
+			_scan_index[module] = ScanIndexEntry (mtime, size);
+		}
+	}
+}
+
+void
+PluginManager::save_scan_index ()
+{
+	std::string path = Glib::build_filename (user_plugin_metadata_dir(), "scan_index");
+	XMLNode* root = new XMLNode (X_("PluginScanIndex"));
+	root->set_property ("version", 1);
+
+	for (ScanIndex::const_iterator i = _scan_index.begin(); i != _scan_index.end(); ++i) {
+		XMLNode* node = new XMLNode (X_("Module"));
+		node->set_property ("path", i->first);
+		node->set_property ("mtime", i->second.mtime);
+		node->set_property ("size", i->second.size);
+		root->add_child_nocopy (*node);
+	}
+
+	XMLTree tree;
+	tree.set_root (root);
+	if (!tree.write (path)) {
+		error << string_compose (_("Could not save Plugin Scan Index to %1"), path) << endmsg;
+	}
+}
+
+/* Modules that are not (yet) indexed are not considered to be changed,
+ * the cache-file timestamp is used for those.
+ */
+bool
+PluginManager::module_changed (std::string const& module_path) const
+{
+	ScanIndex::const_iterator i = _scan_index.find (module_path);
+	if (i == _scan_index.end ()) {
+		return false;
+	}
+
+	GStatBuf sb;
+	if (g_stat (module_path.c_str (), &sb) != 0) {
+		return true;
+	}
+	return sb.st_mtime != i->second.mtime || sb.st_size != i->second.size;
+}
+
+void
+PluginManager::index_module (std::string const& module_path)
+{
+	GStatBuf sb;
+	if (g_stat (module_path.c_str (), &sb) == 0) {
+		_scan_index[module_path] = ScanIndexEntry (sb.st_mtime, sb.st_size);
+	} else {
+		_scan_index.erase (module_path);
+	}
 }
@@ -18,6 +18,8 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <cassert>
+#include <cstring>
 #include <regex.h>
 
 #include "pbd/error.h"
@@ -186,85 +188,199 @@ BackendPort::update_connected_latency (bool for_playback)
 	set_latency_range (lr, for_playback);
 }
 
+uint8_t
+BackendMIDIEvent::concurrent_rank (const uint8_t* data, size_t size)
+{
+	/* concurrent MIDI events, sort
+	 * - CC first (may include bank/patch)
+	 * - Program Change
+	 * - Note Off
+	 * - Note On
+	 * - Note Pressure
+	 * - Channel Pressure
+	 * - Pitch Bend
+	 * - SysEx/RT, etc
+	 *
+	 * see Evoral::Sequence<Time>::const_iterator::choose_next
+	 * and MidiBuffer::second_simultaneous_midi_byte_is_first
+	 */
+	if (size == 0 || size > 3) {
+		return 9;
+	}
+	switch (data[0] & 0xf0) {
+		case 0xB0: /* Control Change */
+			return 1;
+		case 0xC0: /* Program Change */
+			return 2;
+		case 0x80: /* Note Off */
+			return 3;
+		case 0x90: /* Note On */
+			return 4;
+		case 0xA0: /* Key Pressure */
+			return 5;
+		case 0xD0: /* Channel Pressure */
+			return 6;
+		case 0xE0: /* Pitch Bend */
+			return 7;
+		default:
+			return 8;
+	}
+}
+
 bool
 BackendMIDIEvent::operator< (const BackendMIDIEvent &other) const {
 	if (timestamp() == other.timestamp ()) {
-		/* concurrent MIDI events, sort
-		 * - CC first (may include bank/patch)
-		 * - Program Change
-		 * - Note Off
-		 * - Note On
-		 * - Note Pressure
-		 * - Channel Pressure
-		 * - Pitch Bend
-		 * - SysEx/RT, etc
-		 *
-		 * see Evoral::Sequence<Time>::const_iterator::choose_next
-		 * and MidiBuffer::second_simultaneous_midi_byte_is_first
-		 */
-		uint8_t ta = 9;
-		uint8_t tb = 9;
-		if (size () > 0 && size () < 4) {
-			switch (data ()[0] & 0xf0) {
-				case 0xB0: /* Control Change */
-					ta = 1;
-					break;
-				case 0xC0: /* Program Change */
-					ta = 2;
-					break;
-				case 0x80: /* Note Off */
-					ta = 3;
-					break;
-				case 0x90: /* Note On */
-					ta = 4;
-					break;
-				case 0xA0: /* Key Pressure */
-					ta = 5;
-					break;
-				case 0xD0: /* Channel Pressure */
-					ta = 6;
-					break;
-				case 0xE0: /* Pitch Bend */
-					ta = 7;
-					break;
-				default:
-					ta = 8;
-					break;
-			}
+		return concurrent_rank (data (), size ()) < concurrent_rank (other.data (), other.size ());
+	}
+	return timestamp () < other.timestamp ();
+};
+
+BackendMIDIBuffer::BackendMIDIBuffer (size_t max_events, size_t max_bytes)
+	: _index (max_events)
+	, _data (max_bytes)
+	, _n_events (0)
+	, _used (0)
+	, _dropped (0)
+	, _n_sources (0)
+{
+	assert (max_events > 0 && max_bytes > 0);
+}
+
+void
+BackendMIDIBuffer::clear ()
+{
+	_n_events  = 0;
+	_used      = 0;
+	_n_sources = 0;
+}
+
+int
+BackendMIDIBuffer::push (pframes_t timestamp, const uint8_t* data, size_t size)
+{
+	if (_n_events >= _index.size () || _used + size > _data.size ()) {
+		++_dropped;
+		return -1;
+	}
+
+	Index e;
+	e.timestamp = timestamp;
+	e.offset    = _used;
+	e.size      = size;
+	e.rank      = BackendMIDIEvent::concurrent_rank (data, size);
+
+	memcpy (&_data[_used], data, size);
+	_used += size;
+
+	/* usually events are added in order, otherwise shift later ones */
+	size_t pos = _n_events;
+	while (pos > 0 && before (e, _index[pos - 1])) {
+		--pos;
+	}
+	if (pos < _n_events) {
+		memmove (&_index[pos + 1], &_index[pos], (_n_events - pos) * sizeof (Index));
+	}
+	_index[pos] = e;
+	++_n_events;
+	return 0;
+}
+
+void
+BackendMIDIBuffer::copy (BackendMIDIBuffer const& other)
+{
+	clear ();
+	if (other._n_events > _index.size () || other._used > _data.size ()) {
+		/* different capacity, copy what fits */
+		for (size_t i = 0; i < other._n_events; ++i) {
+			Event const& e (other[i]);
+			push (e.timestamp, e.data, e.size);
 		}
+		return;
+	}
+	memcpy (&_index[0], &other._index[0], other._n_events * sizeof (Index));
+	memcpy (&_data[0], &other._data[0], other._used);
+	_n_events = other._n_events;
+	_used     = other._used;
+}
+
+void
+BackendMIDIBuffer::add_source (BackendMIDIBuffer const& src)
+{
+	assert (&src != this);
+	if (src.empty ()) {
+		return;
+	}
+	if (_n_sources == max_sources) {
+		merge ();
+	}
+	_sources[_n_sources++] = &src;
+}
+
+void
+BackendMIDIBuffer::merge ()
+{
+	if (_n_sources == 0) {
+		return;
+	}
+
+	/* Move our own events to the end of the index, and write the merged
+	 * result from the start. Since the result can not exceed the capacity
+	 * of the index, this never overwrites own events that are not yet read.
+	 */
+	const size_t cap = _index.size ();
+	size_t       own = cap - _n_events;
+	if (_n_events > 0 && own > 0) {
+		memmove (&_index[own], &_index[0], _n_events * sizeof (Index));
+	}
 
-		if (other.size () > 0 && other.size () < 4) {
-			switch (other.data ()[0] & 0xf0) {
-				case 0xB0: /* Control Change */
-					tb = 1;
-					break;
-				case 0xC0: /* Program Change */
-					tb = 2;
-					break;
-				case 0x80: /* Note Off */
-					tb = 3;
-					break;
-				case 0x90: /* Note On */
-					tb = 4;
-					break;
-				case 0xA0: /* Key Pressure */
-					tb = 5;
-					break;
-				case 0xD0: /* Channel Pressure */
-					tb = 6;
-					break;
-				case 0xE0: /* Pitch Bend */
-					tb = 7;
-					break;
-				default:
-					tb = 8;
-					break;
+	size_t pos[max_sources];
+	for (size_t s = 0; s < _n_sources; ++s) {
+		pos[s] = 0;
+	}
+
+	size_t n = 0;
+	while (true) {
+		/* find the earliest event, on equal keys own events come first,
+		 * then sources in the order they were added */
+		Index const* best     = own < cap ? &_index[own] : 0;
+		size_t       best_src = max_sources;
+
+		for (size_t s = 0; s < _n_sources; ++s) {
+			if (pos[s] < _sources[s]->_n_events) {
+				Index const& e (_sources[s]->_index[pos[s]]);
+				if (!best || before (e, *best)) {
+					best     = &e;
+					best_src = s;
+				}
 			}
 		}
-		return ta < tb;
+
+		if (!best) {
+			break;
+		}
+
+		if (best_src == max_sources) {
+			_index[n++] = _index[own++];
+			continue;
+		}
+
+		BackendMIDIBuffer const& src (*_sources[best_src]);
+		++pos[best_src];
+
+		if ((n >= own && own < cap) || n >= cap || _used + best->size > _data.size ()) {
+			++_dropped;
+			continue;
+		}
+
+		Index e (*best);
+		e.offset = _used;
+		memcpy (&_data[_used], &src._data[best->offset], best->size);
+		_used += best->size;
+		_index[n++] = e;
 	}
-	return timestamp () < other.timestamp ();
-};
+
+	_n_events  = n;
+	_n_sources = 0;
+}
 
 PortEngineSharedImpl::PortEngineSharedImpl (PortManager& mgr, std::string const & str)
 	: _instance_name (str)
@@ -32,6 +32,7 @@
 #include <glibmm/miscutils.h>
 
 #include "pbd/error.h"
+#include "pbd/malign.h"
 #include "pbd/strsplit.h"
 #include "pbd/unwind.h"
 
@@ -56,6 +57,12 @@ using namespace PBD;
 using std::string;
 using std::vector;
 
+/* minimum number of samples to resample per cycle (number of
+ * resamplers * nframes), for processing to be spread over the
+ * RTTaskList threads
+ */
+static const samplecnt_t parallel_resample_threshold = 4096;
+
 PortManager::AudioInputPort::AudioInputPort (samplecnt_t sz)
 	: scope (AudioPortScope (new CircularSampleBuffer (sz)))
 	, meter (AudioPortMeter (new DPM))
@@ -68,6 +75,67 @@ PortManager::MIDIInputPort::MIDIInputPort (samplecnt_t sz)
 {
 }
 
+class PortManager::InputResampler
+{
+public:
+	InputResampler (std::string const& name, pframes_t nframes)
+		: _name (name)
+		, _data (0)
+	{
+		_src.setup (Port::resampler_quality ());
+		_src.set_rrfilt (10);
+		set_buffer_size (nframes);
+	}
+
+	~InputResampler ()
+	{
+		cache_aligned_free (_data);
+	}
+
+	std::string const& name () const { return _name; }
+	Sample const*      data () const { return _data; }
+
+	void set_buffer_size (pframes_t nframes)
+	{
+		if (_data) {
+			cache_aligned_free (_data);
+		}
+		cache_aligned_malloc ((void**) &_data, sizeof (Sample) * lrint (floor (nframes * Config->get_max_transport_speed ())));
+	}
+
+	/* same as AudioPort::cycle_start */
+	void run (PortEngine& pe, PortEngine::PortHandle ph, pframes_t nframes)
+	{
+		const pframes_t cycle_nframes = Port::cycle_nframes ();
+		Sample*         buf           = ph ? (Sample*) pe.get_buffer (ph, nframes) : 0;
+
+		if (!buf) {
+			_src.reset ();
+			memset (_data, 0, cycle_nframes * sizeof (Sample));
+			return;
+		}
+
+		_src.inp_data  = buf;
+		_src.inp_count = nframes;
+		_src.out_count = cycle_nframes;
+		_src.set_rratio (cycle_nframes / (double)nframes);
+		_src.out_data  = _data;
+		_src.process ();
+		while (_src.out_count > 0) {
+			*_src.out_data =  _src.out_data[-1];
+			++_src.out_data;
+			--_src.out_count;
+		}
+	}
+
+private:
+	std::string             _name;
+	ArdourZita::VMResampler _src;
+	Sample*                 _data;
+};
+
+/* ****************************************************************************/
+
 PortManager::PortID::PortID (boost::shared_ptr<AudioBackend> b, DataType dt, bool in, std::string const& pn)
 	: backend (b->name ())
 	, port_name (pn)
@@ -145,6 +213,7 @@ PortManager::PortManager ()
 	, _midi_info_dirty (true)
 	, _audio_input_ports (new AudioInputPorts)
 	, _midi_input_ports (new MIDIInputPorts)
+	, _input_sources (new InputSources)
 {
 	g_atomic_int_set (&_reset_meters, 1);
 	load_port_info ();
@@ -174,6 +243,16 @@ PortManager::remove_all_ports ()
 	/* process lock MUST be held by caller
 	*/
 
+	{
+		Glib::Threads::Mutex::Lock lm (_input_source_lock);
+		_input_source_map.clear ();
+		RCUWriter<InputSources>         writer (_input_sources);
+		boost::shared_ptr<InputSources> is = writer.get_copy ();
+		is->clear ();
+	}
+
+	_input_sources.flush ();
+
 	{
 		RCUWriter<Ports>         writer (_ports);
 		boost::shared_ptr<Ports> ps = writer.get_copy ();
@@ -547,6 +626,8 @@ PortManager::unregister_port (boost::shared_ptr<Port> port)
 
 	/* caller must hold process lock */
 
+	drop_input_source (make_port_name_relative (port->name ()));
+
 	{
 		RCUWriter<Ports>         writer (_ports);
 		boost::shared_ptr<Ports> ps = writer.get_copy ();
@@ -740,6 +821,12 @@ PortManager::reestablish_ports ()
 	}
 
 	update_input_ports (true);
+
+	{
+		/* backend port handles are only valid for the backend that created them */
+		Glib::Threads::Mutex::Lock lm (_input_source_lock);
+		update_input_sources ();
+	}
 	return 0;
 }
 
@@ -831,6 +918,13 @@ PortManager::connect_callback (const string& a, const string& b, bool conn)
 		}
 	}
 
+	if (!_port_remove_in_progress) {
+		Glib::Threads::Mutex::Lock lm (_input_source_lock);
+		update_input_source (port_a);
+		update_input_source (port_b);
+		update_input_sources ();
+	}
+
 	PortConnectedOrDisconnected (
 	    port_a, a,
 	    port_b, b,
@@ -848,6 +942,12 @@ PortManager::registration_callback ()
 
 	update_input_ports (false);
 
+	{
+		/* drop ports that were unregistered */
+		Glib::Threads::Mutex::Lock lm (_input_source_lock);
+		update_input_sources ();
+	}
+
 	PortRegisteredOrUnregistered (); /* EMIT SIGNAL */
 }
 
@@ -1101,27 +1201,54 @@ PortManager::cycle_start (pframes_t nframes, Session* s)
 	 *    (run it in parallel with 'heavy' resampling.
 	 *    * output ports (sends_output()) only set a flag
 	 *    * midi-ports only scale event timestamps
-	 *
-	 *  - a threshold parallel vs searial processing may be appropriate.
-	 *    amount of work (how many connected ports are there, how
-	 *    many resamplers need to run) vs. available CPU cores and semaphore
-	 *    synchronization overhead.
-	 *
-	 *  - input ports: it would make sense to resample each input only once
-	 *    (rather than resample into each ardour-owned input port).
-	 *    A single external source-port may be connected to many ardour
-	 *    input-ports. Currently re-sampling is per input.
 	 */
-	if (s && s->rt_tasklist () && fabs (Port::speed_ratio ()) != 1.0) {
-		RTTaskList::TaskList tl;
+
+	/* A single external source-port may be connected to many of our
+	 * input-ports. Resample those only once, and copy the result to
+	 * each input, before the ports' own cycle_start ().
+	 */
+	boost::shared_ptr<InputSources> isp = _input_sources.reader ();
+
+	/* amount of work: number of resamplers that need to run vs.
+	 * semaphore synchronization overhead of the RTTaskList
+	 */
+	int32_t n_resample = isp->size ();
+	for (InputSources::const_iterator i = isp->begin (); i != isp->end (); ++i) {
+		n_resample -= i->ports.size ();
+	}
+	for (Ports::iterator p = _cycle_ports->begin (); p != _cycle_ports->end (); ++p) {
+		Port const& port (*p->second);
+		if (port.type () == DataType::AUDIO && port.receives_input () && port.externally_connected () && !(port.flags () & TransportSyncPort)) {
+			++n_resample;
+		}
+	}
+
+	boost::shared_ptr<RTTaskList> tl;
+	if (s && fabs (Port::speed_ratio ()) != 1.0 && n_resample * (samplecnt_t) nframes >= parallel_resample_threshold) {
+		tl = s->rt_tasklist ();
+	}
+
+	if (tl && tl->try_acquire ()) {
+		if (isp->size () > 1) {
+			for (InputSources::const_iterator i = isp->begin (); i != isp->end (); ++i) {
+				tl->push_back (boost::bind (&PortManager::run_input_source, this, &(*i), nframes));
+			}
+			tl->process ();
+		} else if (!isp->empty ()) {
+			run_input_source (&isp->front (), nframes);
+		}
 		for (Ports::iterator p = _cycle_ports->begin (); p != _cycle_ports->end (); ++p) {
 			if (!(p->second->flags () & TransportSyncPort)) {
-				tl.push_back (boost::bind (&Port::cycle_start, p->second, nframes));
+				tl->push_back (boost::bind (&Port::cycle_start, p->second.get (), nframes));
 			}
 		}
-		tl.push_back (boost::bind (&PortManager::run_input_meters, this, nframes, s ? s->nominal_sample_rate () : 0));
-		s->rt_tasklist ()->process (tl);
+		tl->push_back (boost::bind (&PortManager::run_input_meters, this, nframes, s ? s->nominal_sample_rate () : 0));
+		tl->process ();
+		tl->release ();
 	} else {
+		for (InputSources::const_iterator i = isp->begin (); i != isp->end (); ++i) {
+			run_input_source (&(*i), nframes);
+		}
 		for (Ports::iterator p = _cycle_ports->begin (); p != _cycle_ports->end (); ++p) {
 			if (!(p->second->flags () & TransportSyncPort)) {
 				p->second->cycle_start (nframes);
@@ -1136,13 +1263,13 @@ PortManager::cycle_end (pframes_t nframes, Session* s)
 {
 	// see optimzation note in ::cycle_start()
 	if (0 && s && s->rt_tasklist () && fabs (Port::speed_ratio ()) != 1.0) {
-		RTTaskList::TaskList tl;
+		boost::shared_ptr<RTTaskList> tl (s->rt_tasklist ());
 		for (Ports::iterator p = _cycle_ports->begin (); p != _cycle_ports->end (); ++p) {
 			if (!(p->second->flags () & TransportSyncPort)) {
-				tl.push_back (boost::bind (&Port::cycle_end, p->second, nframes));
+				tl->push_back (boost::bind (&Port::cycle_end, p->second.get (), nframes));
 			}
 		}
-		s->rt_tasklist ()->process (tl);
+		tl->process ();
 	} else {
 		for (Ports::iterator p = _cycle_ports->begin (); p != _cycle_ports->end (); ++p) {
 			if (!(p->second->flags () & TransportSyncPort)) {
@@ -1244,13 +1371,13 @@ PortManager::cycle_end_fade_out (gain_t base_gain, gain_t gain_step, pframes_t n
 {
 	// see optimzation note in ::cycle_start()
 	if (0 && s && s->rt_tasklist () && fabs (Port::speed_ratio ()) != 1.0) {
-		RTTaskList::TaskList tl;
+		boost::shared_ptr<RTTaskList> tl (s->rt_tasklist ());
 		for (Ports::iterator p = _cycle_ports->begin (); p != _cycle_ports->end (); ++p) {
 			if (!(p->second->flags () & TransportSyncPort)) {
-				tl.push_back (boost::bind (&Port::cycle_end, p->second, nframes));
+				tl->push_back (boost::bind (&Port::cycle_end, p->second.get (), nframes));
 			}
 		}
-		s->rt_tasklist ()->process (tl);
+		tl->process ();
 	} else {
 		for (Ports::iterator p = _cycle_ports->begin (); p != _cycle_ports->end (); ++p) {
 			if (!(p->second->flags () & TransportSyncPort)) {
@@ -1723,6 +1850,113 @@ PortManager::set_port_buffer_sizes (pframes_t n)
 		p->second->set_buffer_size (n);
 	}
 	_monitor_port.set_buffer_size (n);
+
+	boost::shared_ptr<InputSources> is = _input_sources.reader ();
+	for (InputSources::const_iterator i = is->begin (); i != is->end (); ++i) {
+		i->resampler->set_buffer_size (n);
+	}
+}
+
+/** Note the external port which is the only connection of the given port,
+ * if it is one of our audio inputs. Called with _input_source_lock held.
+ */
+void
+PortManager::update_input_source (boost::shared_ptr<Port> p)
+{
+	if (!p || p->type () != DataType::AUDIO || !p->receives_input () || (p->flags () & TransportSyncPort)) {
+		return;
+	}
+
+	std::vector<std::string> c;
+	if (p->externally_connected () == 1) {
+		/* the port may also be connected to some of our outputs */
+		port_engine ().get_connections (p->port_handle (), c);
+	}
+
+	if (c.size () == 1 && !port_is_mine (c.front ())) {
+		_input_source_map[make_port_name_relative (p->name ())] = c.front ();
+	} else {
+		_input_source_map.erase (make_port_name_relative (p->name ()));
+	}
+}
+
+/** Group our audio inputs by their external source, and publish
+ * all sources that feed more than one input.
+ * Called with _input_source_lock held.
+ */
+void
+PortManager::update_input_sources ()
+{
+	boost::shared_ptr<Ports>        pr  = _ports.reader ();
+	boost::shared_ptr<InputSources> old = _input_sources.reader ();
+
+	typedef std::map<std::string, std::vector<boost::shared_ptr<AudioPort> > > Groups;
+	Groups groups;
+
+	for (std::map<std::string, std::string>::iterator i = _input_source_map.begin (); i != _input_source_map.end ();) {
+		Ports::const_iterator x = pr->find (i->first);
+		boost::shared_ptr<AudioPort> ap;
+		if (x != pr->end ()) {
+			ap = boost::dynamic_pointer_cast<AudioPort> (x->second);
+		}
+		if (!ap) {
+			_input_source_map.erase (i++);
+			continue;
+		}
+		groups[i->second].push_back (ap);
+		++i;
+	}
+
+	RCUWriter<InputSources>         writer (_input_sources);
+	boost::shared_ptr<InputSources> is = writer.get_copy ();
+	is->clear ();
+
+	for (Groups::const_iterator g = groups.begin (); g != groups.end (); ++g) {
+		if (g->second.size () < 2) {
+			/* nothing to share */
+			continue;
+		}
+		InputSource src;
+		/* keep resampler state of existing sources */
+		for (InputSources::const_iterator o = old->begin (); o != old->end (); ++o) {
+			if (o->resampler->name () == g->first) {
+				src.resampler = o->resampler;
+				break;
+			}
+		}
+		if (!src.resampler) {
+			src.resampler.reset (new InputResampler (g->first, AudioEngine::instance ()->samples_per_cycle ()));
+		}
+		/* look up the backend port here, not in the process thread.
+		 * This is called again whenever ports are (un)registered or
+		 * (dis)connected, which refreshes the handle.
+		 */
+		src.port  = port_engine ().get_port_by_name (g->first);
+		src.ports = g->second;
+		is->push_back (src);
+	}
+
+	DEBUG_TRACE (DEBUG::Ports, string_compose ("%1 shared input sources\n", is->size ()));
+}
+
+void
+PortManager::drop_input_source (std::string const& port_name)
+{
+	/* caller must hold process lock */
+	Glib::Threads::Mutex::Lock lm (_input_source_lock);
+	if (_input_source_map.erase (port_name) > 0) {
+		update_input_sources ();
+		_input_sources.flush ();
+	}
+}
+
+void
+PortManager::run_input_source (InputSource const* src, pframes_t nframes)
+{
+	src->resampler->run (port_engine (), src->port, nframes);
+	for (std::vector<boost::shared_ptr<AudioPort> >::const_iterator p = src->ports.begin (); p != src->ports.end (); ++p) {
+		(*p)->set_resampled_input (src->resampler->data ());
+	}
 }
 
 bool
@@ -5371,6 +5371,18 @@ Route::setup_invisible_processors ()
 
 	_processors = new_processors;
 
+	/* fused mix-and-meter: if the meter directly follows the internal return
+	 * (MeterInput on busses), the return computes the peaks while mixing.
+	 */
+	if (_intreturn) {
+		ProcessorList::iterator r = find (_processors.begin(), _processors.end(), _intreturn);
+		if (r != _processors.end() && ++r != _processors.end() && *r == _meter) {
+			_intreturn->set_fused_meter (_meter);
+		} else {
+			_intreturn->set_fused_meter (boost::shared_ptr<PeakMeter> ());
+		}
+	}
+
 	for (ProcessorList::iterator i = _processors.begin(); i != _processors.end(); ++i) {
 		if (!(*i)->display_to_user () && !(*i)->enabled () && (*i) != _monitor_send) {
 			(*i)->enable (true);
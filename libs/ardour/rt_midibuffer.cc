@@ -18,6 +18,7 @@
 
 #include <iostream>
 #include <algorithm>    // std::reverse
+#include <vector>
 
 #include "pbd/malign.h"
 #include "pbd/compose.h"
@@ -33,6 +34,18 @@ using namespace std;
 using namespace ARDOUR;
 using namespace PBD;
 
+/* space taken by a blob of the given size (header and data) in the pool */
+static inline uint32_t
+blob_pool_bytes (uint32_t size)
+{
+	const uint32_t bytes = sizeof (uint32_t) + size;
+#if defined(__arm__) || defined(__aarch64_)
+	return ((bytes - 1) | 3) + 1;
+#else
+	return bytes;
+#endif
+}
+
 RTMidiBuffer::RTMidiBuffer ()
 	: _size (0)
 	, _capacity (0)
@@ -40,6 +53,7 @@ RTMidiBuffer::RTMidiBuffer ()
 	, _reversed (false)
 	, _pool_size (0)
 	, _pool_capacity (0)
+	, _pool_dead (0)
 	, _pool (0)
 {
 }
@@ -163,7 +177,7 @@ RTMidiBuffer::dump (uint32_t cnt)
 
 			/* more than 3 bytes ... indirect */
 
-			uint32_t offset = item->offset & ~(1<<(CHAR_BIT-1));
+			uint32_t offset = blob_offset (*item);
 			Blob* blob = reinterpret_cast<Blob*> (&_pool[offset]);
 
 			size = blob->size;
@@ -188,7 +202,13 @@ RTMidiBuffer::dump (uint32_t cnt)
 }
 
 uint32_t
-RTMidiBuffer::write (TimeType time, Evoral::EventType /*type*/, uint32_t size, const uint8_t* buf)
+RTMidiBuffer::write (TimeType time, Evoral::EventType type, uint32_t size, const uint8_t* buf)
+{
+	return write (time, type, size, buf, 0);
+}
+
+uint32_t
+RTMidiBuffer::write (TimeType time, Evoral::EventType /*type*/, uint32_t size, const uint8_t* buf, uint32_t tag)
 {
 	/* This buffer stores only MIDI, we don't care about the value of "type" */
 
@@ -201,13 +221,14 @@ RTMidiBuffer::write (TimeType time, Evoral::EventType /*type*/, uint32_t size, c
 	}
 
 	_data[_size].timestamp = time;
+	_data[_size].tag = tag;
 
 	if (size > 3) {
 
 		uint32_t off = store_blob (size, buf);
 
 		/* non-zero MSbit indicates that the data (more than 3 bytes) is not inline */
-		_data[_size].offset = (off | (1<<(CHAR_BIT-1)));
+		_data[_size].offset = blob_ref (off);
 
 	} else {
 
@@ -326,7 +347,7 @@ RTMidiBuffer::read (MidiBuffer& dst, samplepos_t start, samplepos_t end, MidiNot
 
 			/* more than 3 bytes ... indirect */
 
-			uint32_t offset = item->offset & ~(1<<(CHAR_BIT-1));
+			uint32_t offset = blob_offset (*item);
 			Blob* blob = reinterpret_cast<Blob*> (&_pool[offset]);
 
 			size = blob->size;
@@ -369,6 +390,145 @@ RTMidiBuffer::read (MidiBuffer& dst, samplepos_t start, samplepos_t end, MidiNot
 	return count;
 }
 
+uint8_t
+RTMidiBuffer::first_byte (Item const & item) const
+{
+	if (!item.bytes[0]) {
+		return item.bytes[1];
+	}
+
+	uint32_t offset = blob_offset (item);
+	Blob* blob = reinterpret_cast<Blob*> (&_pool[offset]);
+
+	return blob->data[0];
+}
+
+RTMidiBuffer::Item
+RTMidiBuffer::import_item (RTMidiBuffer const & src, Item const & item, uint32_t tag)
+{
+	Item ret (item);
+
+	if (item.bytes[0]) {
+		/* more than 3 bytes, so the data lives in src's blob pool */
+		uint32_t offset = blob_offset (item);
+		Blob* blob = reinterpret_cast<Blob*> (&src._pool[offset]);
+		ret.offset = blob_ref (store_blob (blob->size, blob->data));
+	}
+
+	ret.tag = tag;
+
+	return ret;
+}
+
+void
+RTMidiBuffer::splice (RTMidiBuffer const & src, uint32_t tag, samplepos_t start, samplepos_t end)
+{
+	if (src._size) {
+		start = std::min (start, src._data[0].timestamp);
+		end = std::max (end, src._data[src._size-1].timestamp);
+	}
+
+	Item foo;
+
+	foo.timestamp = start;
+	const size_t lo = lower_bound (_data, _data + _size, foo, item_item_earlier) - _data;
+	foo.timestamp = end;
+	const size_t hi = upper_bound (_data, _data + _size, foo, item_item_earlier) - _data;
+
+	/* Merge the surviving events in [lo..hi) with those from src. For
+	 * simultaneous events use the same ordering as MidiBuffer (and
+	 * MidiPlaylist::render()), so that the result matches what a full
+	 * render would produce.
+	 */
+
+	std::vector<Item> merged;
+	merged.reserve ((hi - lo) + src._size);
+
+	size_t si = 0;
+
+	for (size_t n = lo; n < hi; ++n) {
+
+		if (_data[n].tag == tag) {
+			if (_data[n].bytes[0]) {
+				/* replaced: its blob is no longer used */
+				uint32_t offset = blob_offset (_data[n]);
+				_pool_dead += blob_pool_bytes (reinterpret_cast<Blob*> (&_pool[offset])->size);
+			}
+			continue;
+		}
+
+		while (si < src._size &&
+		       (src._data[si].timestamp < _data[n].timestamp ||
+		        (src._data[si].timestamp == _data[n].timestamp &&
+		         !MidiBuffer::second_simultaneous_midi_byte_is_first (src.first_byte (src._data[si]), first_byte (_data[n]))))) {
+			merged.push_back (import_item (src, src._data[si], tag));
+			++si;
+		}
+
+		merged.push_back (_data[n]);
+	}
+
+	while (si < src._size) {
+		merged.push_back (import_item (src, src._data[si], tag));
+		++si;
+	}
+
+	DEBUG_TRACE (DEBUG::MidiRingBuffer, string_compose ("splice tag %1 %2 .. %3: replaced %4 events with %5\n", tag, start, end, hi - lo, merged.size()));
+
+	const size_t new_size = _size - (hi - lo) + merged.size();
+
+	if (new_size >= _capacity) {
+		resize (new_size + 1024); // XXX 1024 is as arbitrary as in ::write()
+	}
+
+	if (merged.size() != hi - lo) {
+		memmove (&_data[lo + merged.size()], &_data[hi], (_size - hi) * sizeof (Item));
+	}
+
+	if (!merged.empty()) {
+		memcpy (&_data[lo], &merged[0], merged.size() * sizeof (Item));
+	}
+
+	_size = new_size;
+
+	/* repeated edits of regions with sysex data would otherwise
+	 * grow the pool without bounds
+	 */
+	if (_pool_dead > 4096 && _pool_dead > _pool_size / 2) {
+		compact_pool ();
+	}
+}
+
+/** Rebuild the blob pool, keeping only blobs that are still referenced */
+void
+RTMidiBuffer::compact_pool ()
+{
+	uint8_t* old_pool = _pool;
+	const uint32_t live = _pool_size - _pool_dead;
+
+	DEBUG_TRACE (DEBUG::MidiRingBuffer, string_compose ("compact blob pool: %1 bytes used, %2 unused\n", live, _pool_dead));
+
+	_pool = 0;
+	_pool_size = 0;
+	_pool_dead = 0;
+	_pool_capacity = live;
+
+	if (live > 0) {
+		cache_aligned_malloc ((void **) &_pool, (_pool_capacity * sizeof (Blob)));
+	}
+
+	for (size_t n = 0; n < _size; ++n) {
+		if (!_data[n].bytes[0]) {
+			continue;
+		}
+		uint32_t offset = blob_offset (_data[n]);
+		Blob* blob = reinterpret_cast<Blob*> (&old_pool[offset]);
+		_data[n].offset = blob_ref (store_blob (blob->size, blob->data));
+	}
+
+	cache_aligned_free (old_pool);
+}
+
 uint32_t
 RTMidiBuffer::alloc_blob (uint32_t size)
 {
@@ -383,11 +543,7 @@ RTMidiBuffer::alloc_blob (uint32_t size)
 	}
 
 	uint32_t offset = _pool_size;
-#if defined(__arm__) || defined(__aarch64_)
-		_pool_size += ((size - 1) | 3) + 1;
-#else
-		_pool_size += size;
-#endif
+	_pool_size += size;
 
 	return offset;
 }
@@ -395,7 +551,8 @@ RTMidiBuffer::alloc_blob (uint32_t size)
 uint32_t
 RTMidiBuffer::store_blob (uint32_t size, uint8_t const * data)
 {
-	uint32_t offset = alloc_blob (size);
+	/* the blob's size is stored in front of the data */
+	uint32_t offset = alloc_blob (blob_pool_bytes (size));
 	uint8_t* addr = &_pool[offset];
 
 	*(reinterpret_cast<uint32_t*> (addr)) = size;
@@ -412,6 +569,7 @@ RTMidiBuffer::clear ()
 	_size = 0;
 	/* free the entire current pool size, if any */
 	_pool_size = 0;
+	_pool_dead = 0;
 	/* rendering new data .. it will not be reversed */
 	_reversed = false;
 }
@@ -20,8 +20,11 @@
 
 #include "pbd/pthread_utils.h"
 
+#include "temporal/tempo.h"
+
 #include "ardour/audioengine.h"
 #include "ardour/debug.h"
+#include "ardour/process_thread.h"
 #include "ardour/rt_tasklist.h"
 #include "ardour/utils.h"
 
@@ -29,10 +32,31 @@
 
 using namespace ARDOUR;
 
-RTTaskList::RTTaskList ()
+/* number of iterations a worker polls for new tasks before falling asleep */
+static const uint32_t spin_iterations = 4096;
+
+static inline void
+spin_pause ()
+{
+#if defined(__i386__) || defined(__x86_64__)
+	__builtin_ia32_pause ();
+#elif defined(__aarch64__)
+	asm volatile ("yield" ::: "memory");
+#endif
+}
+
+RTTaskList::RTTaskList (size_t capacity)
 	: _task_run_sem ("rt_task_run", 0)
 	, _task_end_sem ("rt_task_done", 0)
+	, _tasks (capacity)
+	, _n_queued (0)
+	, _claim (0)
+	, _n_done (0)
+	, _n_sleeping (0)
+	, _processing (false)
+	, _acquired (false)
 {
+	assert (capacity > 0);
 	g_atomic_int_set (&_threads_active, 0);
 	reset_thread_list ();
 }
@@ -58,6 +82,7 @@ RTTaskList::drop_threads ()
 	_threads.clear ();
 	_task_run_sem.reset ();
 	_task_end_sem.reset ();
+	_n_sleeping.store (0);
 }
 
 /*static*/ void*
@@ -65,7 +90,16 @@ RTTaskList::_thread_run (void *arg)
 {
 	RTTaskList *d = static_cast<RTTaskList *>(arg);
 	pthread_set_name ("RTTaskList");
+
+	/* tasks may run processors (e.g. replicated plugin instances),
+	 * which use per-thread scratch buffers */
+	ProcessThread* pt = new ProcessThread ();
+	pt->get_buffers ();
+
 	d->run ();
+
+	pt->drop_buffers ();
+	delete pt;
 	pthread_exit (0);
 	return 0;
 }
@@ -75,6 +109,7 @@ RTTaskList::reset_thread_list ()
 {
 	drop_threads ();
 
+	/* the thread calling process () also runs tasks */
 	const uint32_t num_threads = how_many_dsp_threads ();
 	if (num_threads < 2) {
 		return;
@@ -83,7 +118,7 @@ RTTaskList::reset_thread_list ()
 	Glib::Threads::Mutex::Lock pm (_process_mutex);
 
 	g_atomic_int_set (&_threads_active, 1);
-	for (uint32_t i = 0; i < num_threads; ++i) {
+	for (uint32_t i = 1; i < num_threads; ++i) {
 		pthread_t thread_id;
 		int rv = 1;
 		if (AudioEngine::instance()->is_realtime ()) {
@@ -101,79 +136,131 @@ RTTaskList::reset_thread_list ()
 	}
 }
 
+/** Atomically claim the next task of the current batch.
+ *
+ * The batch size and the next index are kept in a single
+ * atomic, so a task can only be claimed by exactly one thread,
+ * and threads that are late from a previous batch cannot claim
+ * tasks beyond the end of the current one.
+ */
+bool
+RTTaskList::claim (uint32_t& idx, uint32_t& n_tasks)
+{
+	uint64_t v = _claim.load (std::memory_order_acquire);
+	do {
+		n_tasks = v >> 32;
+		idx     = v & 0xffffffff;
+		if (idx >= n_tasks) {
+			return false;
+		}
+	} while (!_claim.compare_exchange_weak (v, v + 1, std::memory_order_acq_rel));
+	return true;
+}
+
+/** Run tasks until none are left to be claimed.
+ * @return true if the calling thread completed the last task of the batch
+ */
+bool
+RTTaskList::run_tasks ()
+{
+	uint32_t idx;
+	uint32_t n_tasks;
+	bool     last = false;
+
+	while (claim (idx, n_tasks)) {
+		_tasks[idx].run ();
+		if (_n_done.fetch_add (1, std::memory_order_acq_rel) + 1 == n_tasks) {
+			last = true;
+		}
+	}
+	return last;
+}
+
 void
 RTTaskList::run ()
 {
-	Glib::Threads::Mutex::Lock tm (_tasklist_mutex, Glib::Threads::NOT_LOCK);
-	bool wait = true;
-
 	while (true) {
-		if (wait) {
+		/* spin for a while, then sleep until woken up by process () */
+		uint64_t v;
+		uint32_t spin = 0;
+		do {
+			v = _claim.load (std::memory_order_acquire);
+			spin_pause ();
+		} while ((v >> 32) <= (v & 0xffffffff) && ++spin < spin_iterations && g_atomic_int_get (&_threads_active));
+
+		if ((v >> 32) <= (v & 0xffffffff)) {
+			_n_sleeping.fetch_add (1);
 			_task_run_sem.wait ();
+			_n_sleeping.fetch_sub (1);
 		}
 
 		if (0 == g_atomic_int_get (&_threads_active)) {
-			_task_end_sem.signal ();
 			break;
 		}
 
-		wait = false;
+		Temporal::TempoMap::fetch ();
 
-		boost::function<void ()> to_run;
-		tm.acquire ();
-		if (!_tasklist.empty ()) {
-			to_run = _tasklist.front();
-			_tasklist.pop_front ();
-		}
-		tm.release ();
-
-		if (!to_run.empty ()) {
-			to_run ();
-			continue;
-		}
-
-		if (!wait) {
+		if (run_tasks ()) {
+			/* notify the thread waiting in process () */
 			_task_end_sem.signal ();
 		}
-
-		wait = true;
 	}
 }
 
 void
-RTTaskList::process (TaskList const& tl)
+RTTaskList::process ()
 {
 	Glib::Threads::Mutex::Lock pm (_process_mutex);
-	Glib::Threads::Mutex::Lock tm (_tasklist_mutex, Glib::Threads::NOT_LOCK);
-
-	tm.acquire ();
-	_tasklist = tl;
-	tm.release ();
 
-	process_tasklist ();
+	const uint32_t n_tasks = _n_queued;
 
-	tm.acquire ();
-	_tasklist.clear ();
-	tm.release ();
-}
+	if (n_tasks == 0) {
+		return;
+	}
 
-void
-RTTaskList::process_tasklist ()
-{
-//	if (0 == g_atomic_int_get (&_threads_active) || _threads.size () == 0) {
+	_processing.store (true, std::memory_order_release);
 
-		for (TaskList::iterator i = _tasklist.begin (); i != _tasklist.end(); ++i) {
-			(*i)();
+	if (n_tasks == 1 || 0 == g_atomic_int_get (&_threads_active) || _threads.size () == 0) {
+		for (uint32_t i = 0; i < n_tasks; ++i) {
+			_tasks[i].run ();
+			_tasks[i].clear ();
 		}
+		_n_queued = 0;
+		_processing.store (false, std::memory_order_release);
 		return;
-//	}
+	}
 
-	uint32_t nt = std::min (_threads.size (), _tasklist.size ());
+	/* publish the batch */
+	_n_done.store (0, std::memory_order_relaxed);
+	_claim.store ((uint64_t)n_tasks << 32, std::memory_order_release);
 
-	for (uint32_t i = 0; i < nt; ++i) {
+	/* wake up sleeping workers, spinning ones will pick up tasks by themselves */
+	uint32_t wakeup = std::min<uint32_t> (_n_sleeping.load (), n_tasks - 1);
+	for (uint32_t i = 0; i < wakeup; ++i) {
 		_task_run_sem.signal ();
 	}
-	for (uint32_t i = 0; i < nt; ++i) {
+
+	/* the calling thread participates */
+	if (!run_tasks ()) {
+		/* wait for the worker that completes the last task */
 		_task_end_sem.wait ();
 	}
+
+	assert (_n_done.load () == n_tasks);
+	_claim.store (0, std::memory_order_release);
+
+	for (uint32_t i = 0; i < n_tasks; ++i) {
+		_tasks[i].clear ();
+	}
+	_n_queued = 0;
+	_processing.store (false, std::memory_order_release);
+}
+
+void
+RTTaskList::process (TaskList const& tl)
+{
+	for (TaskList::const_iterator i = tl.begin (); i != tl.end (); ++i) {
+		push_back (*i);
+	}
+	process ();
 }
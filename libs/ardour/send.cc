@@ -108,6 +108,8 @@ Send::Send (Session& s, boost::shared_ptr<Pannable> p, boost::shared_ptr<MuteMas
 	_send_delay.reset (new DelayLine (_session, "Send-" + name()));
 	_thru_delay.reset (new DelayLine (_session, "Thru-" + name()));
 
+	_compute_output_peaks = true;
+
 	if (panner_shell()) {
 		panner_shell()->Changed.connect_same_thread (*this, boost::bind (&Send::panshell_changed, this));
 		panner_shell()->PannableChanged.connect_same_thread (*this, boost::bind (&Send::pannable_changed, this));
@@ -264,6 +266,10 @@ Send::run (BufferSet& bufs, samplepos_t start_sample, samplepos_t end_sample, do
 		if (_amp->gain_control()->get_value() == 0) {
 			_meter->reset();
 		} else {
+			if (_n_output_peaks > 0) {
+				/* peaks were computed by Delivery::run while copying to the output ports */
+				_meter->set_input_peaks (&_output_peaks[0], _n_output_peaks);
+			}
 			_meter->run (*_output_buffers, start_sample, end_sample, speed, nframes, true);
 		}
 	}
@@ -61,11 +61,13 @@
 #include "ardour/amp.h"
 #include "ardour/analyser.h"
 #include "ardour/async_midi_port.h"
+#include "ardour/audio_block_cache.h"
 #include "ardour/audio_buffer.h"
 #include "ardour/audio_port.h"
 #include "ardour/audio_track.h"
 #include "ardour/audioengine.h"
 #include "ardour/audiofilesource.h"
+#include "ardour/audioregion.h"
 #include "ardour/auditioner.h"
 #include "ardour/boost_debug.h"
 #include "ardour/buffer_manager.h"
@@ -235,6 +237,7 @@ Session::Session (AudioEngine &eng,
 	, _session_dir (new SessionDirectory (fullpath))
 	, _current_snapshot_name (snapshot_name)
 	, state_tree (0)
+	, _pending_snapshot (0)
 	, state_was_pending (false)
 	, _state_of_the_state (StateOfTheState (CannotSave | InitialConnecting | Loading))
 	, _save_queued (false)
@@ -668,6 +671,9 @@ Session::destroy ()
 	delete state_tree;
 	state_tree = 0;
 
+	delete _pending_snapshot;
+	_pending_snapshot = 0;
+
 	{
 		/* unregister all lua functions, drop held references (if any) */
 		Glib::Threads::Mutex::Lock tm (lua_lock, Glib::Threads::TRY_LOCK);
@@ -1545,6 +1551,8 @@ Session::auto_loop_changed (Location* location)
 
 	replace_event (SessionEvent::AutoLoop, location->end_sample(), location->start_sample());
 
+	prefetch_location (location);
+
 	if (transport_rolling()) {
 
 		if (get_play_loop ()) {
@@ -1699,11 +1707,69 @@ Session::set_auto_loop_location (Location* location)
 }
 
 void
-Session::update_marks (Location*)
+Session::update_marks (Location* loc)
 {
+	prefetch_location (loc);
 	set_dirty ();
 }
 
+void
+Session::prefetch_location (Location* loc)
+{
+	if (!Config->get_prefetch_locations ()) {
+		return;
+	}
+	if (loc->is_mark () || loc->is_range_marker () || loc->is_auto_loop ()) {
+		prefetch_audio (loc->start_sample ());
+	}
+}
+
+void
+Session::prefetch_audio (samplepos_t pos)
+{
+	AudioBlockCache* cache = AudioBlockCache::instance ();
+
+	if (!cache || !cache->enabled () || pos < 0) {
+		return;
+	}
+
+	/* as much as a DiskReader reads after a locate */
+	const samplepos_t end = pos + (samplecnt_t) floor (Config->get_audio_playback_buffer_seconds () * sample_rate ());
+
+	boost::shared_ptr<RouteList> rl = routes.reader ();
+
+	for (RouteList::const_iterator i = rl->begin (); i != rl->end (); ++i) {
+		boost::shared_ptr<Track> tr = boost::dynamic_pointer_cast<Track> (*i);
+		if (!tr || tr->data_type () != DataType::AUDIO || !tr->playlist ()) {
+			continue;
+		}
+
+		boost::shared_ptr<RegionList> regions = tr->playlist ()->regions_touched (timepos_t (pos), timepos_t (end));
+
+		for (RegionList::const_iterator r = regions->begin (); r != regions->end (); ++r) {
+			boost::shared_ptr<AudioRegion> ar = boost::dynamic_pointer_cast<AudioRegion> (*r);
+			if (!ar || ar->muted ()) {
+				continue;
+			}
+
+			const samplepos_t rpos = ar->position_sample ();
+			const samplepos_t from = std::max (pos, rpos);
+			const samplepos_t to   = std::min (end, rpos + ar->length_samples ());
+
+			if (to <= from) {
+				continue;
+			}
+
+			for (uint32_t n = 0; n < ar->n_channels (); ++n) {
+				boost::shared_ptr<AudioFileSource> afs = boost::dynamic_pointer_cast<AudioFileSource> (ar->audio_source (n));
+				if (afs) {
+					cache->prefetch (afs, ar->start_sample () + from - rpos, to - from);
+				}
+			}
+		}
+	}
+}
+
 void
 Session::update_skips (Location* loc, bool consolidate)
 {
@@ -1809,6 +1875,8 @@ Session::location_added (Location *location)
 		_session_range_location = location;
 	}
 
+	prefetch_location (location);
+
 	if (location->is_mark()) {
 		/* listen for per-location signals that require us to do any * global updates for marks */
 
@@ -6193,6 +6261,15 @@ Session::plot_process_graph (std::string const& file_name) const {
 	return _process_graph ? _process_graph->plot (file_name) : false;
 }
 
+/** Called by the butler, to update the process graph's dispatch order */
+void
+Session::reprioritize_process_graph ()
+{
+	if (_process_graph) {
+		_process_graph->reprioritize ();
+	}
+}
+
 void
 Session::add_automation_list(AutomationList *al)
 {
@@ -0,0 +1,575 @@
+/*
+ * Copyright (C) 2026 The Ardour Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <set>
+
+#include <glibmm/fileutils.h>
+
+#include "pbd/error.h"
+#include "pbd/compose.h"
+#include "pbd/gstdio_compat.h"
+#include "pbd/string_convert.h"
+#include "pbd/xml++.h"
+
+#include "ardour/filename_extensions.h"
+#include "ardour/session_snapshot.h"
+
+#include "pbd/i18n.h"
+
+using namespace ARDOUR;
+using namespace PBD;
+
+/* File layout (all integers little-endian):
+ *
+ *   header:  magic[8] version:u32
+ *   chunk:   'C' id:u64 hash:u64 size:u32 node[size]
+ *   index:   'I' size:u32 skeleton[size] n:u32 { id:u64 offset:u64 }[n]
+ *   trailer: index-offset:u64 magic[8]
+ *
+ * Incremental writes append changed chunks, an index and a trailer.
+ * Readers use the last trailer that refers to a complete state.
+ *
+ * node:     flags:u8 name:str [content:str] n-props:u32 { name:str value:str }
+ *           n-children:u32 node[n-children]
+ * or        NodeChunk id:u64  (skeleton only, refers to a chunk)
+ */
+
+static const char     snapshot_magic[8] = { 'A', 'R', 'D', 'S', 'N', 'A', 'P', 0 };
+static const char     trailer_magic[8]  = { 'A', 'R', 'D', 'S', 'E', 'N', 'D', 0 };
+static const uint32_t snapshot_version  = 1;
+
+static const size_t header_size       = 12;
+static const size_t trailer_size      = 16;
+static const size_t chunk_header_size = 21;
+
+enum NodeFlags {
+	NodeContent = 0x01,
+	NodeChunk   = 0x02,
+};
+
+struct SessionSnapshot::Object {
+	uint64_t    id;
+	uint64_t    hash;
+	std::string data;
+};
+
+static void
+put_u8 (std::string& b, uint8_t v)
+{
+	b.push_back ((char)v);
+}
+
+static void
+put_u32 (std::string& b, uint32_t v)
+{
+	for (int i = 0; i < 4; ++i) {
+		b.push_back ((char)((v >> (8 * i)) & 0xff));
+	}
+}
+
+static void
+put_u64 (std::string& b, uint64_t v)
+{
+	for (int i = 0; i < 8; ++i) {
+		b.push_back ((char)((v >> (8 * i)) & 0xff));
+	}
+}
+
+static void
+put_str (std::string& b, std::string const& s)
+{
+	put_u32 (b, s.size ());
+	b.append (s);
+}
+
+static uint64_t
+hash_bytes (std::string const& s)
+{
+	/* FNV-1a */
+	uint64_t h = UINT64_C (14695981039346656037);
+	for (std::string::const_iterator i = s.begin (); i != s.end (); ++i) {
+		h = (h ^ (uint8_t)*i) * UINT64_C (1099511628211);
+	}
+	return h;
+}
+
+namespace {
+
+struct Reader {
+	Reader (char const* d, size_t size, size_t offset = 0)
+		: p (d + std::min (offset, size))
+		, end (d + size)
+		, ok (offset <= size)
+	{}
+
+	bool avail (size_t n) {
+		if (ok && (size_t)(end - p) >= n) {
+			return true;
+		}
+		ok = false;
+		return false;
+	}
+
+	uint8_t u8 () {
+		if (!avail (1)) { return 0; }
+		return (uint8_t)*p++;
+	}
+
+	uint32_t u32 () {
+		if (!avail (4)) { return 0; }
+		uint32_t v = 0;
+		for (int i = 0; i < 4; ++i) {
+			v |= (uint32_t)(uint8_t)*p++ << (8 * i);
+		}
+		return v;
+	}
+
+	uint64_t u64 () {
+		if (!avail (8)) { return 0; }
+		uint64_t v = 0;
+		for (int i = 0; i < 8; ++i) {
+			v |= (uint64_t)(uint8_t)*p++ << (8 * i);
+		}
+		return v;
+	}
+
+	bool str (std::string& s) {
+		uint32_t n = u32 ();
+		if (!avail (n)) { return false; }
+		s.assign (p, n);
+		p += n;
+		return true;
+	}
+
+	char const* p;
+	char const* end;
+	bool        ok;
+};
+
+}
+
+/* flags, name, content and properties of a node */
+static void
+encode_head (std::string& b, XMLNode const& node)
+{
+	put_u8 (b, node.is_content () ? NodeContent : 0);
+	put_str (b, node.name ());
+	if (node.is_content ()) {
+		put_str (b, node.content ());
+	}
+
+	XMLPropertyList const& props (node.properties ());
+	put_u32 (b, props.size ());
+	for (XMLPropertyConstIterator i = props.begin (); i != props.end (); ++i) {
+		put_str (b, (*i)->name ());
+		put_str (b, (*i)->value ());
+	}
+}
+
+static void
+encode_node (std::string& b, XMLNode const& node)
+{
+	encode_head (b, node);
+
+	XMLNodeList const& children (node.children ());
+	put_u32 (b, children.size ());
+	for (XMLNodeConstIterator i = children.begin (); i != children.end (); ++i) {
+		encode_node (b, **i);
+	}
+}
+
+/* Split objects (children of top-level nodes with an ID) into chunks */
+template<typename Objects>
+static void
+encode_skeleton (std::string& b, XMLNode const& node, int depth, Objects& objects, std::set<uint64_t>& ids)
+{
+	uint64_t id;
+	XMLProperty const* prop;
+
+	if (depth == 2 && (prop = node.property (X_("id"))) && string_to_uint64 (prop->value (), id) && ids.insert (id).second) {
+		objects.push_back (typename Objects::value_type ());
+		objects.back ().id = id;
+		encode_node (objects.back ().data, node);
+		objects.back ().hash = hash_bytes (objects.back ().data);
+		put_u8 (b, NodeChunk);
+		put_u64 (b, id);
+		return;
+	}
+
+	encode_head (b, node);
+
+	XMLNodeList const& children (node.children ());
+	put_u32 (b, children.size ());
+	for (XMLNodeConstIterator i = children.begin (); i != children.end (); ++i) {
+		encode_skeleton (b, **i, depth + 1, objects, ids);
+	}
+}
+
+typedef std::map<uint64_t, std::pair<char const*, uint32_t> > ChunkData;
+
+static XMLNode*
+decode_node (Reader& r, ChunkData const& chunks, int depth)
+{
+	if (depth > 256) {
+		r.ok = false;
+		return 0;
+	}
+
+	uint8_t flags = r.u8 ();
+
+	if (flags & NodeChunk) {
+		ChunkData::const_iterator c = chunks.find (r.u64 ());
+		if (!r.ok || c == chunks.end ()) {
+			r.ok = false;
+			return 0;
+		}
+		Reader cr (c->second.first, c->second.second);
+		XMLNode* node = decode_node (cr, chunks, depth + 1);
+		if (!cr.ok) {
+			delete node;
+			r.ok = false;
+			return 0;
+		}
+		return node;
+	}
+
+	std::string name;
+	std::string content;
+	if (!r.str (name) || ((flags & NodeContent) && !r.str (content))) {
+		return 0;
+	}
+
+	XMLNode* node = (flags & NodeContent) ? new XMLNode (name, content) : new XMLNode (name);
+
+	uint32_t n_props = r.u32 ();
+	for (uint32_t i = 0; r.ok && i < n_props; ++i) {
+		std::string key;
+		std::string value;
+		if (r.str (key) && r.str (value)) {
+			node->set_property (key.c_str (), value);
+		}
+	}
+
+	uint32_t n_children = r.u32 ();
+	for (uint32_t i = 0; r.ok && i < n_children; ++i) {
+		XMLNode* child = decode_node (r, chunks, depth + 1);
+		if (child) {
+			node->add_child_nocopy (*child);
+		}
+	}
+
+	if (!r.ok) {
+		delete node;
+		return 0;
+	}
+	return node;
+}
+
+static int64_t
+file_size (std::string const& path)
+{
+	GStatBuf sb;
+	if (g_stat (path.c_str (), &sb) != 0) {
+		return -1;
+	}
+	return sb.st_size;
+}
+
+static bool
+write_buffer (std::string const& path, std::string const& b, char const* mode)
+{
+	FILE* f = g_fopen (path.c_str (), mode);
+	if (!f) {
+		return false;
+	}
+	bool ok = fwrite (b.data (), 1, b.size (), f) == b.size ();
+	ok = (fflush (f) == 0) && ok;
+	ok = (fclose (f) == 0) && ok;
+	return ok;
+}
+
+SessionSnapshot::SessionSnapshot ()
+	: _file_size (0)
+	, _chunks_written (0)
+{
+}
+
+void
+SessionSnapshot::reset ()
+{
+	_path.clear ();
+	_file_size = 0;
+	_chunks.clear ();
+}
+
+bool
+SessionSnapshot::is_snapshot (std::string const& path)
+{
+	FILE* f = g_fopen (path.c_str (), "rb");
+	if (!f) {
+		return false;
+	}
+	char magic[sizeof (snapshot_magic)];
+	bool rv = fread (magic, 1, sizeof (magic), f) == sizeof (magic) && !memcmp (magic, snapshot_magic, sizeof (magic));
+	fclose (f);
+	return rv;
+}
+
+void
+SessionSnapshot::encode_index (std::string& b, std::string const& skeleton, ChunkMap const& chunks)
+{
+	put_u8 (b, 'I');
+	put_str (b, skeleton);
+	put_u32 (b, chunks.size ());
+	for (ChunkMap::const_iterator i = chunks.begin (); i != chunks.end (); ++i) {
+		put_u64 (b, i->first);
+		put_u64 (b, i->second.offset);
+	}
+}
+
+int
+SessionSnapshot::write (std::string const& path, XMLNode const& root)
+{
+	std::string         skeleton;
+	Objects             objects;
+	std::set<uint64_t>  ids;
+
+	encode_skeleton (skeleton, root, 0, objects, ids);
+
+	if (path == _path && file_size (path) == (int64_t)_file_size && !_chunks.empty ()) {
+		return append (path, skeleton, objects);
+	}
+	return write_full (path, skeleton, objects);
+}
+
+int
+SessionSnapshot::write_full (std::string const& path, std::string const& skeleton, Objects const& objects)
+{
+	std::string b;
+	ChunkMap    chunks;
+
+	b.append (snapshot_magic, sizeof (snapshot_magic));
+	put_u32 (b, snapshot_version);
+
+	for (Objects::const_iterator i = objects.begin (); i != objects.end (); ++i) {
+		Chunk& c (chunks[i->id]);
+		c.hash   = i->hash;
+		c.offset = b.size ();
+		c.size   = i->data.size ();
+		put_u8 (b, 'C');
+		put_u64 (b, i->id);
+		put_u64 (b, i->hash);
+		put_str (b, i->data);
+	}
+
+	uint64_t index_offset = b.size ();
+	encode_index (b, skeleton, chunks);
+	put_u64 (b, index_offset);
+	b.append (trailer_magic, sizeof (trailer_magic));
+
+	std::string tmp_path (path + temp_suffix);
+
+	if (!write_buffer (tmp_path, b, "wb")) {
+		error << string_compose (_("Could not write session snapshot to %1 (%2)"), tmp_path, g_strerror (errno)) << endmsg;
+		::g_unlink (tmp_path.c_str ());
+		reset ();
+		return -1;
+	}
+
+	if (::g_rename (tmp_path.c_str (), path.c_str ()) != 0) {
+		error << string_compose (_("Could not rename session snapshot %1 to %2 (%3)"), tmp_path, path, g_strerror (errno)) << endmsg;
+		::g_unlink (tmp_path.c_str ());
+		reset ();
+		return -1;
+	}
+
+	_path           = path;
+	_file_size      = b.size ();
+	_chunks_written = objects.size ();
+	_chunks.swap (chunks);
+	return 0;
+}
+
+int
+SessionSnapshot::append (std::string const& path, std::string const& skeleton, Objects const& objects)
+{
+	std::string b;
+	ChunkMap    chunks;
+	uint64_t    live    = header_size + trailer_size;
+	size_t      written = 0;
+
+	for (Objects::const_iterator i = objects.begin (); i != objects.end (); ++i) {
+		Chunk& c (chunks[i->id]);
+		ChunkMap::const_iterator prev = _chunks.find (i->id);
+
+		if (prev != _chunks.end () && prev->second.hash == i->hash && prev->second.size == i->data.size ()) {
+			c = prev->second;
+		} else {
+			c.hash   = i->hash;
+			c.offset = _file_size + b.size ();
+			c.size   = i->data.size ();
+			put_u8 (b, 'C');
+			put_u64 (b, i->id);
+			put_u64 (b, i->hash);
+			put_str (b, i->data);
+			++written;
+		}
+		live += chunk_header_size + c.size;
+	}
+
+	uint64_t index_offset = _file_size + b.size ();
+	size_t   index_start  = b.size ();
+	encode_index (b, skeleton, chunks);
+	live += b.size () - index_start;
+	put_u64 (b, index_offset);
+	b.append (trailer_magic, sizeof (trailer_magic));
+
+	/* compact when more than half of the file would be stale */
+	if (_file_size + b.size () > 2 * live) {
+		return write_full (path, skeleton, objects);
+	}
+
+	if (!write_buffer (path, b, "ab")) {
+		error << string_compose (_("Could not write session snapshot to %1 (%2)"), path, g_strerror (errno)) << endmsg;
+		/* the file may be incomplete, rewrite it */
+		reset ();
+		return write_full (path, skeleton, objects);
+	}
+
+	_file_size     += b.size ();
+	_chunks_written = written;
+	_chunks.swap (chunks);
+	return 0;
+}
+
+/* Decode the snapshot that ends with the trailer at d + size */
+XMLNode*
+SessionSnapshot::decode (char const* d, size_t size, ChunkMap& chunks)
+{
+	Reader tr (d, size, size - trailer_size);
+	uint64_t index_offset = tr.u64 ();
+
+	Reader      r (d, size, index_offset);
+	std::string skeleton;
+	ChunkData   data;
+
+	if (index_offset >= size || r.u8 () != 'I' || !r.str (skeleton)) {
+		r.ok = false;
+	}
+
+	uint32_t n_chunks = r.u32 ();
+
+	for (uint32_t i = 0; r.ok && i < n_chunks; ++i) {
+		uint64_t id     = r.u64 ();
+		uint64_t offset = r.u64 ();
+
+		Reader cr (d, size, offset);
+		if (!r.ok || offset >= size || cr.u8 () != 'C' || cr.u64 () != id) {
+			r.ok = false;
+			break;
+		}
+
+		Chunk& c (chunks[id]);
+		c.hash   = cr.u64 ();
+		c.offset = offset;
+		c.size   = cr.u32 ();
+
+		if (!cr.avail (c.size)) {
+			r.ok = false;
+			break;
+		}
+		data[id] = std::make_pair (cr.p, c.size);
+	}
+
+	if (!r.ok) {
+		return 0;
+	}
+
+	Reader   sr (skeleton.data (), skeleton.size ());
+	XMLNode* root = decode_node (sr, data, 0);
+	if (!sr.ok) {
+		delete root;
+		return 0;
+	}
+	return root;
+}
+
+XMLNode*
+SessionSnapshot::read (std::string const& path)
+{
+	std::string b;
+
+	try {
+		b = Glib::file_get_contents (path);
+	} catch (Glib::FileError const& e) {
+		error << string_compose (_("Could not read session snapshot %1 (%2)"), path, e.what ()) << endmsg;
+		return 0;
+	}
+
+	char const* d    = b.data ();
+	size_t      size = b.size ();
+
+	if (size < header_size + trailer_size || memcmp (d, snapshot_magic, sizeof (snapshot_magic))) {
+		error << string_compose (_("%1 is not a valid session snapshot"), path) << endmsg;
+		return 0;
+	}
+
+	Reader hr (d, size, sizeof (snapshot_magic));
+	if (hr.u32 () != snapshot_version) {
+		error << string_compose (_("Session snapshot %1 has an unsupported version"), path) << endmsg;
+		return 0;
+	}
+
+	/* An incremental write that was interrupted leaves an incomplete
+	 * tail. Use the last trailer that refers to a complete state.
+	 */
+	XMLNode* root = 0;
+	ChunkMap chunks;
+	size_t   end;
+
+	for (end = size; end >= header_size + trailer_size; --end) {
+		if (memcmp (d + end - sizeof (trailer_magic), trailer_magic, sizeof (trailer_magic))) {
+			continue;
+		}
+		chunks.clear ();
+		if ((root = decode (d, end, chunks)) != 0) {
+			break;
+		}
+	}
+
+	if (!root) {
+		error << string_compose (_("Session snapshot %1 is corrupt"), path) << endmsg;
+		return 0;
+	}
+
+	if (end < size) {
+		warning << string_compose (_("Session snapshot %1 ends with an incomplete write, %2 bytes were ignored"), path, size - end) << endmsg;
+	}
+
+	/* a file with a partial tail is rewritten by the next ::write () */
+	_path           = path;
+	_file_size      = end;
+	_chunks_written = 0;
+	_chunks.swap (chunks);
+
+	return root;
+}
@@ -128,6 +128,7 @@
 #include "ardour/session_directory.h"
 #include "ardour/session_metadata.h"
 #include "ardour/session_playlists.h"
+#include "ardour/session_snapshot.h"
 #include "ardour/session_state_utils.h"
 #include "ardour/silentfilesource.h"
 #include "ardour/smf_source.h"
@@ -684,6 +685,10 @@ Session::remove_pending_capture_state ()
 		return;
 	}
 
+	if (_pending_snapshot) {
+		_pending_snapshot->reset ();
+	}
+
 	if (::g_unlink (pending_state_file_path.c_str()) != 0) {
 		error << string_compose(_("Could not remove pending capture state at path \"%1\" (%2)"),
 				pending_state_file_path, g_strerror (errno)) << endmsg;
@@ -858,35 +863,49 @@ Session::save_state (string snapshot_name, bool pending, bool switch_to_snapshot
 		xml_path = Glib::build_filename (xml_path, legalize_for_path (snapshot_name) + pending_suffix);
 	}
 
-	std::string tmp_path(_session_dir->root_path());
-	tmp_path = Glib::build_filename (tmp_path, legalize_for_path (snapshot_name) + temp_suffix);
+	if (pending && Config->get_binary_safety_backups ()) {
 
-#ifndef NDEBUG
-	cerr << "actually writing state to " << tmp_path << endl;
-#endif
+		/* only objects that changed since the previous backup are written */
 
-	if (!tree.write (tmp_path)) {
-		error << string_compose (_("state could not be saved to %1"), tmp_path) << endmsg;
-		if (g_remove (tmp_path.c_str()) != 0) {
-			error << string_compose(_("Could not remove temporary session file at path \"%1\" (%2)"),
-					tmp_path, g_strerror (errno)) << endmsg;
+		if (!_pending_snapshot) {
+			_pending_snapshot = new SessionSnapshot;
+		}
+		if (_pending_snapshot->write (xml_path, *tree.root ())) {
+			return -1;
 		}
-		return -1;
 
 	} else {
 
+		std::string tmp_path(_session_dir->root_path());
+		tmp_path = Glib::build_filename (tmp_path, legalize_for_path (snapshot_name) + temp_suffix);
+
 #ifndef NDEBUG
-		cerr << "renaming state to " << xml_path << endl;
+		cerr << "actually writing state to " << tmp_path << endl;
 #endif
 
-		if (::g_rename (tmp_path.c_str(), xml_path.c_str()) != 0) {
-			error << string_compose (_("could not rename temporary session file %1 to %2 (%3)"),
-					tmp_path, xml_path, g_strerror(errno)) << endmsg;
+		if (!tree.write (tmp_path)) {
+			error << string_compose (_("state could not be saved to %1"), tmp_path) << endmsg;
 			if (g_remove (tmp_path.c_str()) != 0) {
 				error << string_compose(_("Could not remove temporary session file at path \"%1\" (%2)"),
 						tmp_path, g_strerror (errno)) << endmsg;
 			}
 			return -1;
+
+		} else {
+
+#ifndef NDEBUG
+			cerr << "renaming state to " << xml_path << endl;
+#endif
+
+			if (::g_rename (tmp_path.c_str(), xml_path.c_str()) != 0) {
+				error << string_compose (_("could not rename temporary session file %1 to %2 (%3)"),
+						tmp_path, xml_path, g_strerror(errno)) << endmsg;
+				if (g_remove (tmp_path.c_str()) != 0) {
+					error << string_compose(_("Could not remove temporary session file at path \"%1\" (%2)"),
+							tmp_path, g_strerror (errno)) << endmsg;
+				}
+				return -1;
+			}
 		}
 	}
 
@@ -995,7 +1014,21 @@ Session::load_state (string snapshot_name, bool from_template)
 
 	_writable = exists_and_writable (xmlpath) && exists_and_writable(Glib::path_get_dirname(xmlpath));
 
-	if (!state_tree->read (xmlpath)) {
+	bool state_read;
+
+	if (SessionSnapshot::is_snapshot (xmlpath)) {
+		/* binary state, usually a periodic backup */
+		SessionSnapshot snapshot;
+		XMLNode* root = snapshot.read (xmlpath);
+		if ((state_read = (root != 0))) {
+			state_tree->set_root (root);
+			state_tree->set_filename (xmlpath);
+		}
+	} else {
+		state_read = state_tree->read (xmlpath);
+	}
+
+	if (!state_read) {
 		error << string_compose(_("Could not understand session file %1"), xmlpath) << endmsg;
 		delete state_tree;
 		state_tree = 0;
@@ -62,6 +62,11 @@ using namespace PBD;
 using namespace Evoral;
 using namespace std;
 
+/** Models of files with at least this many notes keep them in a compact
+ *  NoteStore until something needs to edit them.
+ */
+static const uint64_t compact_model_notes = 10000;
+
 /** Constructor used for new internal-to-session files.  File cannot exist. */
 SMFSource::SMFSource (Session& s, const string& path, Source::Flag flags)
 	: Source(s, DataType::MIDI, path, flags)
@@ -756,6 +761,8 @@ SMFSource::load_model (const Glib::Threads::Mutex::Lock& lock, bool force_reload
 
 	eventlist.sort(compare_eventlist);
 
+	_model->set_compact_notes (_n_note_on_events >= compact_model_notes);
+
 	std::list< std::pair< Evoral::Event<Temporal::Beats>*, gint > >::iterator it;
 	for (it=eventlist.begin(); it!=eventlist.end(); ++it) {
 		_model->append (*it->first, it->second);
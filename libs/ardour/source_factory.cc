@@ -54,6 +54,7 @@ PBD::Signal1<void, boost::shared_ptr<Source>> SourceFactory::SourceCreated;
 Glib::Threads::Cond                           SourceFactory::PeaksToBuild;
 Glib::Threads::Mutex                          SourceFactory::peak_building_lock;
 std::list<boost::weak_ptr<AudioSource>>       SourceFactory::files_with_peaks;
+std::list<boost::weak_ptr<AudioSource>>       SourceFactory::pyramids_to_build;
 std::vector<PBD::Thread*>                     SourceFactory::peak_thread_pool;
 bool                                          SourceFactory::peak_thread_run = false;
 
@@ -69,7 +70,7 @@ peak_thread_work ()
 		SourceFactory::peak_building_lock.lock ();
 
 	wait:
-		if (SourceFactory::files_with_peaks.empty () && SourceFactory::peak_thread_run) {
+		if (SourceFactory::files_with_peaks.empty () && SourceFactory::pyramids_to_build.empty () && SourceFactory::peak_thread_run) {
 			SourceFactory::PeaksToBuild.wait (SourceFactory::peak_building_lock);
 		}
 
@@ -78,13 +79,17 @@ peak_thread_work ()
 			return;
 		}
 
-		if (SourceFactory::files_with_peaks.empty ()) {
+		if (SourceFactory::files_with_peaks.empty () && SourceFactory::pyramids_to_build.empty ()) {
 			goto wait;
 		}
 
-		boost::shared_ptr<AudioSource> as (SourceFactory::files_with_peaks.front ().lock ());
-		SourceFactory::files_with_peaks.pop_front ();
-		if (as) {
+		/* peakfiles first, pyramids only speed up drawing */
+		const bool pyramid = SourceFactory::files_with_peaks.empty ();
+		std::list<boost::weak_ptr<AudioSource>>& queue (pyramid ? SourceFactory::pyramids_to_build : SourceFactory::files_with_peaks);
+
+		boost::shared_ptr<AudioSource> as (queue.front ().lock ());
+		queue.pop_front ();
+		if (as && !pyramid) {
 			++active_threads;
 		}
 		SourceFactory::peak_building_lock.unlock ();
@@ -93,6 +98,11 @@ peak_thread_work ()
 			continue;
 		}
 
+		if (pyramid) {
+			as->build_peak_pyramid ();
+			continue;
+		}
+
 		as->setup_peakfile ();
 		SourceFactory::peak_building_lock.lock ();
 		--active_threads;
@@ -156,6 +166,14 @@ SourceFactory::setup_peakfile (boost::shared_ptr<Source> s, bool async)
 	return 0;
 }
 
+void
+SourceFactory::queue_peak_pyramid (boost::shared_ptr<AudioSource> as)
+{
+	Glib::Threads::Mutex::Lock lm (peak_building_lock);
+	pyramids_to_build.push_back (boost::weak_ptr<AudioSource> (as));
+	PeaksToBuild.broadcast ();
+}
+
 boost::shared_ptr<Source>
 SourceFactory::createSilent (Session& s, const XMLNode& node, samplecnt_t nframes, float sr)
 {
@@ -17,6 +17,8 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <cmath>
+#include <algorithm>
 #include <xmmintrin.h>
 #include "ardour/types.h"
 
@@ -116,3 +118,145 @@ x86_sse_find_peaks(const ARDOUR::Sample* buf, ARDOUR::pframes_t nframes, float *
 
 
 
+
+/* g[n] = target + (initial - target) * (1 - coeff)^n
+ * is equivalent to the recursive one-pole LPF g[n+1] = g[n] + coeff * (target - g[n])
+ */
+float
+x86_sse_apply_gain_ramp_to_buffer (ARDOUR::Sample* buf, ARDOUR::pframes_t nframes, float initial, float target, float coeff)
+{
+	float d = initial - target;
+
+	if (nframes >= 4) {
+		const float r  = 1.f - coeff;
+		const float r2 = r * r;
+
+		__m128 delta = _mm_set_ps (d * r2 * r, d * r2, d * r, d);
+		__m128 r4    = _mm_set1_ps (r2 * r2);
+		__m128 tgt   = _mm_set1_ps (target);
+
+		while (nframes >= 4) {
+			__m128 g = _mm_add_ps (tgt, delta);
+			_mm_storeu_ps (buf, _mm_mul_ps (_mm_loadu_ps (buf), g));
+			delta = _mm_mul_ps (delta, r4);
+			buf += 4;
+			nframes -= 4;
+		}
+		d = _mm_cvtss_f32 (delta);
+	}
+
+	float g = target + d;
+	while (nframes > 0) {
+		*buf++ *= g;
+		g += coeff * (target - g);
+		--nframes;
+	}
+	return g;
+}
+
+void
+x86_sse_apply_gain_vector_to_buffer (ARDOUR::Sample* buf, ARDOUR::gain_t const* gain, ARDOUR::pframes_t nframes)
+{
+	while (nframes >= 4) {
+		_mm_storeu_ps (buf, _mm_mul_ps (_mm_loadu_ps (buf), _mm_loadu_ps (gain)));
+		buf += 4;
+		gain += 4;
+		nframes -= 4;
+	}
+	while (nframes > 0) {
+		*buf++ *= *gain++;
+		--nframes;
+	}
+}
+
+void
+x86_sse_invert_buffer (ARDOUR::Sample* buf, ARDOUR::pframes_t nframes)
+{
+	const __m128 sign = _mm_set1_ps (-0.f);
+	while (nframes >= 4) {
+		_mm_storeu_ps (buf, _mm_xor_ps (_mm_loadu_ps (buf), sign));
+		buf += 4;
+		nframes -= 4;
+	}
+	while (nframes > 0) {
+		*buf = -*buf;
+		++buf;
+		--nframes;
+	}
+}
+
+static inline float
+x86_sse_hmax (__m128 v)
+{
+	v = _mm_max_ps (v, _mm_movehl_ps (v, v));
+	v = _mm_max_ss (v, _mm_shuffle_ps (v, v, _MM_SHUFFLE (1, 1, 1, 1)));
+	return _mm_cvtss_f32 (v);
+}
+
+float
+x86_sse_mix_buffers_no_gain_and_peak (ARDOUR::Sample* dst, ARDOUR::Sample const* src, ARDOUR::pframes_t nframes, float current)
+{
+	const __m128 sign = _mm_set1_ps (-0.f);
+	__m128       vmax = _mm_set1_ps (current);
+	while (nframes >= 4) {
+		__m128 d = _mm_add_ps (_mm_loadu_ps (dst), _mm_loadu_ps (src));
+		_mm_storeu_ps (dst, d);
+		vmax = _mm_max_ps (vmax, _mm_andnot_ps (sign, d));
+		dst += 4;
+		src += 4;
+		nframes -= 4;
+	}
+	current = x86_sse_hmax (vmax);
+	while (nframes > 0) {
+		*dst += *src++;
+		current = std::max (current, fabsf (*dst++));
+		--nframes;
+	}
+	return current;
+}
+
+float
+x86_sse_mix_buffers_with_gain_and_peak (ARDOUR::Sample* dst, ARDOUR::Sample const* src, ARDOUR::pframes_t nframes, float gain, float current)
+{
+	const __m128 sign = _mm_set1_ps (-0.f);
+	const __m128 g    = _mm_set1_ps (gain);
+	__m128       vmax = _mm_set1_ps (current);
+	while (nframes >= 4) {
+		__m128 d = _mm_add_ps (_mm_loadu_ps (dst), _mm_mul_ps (_mm_loadu_ps (src), g));
+		_mm_storeu_ps (dst, d);
+		vmax = _mm_max_ps (vmax, _mm_andnot_ps (sign, d));
+		dst += 4;
+		src += 4;
+		nframes -= 4;
+	}
+	current = x86_sse_hmax (vmax);
+	while (nframes > 0) {
+		*dst += *src++ * gain;
+		current = std::max (current, fabsf (*dst++));
+		--nframes;
+	}
+	return current;
+}
+
+float
+x86_sse_copy_vector_with_gain_and_peak (ARDOUR::Sample* dst, ARDOUR::Sample const* src, ARDOUR::pframes_t nframes, float gain, float current)
+{
+	const __m128 sign = _mm_set1_ps (-0.f);
+	const __m128 g    = _mm_set1_ps (gain);
+	__m128       vmax = _mm_set1_ps (current);
+	while (nframes >= 4) {
+		__m128 d = _mm_mul_ps (_mm_loadu_ps (src), g);
+		_mm_storeu_ps (dst, d);
+		vmax = _mm_max_ps (vmax, _mm_andnot_ps (sign, d));
+		dst += 4;
+		src += 4;
+		nframes -= 4;
+	}
+	current = x86_sse_hmax (vmax);
+	while (nframes > 0) {
+		*dst = *src++ * gain;
+		current = std::max (current, fabsf (*dst++));
+		--nframes;
+	}
+	return current;
+}
@@ -0,0 +1,223 @@
+#include <glibmm/miscutils.h>
+
+#include "ardour/audio_block_cache.h"
+#include "ardour/sndfilesource.h"
+#include "ardour/source_factory.h"
+#include "audio_block_cache_test.h"
+#include "test_util.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (AudioBlockCacheTest);
+
+using namespace ARDOUR;
+
+static const size_t block_bytes = AudioBlockCache::block_samples * sizeof (Sample);
+
+/* sources are only used as keys and never dereferenced */
+static char src_a;
+static char src_b;
+
+#define SRC_A reinterpret_cast<AudioSource const*> (&src_a)
+#define SRC_B reinterpret_cast<AudioSource const*> (&src_b)
+
+static AudioBlockCache::BlockPtr
+make_block (float v)
+{
+	AudioBlockCache::BlockPtr b (new AudioBlockCache::Block (AudioBlockCache::block_samples));
+	for (samplecnt_t i = 0; i < b->length; ++i) {
+		b->data[i] = v;
+	}
+	return b;
+}
+
+void
+AudioBlockCacheTest::setUp ()
+{
+	TestNeedingSession::setUp ();
+
+	AudioBlockCache* cache = AudioBlockCache::instance ();
+	CPPUNIT_ASSERT (cache);
+	_budget = cache->stats ().budget;
+	cache->clear ();
+	cache->reset_stats ();
+}
+
+void
+AudioBlockCacheTest::tearDown ()
+{
+	AudioBlockCache* cache = AudioBlockCache::instance ();
+	cache->clear ();
+	cache->set_budget (_budget);
+
+	TestNeedingSession::tearDown ();
+}
+
+void
+AudioBlockCacheTest::lruTest ()
+{
+	AudioBlockCache* cache = AudioBlockCache::instance ();
+	cache->set_budget (3 * block_bytes);
+
+	cache->insert (SRC_A, 0, make_block (0), 0);
+	cache->insert (SRC_A, 1, make_block (1), 0);
+	cache->insert (SRC_A, 2, make_block (2), 0);
+
+	/* touch block 0, block 1 is now the least recently used */
+	AudioBlockCache::BlockPtr b = cache->lookup (SRC_A, 0);
+	CPPUNIT_ASSERT (b);
+	CPPUNIT_ASSERT_EQUAL (0.f, b->data[0]);
+
+	cache->insert (SRC_A, 3, make_block (3), 0, true);
+
+	CPPUNIT_ASSERT (cache->contains (SRC_A, 0));
+	CPPUNIT_ASSERT (!cache->contains (SRC_A, 1));
+	CPPUNIT_ASSERT (cache->contains (SRC_A, 2));
+	CPPUNIT_ASSERT (cache->contains (SRC_A, 3));
+
+	CPPUNIT_ASSERT (!cache->lookup (SRC_A, 1));
+	CPPUNIT_ASSERT_EQUAL (3.f, cache->lookup (SRC_A, 3)->data[0]);
+
+	AudioBlockCache::Stats s (cache->stats ());
+	CPPUNIT_ASSERT_EQUAL ((uint64_t) 2, s.hits);
+	CPPUNIT_ASSERT_EQUAL ((uint64_t) 1, s.misses);
+	CPPUNIT_ASSERT_EQUAL ((uint64_t) 1, s.prefetched);
+	CPPUNIT_ASSERT_EQUAL ((uint64_t) 1, s.evictions);
+	CPPUNIT_ASSERT_EQUAL (3 * block_bytes, s.bytes);
+
+	/* shrinking the budget evicts */
+	cache->set_budget (block_bytes);
+	CPPUNIT_ASSERT_EQUAL (block_bytes, cache->stats ().bytes);
+	CPPUNIT_ASSERT (cache->contains (SRC_A, 3));
+
+	/* a block that was handed out stays valid after eviction */
+	CPPUNIT_ASSERT_EQUAL (0.f, b->data[AudioBlockCache::block_samples - 1]);
+}
+
+void
+AudioBlockCacheTest::dropTest ()
+{
+	AudioBlockCache* cache = AudioBlockCache::instance ();
+	cache->set_budget (8 * block_bytes);
+
+	for (int i = 0; i < 3; ++i) {
+		cache->insert (SRC_A, i, make_block (i), 0);
+		cache->insert (SRC_B, i, make_block (i), 0);
+	}
+	CPPUNIT_ASSERT_EQUAL (6 * block_bytes, cache->stats ().bytes);
+
+	cache->drop (SRC_A);
+	cache->forget (SRC_A);
+
+	for (int i = 0; i < 3; ++i) {
+		CPPUNIT_ASSERT (!cache->contains (SRC_A, i));
+		CPPUNIT_ASSERT (cache->contains (SRC_B, i));
+	}
+	CPPUNIT_ASSERT_EQUAL (3 * block_bytes, cache->stats ().bytes);
+
+	/* disabled cache does not hold data */
+	cache->set_budget (0);
+	CPPUNIT_ASSERT (!cache->enabled ());
+	CPPUNIT_ASSERT_EQUAL ((size_t) 0, cache->stats ().bytes);
+	cache->insert (SRC_A, 0, make_block (0), 0);
+	CPPUNIT_ASSERT (!cache->contains (SRC_A, 0));
+}
+
+void
+AudioBlockCacheTest::generationTest ()
+{
+	AudioBlockCache* cache = AudioBlockCache::instance ();
+	cache->set_budget (8 * block_bytes);
+
+	const uint64_t gen = cache->generation (SRC_A);
+
+	/* a block read before the source was dropped is not cached */
+	cache->drop (SRC_A);
+	CPPUNIT_ASSERT (cache->generation (SRC_A) != gen);
+	cache->insert (SRC_A, 0, make_block (0), gen);
+	CPPUNIT_ASSERT (!cache->contains (SRC_A, 0));
+
+	cache->insert (SRC_A, 0, make_block (0), cache->generation (SRC_A));
+	CPPUNIT_ASSERT (cache->contains (SRC_A, 0));
+
+	/* other sources are not affected */
+	cache->insert (SRC_B, 0, make_block (0), gen);
+	CPPUNIT_ASSERT (cache->contains (SRC_B, 0));
+
+	cache->forget (SRC_A);
+	CPPUNIT_ASSERT (!cache->contains (SRC_A, 0));
+	CPPUNIT_ASSERT_EQUAL ((uint64_t) 0, cache->generation (SRC_A));
+}
+
+void
+AudioBlockCacheTest::readTest ()
+{
+	const samplecnt_t bs  = AudioBlockCache::block_samples;
+	const samplecnt_t len = 2 * bs + 1000;
+
+	std::string const path = Glib::build_filename (new_test_output_dir (), "block_cache.wav");
+
+	/* write a ramp, then open the file again read-only, which makes it cacheable */
+	boost::shared_ptr<SndFileSource> w = boost::dynamic_pointer_cast<SndFileSource> (
+			SourceFactory::createWritable (DataType::AUDIO, *_session, path, get_test_sample_rate ()));
+	CPPUNIT_ASSERT (w);
+
+	Sample* ramp = new Sample[len];
+	for (samplecnt_t i = 0; i < len; ++i) {
+		ramp[i] = i / (float) len;
+	}
+	CPPUNIT_ASSERT_EQUAL (len, w->write (ramp, len));
+	w->flush_header ();
+	w->flush ();
+
+	boost::shared_ptr<SndFileSource> src (new SndFileSource (*_session, path, 0, Source::Flag (0)));
+	CPPUNIT_ASSERT (!src->writable ());
+	CPPUNIT_ASSERT_EQUAL (len, src->length ().samples ());
+
+	AudioBlockCache* cache = AudioBlockCache::instance ();
+	cache->set_budget (8 * block_bytes);
+	cache->reset_stats ();
+
+	/* uncached reference */
+	Sample ref[300];
+	cache->set_budget (0);
+	CPPUNIT_ASSERT_EQUAL ((samplecnt_t) 300, src->read (ref, bs - 100, 300));
+	CPPUNIT_ASSERT (!cache->contains (src.get (), 0));
+	cache->set_budget (8 * block_bytes);
+
+	/* a read across a block boundary loads both blocks */
+	Sample buf[300];
+	CPPUNIT_ASSERT_EQUAL ((samplecnt_t) 300, src->read (buf, bs - 100, 300));
+	CPPUNIT_ASSERT (cache->contains (src.get (), 0));
+	CPPUNIT_ASSERT (cache->contains (src.get (), 1));
+	CPPUNIT_ASSERT (!cache->contains (src.get (), 2));
+	for (int i = 0; i < 300; ++i) {
+		CPPUNIT_ASSERT_EQUAL (ref[i], buf[i]);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL (ramp[bs - 100 + i], buf[i], 1e-6);
+	}
+	CPPUNIT_ASSERT_EQUAL ((uint64_t) 2, cache->stats ().misses);
+
+	/* the second read is served from the cache */
+	CPPUNIT_ASSERT_EQUAL ((samplecnt_t) 300, src->read (buf, bs - 100, 300));
+	CPPUNIT_ASSERT_EQUAL ((uint64_t) 2, cache->stats ().hits);
+	CPPUNIT_ASSERT_EQUAL ((uint64_t) 2, cache->stats ().misses);
+
+	/* the partial last block */
+	CPPUNIT_ASSERT_EQUAL ((samplecnt_t) 300, src->read (buf, len - 300, 300));
+	CPPUNIT_ASSERT (cache->contains (src.get (), 2));
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (ramp[len - 1], buf[299], 1e-6);
+
+	/* changing the gain invalidates the cached data */
+	src->set_gain (.5, true);
+	CPPUNIT_ASSERT (!cache->contains (src.get (), 0));
+	CPPUNIT_ASSERT_EQUAL ((samplecnt_t) 300, src->read (buf, bs - 100, 300));
+	for (int i = 0; i < 300; ++i) {
+		CPPUNIT_ASSERT_DOUBLES_EQUAL (.5 * ref[i], buf[i], 1e-6);
+	}
+
+	/* the source is removed from the cache when it goes away */
+	AudioSource const* key = src.get ();
+	src.reset ();
+	CPPUNIT_ASSERT (!cache->contains (key, 0));
+	CPPUNIT_ASSERT_EQUAL ((size_t) 0, cache->stats ().bytes);
+
+	delete [] ramp;
+}
@@ -0,0 +1,23 @@
+#include "test_needing_session.h"
+
+class AudioBlockCacheTest : public TestNeedingSession
+{
+	CPPUNIT_TEST_SUITE (AudioBlockCacheTest);
+	CPPUNIT_TEST (lruTest);
+	CPPUNIT_TEST (dropTest);
+	CPPUNIT_TEST (generationTest);
+	CPPUNIT_TEST (readTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void setUp ();
+	void tearDown ();
+
+	void lruTest ();
+	void dropTest ();
+	void generationTest ();
+	void readTest ();
+
+private:
+	size_t _budget;
+};
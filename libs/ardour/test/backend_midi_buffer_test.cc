@@ -0,0 +1,189 @@
+#include <iostream>
+#include <string.h>
+
+#include "pbd/microseconds.h"
+
+#include "evoral/midi_events.h"
+
+#include "ardour/audioengine.h"
+#include "ardour/port_engine.h"
+#include "ardour/port_engine_shared.h"
+
+#include "backend_midi_buffer_test.h"
+#include "test_util.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (BackendMIDIBufferTest);
+
+using namespace std;
+using namespace ARDOUR;
+
+static void
+check_sorted (BackendMIDIBuffer const& buf)
+{
+	for (size_t n = 1; n < buf.size (); ++n) {
+		CPPUNIT_ASSERT (buf[n - 1].timestamp <= buf[n].timestamp);
+	}
+}
+
+void
+BackendMIDIBufferTest::pushOrderTest ()
+{
+	BackendMIDIBuffer buf (16, 64);
+
+	uint8_t on[3]  = { MIDI_CMD_NOTE_ON, 60, 100 };
+	uint8_t off[3] = { MIDI_CMD_NOTE_OFF, 60, 0 };
+
+	CPPUNIT_ASSERT_EQUAL (0, buf.push (10, on, 3));
+	CPPUNIT_ASSERT_EQUAL (0, buf.push (30, on, 3));
+	/* late event is inserted in order */
+	CPPUNIT_ASSERT_EQUAL (0, buf.push (20, on, 3));
+	/* note-off sorts before note-on at the same time */
+	CPPUNIT_ASSERT_EQUAL (0, buf.push (30, off, 3));
+
+	CPPUNIT_ASSERT_EQUAL ((size_t) 4, buf.size ());
+	check_sorted (buf);
+	CPPUNIT_ASSERT_EQUAL ((pframes_t) 20, buf[1].timestamp);
+	CPPUNIT_ASSERT_EQUAL ((uint8_t) MIDI_CMD_NOTE_OFF, buf[2].data[0]);
+	CPPUNIT_ASSERT_EQUAL ((uint8_t) MIDI_CMD_NOTE_ON, buf[3].data[0]);
+
+	buf.clear ();
+	CPPUNIT_ASSERT (buf.empty ());
+}
+
+void
+BackendMIDIBufferTest::mergeTest ()
+{
+	BackendMIDIBuffer a (64, 256);
+	BackendMIDIBuffer b (64, 256);
+	BackendMIDIBuffer dst (64, 256);
+
+	for (uint8_t i = 0; i < 10; ++i) {
+		uint8_t ev_a[3] = { MIDI_CMD_CONTROL, 1, i };
+		uint8_t ev_b[3] = { MIDI_CMD_CONTROL, 2, i };
+		a.push (i * 2, ev_a, 3);
+		b.push (i * 3, ev_b, 3);
+	}
+
+	uint8_t own[3] = { MIDI_CMD_CONTROL, 3, 0 };
+	dst.push (6, own, 3);
+
+	dst.add_source (a);
+	dst.add_source (b);
+	dst.merge ();
+
+	CPPUNIT_ASSERT_EQUAL ((size_t) 21, dst.size ());
+	check_sorted (dst);
+
+	/* equal timestamps: own events first, then sources in order */
+	size_t n = 0;
+	while (dst[n].timestamp < 6) {
+		++n;
+	}
+	CPPUNIT_ASSERT_EQUAL ((uint8_t) 3, dst[n].data[1]);
+	CPPUNIT_ASSERT_EQUAL ((uint8_t) 1, dst[n + 1].data[1]);
+	CPPUNIT_ASSERT_EQUAL ((uint8_t) 2, dst[n + 2].data[1]);
+
+	/* copy */
+	BackendMIDIBuffer c (64, 256);
+	c.copy (dst);
+	CPPUNIT_ASSERT_EQUAL (dst.size (), c.size ());
+	for (size_t i = 0; i < c.size (); ++i) {
+		CPPUNIT_ASSERT_EQUAL (dst[i].timestamp, c[i].timestamp);
+		CPPUNIT_ASSERT (memcmp (dst[i].data, c[i].data, 3) == 0);
+	}
+}
+
+void
+BackendMIDIBufferTest::capacityTest ()
+{
+	BackendMIDIBuffer src (32, 256);
+	BackendMIDIBuffer dst (8, 16);
+
+	uint8_t ev[3] = { MIDI_CMD_NOTE_ON, 64, 100 };
+
+	for (size_t i = 0; i < 5; ++i) {
+		CPPUNIT_ASSERT_EQUAL (0, dst.push (i, ev, 3));
+	}
+	/* out of bytes */
+	CPPUNIT_ASSERT_EQUAL (-1, dst.push (5, ev, 3));
+	CPPUNIT_ASSERT_EQUAL ((size_t) 5, dst.size ());
+	CPPUNIT_ASSERT_EQUAL ((size_t) 1, dst.dropped ());
+
+	dst.clear ();
+	for (size_t i = 0; i < 20; ++i) {
+		src.push (i, ev, 1);
+	}
+	dst.add_source (src);
+	dst.merge ();
+	CPPUNIT_ASSERT_EQUAL ((size_t) 8, dst.size ());
+	CPPUNIT_ASSERT_EQUAL ((size_t) 13, dst.dropped ());
+	check_sorted (dst);
+}
+
+/* Push 10k events per cycle from two ports into a third one,
+ * through the dummy backend's port-engine API.
+ */
+void
+BackendMIDIBufferTest::dummyBackendStressTest ()
+{
+	create_and_start_dummy_backend ();
+
+	PortEngine& pe (AudioEngine::instance ()->port_engine ());
+
+	PortEngine::PortPtr out1 = pe.register_port ("stress-out-1", DataType::MIDI, IsOutput);
+	PortEngine::PortPtr out2 = pe.register_port ("stress-out-2", DataType::MIDI, IsOutput);
+	PortEngine::PortPtr in   = pe.register_port ("stress-in", DataType::MIDI, IsInput);
+
+	CPPUNIT_ASSERT (out1 && out2 && in);
+	CPPUNIT_ASSERT_EQUAL (0, pe.connect (out1, pe.get_port_name (in)));
+	CPPUNIT_ASSERT_EQUAL (0, pe.connect (out2, pe.get_port_name (in)));
+
+	const pframes_t nframes  = 1024;
+	const uint32_t  n_events = 10000;
+	const int       cycles   = 100;
+
+	microseconds_t t_total = 0;
+
+	for (int c = 0; c < cycles; ++c) {
+		void* b1 = pe.get_buffer (out1, nframes);
+		void* b2 = pe.get_buffer (out2, nframes);
+		pe.midi_clear (b1);
+		pe.midi_clear (b2);
+
+		microseconds_t t0 = PBD::get_microseconds ();
+
+		for (uint32_t i = 0; i < n_events / 2; ++i) {
+			uint8_t ev[3] = { MIDI_CMD_NOTE_ON, (uint8_t)(i & 0x7f), 100 };
+			CPPUNIT_ASSERT_EQUAL (0, pe.midi_event_put (b1, (i * 2 * nframes) / n_events, ev, 3));
+			ev[0] = MIDI_CMD_NOTE_OFF;
+			CPPUNIT_ASSERT_EQUAL (0, pe.midi_event_put (b2, (i * 2 * nframes) / n_events, ev, 3));
+		}
+
+		void* bi = pe.get_buffer (in, nframes);
+
+		t_total += PBD::get_microseconds () - t0;
+
+		CPPUNIT_ASSERT_EQUAL (n_events, pe.get_midi_event_count (bi));
+
+		pframes_t prev = 0;
+		for (uint32_t i = 0; i < n_events; ++i) {
+			pframes_t      ts;
+			size_t         sz;
+			uint8_t const* data;
+			CPPUNIT_ASSERT_EQUAL (0, pe.midi_event_get (ts, sz, &data, bi, i));
+			CPPUNIT_ASSERT_EQUAL ((size_t) 3, sz);
+			CPPUNIT_ASSERT (ts >= prev);
+			CPPUNIT_ASSERT (ts < nframes);
+			prev = ts;
+		}
+	}
+
+	cout << "\nBackendMIDIBuffer: " << n_events << " events/cycle, "
+	     << t_total / (double) cycles << " us/cycle" << endl;
+
+	pe.unregister_port (out1);
+	pe.unregister_port (out2);
+	pe.unregister_port (in);
+
+	stop_and_destroy_backend ();
+}
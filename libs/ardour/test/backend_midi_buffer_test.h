@@ -0,0 +1,21 @@
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class BackendMIDIBufferTest : public CppUnit::TestFixture
+{
+	CPPUNIT_TEST_SUITE (BackendMIDIBufferTest);
+	CPPUNIT_TEST (pushOrderTest);
+	CPPUNIT_TEST (mergeTest);
+	CPPUNIT_TEST (capacityTest);
+	CPPUNIT_TEST (dummyBackendStressTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void setUp () {}
+	void tearDown () {}
+
+	void pushOrderTest ();
+	void mergeTest ();
+	void capacityTest ();
+	void dummyBackendStressTest ();
+};
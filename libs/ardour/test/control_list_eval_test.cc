@@ -0,0 +1,148 @@
+#include <cassert>
+
+#include "evoral/ControlList.h"
+#include "evoral/Curve.h"
+
+#include "control_list_eval_test.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (ControlListEvalTest);
+
+using namespace Evoral;
+using Temporal::timepos_t;
+
+namespace {
+
+/* ControlList evaluates from a contiguous copy of its events.
+ * Compare that against walking the event list point by point,
+ * which is how lists were evaluated before.
+ */
+class TestList : public ControlList
+{
+public:
+	TestList (ParameterDescriptor const& desc)
+		: ControlList (Parameter (0), desc, Temporal::AudioTime)
+	{}
+
+	double list_eval (timepos_t const& x) const
+	{
+		Glib::Threads::RWLock::ReaderLock lm (_lock);
+		if (x <= _events.front ()->when) {
+			return _events.front ()->value;
+		}
+		if (x >= _events.back ()->when) {
+			return _events.back ()->value;
+		}
+		return multipoint_eval (x);
+	}
+};
+
+static const ControlList::InterpolationStyle styles[] = {
+	ControlList::Linear,
+	ControlList::Discrete,
+	ControlList::Logarithmic,
+	ControlList::Exponential
+};
+
+static const int64_t spacing = 1000; // superclock ticks between points
+
+static boost::shared_ptr<TestList>
+make_list ()
+{
+	ParameterDescriptor desc;
+	desc.lower  = .001;
+	desc.upper  = 2;
+	desc.normal = 1;
+
+	boost::shared_ptr<TestList> cl (new TestList (desc));
+	cl->create_curve ();
+
+	/* dense automation */
+	for (int i = 0; i < 64; ++i) {
+		cl->fast_simple_add (timepos_t::from_superclock (i * spacing), (1 + i % 7) / 4.0);
+	}
+	return cl;
+}
+
+static void
+check_vector (boost::shared_ptr<TestList> cl, int64_t x0, int64_t dx, int32_t veclen = 1024)
+{
+	float vec[1024];
+	assert (veclen <= 1024);
+	cl->curve ().get_vector (timepos_t::from_superclock (x0), timepos_t::from_superclock (x0 + (veclen - 1) * dx), vec, veclen);
+
+	for (int i = 0; i < veclen; ++i) {
+		CPPUNIT_ASSERT_DOUBLES_EQUAL (cl->list_eval (timepos_t::from_superclock (x0 + i * dx)), vec[i], 1e-6);
+	}
+}
+
+}
+
+void
+ControlListEvalTest::evalTest ()
+{
+	boost::shared_ptr<TestList> cl (make_list ());
+
+	for (size_t s = 0; s < sizeof (styles) / sizeof (styles[0]); ++s) {
+		cl->set_interpolation (styles[s]);
+		/* every point, and between points, including after the list */
+		for (int64_t x = 0; x < 65 * spacing; x += spacing / 16 + 1) {
+			const timepos_t t (timepos_t::from_superclock (x));
+			CPPUNIT_ASSERT_DOUBLES_EQUAL (cl->list_eval (t), cl->eval (t), 1e-9);
+		}
+		for (int i = 0; i < 64; ++i) {
+			const timepos_t t (timepos_t::from_superclock (i * spacing));
+			CPPUNIT_ASSERT_DOUBLES_EQUAL (cl->list_eval (t), cl->eval (t), 1e-9);
+		}
+	}
+}
+
+void
+ControlListEvalTest::vectorTest ()
+{
+	boost::shared_ptr<TestList> cl (make_list ());
+
+	for (size_t s = 0; s < sizeof (styles) / sizeof (styles[0]); ++s) {
+		cl->set_interpolation (styles[s]);
+		/* many samples per segment */
+		check_vector (cl, 50, 10);
+		check_vector (cl, 5 * spacing + 7, 33);
+		/* several segments per sample */
+		check_vector (cl, 0, 2 * spacing + spacing / 3, 27);
+		/* after the end */
+		check_vector (cl, 64 * spacing, 100);
+	}
+}
+
+void
+ControlListEvalTest::editTest ()
+{
+	boost::shared_ptr<TestList> cl (make_list ());
+	cl->set_interpolation (ControlList::Linear);
+
+	const timepos_t t (timepos_t::from_superclock (10 * spacing + spacing / 4));
+	const double before = cl->eval (t);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (cl->list_eval (t), before, 1e-9);
+
+	/* edits invalidate the contiguous copy */
+	cl->add (timepos_t::from_superclock (10 * spacing + spacing / 2), 2.0, false, false);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (cl->list_eval (t), cl->eval (t), 1e-9);
+	CPPUNIT_ASSERT (cl->eval (t) != before);
+
+	/* appending many points and evaluating in between */
+	for (int i = 64; i < 4096; ++i) {
+		cl->fast_simple_add (timepos_t::from_superclock (i * spacing), (1 + i % 5) / 4.0);
+		if (i % 512 == 0) {
+			const timepos_t m (timepos_t::from_superclock (i * spacing - spacing / 3));
+			CPPUNIT_ASSERT_DOUBLES_EQUAL (cl->list_eval (m), cl->eval (m), 1e-9);
+		}
+	}
+	check_vector (cl, 4000 * spacing + 11, 10);
+
+	/* while frozen, events are evaluated from the list */
+	cl->freeze ();
+	cl->fast_simple_add (timepos_t::from_superclock (5000 * spacing), .5);
+	const timepos_t e (timepos_t::from_superclock (4500 * spacing));
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (cl->list_eval (e), cl->eval (e), 1e-9);
+	cl->thaw ();
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (cl->list_eval (e), cl->eval (e), 1e-9);
+}
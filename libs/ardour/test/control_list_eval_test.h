@@ -0,0 +1,16 @@
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class ControlListEvalTest : public CppUnit::TestFixture
+{
+	CPPUNIT_TEST_SUITE (ControlListEvalTest);
+	CPPUNIT_TEST (evalTest);
+	CPPUNIT_TEST (vectorTest);
+	CPPUNIT_TEST (editTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void evalTest ();
+	void vectorTest ();
+	void editTest ();
+};
@@ -0,0 +1,212 @@
+#include <cmath>
+#include <vector>
+
+#include "ardour/dsp_filter.h"
+
+#include "dsp_filter_test.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (DSPFilterTest);
+
+using namespace std;
+using namespace ARDOUR;
+
+static const uint32_t n_samples = 1024;
+
+static void
+fill_sine (vector<float>& d, double freq, double rate)
+{
+	for (size_t i = 0; i < d.size (); ++i) {
+		d[i] = sin (2.0 * M_PI * freq * i / rate);
+	}
+}
+
+static double
+rms (vector<float> const& d, size_t start, size_t end)
+{
+	double s = 0;
+	for (size_t i = start; i < end; ++i) {
+		s += d[i] * d[i];
+	}
+	return sqrt (s / (end - start));
+}
+
+void
+DSPFilterTest::rampTest ()
+{
+	vector<float> a (n_samples, 1.f);
+	vector<float> b (n_samples, .5f);
+
+	DSP::gain_ramp (&a[0], 0.f, 1.f, n_samples);
+	for (uint32_t i = 0; i < n_samples; ++i) {
+		CPPUNIT_ASSERT_DOUBLES_EQUAL (i / (double) n_samples, a[i], 1e-6);
+	}
+
+	/* constant gain, uses the optimized kernel */
+	DSP::gain_ramp (&a[0], 2.f, 2.f, n_samples);
+	for (uint32_t i = 0; i < n_samples; ++i) {
+		CPPUNIT_ASSERT_DOUBLES_EQUAL (2.0 * i / n_samples, a[i], 1e-6);
+	}
+
+	DSP::mix_ramp (&a[0], &b[0], 1.f, 0.f, n_samples);
+	for (uint32_t i = 0; i < n_samples; ++i) {
+		CPPUNIT_ASSERT_DOUBLES_EQUAL (2.0 * i / n_samples + .5 * (1.0 - i / (double) n_samples), a[i], 1e-5);
+	}
+
+	fill (a.begin (), a.end (), 1.f);
+	DSP::mix_ramp (&a[0], &b[0], 3.f, 3.f, n_samples);
+	for (uint32_t i = 0; i < n_samples; ++i) {
+		CPPUNIT_ASSERT_DOUBLES_EQUAL (2.5, a[i], 1e-6);
+	}
+
+	/* odd length and unaligned start */
+	fill (a.begin (), a.end (), 1.f);
+	DSP::gain_ramp (&a[1], .5f, .5f, 13);
+	CPPUNIT_ASSERT_EQUAL (1.f, a[0]);
+	for (uint32_t i = 1; i < 14; ++i) {
+		CPPUNIT_ASSERT_EQUAL (.5f, a[i]);
+	}
+	CPPUNIT_ASSERT_EQUAL (1.f, a[14]);
+}
+
+void
+DSPFilterTest::xfadeTest ()
+{
+	vector<float> a (n_samples, 1.f);
+	vector<float> b (n_samples, -1.f);
+
+	DSP::xfade (&a[0], &b[0], n_samples, false);
+	CPPUNIT_ASSERT_EQUAL (1.f, a[0]);
+	for (uint32_t i = 0; i < n_samples; ++i) {
+		CPPUNIT_ASSERT_DOUBLES_EQUAL (1.0 - 2.0 * i / n_samples, a[i], 1e-5);
+	}
+
+	/* constant power: gains are sqrt (1 - x) and sqrt (x) */
+	vector<float> c (n_samples, 1.f);
+	vector<float> d (n_samples, 0.f);
+	DSP::xfade (&c[0], &d[0], n_samples, true);
+	fill (a.begin (), a.end (), 0.f);
+	fill (b.begin (), b.end (), 1.f);
+	DSP::xfade (&a[0], &b[0], n_samples, true);
+	for (uint32_t i = 0; i < n_samples; ++i) {
+		CPPUNIT_ASSERT_DOUBLES_EQUAL (1.0, c[i] * c[i] + a[i] * a[i], 1e-5);
+	}
+	CPPUNIT_ASSERT_EQUAL (1.f, c[0]);
+	CPPUNIT_ASSERT_EQUAL (0.f, a[0]);
+}
+
+void
+DSPFilterTest::biquadCascadeTest ()
+{
+	const double rate = 48000;
+
+	DSP::BiquadCascade bc (rate, 2, 2);
+	bc.compute (0, DSP::Biquad::LowPass, 1000, .707, 0);
+	bc.compute (1, DSP::Biquad::HighPass, 100, .707, 0);
+
+	DSP::Biquad lp (rate);
+	DSP::Biquad hp (rate);
+	lp.compute (DSP::Biquad::LowPass, 1000, .707, 0);
+	hp.compute (DSP::Biquad::HighPass, 100, .707, 0);
+
+	vector<float> ref (n_samples);
+	vector<float> c0 (n_samples);
+	vector<float> c1 (n_samples);
+
+	/* same as running the stages one after another, channels are independent */
+	for (int cycle = 0; cycle < 4; ++cycle) {
+		fill_sine (ref, 440 * (cycle + 1), rate);
+		c0 = ref;
+		fill (c1.begin (), c1.end (), 0.f);
+		lp.run (&ref[0], n_samples);
+		hp.run (&ref[0], n_samples);
+		bc.run (0, &c0[0], n_samples);
+		bc.run (1, &c1[0], n_samples);
+		for (uint32_t i = 0; i < n_samples; ++i) {
+			CPPUNIT_ASSERT_DOUBLES_EQUAL (ref[i], c0[i], 1e-6);
+			CPPUNIT_ASSERT_EQUAL (0.f, c1[i]);
+		}
+	}
+
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (lp.dB_at_freq (5000) + hp.dB_at_freq (5000), bc.dB_at_freq (5000), 1e-3);
+	CPPUNIT_ASSERT (bc.dB_at_freq (10000) < -20);
+
+	/* out of range channel or stage is ignored */
+	fill_sine (c0, 440, rate);
+	ref = c0;
+	bc.run (2, &c0[0], n_samples);
+	bc.compute (2, DSP::Biquad::LowPass, 10, .707, 0);
+	for (uint32_t i = 0; i < n_samples; ++i) {
+		CPPUNIT_ASSERT_EQUAL (ref[i], c0[i]);
+	}
+}
+
+void
+DSPFilterTest::envelopeTest ()
+{
+	const double rate = 48000;
+	/* 10ms attack, 100ms release */
+	DSP::EnvelopeFollower ef (rate, 10, 100);
+
+	vector<float> d (4800, 1.f);
+	vector<float> e (4800);
+
+	ef.run (&d[0], &e[0], 4800);
+	/* rises monotonically, reaches 1 - 1/e after one time-constant */
+	for (uint32_t i = 1; i < 4800; ++i) {
+		CPPUNIT_ASSERT (e[i] >= e[i - 1]);
+	}
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (1.0 - exp (-1.0), e[479], 1e-3);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (1.0, ef.value (), 1e-3);
+
+	/* release */
+	fill (d.begin (), d.end (), 0.f);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (exp (-1.0), ef.process (&d[0], 4800), 1e-3);
+
+	/* in-place, negative values */
+	ef.reset ();
+	fill (d.begin (), d.end (), -1.f);
+	ef.run (&d[0], &d[0], 480);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (1.0 - exp (-1.0), d[479], 1e-3);
+}
+
+void
+DSPFilterTest::resamplerTest ()
+{
+	const double   rate = 48000;
+	const uint32_t q    = 32;
+	vector<float>  in (8192);
+	vector<float>  out (4096);
+
+	DSP::Resampler down (.5, q);
+	CPPUNIT_ASSERT_EQUAL (.5, down.ratio ());
+
+	/* DC and frequencies below the target Nyquist frequency pass */
+	fill (in.begin (), in.end (), 1.f);
+	uint32_t n = down.process (&in[0], in.size (), &out[0], out.size ());
+	CPPUNIT_ASSERT (n > 4000 && n <= 4096);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (1.0, rms (out, 2 * q, n - q), 1e-3);
+
+	down.reset ();
+	fill_sine (in, 2400, rate);
+	n = down.process (&in[0], in.size (), &out[0], out.size ());
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (sqrt (.5), rms (out, 2 * q, n - q), 1e-2);
+
+	/* above the target Nyquist frequency (12kHz) is removed, not aliased */
+	down.reset ();
+	fill_sine (in, 19200, rate);
+	n = down.process (&in[0], in.size (), &out[0], out.size ());
+	CPPUNIT_ASSERT (rms (out, 2 * q, n - q) < 1e-2);
+
+	down.reset ();
+	fill_sine (in, 13000, rate);
+	n = down.process (&in[0], in.size (), &out[0], out.size ());
+	CPPUNIT_ASSERT (rms (out, 2 * q, n - q) < 1e-2);
+
+	/* upsampling */
+	DSP::Resampler up (2, q);
+	out.resize (16384);
+	fill_sine (in, 2400, rate);
+	n = up.process (&in[0], in.size (), &out[0], out.size ());
+	CPPUNIT_ASSERT (n > 16000 && n <= 16384);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (sqrt (.5), rms (out, 4 * q, n - 2 * q), 1e-2);
+}
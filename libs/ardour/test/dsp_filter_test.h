@@ -0,0 +1,23 @@
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class DSPFilterTest : public CppUnit::TestFixture
+{
+	CPPUNIT_TEST_SUITE (DSPFilterTest);
+	CPPUNIT_TEST (rampTest);
+	CPPUNIT_TEST (xfadeTest);
+	CPPUNIT_TEST (biquadCascadeTest);
+	CPPUNIT_TEST (envelopeTest);
+	CPPUNIT_TEST (resamplerTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void setUp () {}
+	void tearDown () {}
+
+	void rampTest ();
+	void xfadeTest ();
+	void biquadCascadeTest ();
+	void envelopeTest ();
+	void resamplerTest ();
+};
@@ -0,0 +1,380 @@
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <set>
+
+#include "pbd/microseconds.h"
+
+#include "evoral/Control.h"
+#include "evoral/ControlList.h"
+#include "evoral/NoteStore.h"
+#include "evoral/Sequence.h"
+#include "evoral/TypeMap.h"
+#include "evoral/midi_events.h"
+
+#include "temporal/beats.h"
+
+#include "note_store_test.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (NoteStoreTest);
+
+using namespace std;
+using namespace Evoral;
+
+typedef Temporal::Beats Time;
+typedef NoteStore<Time> Store;
+
+namespace {
+
+class TestTypeMap : public TypeMap
+{
+public:
+	bool          type_is_midi (uint32_t) const { return true; }
+	uint8_t       parameter_midi_type (Parameter const&) const { return 0; }
+	ParameterType midi_parameter_type (uint8_t const*, uint32_t) const { return 0; }
+	std::string   to_symbol (Parameter const&) const { return "control"; }
+
+	ParameterDescriptor descriptor (Parameter const&) const
+	{
+		return ParameterDescriptor ();
+	}
+};
+
+class TestSequence : public Sequence<Time>
+{
+public:
+	TestSequence (TypeMap const& map)
+		: Sequence<Time> (map)
+	{}
+
+	TestSequence (TestSequence const& other)
+		: ControlSet (other)
+		, Sequence<Time> (other)
+	{}
+
+	boost::shared_ptr<Control> control_factory (Parameter const& param)
+	{
+		ParameterDescriptor            desc;
+		boost::shared_ptr<ControlList> list (new ControlList (param, desc, Temporal::BeatTime));
+		return boost::shared_ptr<Control> (new Control (param, desc, list));
+	}
+};
+
+struct TestEvent {
+	TestEvent (Time t, uint8_t s, uint8_t n, uint8_t v, event_id_t i)
+		: time (t), id (i)
+	{
+		buf[0] = s;
+		buf[1] = n;
+		buf[2] = v;
+	}
+
+	bool operator< (TestEvent const& other) const { return time < other.time; }
+
+	Time       time;
+	uint8_t    buf[3];
+	event_id_t id;
+};
+
+} // anonymous namespace
+
+static void
+check_order (Store const& s)
+{
+	for (size_t r = 1; r < s.size (); ++r) {
+		CPPUNIT_ASSERT (s.time (r - 1) <= s.time (r));
+	}
+	for (size_t r = 0; r < s.size (); ++r) {
+		CPPUNIT_ASSERT_EQUAL (r, s.row (s.handle (r)));
+	}
+}
+
+static void
+load (TestSequence& seq, vector<TestEvent> const& events, bool compact, Time end)
+{
+	Event<Time> ev (MIDI_EVENT, Time (), 3, NULL, true);
+
+	seq.set_compact_notes (compact);
+	seq.start_write ();
+	for (vector<TestEvent>::const_iterator i = events.begin (); i != events.end (); ++i) {
+		ev.set (i->buf, 3, i->time);
+		seq.append (ev, i->id);
+	}
+	seq.end_write (Sequence<Time>::ResolveStuckNotes, end);
+}
+
+static size_t
+compare (TestSequence const& a, TestSequence const& b, Time start = Time ())
+{
+	size_t                             n = 0;
+	TestSequence::const_iterator       j = b.begin (start);
+
+	for (TestSequence::const_iterator i = a.begin (start); i != a.end (); ++i, ++j) {
+		CPPUNIT_ASSERT (j != b.end ());
+		CPPUNIT_ASSERT_EQUAL (i->time (), j->time ());
+		CPPUNIT_ASSERT_EQUAL (i->size (), j->size ());
+		CPPUNIT_ASSERT_EQUAL (i->buffer ()[0], j->buffer ()[0]);
+		CPPUNIT_ASSERT_EQUAL (i->buffer ()[1], j->buffer ()[1]);
+		CPPUNIT_ASSERT_EQUAL (i->buffer ()[2], j->buffer ()[2]);
+		CPPUNIT_ASSERT_EQUAL (i->id (), j->id ());
+		++n;
+	}
+	CPPUNIT_ASSERT (j == b.end ());
+	return n;
+}
+
+void
+NoteStoreTest::addRemoveTest ()
+{
+	Store s;
+	CPPUNIT_ASSERT (s.empty ());
+
+	Store::Handle c = s.add (Time::ticks (960 * 2), Time::ticks (960), 0, 60, 100);
+	Store::Handle a = s.add (Time (), Time::ticks (960), 0, 62, 90);
+	Store::Handle b = s.add (Time::ticks (960), Time::ticks (960), 1, 64, 80);
+
+	CPPUNIT_ASSERT_EQUAL (size_t (3), s.size ());
+	check_order (s);
+
+	CPPUNIT_ASSERT_EQUAL (size_t (0), s.row (a));
+	CPPUNIT_ASSERT_EQUAL (size_t (1), s.row (b));
+	CPPUNIT_ASSERT_EQUAL (size_t (2), s.row (c));
+	CPPUNIT_ASSERT_EQUAL (uint8_t (64), s.note (s.row (b)));
+	CPPUNIT_ASSERT_EQUAL (uint8_t (1), s.channel (s.row (b)));
+	CPPUNIT_ASSERT (s.id (s.row (a)) != s.id (s.row (b)));
+
+	s.remove (b);
+	CPPUNIT_ASSERT (!s.valid (b));
+	CPPUNIT_ASSERT (s.valid (a));
+	CPPUNIT_ASSERT (s.valid (c));
+	CPPUNIT_ASSERT_EQUAL (size_t (2), s.size ());
+	CPPUNIT_ASSERT_EQUAL (uint8_t (60), s.note (s.row (c)));
+	check_order (s);
+
+	/* notes added at the same time go after existing ones, as in a multiset */
+	Store::Handle d = s.add (Time (), Time::ticks (10), 0, 70, 100);
+	CPPUNIT_ASSERT_EQUAL (size_t (1), s.row (d));
+	CPPUNIT_ASSERT_EQUAL (size_t (2), s.lower_bound (Time::ticks (1)));
+	CPPUNIT_ASSERT_EQUAL (size_t (0), s.lower_bound (Time ()));
+	check_order (s);
+
+	s.clear ();
+	CPPUNIT_ASSERT (s.empty ());
+	CPPUNIT_ASSERT (!s.valid (a));
+}
+
+void
+NoteStoreTest::editTest ()
+{
+	Store                 s;
+	vector<Store::Handle> h;
+	for (int i = 0; i < 16; ++i) {
+		h.push_back (s.add (Time::ticks (i * 100), Time::ticks (50), 0, 60 + (i % 4), 100));
+	}
+
+	CPPUNIT_ASSERT_EQUAL (size_t (4), s.pitch_index (0, 60).size ());
+
+	/* move the first note to the end, keeping its handle and ID */
+	const event_id_t id = s.id (s.row (h[0]));
+	s.set_time (h[0], Time::ticks (5000));
+	CPPUNIT_ASSERT_EQUAL (size_t (15), s.row (h[0]));
+	CPPUNIT_ASSERT_EQUAL (size_t (0), s.row (h[1]));
+	CPPUNIT_ASSERT_EQUAL (id, s.id (s.row (h[0])));
+	check_order (s);
+
+	/* the pitch index stays in time order */
+	vector<Store::Handle> const& p60 = s.pitch_index (0, 60);
+	CPPUNIT_ASSERT_EQUAL (h[0], p60.back ());
+	for (size_t i = 1; i < p60.size (); ++i) {
+		CPPUNIT_ASSERT (s.row (p60[i - 1]) < s.row (p60[i]));
+	}
+
+	s.set_note (h[5], 72);
+	CPPUNIT_ASSERT_EQUAL (size_t (3), s.pitch_index (0, 61).size ());
+	CPPUNIT_ASSERT_EQUAL (size_t (1), s.pitch_index (0, 72).size ());
+	CPPUNIT_ASSERT_EQUAL (uint8_t (72), s.note (s.row (h[5])));
+
+	s.set_velocity (h[3], 12);
+	s.set_length (h[3], Time::ticks (7));
+	CPPUNIT_ASSERT_EQUAL (uint8_t (12), s.velocity (s.row (h[3])));
+	CPPUNIT_ASSERT_EQUAL (Time::ticks (307), s.end_time (s.row (h[3])));
+
+	Store::NotePtr n = s.note_ptr (s.row (h[3]));
+	CPPUNIT_ASSERT_EQUAL (Time::ticks (300), n->time ());
+	CPPUNIT_ASSERT_EQUAL (uint8_t (63), n->note ());
+	CPPUNIT_ASSERT_EQUAL (s.id (s.row (h[3])), n->id ());
+}
+
+/* A Sequence with compact notes must play back exactly like one without,
+ * before and after its notes are expanded.
+ */
+void
+NoteStoreTest::compactSequenceTest ()
+{
+	TestTypeMap       map;
+	TestSequence      seq (map);
+	TestSequence      compact (map);
+	vector<TestEvent> events;
+	set<Time>         ends;
+
+	/* note-ons are at multiples of 8 ticks and note-offs 3 ticks later,
+	 * and no two notes end together, so the event order is unambiguous.
+	 * A few pitches on a few channels make for overlapping notes that
+	 * are resolved first-in, first-out.
+	 */
+	srand (1);
+	for (int i = 0; i < 500; ++i) {
+		const Time    t = Time::ticks (i * 8);
+		const uint8_t c = i % 3;
+		const uint8_t n = 60 + rand () % 8;
+		Time          e;
+		do {
+			e = t + Time::ticks (3 + 8 * (rand () % 40));
+		} while (ends.find (e) != ends.end ());
+		ends.insert (e);
+
+		events.push_back (TestEvent (t, MIDI_CMD_NOTE_ON | c, n, 1 + rand () % 127, 2 * i + 1));
+		events.push_back (TestEvent (e, MIDI_CMD_NOTE_OFF | c, n, rand () % 128, 2 * i + 2));
+	}
+
+	/* a stuck note, and a note-off without a note-on */
+	events.push_back (TestEvent (Time::ticks (8 * 600), MIDI_CMD_NOTE_ON | 5, 40, 90, 5000));
+	events.push_back (TestEvent (Time::ticks (8 * 601), MIDI_CMD_NOTE_OFF | 6, 41, 0, 5001));
+
+	stable_sort (events.begin (), events.end ());
+
+	load (seq, events, false, Time::ticks (8 * 700));
+	load (compact, events, true, Time::ticks (8 * 700));
+
+	CPPUNIT_ASSERT (!seq.notes_in_store ());
+	CPPUNIT_ASSERT (compact.notes_in_store ());
+	CPPUNIT_ASSERT_EQUAL (size_t (501), seq.n_notes ());
+	CPPUNIT_ASSERT_EQUAL (seq.n_notes (), compact.n_notes ());
+	CPPUNIT_ASSERT_EQUAL (seq.lowest_note (), compact.lowest_note ());
+	CPPUNIT_ASSERT_EQUAL (seq.highest_note (), compact.highest_note ());
+
+	CPPUNIT_ASSERT_EQUAL (size_t (1002), compare (seq, compact));
+	compare (seq, compact, Time::ticks (8 * 250 + 1));
+
+	/* expanding while an iterator is in use */
+	TestSequence::const_iterator i = compact.begin ();
+	++i;
+
+	CPPUNIT_ASSERT_EQUAL (seq.notes ().size (), compact.notes ().size ());
+	CPPUNIT_ASSERT (!compact.notes_in_store ());
+
+	size_t n = 1;
+	for (; i != compact.end (); ++i) {
+		++n;
+	}
+	CPPUNIT_ASSERT_EQUAL (size_t (1002), n);
+
+	/* and with Note objects */
+	CPPUNIT_ASSERT_EQUAL (size_t (1002), compare (seq, compact));
+
+	TestSequence::NotePtr first = *compact.notes ().begin ();
+	compact.remove_note_unlocked (first);
+	CPPUNIT_ASSERT_EQUAL (size_t (500), compact.n_notes ());
+
+	/* a copy of a compact sequence stays compact */
+	TestSequence copy (map);
+	load (copy, events, true, Time::ticks (8 * 700));
+	TestSequence copied (copy);
+	CPPUNIT_ASSERT (copied.notes_in_store ());
+	CPPUNIT_ASSERT_EQUAL (size_t (1002), compare (seq, copied));
+}
+
+/* Compare load, iteration and edit cost of a Sequence with and without
+ * compact notes, and of a bare NoteStore. The number of notes can be set
+ * with EVORAL_BENCH_NOTES.
+ */
+void
+NoteStoreTest::benchmark ()
+{
+	size_t n_notes = 1000000;
+	if (getenv ("EVORAL_BENCH_NOTES")) {
+		n_notes = atoi (getenv ("EVORAL_BENCH_NOTES"));
+	}
+	const size_t n_edits = std::min<size_t> (n_notes, 1000);
+
+	vector<TestEvent> events;
+	vector<uint8_t>   pitches;
+
+	events.reserve (n_notes * 2);
+	pitches.reserve (n_notes);
+
+	/* every note lasts 4 notes, its note-off precedes the note-on at the same time */
+	srand (1);
+	for (size_t i = 0; i < n_notes; ++i) {
+		pitches.push_back (rand () % 128);
+		if (i >= 4) {
+			events.push_back (TestEvent (Time::ticks (i * 10), MIDI_CMD_NOTE_OFF, pitches[i - 4], 64, -1));
+		}
+		events.push_back (TestEvent (Time::ticks (i * 10), MIDI_CMD_NOTE_ON, pitches[i], 100, -1));
+	}
+	for (size_t i = n_notes > 4 ? n_notes - 4 : 0; i < n_notes; ++i) {
+		events.push_back (TestEvent (Time::ticks (i * 10 + 40), MIDI_CMD_NOTE_OFF, pitches[i], 64, -1));
+	}
+
+	TestTypeMap  map;
+	TestSequence seq (map);
+	TestSequence compact (map);
+	Store        store;
+
+	PBD::microseconds_t t0 = PBD::get_microseconds ();
+	load (seq, events, false, Time ());
+	PBD::microseconds_t t1 = PBD::get_microseconds ();
+	load (compact, events, true, Time ());
+	PBD::microseconds_t t2 = PBD::get_microseconds ();
+
+	CPPUNIT_ASSERT (compact.notes_in_store ());
+
+	size_t seq_events = 0;
+	for (TestSequence::const_iterator i = seq.begin (); i != seq.end (); ++i) {
+		++seq_events;
+	}
+	PBD::microseconds_t t3 = PBD::get_microseconds ();
+	size_t compact_events = 0;
+	for (TestSequence::const_iterator i = compact.begin (); i != compact.end (); ++i) {
+		++compact_events;
+	}
+	PBD::microseconds_t t4 = PBD::get_microseconds ();
+
+	CPPUNIT_ASSERT_EQUAL (n_notes * 2, seq_events);
+	CPPUNIT_ASSERT_EQUAL (seq_events, compact_events);
+
+	/* move notes around; a compact sequence is expanded on first use */
+	vector<TestSequence::NotePtr> notes (seq.notes ().begin (), seq.notes ().end ());
+	PBD::microseconds_t t5 = PBD::get_microseconds ();
+	for (size_t i = 0; i < n_edits; ++i) {
+		TestSequence::NotePtr n = notes[(i * 7919) % n_notes];
+		seq.remove_note_unlocked (n);
+		n->set_time (n->time () + Time::ticks (5));
+		seq.add_note_unlocked (n);
+	}
+	PBD::microseconds_t t6 = PBD::get_microseconds ();
+	compact.notes ();
+	PBD::microseconds_t t7 = PBD::get_microseconds ();
+
+	CPPUNIT_ASSERT (!compact.notes_in_store ());
+	CPPUNIT_ASSERT_EQUAL (n_notes, compact.n_notes ());
+
+	vector<Store::Handle> handles;
+	handles.reserve (n_notes);
+	store.reserve (n_notes);
+	for (size_t i = 0; i < n_notes; ++i) {
+		handles.push_back (store.add (Time::ticks (i * 10), Time::ticks (40), 0, pitches[i], 100));
+	}
+	PBD::microseconds_t t8 = PBD::get_microseconds ();
+	for (size_t i = 0; i < n_edits; ++i) {
+		Store::Handle h = handles[(i * 7919) % n_notes];
+		store.set_time (h, store.time (store.row (h)) + Time::ticks (5));
+	}
+	PBD::microseconds_t t9 = PBD::get_microseconds ();
+
+	cout << endl << "NoteStore benchmark, " << n_notes << " notes, " << n_edits << " edits" << endl
+	     << "  load:    Sequence " << (t1 - t0) / 1000.0 << " ms, compact " << (t2 - t1) / 1000.0 << " ms" << endl
+	     << "  iterate: Sequence " << (t3 - t2) / 1000.0 << " ms, compact " << (t4 - t3) / 1000.0 << " ms" << endl
+	     << "  expand:  " << (t7 - t6) / 1000.0 << " ms" << endl
+	     << "  edit:    Sequence " << (t6 - t5) / 1000.0 << " ms, NoteStore " << (t9 - t8) / 1000.0 << " ms" << endl;
+}
@@ -0,0 +1,18 @@
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class NoteStoreTest : public CppUnit::TestFixture
+{
+	CPPUNIT_TEST_SUITE (NoteStoreTest);
+	CPPUNIT_TEST (addRemoveTest);
+	CPPUNIT_TEST (editTest);
+	CPPUNIT_TEST (compactSequenceTest);
+	CPPUNIT_TEST (benchmark);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void addRemoveTest ();
+	void editTest ();
+	void compactSequenceTest ();
+	void benchmark ();
+};
@@ -0,0 +1,125 @@
+#include <cmath>
+
+#include <glib/gstdio.h>
+#include <glibmm/fileutils.h>
+#include <glibmm/miscutils.h>
+
+#include "ardour/sndfilesource.h"
+#include "ardour/source_factory.h"
+#include "peak_pyramid_test.h"
+#include "test_util.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (PeakPyramidTest);
+
+using namespace ARDOUR;
+
+void
+PeakPyramidTest::setUp ()
+{
+	TestNeedingSession::setUp ();
+
+	_build_peakfiles = AudioSource::get_build_peakfiles ();
+	AudioSource::set_build_peakfiles (true);
+	AudioSource::set_build_missing_peakfiles (true);
+
+	/* a bit over 20 blocks of the coarsest pyramid level */
+	_data.resize (20 * 65536 + 1234);
+	for (size_t i = 0; i < _data.size (); ++i) {
+		_data[i] = sinf (i * .01f) * (.1f + .8f * ((i / 3000) % 10) / 10.f);
+	}
+
+	_path = Glib::build_filename (new_test_output_dir (), "peak_pyramid.wav");
+
+	boost::shared_ptr<SndFileSource> w = boost::dynamic_pointer_cast<SndFileSource> (
+			SourceFactory::createWritable (DataType::AUDIO, *_session, _path, get_test_sample_rate (), false));
+	CPPUNIT_ASSERT (w);
+	CPPUNIT_ASSERT_EQUAL ((samplecnt_t) _data.size (), w->write (&_data[0], _data.size ()));
+	w->flush_header ();
+	w->flush ();
+}
+
+void
+PeakPyramidTest::tearDown ()
+{
+	AudioSource::set_build_peakfiles (_build_peakfiles);
+	AudioSource::set_build_missing_peakfiles (false);
+
+	TestNeedingSession::tearDown ();
+}
+
+boost::shared_ptr<AudioFileSource>
+PeakPyramidTest::open_source ()
+{
+	/* read-only, builds the peakfile if it does not exist yet */
+	boost::shared_ptr<AudioFileSource> src (new SndFileSource (*_session, _path, 0, Source::Flag (0)));
+	CPPUNIT_ASSERT_EQUAL (0, src->setup_peakfile ());
+	CPPUNIT_ASSERT_EQUAL ((samplecnt_t) _data.size (), src->length ().samples ());
+	return src;
+}
+
+void
+PeakPyramidTest::check_peaks (boost::shared_ptr<AudioFileSource> src, samplecnt_t spp)
+{
+	const samplecnt_t npeaks = (_data.size () + spp - 1) / spp;
+	std::vector<PeakData> peaks (npeaks);
+
+	CPPUNIT_ASSERT_EQUAL (0, src->read_peaks (&peaks[0], npeaks, 0, _data.size (), spp));
+
+	for (samplecnt_t p = 0; p < npeaks; ++p) {
+		const size_t s0 = p * spp;
+		const size_t s1 = std::min (_data.size (), (size_t) (s0 + spp));
+		float        mn = _data[s0];
+		float        mx = _data[s0];
+		for (size_t s = s0 + 1; s < s1; ++s) {
+			mn = std::min (mn, _data[s]);
+			mx = std::max (mx, _data[s]);
+		}
+		CPPUNIT_ASSERT_EQUAL (mn, peaks[p].min);
+		CPPUNIT_ASSERT_EQUAL (mx, peaks[p].max);
+	}
+}
+
+void
+PeakPyramidTest::buildTest ()
+{
+	boost::shared_ptr<AudioFileSource> src (open_source ());
+
+	/* computed in the same pass as the peakfile */
+	CPPUNIT_ASSERT (src->has_peak_pyramid ());
+
+	/* both levels, and in-between zoom levels that reduce a level */
+	check_peaks (src, 4096);
+	check_peaks (src, 16384);
+	check_peaks (src, 65536);
+	check_peaks (src, 4 * 65536);
+}
+
+void
+PeakPyramidTest::upgradeTest ()
+{
+	std::string pyramid_path;
+
+	{
+		boost::shared_ptr<AudioFileSource> src (open_source ());
+		pyramid_path = src->construct_peak_filepath (src->path (), src->within_session ()) + ".pyr";
+	}
+
+	/* a peakfile written by an older version */
+	CPPUNIT_ASSERT (Glib::file_test (pyramid_path, Glib::FILE_TEST_EXISTS));
+	::g_unlink (pyramid_path.c_str ());
+
+	boost::shared_ptr<AudioFileSource> src (open_source ());
+	CPPUNIT_ASSERT (!src->has_peak_pyramid ());
+
+	/* zoomed out reads work without the pyramid, and schedule it to be built */
+	const samplecnt_t npeaks = _data.size () / 65536;
+	std::vector<PeakData> peaks (npeaks);
+	CPPUNIT_ASSERT_EQUAL (0, src->read_peaks (&peaks[0], npeaks, 0, npeaks * 65536, 65536));
+
+	CPPUNIT_ASSERT_EQUAL (0, src->build_peak_pyramid ());
+	CPPUNIT_ASSERT (src->has_peak_pyramid ());
+	CPPUNIT_ASSERT (Glib::file_test (pyramid_path, Glib::FILE_TEST_EXISTS));
+
+	check_peaks (src, 4096);
+	check_peaks (src, 65536);
+}
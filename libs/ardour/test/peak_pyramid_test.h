@@ -0,0 +1,34 @@
+#include <string>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+
+#include "ardour/types.h"
+#include "test_needing_session.h"
+
+namespace ARDOUR {
+	class AudioFileSource;
+}
+
+class PeakPyramidTest : public TestNeedingSession
+{
+	CPPUNIT_TEST_SUITE (PeakPyramidTest);
+	CPPUNIT_TEST (buildTest);
+	CPPUNIT_TEST (upgradeTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void setUp ();
+	void tearDown ();
+
+	void buildTest ();
+	void upgradeTest ();
+
+private:
+	boost::shared_ptr<ARDOUR::AudioFileSource> open_source ();
+	void check_peaks (boost::shared_ptr<ARDOUR::AudioFileSource>, ARDOUR::samplecnt_t samples_per_peak);
+
+	std::string                _path;
+	std::vector<ARDOUR::Sample> _data;
+	bool                       _build_peakfiles;
+};
@@ -0,0 +1,224 @@
+#include <iostream>
+#include <boost/bind.hpp>
+
+#include <glibmm/threads.h>
+
+#include "pbd/compose.h"
+#include "pbd/microseconds.h"
+#include "pbd/pthread_utils.h"
+#include "pbd/semutils.h"
+
+#include "ardour/ardour.h"
+#include "ardour/audioengine.h"
+#include "ardour/rt_tasklist.h"
+#include "ardour/utils.h"
+
+#include "test_ui.h"
+#include "test_util.h"
+
+using namespace std;
+using namespace PBD;
+using namespace ARDOUR;
+
+static const char* localedir = LOCALEDIR;
+
+/* Compare the previous RTTaskList implementation with the task arena,
+ * for 1k .. 10k tasks per cycle.
+ */
+
+/* The RTTaskList implementation that the arena replaced: a std::list of
+ * boost::function, shared with the worker threads through a mutex.
+ * It shipped with the parallel path disabled (tasks ran serially in
+ * process ()), both variants are measured.
+ */
+class BaselineTaskList
+{
+public:
+	BaselineTaskList (uint32_t n_threads, bool parallel)
+		: _parallel (parallel)
+		, _task_run_sem ("baseline_run", 0)
+		, _task_end_sem ("baseline_done", 0)
+	{
+		g_atomic_int_set (&_threads_active, 1);
+		for (uint32_t i = 0; parallel && i < n_threads; ++i) {
+			pthread_t thread_id;
+			pbd_pthread_create (PBD_RT_STACKSIZE_HELP, &thread_id, _thread_run, this);
+			_threads.push_back (thread_id);
+		}
+	}
+
+	~BaselineTaskList ()
+	{
+		g_atomic_int_set (&_threads_active, 0);
+		for (size_t i = 0; i < _threads.size (); ++i) {
+			_task_run_sem.signal ();
+		}
+		for (std::vector<pthread_t>::const_iterator i = _threads.begin (); i != _threads.end (); ++i) {
+			pthread_join (*i, NULL);
+		}
+	}
+
+	void process (RTTaskList::TaskList const& tl)
+	{
+		Glib::Threads::Mutex::Lock tm (_tasklist_mutex, Glib::Threads::NOT_LOCK);
+		tm.acquire ();
+		_tasklist = tl;
+		tm.release ();
+
+		if (!_parallel || _threads.empty ()) {
+			for (RTTaskList::TaskList::iterator i = _tasklist.begin (); i != _tasklist.end (); ++i) {
+				(*i)();
+			}
+		} else {
+			uint32_t nt = std::min (_threads.size (), _tasklist.size ());
+			for (uint32_t i = 0; i < nt; ++i) {
+				_task_run_sem.signal ();
+			}
+			for (uint32_t i = 0; i < nt; ++i) {
+				_task_end_sem.wait ();
+			}
+		}
+
+		tm.acquire ();
+		_tasklist.clear ();
+		tm.release ();
+	}
+
+private:
+	static void* _thread_run (void* arg)
+	{
+		static_cast<BaselineTaskList*> (arg)->run ();
+		return 0;
+	}
+
+	void run ()
+	{
+		Glib::Threads::Mutex::Lock tm (_tasklist_mutex, Glib::Threads::NOT_LOCK);
+		bool wait = true;
+
+		while (true) {
+			if (wait) {
+				_task_run_sem.wait ();
+			}
+			if (0 == g_atomic_int_get (&_threads_active)) {
+				break;
+			}
+			wait = false;
+
+			boost::function<void ()> to_run;
+			tm.acquire ();
+			if (!_tasklist.empty ()) {
+				to_run = _tasklist.front ();
+				_tasklist.pop_front ();
+			}
+			tm.release ();
+
+			if (!to_run.empty ()) {
+				to_run ();
+				continue;
+			}
+
+			_task_end_sem.signal ();
+			wait = true;
+		}
+	}
+
+	bool                   _parallel;
+	GATOMIC_QUAL gint      _threads_active;
+	std::vector<pthread_t> _threads;
+	Glib::Threads::Mutex   _tasklist_mutex;
+	PBD::Semaphore         _task_run_sem;
+	PBD::Semaphore         _task_end_sem;
+	RTTaskList::TaskList   _tasklist;
+};
+
+struct Work {
+	Work () : acc (0) {}
+
+	void run (uint32_t n)
+	{
+		float a = acc;
+		for (uint32_t i = 0; i < n; ++i) {
+			a = a * 0.999f + 1.f;
+		}
+		acc = a;
+	}
+
+	float acc;
+};
+
+int
+main (int argc, char* argv[])
+{
+	const int      cycles = argc > 1 ? atoi (argv[1]) : 1000;
+	const uint32_t load   = argc > 2 ? atoi (argv[2]) : 64;
+
+	ARDOUR::init (true, localedir);
+	TestUI* test_ui = new TestUI();
+	create_and_start_dummy_backend ();
+
+	RTTaskList       rtl (10000);
+	BaselineTaskList serial (0, false);
+	BaselineTaskList parallel (how_many_dsp_threads (), true);
+
+	cout << "INFO: " << how_many_dsp_threads () << " DSP threads, " << cycles << " cycles, load " << load << "\n";
+
+	static const uint32_t n_tasks[] = { 1000, 2000, 5000, 10000 };
+
+	for (size_t t = 0; t < sizeof (n_tasks) / sizeof (uint32_t); ++t) {
+		const uint32_t n = n_tasks[t];
+		std::vector<Work> work (n);
+
+		microseconds_t tb0 = get_microseconds ();
+		for (int c = 0; c < cycles; ++c) {
+			RTTaskList::TaskList tl;
+			for (uint32_t i = 0; i < n; ++i) {
+				tl.push_back (boost::bind (&Work::run, &work[i], load));
+			}
+			serial.process (tl);
+		}
+		microseconds_t tb1 = get_microseconds ();
+		for (int c = 0; c < cycles; ++c) {
+			RTTaskList::TaskList tl;
+			for (uint32_t i = 0; i < n; ++i) {
+				tl.push_back (boost::bind (&Work::run, &work[i], load));
+			}
+			parallel.process (tl);
+		}
+		microseconds_t t0 = get_microseconds ();
+		for (int c = 0; c < cycles; ++c) {
+			RTTaskList::TaskList tl;
+			for (uint32_t i = 0; i < n; ++i) {
+				tl.push_back (boost::bind (&Work::run, &work[i], load));
+			}
+			rtl.process (tl);
+		}
+		microseconds_t t1 = get_microseconds ();
+		for (int c = 0; c < cycles; ++c) {
+			for (uint32_t i = 0; i < n; ++i) {
+				rtl.push_back (boost::bind (&Work::run, &work[i], load));
+			}
+			rtl.process ();
+		}
+		microseconds_t t2 = get_microseconds ();
+		for (int c = 0; c < cycles; ++c) {
+			for (uint32_t i = 0; i < n; ++i) {
+				work[i].run (load);
+			}
+		}
+		microseconds_t t3 = get_microseconds ();
+
+		cout << string_compose ("%1 tasks/cycle: baseline %2 us/cycle, baseline-parallel %3 us/cycle, list API %4 us/cycle, arena %5 us/cycle, plain loop %6 us/cycle\n",
+		                        n,
+		                        (tb1 - tb0) / (double)cycles,
+		                        (t0 - tb1) / (double)cycles,
+		                        (t1 - t0) / (double)cycles,
+		                        (t2 - t1) / (double)cycles,
+		                        (t3 - t2) / (double)cycles);
+	}
+
+	stop_and_destroy_backend ();
+	delete test_ui;
+	ARDOUR::cleanup ();
+	return 0;
+}
@@ -0,0 +1,131 @@
+#include <iostream>
+#include <vector>
+#include <cstdlib>
+
+#include "pbd/compose.h"
+#include "pbd/fpu.h"
+#include "pbd/microseconds.h"
+
+#include "ardour/mix.h"
+#include "ardour/types.h"
+
+using namespace std;
+using namespace PBD;
+using namespace ARDOUR;
+
+/* Compare the runtime-dispatched DSP kernels of the available
+ * ISA tiers (generic, SSE, AVX, FMA, AVX-512F) for 32 .. 8192 samples.
+ */
+
+struct Kernels {
+	const char* name;
+	float (*compute_peak) (Sample const*, pframes_t, float);
+	void  (*apply_gain_to_buffer) (Sample*, pframes_t, float);
+	void  (*mix_buffers_with_gain) (Sample*, Sample const*, pframes_t, float);
+	float (*apply_gain_ramp_to_buffer) (Sample*, pframes_t, float, float, float);
+	void  (*apply_gain_vector_to_buffer) (Sample*, gain_t const*, pframes_t);
+	void  (*deinterleave_buffer) (Sample*, Sample const*, pframes_t, uint32_t, uint32_t);
+	float (*mix_buffers_with_gain_and_peak) (Sample*, Sample const*, pframes_t, float, float);
+};
+
+static volatile float sink;
+
+static double
+bench (Kernels const& k, int kernel, uint32_t n_samples, int iter)
+{
+	std::vector<Sample> a (n_samples * 2);
+	std::vector<Sample> b (n_samples * 2);
+	for (uint32_t i = 0; i < n_samples * 2; ++i) {
+		a[i] = (rand () / (float)RAND_MAX) * .5f;
+		b[i] = (rand () / (float)RAND_MAX) * .5f;
+	}
+
+	float r = 0;
+	microseconds_t t0 = get_microseconds ();
+	for (int it = 0; it < iter; ++it) {
+		switch (kernel) {
+			case 0: r = k.compute_peak (&a[0], n_samples, r); break;
+			case 1: k.apply_gain_to_buffer (&a[0], n_samples, 1.f); break;
+			case 2: k.mix_buffers_with_gain (&a[0], &b[0], n_samples, 0.f); break;
+			case 3: r += k.apply_gain_ramp_to_buffer (&a[0], n_samples, 1.f, 1.f, 0.0033f); break;
+			case 4: k.apply_gain_vector_to_buffer (&a[0], &b[0], n_samples); break;
+			case 5: k.deinterleave_buffer (&a[0], &b[0], n_samples, 1, 2); break;
+			case 6:
+				/* mix, then meter (two passes) */
+				k.mix_buffers_with_gain (&a[0], &b[0], n_samples, 0.f);
+				r = k.compute_peak (&a[0], n_samples, r);
+				break;
+			case 7: r = k.mix_buffers_with_gain_and_peak (&a[0], &b[0], n_samples, 0.f, r); break;
+		}
+	}
+	microseconds_t t1 = get_microseconds ();
+	sink = r;
+	return 1000. * (t1 - t0) / (double)iter;
+}
+
+int
+main (int argc, char* argv[])
+{
+	const int iter = argc > 1 ? atoi (argv[1]) : 100000;
+
+	FPU* fpu = FPU::instance ();
+	std::vector<Kernels> tiers;
+
+	Kernels generic = { "generic", default_compute_peak, default_apply_gain_to_buffer, default_mix_buffers_with_gain,
+	                    default_apply_gain_ramp_to_buffer, default_apply_gain_vector_to_buffer, default_deinterleave_buffer,
+	                    default_mix_buffers_with_gain_and_peak };
+	tiers.push_back (generic);
+
+#if defined(ARCH_X86) && defined(BUILD_SSE_OPTIMIZATIONS)
+	if (fpu->has_sse ()) {
+		Kernels k = { "SSE", x86_sse_compute_peak, x86_sse_apply_gain_to_buffer, x86_sse_mix_buffers_with_gain,
+		              x86_sse_apply_gain_ramp_to_buffer, x86_sse_apply_gain_vector_to_buffer, default_deinterleave_buffer,
+		              x86_sse_mix_buffers_with_gain_and_peak };
+		tiers.push_back (k);
+	}
+	if (fpu->has_avx ()) {
+		Kernels k = { "AVX", x86_sse_avx_compute_peak, x86_sse_avx_apply_gain_to_buffer, x86_sse_avx_mix_buffers_with_gain,
+		              x86_sse_avx_apply_gain_ramp_to_buffer, x86_sse_avx_apply_gain_vector_to_buffer, default_deinterleave_buffer,
+		              x86_sse_avx_mix_buffers_with_gain_and_peak };
+		tiers.push_back (k);
+	}
+#ifdef FPU_AVX_FMA_SUPPORT
+	if (fpu->has_fma ()) {
+		Kernels k = { "FMA", x86_sse_avx_compute_peak, x86_sse_avx_apply_gain_to_buffer, x86_fma_mix_buffers_with_gain,
+		              x86_sse_avx_apply_gain_ramp_to_buffer, x86_sse_avx_apply_gain_vector_to_buffer, default_deinterleave_buffer,
+		              x86_sse_avx_mix_buffers_with_gain_and_peak };
+		tiers.push_back (k);
+	}
+#endif
+#ifdef FPU_AVX512F_SUPPORT
+	if (fpu->has_avx512f ()) {
+		Kernels k = { "AVX-512F", x86_avx512f_compute_peak, x86_avx512f_apply_gain_to_buffer, x86_avx512f_mix_buffers_with_gain,
+		              x86_avx512f_apply_gain_ramp_to_buffer, x86_avx512f_apply_gain_vector_to_buffer, x86_avx512f_deinterleave_buffer,
+		              x86_avx512f_mix_buffers_with_gain_and_peak };
+		tiers.push_back (k);
+	}
+#endif
+#endif
+
+	static const char* kernel_names[] = { "compute_peak", "apply_gain", "mix_with_gain", "gain_ramp", "gain_vector", "deinterleave", "mix + compute_peak", "mix_with_gain_and_peak" };
+	static const uint32_t n_samples[] = { 32, 64, 128, 256, 512, 1024, 2048, 4096, 8192 };
+
+	for (int kernel = 0; kernel < 8; ++kernel) {
+		cout << "# " << kernel_names[kernel] << " [ns/call]\n";
+		cout << "samples";
+		for (std::vector<Kernels>::const_iterator t = tiers.begin (); t != tiers.end (); ++t) {
+			cout << "\t" << t->name;
+		}
+		cout << "\n";
+		for (size_t s = 0; s < sizeof (n_samples) / sizeof (uint32_t); ++s) {
+			cout << n_samples[s];
+			for (std::vector<Kernels>::const_iterator t = tiers.begin (); t != tiers.end (); ++t) {
+				cout << "\t" << string_compose ("%1", bench (*t, kernel, n_samples[s], iter * 32 / n_samples[s]));
+			}
+			cout << "\n";
+		}
+	}
+
+	FPU::destroy ();
+	return 0;
+}
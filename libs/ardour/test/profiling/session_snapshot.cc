@@ -0,0 +1,125 @@
+#include <iostream>
+#include <cstdlib>
+
+#include <glibmm/fileutils.h>
+#include <glibmm/miscutils.h>
+
+#include "pbd/compose.h"
+#include "pbd/gstdio_compat.h"
+#include "pbd/microseconds.h"
+#include "pbd/xml++.h"
+
+#include "ardour/ardour.h"
+#include "ardour/audioengine.h"
+#include "ardour/audio_track.h"
+#include "ardour/filename_extensions.h"
+#include "ardour/gain_control.h"
+#include "ardour/rc_configuration.h"
+#include "ardour/session.h"
+#include "ardour/session_snapshot.h"
+
+#include "test_ui.h"
+#include "test_util.h"
+
+using namespace std;
+using namespace PBD;
+using namespace ARDOUR;
+
+static const char* localedir = LOCALEDIR;
+
+/* Compare XML and binary session state, save and load times
+ * for a session with many tracks (default 1000).
+ */
+
+int
+main (int argc, char* argv[])
+{
+	const uint32_t n_tracks = argc > 1 ? atoi (argv[1]) : 1000;
+	const int      cycles   = argc > 2 ? atoi (argv[2]) : 5;
+
+	ARDOUR::init (true, localedir);
+	TestUI* test_ui = new TestUI();
+	create_and_start_dummy_backend ();
+
+	const string name ("snapshot_bench");
+	const string dir (Glib::build_filename (new_test_output_dir ("snapshot"), name));
+
+	Session* session = new Session (*AudioEngine::instance (), dir, name);
+
+	microseconds_t t0 = get_microseconds ();
+	std::list<boost::shared_ptr<AudioTrack> > tracks = session->new_audio_track (1, 2, NULL, n_tracks, "Audio", PresentationInfo::max_order);
+	cout << string_compose ("INFO: created %1 tracks in %2 ms\n", tracks.size (), (get_microseconds () - t0) / 1000.0);
+
+	const string xml_path (Glib::build_filename (dir, name + statefile_suffix));
+	const string bin_path (Glib::build_filename (dir, name + pending_suffix));
+
+	double xml_save = 0, xml_load = 0, bin_save = 0, bin_incr = 0, bin_load = 0;
+
+	for (int c = 0; c < cycles; ++c) {
+		t0 = get_microseconds ();
+		session->save_state ("");
+		microseconds_t t1 = get_microseconds ();
+		XMLTree xml (xml_path);
+		microseconds_t t2 = get_microseconds ();
+
+		/* binary pending state, full write */
+		::g_unlink (bin_path.c_str ());
+		Config->set_binary_safety_backups (true);
+		session->save_state ("", true);
+		microseconds_t t3 = get_microseconds ();
+
+		/* change a single track, incremental write */
+		tracks.front ()->gain_control ()->set_value (0.5 + 0.1 * c, Controllable::NoGroup);
+		session->save_state ("", true);
+		microseconds_t t4 = get_microseconds ();
+
+		SessionSnapshot snapshot;
+		XMLNode* root = snapshot.read (bin_path);
+		microseconds_t t5 = get_microseconds ();
+
+		Config->set_binary_safety_backups (false);
+
+		if (!root || !xml.root ()) {
+			cerr << "ERROR: failed to read state\n";
+			exit (EXIT_FAILURE);
+		}
+		if (c == 0) {
+			cout << string_compose ("INFO: XML %1 bytes, binary %2 bytes, %3 chunks\n",
+			                        Glib::file_get_contents (xml_path).size (),
+			                        Glib::file_get_contents (bin_path).size (),
+			                        snapshot.n_chunks ());
+		}
+		delete root;
+
+		xml_save += t1 - t0;
+		xml_load += t2 - t1;
+		bin_save += t3 - t2;
+		bin_incr += t4 - t3;
+		bin_load += t5 - t4;
+	}
+
+	cout << string_compose ("save: XML %1 ms, binary %2 ms, binary incremental %3 ms\n",
+	                        xml_save / cycles / 1000.0, bin_save / cycles / 1000.0, bin_incr / cycles / 1000.0);
+	cout << string_compose ("load: XML %1 ms, binary %2 ms\n",
+	                        xml_load / cycles / 1000.0, bin_load / cycles / 1000.0);
+
+	/* lossless round-trip: binary -> XML -> binary */
+	{
+		SessionSnapshot snapshot;
+		XMLNode* root = snapshot.read (bin_path);
+		const string rt_path (bin_path + ".rt");
+		SessionSnapshot rt;
+		rt.write (rt_path, *root);
+		XMLNode* root2 = rt.read (rt_path);
+		cout << "round-trip: " << ((root2 && *root == *root2) ? "ok" : "MISMATCH") << "\n";
+		delete root;
+		delete root2;
+	}
+
+	AudioEngine::instance ()->remove_session ();
+	delete session;
+	stop_and_destroy_backend ();
+	delete test_ui;
+	ARDOUR::cleanup ();
+	return 0;
+}
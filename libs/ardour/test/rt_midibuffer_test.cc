@@ -0,0 +1,197 @@
+#include <string.h>
+
+#include "evoral/midi_events.h"
+
+#include "ardour/rt_midibuffer.h"
+#include "rt_midibuffer_test.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (RTMidiBufferTest);
+
+using namespace ARDOUR;
+
+static void
+write_note (RTMidiBuffer& buf, samplepos_t on, samplepos_t off, uint8_t note, uint32_t tag)
+{
+	uint8_t ev[3] = { MIDI_CMD_NOTE_ON, note, 100 };
+	buf.write (on, Evoral::MIDI_EVENT, 3, ev, tag);
+	ev[0] = MIDI_CMD_NOTE_OFF;
+	ev[2] = 0;
+	buf.write (off, Evoral::MIDI_EVENT, 3, ev, tag);
+}
+
+static void
+check_equal (RTMidiBuffer& a, RTMidiBuffer& b)
+{
+	CPPUNIT_ASSERT_EQUAL (a.size (), b.size ());
+
+	for (size_t n = 0; n < a.size (); ++n) {
+		uint32_t asz;
+		uint32_t bsz;
+		uint8_t const * ad = a.bytes (a[n], asz);
+		uint8_t const * bd = b.bytes (b[n], bsz);
+
+		CPPUNIT_ASSERT_EQUAL (a[n].timestamp, b[n].timestamp);
+		CPPUNIT_ASSERT_EQUAL (a[n].tag, b[n].tag);
+		CPPUNIT_ASSERT_EQUAL (asz, bsz);
+		CPPUNIT_ASSERT (memcmp (ad, bd, asz) == 0);
+	}
+}
+
+void
+RTMidiBufferTest::spliceReplaceTest ()
+{
+	/* two "regions": tag 1 covers 0..1000, tag 2 covers 500..1500 */
+
+	RTMidiBuffer buf;
+
+	write_note (buf, 0, 100, 60, 1);
+	write_note (buf, 200, 300, 62, 1);
+	write_note (buf, 500, 600, 40, 2);
+	write_note (buf, 700, 1000, 64, 1);
+	write_note (buf, 1200, 1500, 41, 2);
+
+	/* replace region 1's contents: drop the note at 200, move the one at 700 */
+
+	RTMidiBuffer region;
+	write_note (region, 0, 100, 60, 0);
+	write_note (region, 650, 900, 65, 0);
+
+	buf.splice (region, 1, 0, 1000);
+
+	RTMidiBuffer expected;
+	write_note (expected, 0, 100, 60, 1);
+	write_note (expected, 500, 600, 40, 2);
+	write_note (expected, 650, 900, 65, 1);
+	write_note (expected, 1200, 1500, 41, 2);
+
+	check_equal (buf, expected);
+}
+
+void
+RTMidiBufferTest::spliceRemoveTest ()
+{
+	RTMidiBuffer buf;
+
+	for (uint32_t n = 0; n < 1000; ++n) {
+		write_note (buf, n * 100, n * 100 + 50, 60, 1 + (n % 3));
+	}
+
+	RTMidiBuffer nothing;
+
+	/* only tag 2 events in 10000..20000 go away */
+
+	buf.splice (nothing, 2, 10000, 20000);
+
+	RTMidiBuffer expected;
+
+	for (uint32_t n = 0; n < 1000; ++n) {
+		const samplepos_t t = n * 100;
+		const uint32_t tag = 1 + (n % 3);
+		uint8_t ev[3] = { MIDI_CMD_NOTE_ON, 60, 100 };
+
+		if (tag != 2 || t < 10000 || t > 20000) {
+			expected.write (t, Evoral::MIDI_EVENT, 3, ev, tag);
+		}
+
+		ev[0] = MIDI_CMD_NOTE_OFF;
+		ev[2] = 0;
+
+		if (tag != 2 || t + 50 < 10000 || t + 50 > 20000) {
+			expected.write (t + 50, Evoral::MIDI_EVENT, 3, ev, tag);
+		}
+	}
+
+	check_equal (buf, expected);
+}
+
+void
+RTMidiBufferTest::spliceOrderTest ()
+{
+	/* region 2 has a note-on at 100, region 1 is re-rendered with a
+	 * note-off on the same channel and note at the same time. As in
+	 * MidiBuffer, the note-off must come first.
+	 */
+
+	RTMidiBuffer buf;
+	uint8_t on[3] = { MIDI_CMD_NOTE_ON, 60, 100 };
+
+	buf.write (100, Evoral::MIDI_EVENT, 3, on, 2);
+
+	RTMidiBuffer region;
+	write_note (region, 0, 100, 60, 0);
+
+	buf.splice (region, 1, 0, 100);
+
+	CPPUNIT_ASSERT_EQUAL (size_t (3), buf.size ());
+	CPPUNIT_ASSERT_EQUAL (uint32_t (1), buf[0].tag);
+	CPPUNIT_ASSERT_EQUAL (uint32_t (1), buf[1].tag);
+	CPPUNIT_ASSERT_EQUAL (samplepos_t (100), buf[1].timestamp);
+	CPPUNIT_ASSERT_EQUAL (uint32_t (2), buf[2].tag);
+}
+
+void
+RTMidiBufferTest::spliceBlobTest ()
+{
+	RTMidiBuffer buf;
+	write_note (buf, 0, 100, 60, 1);
+
+	uint8_t sysex[6] = { 0xf0, 0x7e, 0x7f, 0x06, 0x01, 0xf7 };
+
+	RTMidiBuffer region;
+	region.write (50, Evoral::MIDI_EVENT, sizeof (sysex), sysex, 0);
+
+	buf.splice (region, 2, 0, 100);
+
+	CPPUNIT_ASSERT_EQUAL (size_t (3), buf.size ());
+
+	uint32_t size;
+	uint8_t const * data = buf.bytes (buf[1], size);
+
+	CPPUNIT_ASSERT_EQUAL (samplepos_t (50), buf[1].timestamp);
+	CPPUNIT_ASSERT_EQUAL (uint32_t (2), buf[1].tag);
+	CPPUNIT_ASSERT_EQUAL (uint32_t (sizeof (sysex)), size);
+	CPPUNIT_ASSERT (memcmp (data, sysex, size) == 0);
+}
+
+void
+RTMidiBufferTest::splicePoolTest ()
+{
+	RTMidiBuffer buf;
+	uint8_t sysex[6] = { 0xf0, 0x7e, 0x7f, 0x06, 0x01, 0xf7 };
+
+	/* sysex data of another region, which is never replaced */
+	RTMidiBuffer other;
+	other.write (5000, Evoral::MIDI_EVENT, sizeof (sysex), sysex, 0);
+	buf.splice (other, 1, 5000, 5000);
+
+	RTMidiBuffer region;
+	for (int i = 0; i < 16; ++i) {
+		sysex[4] = i;
+		region.write (i * 10, Evoral::MIDI_EVENT, sizeof (sysex), sysex, 0);
+	}
+
+	buf.splice (region, 2, 0, 1000);
+	const uint32_t used = buf.pool_size ();
+
+	/* editing the region over and over does not grow the pool */
+	for (int n = 0; n < 1000; ++n) {
+		buf.splice (region, 2, 0, 1000);
+	}
+
+	CPPUNIT_ASSERT (buf.pool_size () <= 2 * (used + 4096));
+	CPPUNIT_ASSERT_EQUAL (size_t (17), buf.size ());
+
+	/* and the data of all events survives compaction */
+	uint32_t size;
+	for (int i = 0; i < 16; ++i) {
+		uint8_t const * data = buf.bytes (buf[i], size);
+		CPPUNIT_ASSERT_EQUAL (uint32_t (2), buf[i].tag);
+		CPPUNIT_ASSERT_EQUAL (uint32_t (sizeof (sysex)), size);
+		CPPUNIT_ASSERT_EQUAL (uint8_t (i), data[4]);
+	}
+
+	uint8_t const * data = buf.bytes (buf[16], size);
+	CPPUNIT_ASSERT_EQUAL (uint32_t (1), buf[16].tag);
+	CPPUNIT_ASSERT_EQUAL (samplepos_t (5000), buf[16].timestamp);
+	CPPUNIT_ASSERT_EQUAL (uint8_t (0x01), data[4]);
+}
@@ -0,0 +1,23 @@
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class RTMidiBufferTest : public CppUnit::TestFixture
+{
+	CPPUNIT_TEST_SUITE (RTMidiBufferTest);
+	CPPUNIT_TEST (spliceReplaceTest);
+	CPPUNIT_TEST (spliceRemoveTest);
+	CPPUNIT_TEST (spliceOrderTest);
+	CPPUNIT_TEST (spliceBlobTest);
+	CPPUNIT_TEST (splicePoolTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void setUp () {}
+	void tearDown () {}
+
+	void spliceReplaceTest ();
+	void spliceRemoveTest ();
+	void spliceOrderTest ();
+	void spliceBlobTest ();
+	void splicePoolTest ();
+};
@@ -0,0 +1,183 @@
+#include <glibmm/fileutils.h>
+#include <glibmm/miscutils.h>
+
+#include "pbd/compose.h"
+#include "pbd/xml++.h"
+
+#include "ardour/session_snapshot.h"
+
+#include "session_snapshot_test.h"
+#include "test_util.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (SessionSnapshotTest);
+
+using namespace std;
+using namespace ARDOUR;
+
+static XMLNode*
+make_state (uint32_t n_routes)
+{
+	XMLNode* root = new XMLNode ("Session");
+	root->set_property ("version", 7000);
+	root->set_property ("name", "snapshot \"test\" <&>");
+
+	XMLNode* config = root->add_child ("Config");
+	config->add_child ("Option")->set_property ("value", "1");
+
+	XMLNode* routes = root->add_child ("Routes");
+	for (uint32_t i = 0; i < n_routes; ++i) {
+		XMLNode* route = routes->add_child ("Route");
+		route->set_property ("id", 1000 + i);
+		route->set_property ("name", string_compose ("Audio %1", i));
+		XMLNode* events = route->add_child ("Controllable")->add_child ("events");
+		events->add_content ("0 1\n48000 0.5\n");
+	}
+
+	/* objects without an ID are kept inline */
+	root->add_child ("Locations")->add_child ("Location")->set_property ("name", "loop");
+	root->add_child ("Extra")->add_content ("some text");
+	return root;
+}
+
+void
+SessionSnapshotTest::roundTripTest ()
+{
+	const string path = Glib::build_filename (new_test_output_dir ("snapshot"), "roundtrip.pending");
+
+	XMLNode* state = make_state (10);
+
+	SessionSnapshot w;
+	CPPUNIT_ASSERT_EQUAL (0, w.write (path, *state));
+	CPPUNIT_ASSERT_EQUAL ((size_t) 10, w.chunks_written ());
+	CPPUNIT_ASSERT (SessionSnapshot::is_snapshot (path));
+
+	SessionSnapshot r;
+	XMLNode* root = r.read (path);
+	CPPUNIT_ASSERT (root);
+	CPPUNIT_ASSERT (*root == *state);
+	CPPUNIT_ASSERT_EQUAL ((size_t) 10, r.n_chunks ());
+
+	/* binary -> XML -> binary */
+	const string xml_path = Glib::build_filename (new_test_output_dir ("snapshot"), "roundtrip.ardour");
+	XMLTree tree;
+	tree.set_root (root);
+	CPPUNIT_ASSERT (tree.write (xml_path));
+
+	XMLTree xml (xml_path);
+	CPPUNIT_ASSERT (xml.root ());
+	CPPUNIT_ASSERT (*xml.root () == *state);
+	CPPUNIT_ASSERT (!SessionSnapshot::is_snapshot (xml_path));
+
+	delete state;
+}
+
+void
+SessionSnapshotTest::incrementalTest ()
+{
+	const string path = Glib::build_filename (new_test_output_dir ("snapshot"), "incremental.pending");
+
+	XMLNode* state = make_state (100);
+
+	SessionSnapshot w;
+	CPPUNIT_ASSERT_EQUAL (0, w.write (path, *state));
+	CPPUNIT_ASSERT_EQUAL ((size_t) 100, w.chunks_written ());
+
+	const size_t full_size = Glib::file_get_contents (path).size ();
+
+	/* no change */
+	CPPUNIT_ASSERT_EQUAL (0, w.write (path, *state));
+	CPPUNIT_ASSERT_EQUAL ((size_t) 0, w.chunks_written ());
+
+	/* modify one route, remove another */
+	XMLNode* routes = state->child ("Routes");
+	routes->children ().front ()->set_property ("name", "Renamed");
+	routes->remove_node_and_delete ("Route", "id", "1099");
+
+	CPPUNIT_ASSERT_EQUAL (0, w.write (path, *state));
+	CPPUNIT_ASSERT_EQUAL ((size_t) 1, w.chunks_written ());
+	CPPUNIT_ASSERT_EQUAL ((size_t) 99, w.n_chunks ());
+
+	SessionSnapshot r;
+	XMLNode* root = r.read (path);
+	CPPUNIT_ASSERT (root);
+	CPPUNIT_ASSERT (*root == *state);
+	delete root;
+
+	/* the file is compacted and does not grow without bounds */
+	for (int i = 0; i < 500; ++i) {
+		routes->children ().front ()->set_property ("name", string_compose ("Name %1", i));
+		CPPUNIT_ASSERT_EQUAL (0, w.write (path, *state));
+	}
+	CPPUNIT_ASSERT (Glib::file_get_contents (path).size () < 2 * full_size);
+
+	root = r.read (path);
+	CPPUNIT_ASSERT (root);
+	CPPUNIT_ASSERT (*root == *state);
+	delete root;
+
+	/* a different instance starts with a full write */
+	SessionSnapshot w2;
+	CPPUNIT_ASSERT_EQUAL (0, w2.write (path, *state));
+	CPPUNIT_ASSERT_EQUAL ((size_t) 99, w2.chunks_written ());
+
+	delete state;
+}
+
+void
+SessionSnapshotTest::corruptTest ()
+{
+	const string path = Glib::build_filename (new_test_output_dir ("snapshot"), "corrupt.pending");
+
+	XMLNode* state = make_state (4);
+	SessionSnapshot w;
+	CPPUNIT_ASSERT_EQUAL (0, w.write (path, *state));
+	delete state;
+
+	string data = Glib::file_get_contents (path);
+
+	/* truncated */
+	Glib::file_set_contents (path, data.substr (0, data.size () - 5));
+	SessionSnapshot r;
+	CPPUNIT_ASSERT (!r.read (path));
+
+	/* bogus index offset */
+	string bad (data);
+	bad[bad.size () - 10] ^= 0x55;
+	Glib::file_set_contents (path, bad);
+	CPPUNIT_ASSERT (!r.read (path));
+
+	CPPUNIT_ASSERT (!r.read (path + ".does-not-exist"));
+
+	/* interrupted incremental write */
+	XMLNode* s1 = make_state (4);
+	XMLNode* s2 = make_state (4);
+	s2->child ("Routes")->children ().front ()->set_property ("name", "Renamed");
+
+	SessionSnapshot wi;
+	CPPUNIT_ASSERT_EQUAL (0, wi.write (path, *s1));
+	const size_t s1_size = Glib::file_get_contents (path).size ();
+	CPPUNIT_ASSERT_EQUAL (0, wi.write (path, *s2));
+	CPPUNIT_ASSERT_EQUAL ((size_t) 1, wi.chunks_written ());
+
+	data = Glib::file_get_contents (path);
+	CPPUNIT_ASSERT (data.size () > s1_size + 5);
+
+	for (size_t cut = s1_size; cut < data.size (); cut += 3) {
+		Glib::file_set_contents (path, data.substr (0, cut));
+		XMLNode* root = r.read (path);
+		CPPUNIT_ASSERT (root);
+		CPPUNIT_ASSERT (*root == *s1);
+		delete root;
+	}
+
+	/* the next write replaces the partial tail */
+	CPPUNIT_ASSERT_EQUAL (0, r.write (path, *s2));
+	SessionSnapshot r2;
+	XMLNode* root = r2.read (path);
+	CPPUNIT_ASSERT (root);
+	CPPUNIT_ASSERT (*root == *s2);
+	delete root;
+
+	delete s1;
+	delete s2;
+}
@@ -0,0 +1,19 @@
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class SessionSnapshotTest : public CppUnit::TestFixture
+{
+	CPPUNIT_TEST_SUITE (SessionSnapshotTest);
+	CPPUNIT_TEST (roundTripTest);
+	CPPUNIT_TEST (incrementalTest);
+	CPPUNIT_TEST (corruptTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void setUp () {}
+	void tearDown () {}
+
+	void roundTripTest ();
+	void incrementalTest ();
+	void corruptTest ();
+};
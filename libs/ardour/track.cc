@@ -512,6 +512,18 @@ Track::playback_buffer_load () const
 	return _disk_reader->buffer_load ();
 }
 
+RefillStats
+Track::playback_refill_stats () const
+{
+	return _disk_reader->refill_stats ();
+}
+
+void
+Track::reset_playback_refill_stats ()
+{
+	_disk_reader->reset_refill_stats ();
+}
+
 float
 Track::capture_buffer_load () const
 {
@@ -13,6 +13,7 @@
 #include "pbd/basename.h"
 #include "pbd/compose.h"
 #include "pbd/failed_constructor.h"
+#include "pbd/playback_buffer.h"
 #include "pbd/pthread_utils.h"
 #include "pbd/types_convert.h"
 #include "pbd/unwind.h"
@@ -1154,8 +1155,75 @@ Trigger::start_and_roll_to (samplepos_t start_pos, samplepos_t end_position, Tri
 
 /*--------------------*/
 
+/* Regions that do not fit into the trigger-memory-budget of their TriggerBox
+ * keep only their first stream_head_seconds in memory, so that a launch
+ * never has to wait for the disk. The rest is read into per-channel ring
+ * buffers by the TriggerBoxThread while the head plays.
+ */
+static const double      stream_head_seconds   = 2.0;
+static const double      stream_buffer_seconds = 4.0;
+static const samplecnt_t stream_chunk          = 8192;
+
+struct AudioTrigger::Stream {
+	Stream (uint32_t nchans, samplecnt_t head_len, samplecnt_t bufsize)
+		: head (head_len)
+		, io_buf (new Sample[stream_chunk])
+		, write_pos (0)
+		, read_pos (0)
+		, seek_to (head_len)
+		, seek_request (1)
+		, seek_done (0)
+		, underruns (0)
+	{
+		for (uint32_t n = 0; n < nchans; ++n) {
+			rb.push_back (new PBD::PlaybackBuffer<Sample> (bufsize, 0));
+			chunk.push_back (new Sample[stream_chunk]);
+		}
+	}
+
+	~Stream ()
+	{
+		for (auto& r : rb) {
+			delete r;
+		}
+		for (auto& c : chunk) {
+			delete [] c;
+		}
+		delete [] io_buf;
+	}
+
+	samplecnt_t read_space () const {
+		samplecnt_t rs = rb[0]->read_space ();
+		for (auto const& r : rb) {
+			rs = std::min (rs, (samplecnt_t) r->read_space ());
+		}
+		return rs;
+	}
+
+	samplecnt_t write_space () const {
+		samplecnt_t ws = rb[0]->write_space ();
+		for (auto const& r : rb) {
+			ws = std::min (ws, (samplecnt_t) r->write_space ());
+		}
+		return ws;
+	}
+
+	samplecnt_t                               head;   /* samples of data held in memory */
+	std::vector<PBD::PlaybackBuffer<Sample>*> rb;
+	std::vector<Sample*>                      chunk;  /* process thread: contiguous data spanning head and ring buffer */
+	Sample*                                   io_buf; /* TriggerBoxThread: disk read buffer */
+	samplepos_t                               write_pos; /* TriggerBoxThread: next sample to read from the region */
+	std::atomic<samplepos_t>                  read_pos;  /* region sample at the read pointer of the ring buffers */
+	std::atomic<samplepos_t>                  seek_to;
+	std::atomic<uint32_t>                     seek_request;
+	std::atomic<uint32_t>                     seek_done;
+	std::atomic<uint32_t>                     underruns;
+};
+
 AudioTrigger::AudioTrigger (uint32_t n, TriggerBox& b)
 	: Trigger (n, b)
+	, _stream (0)
+	, _data_bytes (0)
 	, _stretcher (0)
 	, _start_offset (0)
 	, read_index (0)
@@ -1328,6 +1396,10 @@ void
 AudioTrigger::start_and_roll_to (samplepos_t start_pos, samplepos_t end_position)
 {
 	Trigger::start_and_roll_to<AudioTrigger> (start_pos, end_position, *this, &AudioTrigger::audio_run<false>);
+
+	if (_stream) {
+		stream_seek (std::max (_stream->head, read_index));
+	}
 }
 
 timepos_t
@@ -1581,7 +1653,15 @@ AudioTrigger::estimate_tempo ()
 
 			mbpm.setBPMRange (metric.tempo().quarter_notes_per_minute () * 0.75, metric.tempo().quarter_notes_per_minute() * 1.5);
 
-			_estimated_tempo = mbpm.estimateTempoOfSamples (data[0], data.length);
+			if (_stream) {
+				/* only the head is in memory, analyse (up to) the first 30 seconds */
+				const samplecnt_t n = std::min (data.length, (samplecnt_t) (_box.session().sample_rate() * 30));
+				std::vector<Sample> tmp (n);
+				boost::dynamic_pointer_cast<AudioRegion> (_region)->read (&tmp[0], 0, n, 0);
+				_estimated_tempo = mbpm.estimateTempoOfSamples (&tmp[0], n);
+			} else {
+				_estimated_tempo = mbpm.estimateTempoOfSamples (data[0], data.length);
+			}
 
 			cerr << name() << "MiniBPM Estimated: " << _estimated_tempo << " bpm from " << (double) data.length / _box.session().sample_rate() << " seconds\n";
 		}
@@ -1685,36 +1765,233 @@ AudioTrigger::setup_stretcher ()
 void
 AudioTrigger::drop_data ()
 {
+	if (_stream) {
+		TriggerBox::worker->remove_stream (this);
+		delete _stream;
+		_stream = 0;
+	}
+
 	for (auto& d : data) {
 		delete [] d;
 	}
 	data.clear ();
+	_data_ptrs.clear ();
+
+	if (_data_bytes) {
+		_box.release_clip_memory (_data_bytes);
+		_data_bytes = 0;
+	}
 }
 
 int
 AudioTrigger::load_data (boost::shared_ptr<AudioRegion> ar)
 {
-	const uint32_t nchans = ar->n_channels();
+	const uint32_t    nchans  = ar->n_channels();
+	const samplecnt_t sr      = _box.session().sample_rate();
+	const samplecnt_t head    = sr * stream_head_seconds;
+	const samplecnt_t bufsize = sr * stream_buffer_seconds;
 
-	data.length = ar->length_samples();
 	drop_data ();
 
+	data.length = ar->length_samples();
+
+	/* Stream from disk if the complete region does not fit into the
+	 * memory budget of the box, unless that would not save any memory.
+	 */
+	const int64_t full_bytes = (int64_t) nchans * data.length * sizeof (Sample);
+	bool stream = false;
+
+	if (data.length > head + bufsize) {
+		stream = !_box.reserve_clip_memory (full_bytes);
+	} else {
+		_box.reserve_clip_memory (full_bytes, true);
+	}
+
+	if (stream) {
+		_data_bytes = (int64_t) nchans * (head + bufsize) * sizeof (Sample);
+		_box.reserve_clip_memory (_data_bytes, true);
+	} else {
+		_data_bytes = full_bytes;
+	}
+
+	const samplecnt_t in_memory = stream ? head : data.length;
+
 	try {
 		for (uint32_t n = 0; n < nchans; ++n) {
-			data.push_back (new Sample[data.length]);
-			ar->read (data[n], 0, data.length, n);
+			data.push_back (new Sample[in_memory]);
+			ar->read (data[n], 0, in_memory, n);
 		}
 
+		_data_ptrs.resize (nchans);
 		set_name (ar->name());
 
+		if (stream) {
+			_stream = new Stream (nchans, head, bufsize);
+			/* prime the ring buffers before the first launch */
+			refill_stream ();
+			TriggerBox::worker->add_stream (this);
+		}
+
 	} catch (...) {
 		drop_data ();
 		return -1;
 	}
 
+	DEBUG_TRACE (DEBUG::Triggers, string_compose ("%1 loaded %2 (%3 samples), %4, box now uses %5 bytes\n", index(), ar->name(), data.length,
+	                                              (stream ? "streaming" : "in memory"), _box.clip_memory ()));
+
 	return 0;
 }
 
+/* Return pointers to @param cnt samples of data per channel, starting at @param pos */
+Sample* const*
+AudioTrigger::audio_data (samplepos_t pos, samplecnt_t cnt, bool in_process_context)
+{
+	if (!_stream || pos + cnt <= _stream->head) {
+		for (uint32_t chn = 0; chn < data.size(); ++chn) {
+			_data_ptrs[chn] = data[chn] + pos;
+		}
+		return &_data_ptrs[0];
+	}
+
+	stream_read (pos, cnt, in_process_context);
+	return &_stream->chunk[0];
+}
+
+void
+AudioTrigger::stream_read (samplepos_t pos, samplecnt_t cnt, bool in_process_context)
+{
+	Stream&        s (*_stream);
+	const uint32_t nchans = data.size();
+	samplecnt_t    from_head = 0;
+
+	assert (cnt <= stream_chunk);
+
+	if (pos < s.head) {
+		from_head = s.head - pos;
+		for (uint32_t chn = 0; chn < nchans; ++chn) {
+			memcpy (s.chunk[chn], data[chn] + pos, from_head * sizeof (Sample));
+		}
+		pos += from_head;
+		cnt -= from_head;
+	}
+
+	if (!in_process_context) {
+		/* start_and_roll_to(), not realtime: read directly */
+		boost::shared_ptr<AudioRegion> ar = boost::dynamic_pointer_cast<AudioRegion> (_region);
+		for (uint32_t chn = 0; chn < nchans; ++chn) {
+			const samplecnt_t n = ar->read (s.chunk[chn] + from_head, pos, cnt, chn);
+			if (n < cnt) {
+				memset (s.chunk[chn] + from_head + n, 0, (cnt - n) * sizeof (Sample));
+			}
+		}
+		return;
+	}
+
+	samplecnt_t got = 0;
+
+	if (s.seek_done == s.seek_request) {
+
+		samplepos_t rp    = s.read_pos;
+		samplecnt_t avail = s.read_space ();
+
+		if (pos > rp && pos - rp < avail) {
+			/* skip ahead, e.g. to catch up after an underrun */
+			for (auto& r : s.rb) {
+				r->increment_read_ptr (pos - rp);
+			}
+			avail -= pos - rp;
+			rp = pos;
+			s.read_pos = rp;
+		}
+
+		if (pos == rp) {
+			got = std::min (cnt, avail);
+			for (uint32_t chn = 0; chn < nchans; ++chn) {
+				s.rb[chn]->read (s.chunk[chn] + from_head, got);
+			}
+			s.read_pos = pos + got;
+
+			if (avail - got < (samplecnt_t) s.rb[0]->bufsize () / 2) {
+				TriggerBox::worker->request_refill ();
+			}
+		} else {
+			stream_seek (pos);
+		}
+	}
+
+	if (got < cnt) {
+		for (uint32_t chn = 0; chn < nchans; ++chn) {
+			memset (s.chunk[chn] + from_head + got, 0, (cnt - got) * sizeof (Sample));
+		}
+		s.underruns++;
+		DEBUG_TRACE (DEBUG::Triggers, string_compose ("%1 stream underrun at %2, missing %3 samples\n", index(), pos + got, cnt - got));
+	}
+}
+
+void
+AudioTrigger::stream_seek (samplepos_t pos)
+{
+	Stream& s (*_stream);
+
+	const samplepos_t current = (s.seek_done == s.seek_request) ? s.read_pos.load () : s.seek_to.load ();
+
+	if (current == pos) {
+		return;
+	}
+
+	s.seek_to = pos;
+	s.seek_request++;
+	TriggerBox::worker->request_refill ();
+}
+
+void
+AudioTrigger::refill_stream ()
+{
+	Stream& s (*_stream);
+	boost::shared_ptr<AudioRegion> ar = boost::dynamic_pointer_cast<AudioRegion> (_region);
+
+	if (!ar) {
+		return;
+	}
+
+	while (true) {
+
+		const uint32_t req = s.seek_request;
+
+		if (req != s.seek_done) {
+			for (auto& r : s.rb) {
+				r->reset ();
+			}
+			s.write_pos = s.seek_to;
+			s.read_pos  = s.write_pos;
+			s.seek_done = req;
+		}
+
+		const samplecnt_t to_read = std::min (std::min (s.write_space (), stream_chunk), data.length - s.write_pos);
+
+		if (to_read <= 0 || (to_read < stream_chunk / 2 && s.write_pos + to_read < data.length)) {
+			break;
+		}
+
+		for (uint32_t chn = 0; chn < s.rb.size(); ++chn) {
+			const samplecnt_t n = ar->read (s.io_buf, s.write_pos, to_read, chn);
+			if (n < to_read) {
+				memset (s.io_buf + n, 0, (to_read - n) * sizeof (Sample));
+			}
+			s.rb[chn]->write (s.io_buf, to_read);
+		}
+
+		s.write_pos += to_read;
+	}
+}
+
+uint32_t
+AudioTrigger::stream_underruns () const
+{
+	return _stream ? _stream->underruns.load () : 0;
+}
+
 void
 AudioTrigger::retrigger ()
 {
@@ -1727,6 +2004,11 @@ AudioTrigger::retrigger ()
 	retrieved = 0;
 	_legato_offset = 0; /* used one time only */
 
+	if (_stream) {
+		/* the head covers the start, meanwhile reposition the stream */
+		stream_seek (std::max (_stream->head, read_index));
+	}
+
 	DEBUG_TRACE (DEBUG::Triggers, string_compose ("%1 retriggered to %2\n", _index, read_index));
 }
 
@@ -1855,9 +2137,10 @@ AudioTrigger::audio_run (BufferSet& bufs, samplepos_t start_sample, samplepos_t
 					 */
 
 					std::vector<Sample*> in(nchans);
+					Sample* const* src = audio_data (read_index, to_stretcher, in_process_context);
 
 					for (uint32_t chn = 0; chn < nchans; ++chn) {
-						in[chn] = data[chn] + read_index;
+						in[chn] = src[chn];
 					}
 
 					/* Note: RubberBandStretcher's process() and retrieve() API's accepts Sample**
@@ -1933,6 +2216,10 @@ AudioTrigger::audio_run (BufferSet& bufs, samplepos_t start_sample, samplepos_t
 			from_stretcher = (pframes_t) std::min ((samplecnt_t) nframes, (last_readable_sample - read_index));
 			// cerr << "FS#3 from lrs " << last_readable_sample <<  " - " << read_index << " = " << from_stretcher << endl;
 
+			if (_stream) {
+				from_stretcher = (pframes_t) std::min ((samplecnt_t) from_stretcher, stream_chunk);
+			}
+
 		}
 
 		DEBUG_TRACE (DEBUG::Triggers, string_compose ("%1 ready with %2 ri %3 ls %4, will write %5\n", name(), avail, read_index, last_readable_sample, from_stretcher));
@@ -1941,11 +2228,13 @@ AudioTrigger::audio_run (BufferSet& bufs, samplepos_t start_sample, samplepos_t
 
 		if (in_process_context) { /* constexpr, will be handled at compile time */
 
+			Sample* const* src_data = do_stretch ? &bufp[0] : audio_data (read_index, from_stretcher, true);
+
 			for (uint32_t chn = 0; chn < bufs.count().n_audio(); ++chn) {
 
 				uint32_t channel = chn %  data.size();
 				AudioBuffer& buf (bufs.get_audio (chn));
-				Sample* src = do_stretch ? bufp[channel] : (data[channel] + read_index);
+				Sample* src = src_data[channel];
 
 				gain_t gain = _velocity_gain * _gain;  //incorporate the gain from velocity_effect
 
@@ -2791,6 +3080,7 @@ TriggerBox::TriggerBox (Session& s, DataType dt)
 	, tracker (dt == DataType::MIDI ? new MidiStateTracker : 0)
 	, _data_type (dt)
 	, _order (-1)
+	, _clip_memory (0)
 	, explicit_queue (64)
 	, _currently_playing (0)
 	, _stop_all (false)
@@ -3262,6 +3552,25 @@ TriggerBox::~TriggerBox ()
 {
 }
 
+bool
+TriggerBox::reserve_clip_memory (int64_t bytes, bool force)
+{
+	const int64_t budget = (int64_t) Config->get_trigger_memory_budget () * 1048576;
+
+	if (!force && budget > 0 && _clip_memory + bytes > budget) {
+		return false;
+	}
+
+	_clip_memory += bytes;
+	return true;
+}
+
+void
+TriggerBox::release_clip_memory (int64_t bytes)
+{
+	_clip_memory -= bytes;
+}
+
 void
 TriggerBox::stop_all_immediately ()
 {
@@ -4274,6 +4583,7 @@ MultiAllocSingleReleasePool* TriggerBoxThread::Request::pool = 0;
 TriggerBoxThread::TriggerBoxThread ()
 	: requests (1024)
 	, _xthread (true)
+	, _refill_pending (false)
 {
 	if (pthread_create_and_store ("triggerbox thread", &thread, _thread_work, this)) {
 		error << _("Session: could not create triggerbox thread") << endmsg;
@@ -4313,6 +4623,12 @@ TriggerBoxThread::thread_work ()
 				abort(); /*NOTREACHED*/
 			}
 
+			if (msg == (char) Refill) {
+				_refill_pending = false;
+				refill_streams ();
+				continue;
+			}
+
 			Temporal::TempoMap::fetch ();
 
 			Request* req;
@@ -4397,3 +4713,42 @@ TriggerBoxThread::delete_trigger (Trigger* t)
 {
 	delete t;
 }
+
+void
+TriggerBoxThread::add_stream (AudioTrigger* t)
+{
+	Glib::Threads::Mutex::Lock lm (_stream_lock);
+	_streams.push_back (t);
+}
+
+void
+TriggerBoxThread::remove_stream (AudioTrigger* t)
+{
+	Glib::Threads::Mutex::Lock lm (_stream_lock);
+	std::vector<AudioTrigger*>::iterator i = std::find (_streams.begin(), _streams.end(), t);
+	if (i != _streams.end()) {
+		_streams.erase (i);
+	}
+}
+
+void
+TriggerBoxThread::request_refill ()
+{
+	/* called from process context. Like Quit, this is delivered without a
+	 * Request (the pool allocator takes a lock), and only once until the
+	 * thread gets to it.
+	 */
+	if (!_refill_pending.exchange (true)) {
+		_xthread.deliver ((char) Refill);
+	}
+}
+
+void
+TriggerBoxThread::refill_streams ()
+{
+	Glib::Threads::Mutex::Lock lm (_stream_lock);
+
+	for (auto& t : _streams) {
+		t->refill_stream ();
+	}
+}
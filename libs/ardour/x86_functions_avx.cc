@@ -0,0 +1,256 @@
+/*
+ * Copyright (C) 2026 The Ardour Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "ardour/mix.h"
+
+#include <cmath>
+#include <algorithm>
+
+#include <immintrin.h>
+#include <xmmintrin.h>
+
+#ifndef __AVX__
+#error "__AVX__ must be enabled for this module to work"
+#endif
+
+/**
+ * @brief x86-64 AVX optimized routine for a one-pole smoothed gain ramp
+ *
+ * g[n] = target + (initial - target) * (1 - coeff)^n, which is
+ * equivalent to g[n+1] = g[n] + coeff * (target - g[n])
+ *
+ * @param[in,out] buf Pointer to buffer
+ * @param nframes Number of samples to process
+ * @param initial Gain of the first sample
+ * @param target Target gain
+ * @param coeff Low-pass filter coefficient
+ * @return gain after the last sample
+ */
+float
+x86_sse_avx_apply_gain_ramp_to_buffer (float* buf, uint32_t nframes, float initial, float target, float coeff)
+{
+	float d = initial - target;
+
+	if (nframes >= 8) {
+		const float r  = 1.f - coeff;
+		const float r2 = r * r;
+		const float r4 = r2 * r2;
+
+		__m256 delta = _mm256_set_ps (d * r4 * r2 * r, d * r4 * r2, d * r4 * r, d * r4, d * r2 * r, d * r2, d * r, d);
+		__m256 r8    = _mm256_set1_ps (r4 * r4);
+		__m256 tgt   = _mm256_set1_ps (target);
+
+		while (nframes >= 8) {
+			__m256 g = _mm256_add_ps (tgt, delta);
+			_mm256_storeu_ps (buf, _mm256_mul_ps (_mm256_loadu_ps (buf), g));
+			delta = _mm256_mul_ps (delta, r8);
+			buf += 8;
+			nframes -= 8;
+		}
+		d = _mm_cvtss_f32 (_mm256_castps256_ps128 (delta));
+	}
+
+	_mm256_zeroupper ();
+
+	float g = target + d;
+	while (nframes > 0) {
+		*buf++ *= g;
+		g += coeff * (target - g);
+		--nframes;
+	}
+	return g;
+}
+
+/**
+ * @brief x86-64 AVX optimized routine to apply per-sample gain
+ * @param[in,out] buf Pointer to buffer
+ * @param[in] gain Pointer to gain coefficients, one per sample
+ * @param nframes Number of samples to process
+ */
+void
+x86_sse_avx_apply_gain_vector_to_buffer (float* buf, float const* gain, uint32_t nframes)
+{
+	while (nframes >= 16) {
+		__m256 b0 = _mm256_loadu_ps (buf + 0);
+		__m256 b1 = _mm256_loadu_ps (buf + 8);
+		b0 = _mm256_mul_ps (b0, _mm256_loadu_ps (gain + 0));
+		b1 = _mm256_mul_ps (b1, _mm256_loadu_ps (gain + 8));
+		_mm256_storeu_ps (buf + 0, b0);
+		_mm256_storeu_ps (buf + 8, b1);
+		buf += 16;
+		gain += 16;
+		nframes -= 16;
+	}
+
+	while (nframes >= 8) {
+		_mm256_storeu_ps (buf, _mm256_mul_ps (_mm256_loadu_ps (buf), _mm256_loadu_ps (gain)));
+		buf += 8;
+		gain += 8;
+		nframes -= 8;
+	}
+
+	_mm256_zeroupper ();
+
+	while (nframes > 0) {
+		*buf++ *= *gain++;
+		--nframes;
+	}
+}
+
+/**
+ * @brief x86-64 AVX optimized routine for polarity inversion
+ * @param[in,out] buf Pointer to buffer
+ * @param nframes Number of samples to process
+ */
+void
+x86_sse_avx_invert_buffer (float* buf, uint32_t nframes)
+{
+	const __m256 sign = _mm256_set1_ps (-0.f);
+
+	while (nframes >= 8) {
+		_mm256_storeu_ps (buf, _mm256_xor_ps (_mm256_loadu_ps (buf), sign));
+		buf += 8;
+		nframes -= 8;
+	}
+
+	_mm256_zeroupper ();
+
+	while (nframes > 0) {
+		*buf = -*buf;
+		++buf;
+		--nframes;
+	}
+}
+
+static inline float
+avx_hmax (__m256 v)
+{
+	__m128 m = _mm_max_ps (_mm256_castps256_ps128 (v), _mm256_extractf128_ps (v, 1));
+	m = _mm_max_ps (m, _mm_movehl_ps (m, m));
+	m = _mm_max_ss (m, _mm_shuffle_ps (m, m, _MM_SHUFFLE (1, 1, 1, 1)));
+	return _mm_cvtss_f32 (m);
+}
+
+/**
+ * @brief x86-64 AVX optimized routine to accumulate a buffer and compute the peak of the result
+ * @param[in,out] dst Pointer to destination buffer, which gets updated
+ * @param[in] src Pointer to source buffer (not updated)
+ * @param nframes Number of samples to process
+ * @param current Current peak value
+ * @return max (current, absolute peak of @a dst after the operation)
+ */
+float
+x86_sse_avx_mix_buffers_no_gain_and_peak (float* dst, float const* src, uint32_t nframes, float current)
+{
+	const __m256 sign = _mm256_set1_ps (-0.f);
+	__m256       vmax = _mm256_set1_ps (current);
+
+	while (nframes >= 8) {
+		__m256 d = _mm256_add_ps (_mm256_loadu_ps (dst), _mm256_loadu_ps (src));
+		_mm256_storeu_ps (dst, d);
+		vmax = _mm256_max_ps (vmax, _mm256_andnot_ps (sign, d));
+		dst += 8;
+		src += 8;
+		nframes -= 8;
+	}
+
+	current = avx_hmax (vmax);
+
+	_mm256_zeroupper ();
+
+	while (nframes > 0) {
+		*dst += *src++;
+		current = std::max (current, fabsf (*dst++));
+		--nframes;
+	}
+	return current;
+}
+
+/**
+ * @brief x86-64 AVX optimized routine to accumulate a buffer with gain and compute the peak of the result
+ * @param[in,out] dst Pointer to destination buffer, which gets updated
+ * @param[in] src Pointer to source buffer (not updated)
+ * @param nframes Number of samples to process
+ * @param gain Gain to apply to @a src
+ * @param current Current peak value
+ * @return max (current, absolute peak of @a dst after the operation)
+ */
+float
+x86_sse_avx_mix_buffers_with_gain_and_peak (float* dst, float const* src, uint32_t nframes, float gain, float current)
+{
+	const __m256 sign = _mm256_set1_ps (-0.f);
+	const __m256 g    = _mm256_set1_ps (gain);
+	__m256       vmax = _mm256_set1_ps (current);
+
+	while (nframes >= 8) {
+		__m256 d = _mm256_add_ps (_mm256_loadu_ps (dst), _mm256_mul_ps (_mm256_loadu_ps (src), g));
+		_mm256_storeu_ps (dst, d);
+		vmax = _mm256_max_ps (vmax, _mm256_andnot_ps (sign, d));
+		dst += 8;
+		src += 8;
+		nframes -= 8;
+	}
+
+	current = avx_hmax (vmax);
+
+	_mm256_zeroupper ();
+
+	while (nframes > 0) {
+		*dst += *src++ * gain;
+		current = std::max (current, fabsf (*dst++));
+		--nframes;
+	}
+	return current;
+}
+
+/**
+ * @brief x86-64 AVX optimized routine to copy a buffer with gain and compute the peak of the result
+ * @param[in,out] dst Pointer to destination buffer, which gets updated
+ * @param[in] src Pointer to source buffer (not updated)
+ * @param nframes Number of samples to process
+ * @param gain Gain to apply to @a src
+ * @param current Current peak value
+ * @return max (current, absolute peak of @a dst after the operation)
+ */
+float
+x86_sse_avx_copy_vector_with_gain_and_peak (float* dst, float const* src, uint32_t nframes, float gain, float current)
+{
+	const __m256 sign = _mm256_set1_ps (-0.f);
+	const __m256 g    = _mm256_set1_ps (gain);
+	__m256       vmax = _mm256_set1_ps (current);
+
+	while (nframes >= 8) {
+		__m256 d = _mm256_mul_ps (_mm256_loadu_ps (src), g);
+		_mm256_storeu_ps (dst, d);
+		vmax = _mm256_max_ps (vmax, _mm256_andnot_ps (sign, d));
+		dst += 8;
+		src += 8;
+		nframes -= 8;
+	}
+
+	current = avx_hmax (vmax);
+
+	_mm256_zeroupper ();
+
+	while (nframes > 0) {
+		*dst = *src++ * gain;
+		current = std::max (current, fabsf (*dst++));
+		--nframes;
+	}
+	return current;
+}
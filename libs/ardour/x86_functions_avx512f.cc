@@ -0,0 +1,494 @@
+/*
+ * Copyright (C) 2026 The Ardour Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifdef FPU_AVX512F_SUPPORT
+
+#include "ardour/mix.h"
+
+#include <immintrin.h>
+
+/* All AVX-512 routines use unaligned loads/stores (no penalty on
+ * AVX-512 capable CPUs when the data is aligned) and process the
+ * remaining samples with a masked load/store.
+ */
+
+static inline __mmask16
+tail_mask (uint32_t n)
+{
+	return (__mmask16) ((1u << n) - 1);
+}
+
+/**
+ * @brief x86-64 AVX-512F optimized routine for compute peak procedure
+ * @param src Pointer to source buffer
+ * @param nframes Number of frames to process
+ * @param current Current peak value
+ * @return float New peak value
+ */
+float
+x86_avx512f_compute_peak (float const* src, uint32_t nframes, float current)
+{
+	__m512 vmax = _mm512_set1_ps (current);
+
+	while (nframes >= 32) {
+		__m512 s0 = _mm512_abs_ps (_mm512_loadu_ps (src + 0));
+		__m512 s1 = _mm512_abs_ps (_mm512_loadu_ps (src + 16));
+		vmax = _mm512_max_ps (vmax, _mm512_max_ps (s0, s1));
+		src += 32;
+		nframes -= 32;
+	}
+
+	while (nframes >= 16) {
+		vmax = _mm512_max_ps (vmax, _mm512_abs_ps (_mm512_loadu_ps (src)));
+		src += 16;
+		nframes -= 16;
+	}
+
+	if (nframes > 0) {
+		__m512 s = _mm512_maskz_loadu_ps (tail_mask (nframes), src);
+		vmax = _mm512_max_ps (vmax, _mm512_abs_ps (s));
+	}
+
+	return _mm512_reduce_max_ps (vmax);
+}
+
+/**
+ * @brief x86-64 AVX-512F optimized routine for find peak procedure
+ * @param src Pointer to source buffer
+ * @param nframes Number of frames to process
+ * @param[in,out] minf Current minimum value, updated
+ * @param[in,out] maxf Current maximum value, updated
+ */
+void
+x86_avx512f_find_peaks (float const* src, uint32_t nframes, float* minf, float* maxf)
+{
+	__m512 vmin = _mm512_set1_ps (*minf);
+	__m512 vmax = _mm512_set1_ps (*maxf);
+
+	while (nframes >= 16) {
+		__m512 s = _mm512_loadu_ps (src);
+		vmin = _mm512_min_ps (vmin, s);
+		vmax = _mm512_max_ps (vmax, s);
+		src += 16;
+		nframes -= 16;
+	}
+
+	if (nframes > 0) {
+		const __mmask16 m = tail_mask (nframes);
+		vmin = _mm512_mask_min_ps (vmin, m, vmin, _mm512_maskz_loadu_ps (m, src));
+		vmax = _mm512_mask_max_ps (vmax, m, vmax, _mm512_maskz_loadu_ps (m, src));
+	}
+
+	*minf = _mm512_reduce_min_ps (vmin);
+	*maxf = _mm512_reduce_max_ps (vmax);
+}
+
+/**
+ * @brief x86-64 AVX-512F optimized routine for apply gain routine
+ * @param[in,out] dst Pointer to the destination buffer, which gets updated
+ * @param nframes Number of frames (or samples) to process
+ * @param gain Gain to apply
+ */
+void
+x86_avx512f_apply_gain_to_buffer (float* dst, uint32_t nframes, float gain)
+{
+	const __m512 g = _mm512_set1_ps (gain);
+
+	while (nframes >= 32) {
+		__m512 d0 = _mm512_mul_ps (g, _mm512_loadu_ps (dst + 0));
+		__m512 d1 = _mm512_mul_ps (g, _mm512_loadu_ps (dst + 16));
+		_mm512_storeu_ps (dst + 0, d0);
+		_mm512_storeu_ps (dst + 16, d1);
+		dst += 32;
+		nframes -= 32;
+	}
+
+	while (nframes >= 16) {
+		_mm512_storeu_ps (dst, _mm512_mul_ps (g, _mm512_loadu_ps (dst)));
+		dst += 16;
+		nframes -= 16;
+	}
+
+	if (nframes > 0) {
+		const __mmask16 m = tail_mask (nframes);
+		_mm512_mask_storeu_ps (dst, m, _mm512_mul_ps (g, _mm512_maskz_loadu_ps (m, dst)));
+	}
+}
+
+/**
+ * @brief x86-64 AVX-512F optimized routine for mixing buffer with gain
+ * @param[in,out] dst Pointer to destination buffer, which gets updated
+ * @param[in] src Pointer to source buffer (not updated)
+ * @param nframes Number of samples to process
+ * @param gain Gain to apply
+ */
+void
+x86_avx512f_mix_buffers_with_gain (float* dst, float const* src, uint32_t nframes, float gain)
+{
+	const __m512 g = _mm512_set1_ps (gain);
+
+	while (nframes >= 32) {
+		__m512 d0 = _mm512_fmadd_ps (g, _mm512_loadu_ps (src + 0), _mm512_loadu_ps (dst + 0));
+		__m512 d1 = _mm512_fmadd_ps (g, _mm512_loadu_ps (src + 16), _mm512_loadu_ps (dst + 16));
+		_mm512_storeu_ps (dst + 0, d0);
+		_mm512_storeu_ps (dst + 16, d1);
+		src += 32;
+		dst += 32;
+		nframes -= 32;
+	}
+
+	while (nframes >= 16) {
+		_mm512_storeu_ps (dst, _mm512_fmadd_ps (g, _mm512_loadu_ps (src), _mm512_loadu_ps (dst)));
+		src += 16;
+		dst += 16;
+		nframes -= 16;
+	}
+
+	if (nframes > 0) {
+		const __mmask16 m = tail_mask (nframes);
+		__m512 d = _mm512_fmadd_ps (g, _mm512_maskz_loadu_ps (m, src), _mm512_maskz_loadu_ps (m, dst));
+		_mm512_mask_storeu_ps (dst, m, d);
+	}
+}
+
+/**
+ * @brief x86-64 AVX-512F optimized routine for mixing buffer with no gain
+ * @param[in,out] dst Pointer to destination buffer, which gets updated
+ * @param[in] src Pointer to source buffer (not updated)
+ * @param nframes Number of samples to process
+ */
+void
+x86_avx512f_mix_buffers_no_gain (float* dst, float const* src, uint32_t nframes)
+{
+	while (nframes >= 32) {
+		__m512 d0 = _mm512_add_ps (_mm512_loadu_ps (src + 0), _mm512_loadu_ps (dst + 0));
+		__m512 d1 = _mm512_add_ps (_mm512_loadu_ps (src + 16), _mm512_loadu_ps (dst + 16));
+		_mm512_storeu_ps (dst + 0, d0);
+		_mm512_storeu_ps (dst + 16, d1);
+		src += 32;
+		dst += 32;
+		nframes -= 32;
+	}
+
+	while (nframes >= 16) {
+		_mm512_storeu_ps (dst, _mm512_add_ps (_mm512_loadu_ps (src), _mm512_loadu_ps (dst)));
+		src += 16;
+		dst += 16;
+		nframes -= 16;
+	}
+
+	if (nframes > 0) {
+		const __mmask16 m = tail_mask (nframes);
+		_mm512_mask_storeu_ps (dst, m, _mm512_add_ps (_mm512_maskz_loadu_ps (m, src), _mm512_maskz_loadu_ps (m, dst)));
+	}
+}
+
+/**
+ * @brief Copy vector from one location to another
+ * @param[out] dst Pointer to destination buffer
+ * @param[in] src Pointer to source buffer
+ * @param nframes Number of samples to copy
+ */
+void
+x86_avx512f_copy_vector (float* dst, float const* src, uint32_t nframes)
+{
+	while (nframes >= 64) {
+		__m512 s0 = _mm512_loadu_ps (src + 0);
+		__m512 s1 = _mm512_loadu_ps (src + 16);
+		__m512 s2 = _mm512_loadu_ps (src + 32);
+		__m512 s3 = _mm512_loadu_ps (src + 48);
+		_mm512_storeu_ps (dst + 0, s0);
+		_mm512_storeu_ps (dst + 16, s1);
+		_mm512_storeu_ps (dst + 32, s2);
+		_mm512_storeu_ps (dst + 48, s3);
+		src += 64;
+		dst += 64;
+		nframes -= 64;
+	}
+
+	while (nframes >= 16) {
+		_mm512_storeu_ps (dst, _mm512_loadu_ps (src));
+		src += 16;
+		dst += 16;
+		nframes -= 16;
+	}
+
+	if (nframes > 0) {
+		const __mmask16 m = tail_mask (nframes);
+		_mm512_mask_storeu_ps (dst, m, _mm512_maskz_loadu_ps (m, src));
+	}
+}
+
+/**
+ * @brief x86-64 AVX-512F optimized routine for a one-pole smoothed gain ramp
+ *
+ * g[n] = target + (initial - target) * (1 - coeff)^n, which is
+ * equivalent to g[n+1] = g[n] + coeff * (target - g[n])
+ *
+ * @return gain after the last sample
+ */
+float
+x86_avx512f_apply_gain_ramp_to_buffer (float* buf, uint32_t nframes, float initial, float target, float coeff)
+{
+	float d = initial - target;
+
+	if (nframes >= 16) {
+		const float r = 1.f - coeff;
+		float       p[16];
+		float       r16 = r;
+
+		p[0] = d;
+		for (int i = 1; i < 16; ++i) {
+			p[i] = p[i - 1] * r;
+			r16 *= r;
+		}
+
+		const __m512 rr    = _mm512_set1_ps (r16);
+		const __m512 tgt   = _mm512_set1_ps (target);
+		__m512       delta = _mm512_loadu_ps (p);
+
+		while (nframes >= 16) {
+			_mm512_storeu_ps (buf, _mm512_mul_ps (_mm512_loadu_ps (buf), _mm512_add_ps (tgt, delta)));
+			delta = _mm512_mul_ps (delta, rr);
+			buf += 16;
+			nframes -= 16;
+		}
+		d = _mm_cvtss_f32 (_mm512_castps512_ps128 (delta));
+	}
+
+	float g = target + d;
+	while (nframes > 0) {
+		*buf++ *= g;
+		g += coeff * (target - g);
+		--nframes;
+	}
+	return g;
+}
+
+/**
+ * @brief x86-64 AVX-512F optimized routine to apply per-sample gain
+ * @param[in,out] buf Pointer to buffer
+ * @param[in] gain Pointer to gain coefficients, one per sample
+ * @param nframes Number of samples to process
+ */
+void
+x86_avx512f_apply_gain_vector_to_buffer (float* buf, float const* gain, uint32_t nframes)
+{
+	while (nframes >= 16) {
+		_mm512_storeu_ps (buf, _mm512_mul_ps (_mm512_loadu_ps (buf), _mm512_loadu_ps (gain)));
+		buf += 16;
+		gain += 16;
+		nframes -= 16;
+	}
+
+	if (nframes > 0) {
+		const __mmask16 m = tail_mask (nframes);
+		_mm512_mask_storeu_ps (buf, m, _mm512_mul_ps (_mm512_maskz_loadu_ps (m, buf), _mm512_maskz_loadu_ps (m, gain)));
+	}
+}
+
+/**
+ * @brief x86-64 AVX-512F optimized routine for polarity inversion
+ * @param[in,out] buf Pointer to buffer
+ * @param nframes Number of samples to process
+ */
+void
+x86_avx512f_invert_buffer (float* buf, uint32_t nframes)
+{
+	const __m512i sign = _mm512_set1_epi32 (0x80000000);
+
+	while (nframes >= 16) {
+		__m512i v = _mm512_castps_si512 (_mm512_loadu_ps (buf));
+		_mm512_storeu_ps (buf, _mm512_castsi512_ps (_mm512_xor_si512 (v, sign)));
+		buf += 16;
+		nframes -= 16;
+	}
+
+	if (nframes > 0) {
+		const __mmask16 m = tail_mask (nframes);
+		__m512i v = _mm512_castps_si512 (_mm512_maskz_loadu_ps (m, buf));
+		_mm512_mask_storeu_ps (buf, m, _mm512_castsi512_ps (_mm512_xor_si512 (v, sign)));
+	}
+}
+
+/**
+ * @brief x86-64 AVX-512F optimized routine to interleave a mono buffer
+ * @param[out] dst Interleaved buffer with @a n_chn channels
+ * @param[in] src Mono source buffer
+ * @param nframes Number of samples to process
+ * @param chn Channel in the interleaved buffer
+ * @param n_chn Number of channels in the interleaved buffer
+ */
+void
+x86_avx512f_interleave_buffer (float* dst, float const* src, uint32_t nframes, uint32_t chn, uint32_t n_chn)
+{
+	if (n_chn == 1) {
+		x86_avx512f_copy_vector (dst, src, nframes);
+		return;
+	}
+
+	const __m512i idx = _mm512_mullo_epi32 (_mm512_set_epi32 (15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0), _mm512_set1_epi32 (n_chn));
+	dst += chn;
+
+	while (nframes >= 16) {
+		_mm512_i32scatter_ps (dst, idx, _mm512_loadu_ps (src), 4);
+		src += 16;
+		dst += 16 * n_chn;
+		nframes -= 16;
+	}
+
+	if (nframes > 0) {
+		const __mmask16 m = tail_mask (nframes);
+		_mm512_mask_i32scatter_ps (dst, m, idx, _mm512_maskz_loadu_ps (m, src), 4);
+	}
+}
+
+/**
+ * @brief x86-64 AVX-512F optimized routine to de-interleave into a mono buffer
+ * @param[out] dst Mono destination buffer
+ * @param[in] src Interleaved buffer with @a n_chn channels
+ * @param nframes Number of samples to process
+ * @param chn Channel in the interleaved buffer
+ * @param n_chn Number of channels in the interleaved buffer
+ */
+void
+x86_avx512f_deinterleave_buffer (float* dst, float const* src, uint32_t nframes, uint32_t chn, uint32_t n_chn)
+{
+	if (n_chn == 1) {
+		x86_avx512f_copy_vector (dst, src, nframes);
+		return;
+	}
+
+	const __m512i idx = _mm512_mullo_epi32 (_mm512_set_epi32 (15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0), _mm512_set1_epi32 (n_chn));
+	src += chn;
+
+	while (nframes >= 16) {
+		_mm512_storeu_ps (dst, _mm512_i32gather_ps (idx, src, 4));
+		src += 16 * n_chn;
+		dst += 16;
+		nframes -= 16;
+	}
+
+	if (nframes > 0) {
+		const __mmask16 m = tail_mask (nframes);
+		__m512 v = _mm512_mask_i32gather_ps (_mm512_setzero_ps (), m, idx, src, 4);
+		_mm512_mask_storeu_ps (dst, m, v);
+	}
+}
+
+/**
+ * @brief x86-64 AVX-512F optimized routine to accumulate a buffer and compute the peak of the result
+ * @param[in,out] dst Pointer to destination buffer, which gets updated
+ * @param[in] src Pointer to source buffer (not updated)
+ * @param nframes Number of samples to process
+ * @param current Current peak value
+ * @return max (current, absolute peak of @a dst after the operation)
+ */
+float
+x86_avx512f_mix_buffers_no_gain_and_peak (float* dst, float const* src, uint32_t nframes, float current)
+{
+	__m512 vmax = _mm512_set1_ps (current);
+
+	while (nframes >= 16) {
+		__m512 d = _mm512_add_ps (_mm512_loadu_ps (dst), _mm512_loadu_ps (src));
+		_mm512_storeu_ps (dst, d);
+		vmax = _mm512_max_ps (vmax, _mm512_abs_ps (d));
+		dst += 16;
+		src += 16;
+		nframes -= 16;
+	}
+
+	if (nframes > 0) {
+		const __mmask16 m = tail_mask (nframes);
+		__m512 d = _mm512_add_ps (_mm512_maskz_loadu_ps (m, dst), _mm512_maskz_loadu_ps (m, src));
+		_mm512_mask_storeu_ps (dst, m, d);
+		vmax = _mm512_max_ps (vmax, _mm512_abs_ps (d));
+	}
+
+	return _mm512_reduce_max_ps (vmax);
+}
+
+/**
+ * @brief x86-64 AVX-512F optimized routine to accumulate a buffer with gain and compute the peak of the result
+ * @param[in,out] dst Pointer to destination buffer, which gets updated
+ * @param[in] src Pointer to source buffer (not updated)
+ * @param nframes Number of samples to process
+ * @param gain Gain to apply to @a src
+ * @param current Current peak value
+ * @return max (current, absolute peak of @a dst after the operation)
+ */
+float
+x86_avx512f_mix_buffers_with_gain_and_peak (float* dst, float const* src, uint32_t nframes, float gain, float current)
+{
+	const __m512 g    = _mm512_set1_ps (gain);
+	__m512 vmax = _mm512_set1_ps (current);
+
+	while (nframes >= 16) {
+		__m512 d = _mm512_fmadd_ps (_mm512_loadu_ps (src), g, _mm512_loadu_ps (dst));
+		_mm512_storeu_ps (dst, d);
+		vmax = _mm512_max_ps (vmax, _mm512_abs_ps (d));
+		dst += 16;
+		src += 16;
+		nframes -= 16;
+	}
+
+	if (nframes > 0) {
+		const __mmask16 m = tail_mask (nframes);
+		__m512 d = _mm512_fmadd_ps (_mm512_maskz_loadu_ps (m, src), g, _mm512_maskz_loadu_ps (m, dst));
+		_mm512_mask_storeu_ps (dst, m, d);
+		vmax = _mm512_max_ps (vmax, _mm512_abs_ps (d));
+	}
+
+	return _mm512_reduce_max_ps (vmax);
+}
+
+/**
+ * @brief x86-64 AVX-512F optimized routine to copy a buffer with gain and compute the peak of the result
+ * @param[in,out] dst Pointer to destination buffer, which gets updated
+ * @param[in] src Pointer to source buffer (not updated)
+ * @param nframes Number of samples to process
+ * @param gain Gain to apply to @a src
+ * @param current Current peak value
+ * @return max (current, absolute peak of @a dst after the operation)
+ */
+float
+x86_avx512f_copy_vector_with_gain_and_peak (float* dst, float const* src, uint32_t nframes, float gain, float current)
+{
+	const __m512 g    = _mm512_set1_ps (gain);
+	__m512 vmax = _mm512_set1_ps (current);
+
+	while (nframes >= 16) {
+		__m512 d = _mm512_mul_ps (_mm512_loadu_ps (src), g);
+		_mm512_storeu_ps (dst, d);
+		vmax = _mm512_max_ps (vmax, _mm512_abs_ps (d));
+		dst += 16;
+		src += 16;
+		nframes -= 16;
+	}
+
+	if (nframes > 0) {
+		const __mmask16 m = tail_mask (nframes);
+		__m512 d = _mm512_mul_ps (_mm512_maskz_loadu_ps (m, src), g);
+		_mm512_mask_storeu_ps (dst, m, d);
+		vmax = _mm512_max_ps (vmax, _mm512_abs_ps (d));
+	}
+
+	return _mm512_reduce_max_ps (vmax);
+}
+
+#endif // FPU_AVX512F_SUPPORT
@@ -1651,11 +1651,11 @@ AlsaAudioBackend::midi_event_get (
 	if (event_index >= source.size ()) {
 		return -1;
 	}
-	AlsaMidiEvent const& event = source[event_index];
+	AlsaMidiBuffer::Event const event (source[event_index]);
 
-	timestamp = event.timestamp ();
-	size      = event.size ();
-	*buf      = event.data ();
+	timestamp = event.timestamp;
+	size      = event.size;
+	*buf      = event.data;
 	return 0;
 }
 
@@ -1671,14 +1671,13 @@ AlsaAudioBackend::midi_event_put (
 	}
 	AlsaMidiBuffer& dst = *static_cast<AlsaMidiBuffer*> (port_buffer);
 #ifndef NDEBUG
-	if (dst.size () && (pframes_t)dst.back ().timestamp () > timestamp) {
-		// nevermind, ::get_buffer() sorts events
+	if (dst.size () && dst[dst.size () - 1].timestamp > timestamp) {
+		// nevermind, the buffer keeps events sorted
 		fprintf (stderr, "AlsaMidiBuffer: it's too late for this event. %d > %d\n",
-		         (pframes_t)dst.back ().timestamp (), timestamp);
+		         dst[dst.size () - 1].timestamp, timestamp);
 	}
 #endif
-	dst.push_back (AlsaMidiEvent (timestamp, buffer, size));
-	return 0;
+	return dst.push (timestamp, buffer, size);
 }
 
 uint32_t
@@ -1980,8 +1979,9 @@ AlsaAudioBackend::main_process_thread ()
 					AlsaMidiBuffer const* src = boost::dynamic_pointer_cast<const AlsaMidiPort> (*it)->const_buffer ();
 					AlsaMidiOut*          rm  = _rmidi_out.at (i);
 					rm->sync_time (clock1);
-					for (AlsaMidiBuffer::const_iterator mit = src->begin (); mit != src->end (); ++mit) {
-						rm->send_event (mit->timestamp (), mit->data (), mit->size ());
+					for (size_t e = 0; e < src->size (); ++e) {
+						AlsaMidiBuffer::Event const ev ((*src)[e]);
+						rm->send_event (ev.timestamp, ev.data, ev.size);
 					}
 				}
 				pthread_mutex_unlock (&_device_port_mutex);
@@ -2343,60 +2343,28 @@ AlsaMidiPort::AlsaMidiPort (AlsaAudioBackend& b, const std::string& name, PortFl
 	_buffer[0].clear ();
 	_buffer[1].clear ();
 	_buffer[2].clear ();
-
-	_buffer[0].reserve (256);
-	_buffer[1].reserve (256);
-	_buffer[2].reserve (256);
 }
 
 AlsaMidiPort::~AlsaMidiPort ()
 {
 }
 
-struct MidiEventSorter {
-	bool operator() (AlsaMidiEvent const& a, AlsaMidiEvent const& b)
-	{
-		return a < b;
-	}
-};
-
 void* AlsaMidiPort::get_buffer (pframes_t /* nframes */)
 {
 	if (is_input ()) {
-		(_buffer[_bufperiod]).clear ();
+		AlsaMidiBuffer& dst (_buffer[_bufperiod]);
+		dst.clear ();
 		const std::set<BackendPortPtr>& connections = get_connections ();
 		for (std::set<BackendPortPtr>::const_iterator i = connections.begin ();
 		     i != connections.end ();
 		     ++i) {
-			const AlsaMidiBuffer* src = boost::dynamic_pointer_cast<const AlsaMidiPort> (*i)->const_buffer ();
-			for (AlsaMidiBuffer::const_iterator it = src->begin (); it != src->end (); ++it) {
-				(_buffer[_bufperiod]).push_back (*it);
-			}
+			dst.add_source (*boost::dynamic_pointer_cast<const AlsaMidiPort> (*i)->const_buffer ());
 		}
-		std::stable_sort ((_buffer[_bufperiod]).begin (), (_buffer[_bufperiod]).end (), MidiEventSorter ());
+		dst.merge ();
 	}
 	return &(_buffer[_bufperiod]);
 }
 
-AlsaMidiEvent::AlsaMidiEvent (const pframes_t timestamp, const uint8_t* data, size_t size)
-	: _size (size)
-	, _timestamp (timestamp)
-{
-	if (size > 0 && size < MaxAlsaMidiEventSize) {
-		memcpy (_data, data, size);
-	}
-}
-
-AlsaMidiEvent::AlsaMidiEvent (const AlsaMidiEvent& other)
-	: _size (other.size ())
-	, _timestamp (other.timestamp ())
-{
-	if (other._size > 0) {
-		assert (other._size < MaxAlsaMidiEventSize);
-		memcpy (_data, other._data, other._size);
-	}
-};
-
 /******************************************************************************/
 
 AlsaDeviceReservation::AlsaDeviceReservation ()
@@ -50,20 +50,7 @@ namespace ARDOUR {
 
 class AlsaAudioBackend;
 
-class AlsaMidiEvent : public BackendMIDIEvent {
-	public:
-		AlsaMidiEvent (const pframes_t timestamp, const uint8_t* data, size_t size);
-		AlsaMidiEvent (const AlsaMidiEvent& other);
-		size_t size () const { return _size; };
-		pframes_t timestamp () const { return _timestamp; };
-		const uint8_t* data () const { return _data; };
-	private:
-		size_t _size;
-		pframes_t _timestamp;
-		uint8_t _data[MaxAlsaMidiEventSize];
-};
-
-typedef std::vector<AlsaMidiEvent> AlsaMidiBuffer;
+typedef BackendMIDIBuffer AlsaMidiBuffer;
 
 class AlsaAudioPort : public BackendPort {
 	public:
@@ -90,6 +90,7 @@ DummyAudioBackend::DummyAudioBackend (AudioEngine& e, AudioBackendInfo& info)
 		_driver_speed.push_back (DriverSpeed (_("15x Speed"),    0.06666f));
 		_driver_speed.push_back (DriverSpeed (_("20x Speed"),    0.05f));
 		_driver_speed.push_back (DriverSpeed (_("50x Speed"),    0.02f));
+		_driver_speed.push_back (DriverSpeed (_("Offline (No Pacing)"), 0.0f));
 	}
 
 }
@@ -462,6 +463,8 @@ DummyAudioBackend::_start (bool /*for_latency_measurement*/)
 	engine.reconnect_ports ();
 	g_atomic_int_set (&_port_change_flag, 0);
 
+	_cycle_histogram.reset ();
+
 	if (pbd_pthread_create (PBD_RT_STACKSIZE_PROC, &_main_thread, pthread_process, this)) {
 		PBD::error << _("DummyAudioBackend: cannot start.") << endmsg;
 	}
@@ -491,6 +494,10 @@ DummyAudioBackend::stop ()
 		return -1;
 	}
 	unregister_ports();
+
+	if (offline () && _cycle_histogram.count () > 0) {
+		PBD::info << _cycle_histogram.report (1e6 * _samples_per_period / _samplerate) << endmsg;
+	}
 	return 0;
 }
 
@@ -791,11 +798,11 @@ DummyAudioBackend::midi_event_get (
 	if (event_index >= source.size ()) {
 		return -1;
 	}
-	DummyMidiEvent * const event = source[event_index].get ();
+	DummyMidiBuffer::Event const event (source[event_index]);
 
-	timestamp = event->timestamp ();
-	size = event->size ();
-	*buf = event->data ();
+	timestamp = event.timestamp;
+	size = event.size;
+	*buf = event.data;
 	return 0;
 }
 
@@ -807,11 +814,13 @@ DummyAudioBackend::midi_event_put (
 {
 	assert (buffer && port_buffer);
 	DummyMidiBuffer& dst = * static_cast<DummyMidiBuffer*>(port_buffer);
-	if (dst.size () && (pframes_t)dst.back ()->timestamp () > timestamp) {
-		// nevermind, ::get_buffer() sorts events, but always print warning
-		fprintf (stderr, "DummyMidiBuffer: it's too late for this event %d > %d.\n", (pframes_t)dst.back ()->timestamp (), timestamp);
+	if (dst.size () && dst[dst.size () - 1].timestamp > timestamp) {
+		// nevermind, the buffer keeps events sorted, but always print warning
+		fprintf (stderr, "DummyMidiBuffer: it's too late for this event %d > %d.\n", dst[dst.size () - 1].timestamp, timestamp);
+	}
+	if (dst.push (timestamp, buffer, size)) {
+		return -1;
 	}
-	dst.push_back (boost::shared_ptr<DummyMidiEvent>(new DummyMidiEvent (timestamp, buffer, size)));
 #if 0 // DEBUG MIDI EVENTS
 	printf("DummyAudioBackend::midi_event_put %d, %zu: ", timestamp, size);
 	for (size_t xx = 0; xx < size; ++xx) {
@@ -948,6 +957,9 @@ DummyAudioBackend::main_process_thread ()
 			boost::dynamic_pointer_cast<DummyPort>(*it)->next_period ();
 		}
 
+		dsp_stats[RunLoop].start ();
+		const int64_t cycle_start = _x_get_monotonic_usec ();
+
 		if (engine.process_callback (samples_per_period)) {
 			return 0;
 		}
@@ -981,7 +993,16 @@ DummyAudioBackend::main_process_thread ()
 			}
 		}
 
-		if (!_freewheel) {
+		_cycle_histogram.add (_x_get_monotonic_usec () - cycle_start);
+		dsp_stats[RunLoop].update ();
+
+		if (offline ()) {
+			/* run the next cycle right away, load is relative to the nominal period */
+			_dsp_load_calc.set_max_time (_samplerate, samples_per_period);
+			_dsp_load_calc.set_start_timestamp_us (clock1);
+			_dsp_load_calc.set_stop_timestamp_us (_x_get_monotonic_usec());
+			_dsp_load = _dsp_load_calc.get_dsp_load_unbound ();
+		} else if (!_freewheel) {
 			_dsp_load_calc.set_max_time (_samplerate, samples_per_period);
 			_dsp_load_calc.set_start_timestamp_us (clock1);
 			_dsp_load_calc.set_stop_timestamp_us (_x_get_monotonic_usec());
@@ -1102,6 +1123,60 @@ extern "C" ARDOURBACKEND_API ARDOUR::AudioBackendInfo* descriptor ()
 }
 
 
+/******************************************************************************/
+
+void
+DummyCycleHistogram::reset ()
+{
+	for (int i = 0; i < n_bins; ++i) {
+		_bins[i] = 0;
+	}
+	_count = 0;
+	_min   = INT64_MAX;
+	_max   = 0;
+	_sum   = 0;
+}
+
+void
+DummyCycleHistogram::add (int64_t usec)
+{
+	if (usec < 0) {
+		return;
+	}
+	int b = 0;
+	while (b < n_bins - 1 && (INT64_C(1) << b) <= usec) {
+		++b;
+	}
+	++_bins[b];
+	++_count;
+	_sum += usec;
+	_min = std::min (_min, usec);
+	_max = std::max (_max, usec);
+}
+
+std::string
+DummyCycleHistogram::report (int64_t nominal_usec) const
+{
+	if (_count == 0) {
+		return "";
+	}
+	const double avg = _sum / _count;
+	std::string rv = string_compose (_("DummyAudioBackend: %1 cycles, process time min: %2 us, avg: %3 us, max: %4 us, nominal period: %5 us (%6x realtime)"),
+	                                 _count, _min, avg, _max, nominal_usec,
+	                                 _sum > 0 ? nominal_usec * _count / _sum : 0);
+
+	for (int b = 0; b < n_bins; ++b) {
+		if (_bins[b] == 0) {
+			continue;
+		}
+		rv += string_compose ("\n  %1 us .. %2 us: %3 (%4%%)",
+		                      b > 0 ? (INT64_C(1) << (b - 1)) : 0,
+		                      b < n_bins - 1 ? string_compose ("%1", INT64_C(1) << b) : std::string ("inf"),
+		                      _bins[b], 100.0 * _bins[b] / _count);
+	}
+	return rv;
+}
+
 /******************************************************************************/
 DummyPort::DummyPort (DummyAudioBackend &b, const std::string& name, PortFlags flags)
 	: BackendPort (b, name, flags)
@@ -1117,6 +1192,17 @@ DummyPort::~DummyPort ()
 
 void DummyPort::setup_random_number_generator ()
 {
+	if (_engine.offline ()) {
+		/* reproducible output: seed from the port-name (FNV-1a) */
+		uint32_t h = 2166136261u;
+		const std::string& n (name ());
+		for (std::string::const_iterator i = n.begin (); i != n.end (); ++i) {
+			h = (h ^ (uint8_t)*i) * 16777619u;
+		}
+		_rseed = h % INT_MAX;
+		if (_rseed == 0) _rseed = 1;
+		return;
+	}
 #ifdef PLATFORM_WINDOWS
 	LARGE_INTEGER Count;
 	if (QueryPerformanceCounter (&Count)) {
@@ -1381,13 +1467,14 @@ void DummyAudioPort::midi_to_wavetable (DummyMidiBuffer const * const src, size_
 	 * to verify layency-compensation alignment
 	 * (here: midi-out playback-latency + audio-in capture-latency)
 	 */
-	for (DummyMidiBuffer::const_iterator it = src->begin (); it != src->end (); ++it) {
-		const pframes_t t = (*it)->timestamp();
+	for (size_t i = 0; i < src->size (); ++i) {
+		DummyMidiBuffer::Event const ev ((*src)[i]);
+		const pframes_t t = ev.timestamp;
 		assert(t < n_samples);
 		// somewhat arbitrary mapping for quick visual feedback
 		float v = -.5f;
-		if ((*it)->size() == 3) {
-			const unsigned char *d = (*it)->data();
+		if (ev.size == 3) {
+			const unsigned char *d = ev.data;
 			if ((d[0] & 0xf0) == 0x90) { // note on
 				v = .25f + d[2] / 512.f;
 			}
@@ -1647,6 +1734,8 @@ DummyAudioPort::get_buffer (pframes_t n_samples)
 
 DummyMidiPort::DummyMidiPort (DummyAudioBackend &b, const std::string& name, PortFlags flags)
 	: DummyPort (b, name, flags)
+	, _buffer (midi_buffer_events, midi_buffer_bytes)
+	, _loopback (midi_buffer_events, midi_buffer_bytes)
 	, _midi_seq_spb (0)
 	, _midi_seq_time (0)
 	, _midi_seq_pos (0)
@@ -1661,18 +1750,9 @@ DummyMidiPort::~DummyMidiPort () {
 	_loopback.clear ();
 }
 
-struct MidiEventSorter {
-	bool operator() (const boost::shared_ptr<DummyMidiEvent>& a, const boost::shared_ptr<DummyMidiEvent>& b) {
-		return *a < *b;
-	}
-};
-
 void DummyMidiPort::set_loopback (DummyMidiBuffer const * const src)
 {
-	_loopback.clear ();
-	for (DummyMidiBuffer::const_iterator it = src->begin (); it != src->end (); ++it) {
-		_loopback.push_back (boost::shared_ptr<DummyMidiEvent>(new DummyMidiEvent (**it)));
-	}
+	_loopback.copy (*src);
 }
 
 std::string
@@ -1720,18 +1800,16 @@ void DummyMidiPort::midi_generate (const pframes_t n_samples)
 		pframes_t pp = pulse_position ();
 		if (pp < n_samples - 1) {
 			uint8_t md[3] = {0x90, 0x3c, 0x7f};
-			_buffer.push_back (boost::shared_ptr<DummyMidiEvent>(new DummyMidiEvent (pp, md, 3)));
+			_buffer.push (pp, md, 3);
 			md[0] = 0x80;
 			md[2] = 0;
-			_buffer.push_back (boost::shared_ptr<DummyMidiEvent>(new DummyMidiEvent (pp + 1, md, 3)));
+			_buffer.push (pp + 1, md, 3);
 		}
 		return;
 	}
 
 	if (_midi_seq_spb == 0 || !_midi_seq_dat) {
-		for (DummyMidiBuffer::const_iterator it = _loopback.begin (); it != _loopback.end (); ++it) {
-			_buffer.push_back (boost::shared_ptr<DummyMidiEvent>(new DummyMidiEvent (**it)));
-		}
+		_buffer.copy (_loopback);
 		return;
 	}
 
@@ -1763,7 +1841,7 @@ void DummyMidiPort::midi_generate (const pframes_t n_samples)
 					case 6: buf[1] =  0x60 |  ((/* 25fps*/ 0x20 | hour) & 0x0f); break;
 					case 7: buf[1] =  0x70 | (((/* 25fps*/ 0x20 | hour) & 0xf0)>>4); break;
 				}
-				_buffer.push_back (boost::shared_ptr<DummyMidiEvent>(new DummyMidiEvent (tc_sample - _midi_seq_time, buf, 2)));
+				_buffer.push (tc_sample - _midi_seq_time, buf, 2);
 			}
 			tc_sample += audio_samples_per_qf;
 			if (++qf == 8) {
@@ -1789,7 +1867,7 @@ void DummyMidiPort::midi_generate (const pframes_t n_samples)
 			buf[0] = 0xf2;
 			buf[1] = bcnt & 0x7f; // LSB
 			buf[2] = (bcnt >> 7) & 0x7f; // MSB
-			_buffer.push_back (boost::shared_ptr<DummyMidiEvent>(new DummyMidiEvent (0, buf, 3)));
+			_buffer.push (0, buf, 3);
 		}
 
 		/* MIDI System Real-Time Messages */
@@ -1801,7 +1879,7 @@ void DummyMidiPort::midi_generate (const pframes_t n_samples)
 		if (_midi_seq_time == 0) {
 			/* start */
 			buf[0] = MIDI_RT_START;
-			_buffer.push_back (boost::shared_ptr<DummyMidiEvent>(new DummyMidiEvent (0, buf, 1)));
+			_buffer.push (0, buf, 1);
 		}
 
 		const int clock_tick_interval = _midi_seq_spb; // samples per clock-tick
@@ -1811,7 +1889,7 @@ void DummyMidiPort::midi_generate (const pframes_t n_samples)
 		while (clk_sample < _midi_seq_time + n_samples) {
 			if (clk_sample >= _midi_seq_time) {
 				buf[0] = MIDI_RT_CLOCK;
-				_buffer.push_back (boost::shared_ptr<DummyMidiEvent>(new DummyMidiEvent (clk_sample - _midi_seq_time, buf, 1)));
+				_buffer.push (clk_sample - _midi_seq_time, buf, 1);
 			}
 			clk_sample += clock_tick_interval;
 		}
@@ -1832,11 +1910,7 @@ void DummyMidiPort::midi_generate (const pframes_t n_samples)
 		if ((pframes_t) ev_beat_time >= n_samples) {
 			break;
 		}
-		_buffer.push_back (boost::shared_ptr<DummyMidiEvent>(new DummyMidiEvent (
-						ev_beat_time,
-						_midi_seq_dat[_midi_seq_pos].event,
-						_midi_seq_dat[_midi_seq_pos].size
-						)));
+		_buffer.push (ev_beat_time, _midi_seq_dat[_midi_seq_pos].event, _midi_seq_dat[_midi_seq_pos].size);
 		++_midi_seq_pos;
 
 		if (_midi_seq_dat[_midi_seq_pos].event[0] == 0xff && _midi_seq_dat[_midi_seq_pos].event[1] == 0xff) {
@@ -1860,12 +1934,9 @@ void* DummyMidiPort::get_buffer (pframes_t n_samples)
 			if (source->is_physical() && source->is_terminal()) {
 				source->get_buffer(n_samples); // generate signal.
 			}
-			const DummyMidiBuffer *src = source->const_buffer ();
-			for (DummyMidiBuffer::const_iterator it = src->begin (); it != src->end (); ++it) {
-				_buffer.push_back (boost::shared_ptr<DummyMidiEvent>(new DummyMidiEvent (**it)));
-			}
+			_buffer.add_source (*source->const_buffer ());
 		}
-		std::stable_sort (_buffer.begin (), _buffer.end (), MidiEventSorter());
+		_buffer.merge ();
 	} else if (is_output () && is_physical () && is_terminal()) {
 		if (!_gen_cycle) {
 			midi_generate(n_samples);
@@ -1873,29 +1944,3 @@ void* DummyMidiPort::get_buffer (pframes_t n_samples)
 	}
 	return &_buffer;
 }
-
-DummyMidiEvent::DummyMidiEvent (const pframes_t timestamp, const uint8_t* data, size_t size)
-	: _size (size)
-	, _timestamp (timestamp)
-	, _data (0)
-{
-	if (size > 0) {
-		_data = (uint8_t*) malloc (size);
-		memcpy (_data, data, size);
-	}
-}
-
-DummyMidiEvent::DummyMidiEvent (const DummyMidiEvent& other)
-	: _size (other.size ())
-	, _timestamp (other.timestamp ())
-	, _data (0)
-{
-	if (other.size () && other.data ()) {
-		_data = (uint8_t*) malloc (other.size ());
-		memcpy (_data, other.data (), other.size ());
-	}
-};
-
-DummyMidiEvent::~DummyMidiEvent () {
-	free (_data);
-};
@@ -52,21 +52,28 @@ namespace DummyMidiData {
 };
 
 
-class DummyMidiEvent : public BackendMIDIEvent {
+typedef BackendMIDIBuffer DummyMidiBuffer;
+
+/** Histogram of per-cycle process time, log2 spaced bins in microseconds */
+class DummyCycleHistogram {
 	public:
-		DummyMidiEvent (const pframes_t timestamp, const uint8_t* data, size_t size);
-		DummyMidiEvent (const DummyMidiEvent& other);
-		~DummyMidiEvent ();
-		size_t size () const { return _size; };
-		pframes_t timestamp () const { return _timestamp; };
-		const uint8_t* data () const { return _data; };
+		DummyCycleHistogram () { reset (); }
+
+		void reset ();
+		void add (int64_t usec);
+
+		uint64_t count () const { return _count; }
+		std::string report (int64_t nominal_usec) const;
+
 	private:
-		size_t _size;
-		pframes_t _timestamp;
-		uint8_t *_data;
-};
+		static const int n_bins = 24;
 
-typedef std::vector<boost::shared_ptr<DummyMidiEvent> > DummyMidiBuffer;
+		uint64_t _bins[n_bins];
+		uint64_t _count;
+		int64_t  _min;
+		int64_t  _max;
+		double   _sum;
+};
 
 class DummyPort : public BackendPort {
 	protected:
@@ -90,7 +97,7 @@ class DummyPort : public BackendPort {
 		Glib::Threads::Mutex generator_lock;
 
         private:
-		AudioBackend& _engine;
+		DummyAudioBackend& _engine;
 
 }; // class DummyPort
 
@@ -173,6 +180,10 @@ class DummyMidiPort : public DummyPort {
 		void set_loopback (DummyMidiBuffer const * const src);
 
 	private:
+		/* capacity per port and cycle, allocated once */
+		static const size_t midi_buffer_events = 16384;
+		static const size_t midi_buffer_bytes  = 65536;
+
 		DummyMidiBuffer _buffer;
 		DummyMidiBuffer _loopback;
 
@@ -191,6 +202,10 @@ class DummyAudioBackend : public AudioBackend, public PortEngineSharedImpl {
 
 		bool is_running () const { return _running; }
 
+		/** true if cycles are processed back-to-back without pacing,
+		 * and generators produce reproducible output */
+		bool offline () const { return _speedup == 0.f; }
+
 		/* AUDIOBACKEND API */
 
 		std::string name () const;
@@ -370,6 +385,7 @@ class DummyAudioBackend : public AudioBackend, public PortEngineSharedImpl {
 		size_t _samples_per_period;
 		float  _dsp_load;
 		DSPLoadCalculator _dsp_load_calc;
+		DummyCycleHistogram _cycle_histogram;
 		static size_t _max_buffer_size;
 
 		uint32_t _n_inputs;
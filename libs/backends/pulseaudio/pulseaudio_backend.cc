@@ -32,6 +32,7 @@
 #include "pbd/pthread_utils.h"
 
 #include "ardour/port_manager.h"
+#include "ardour/runtime_functions.h"
 
 #include "pulseaudio_backend.h"
 
@@ -1084,9 +1085,7 @@ PulseAudioBackend::main_process_thread ()
 			for (std::vector<BackendPortPtr>::const_iterator it = _system_outputs.begin (); it != _system_outputs.end (); ++it, ++i) {
 				BackendPortPtr port = boost::dynamic_pointer_cast<BackendPort> (*it);
 				const float* src = (const float*) port->get_buffer (_samples_per_period);
-				for (size_t n = 0; n < _samples_per_period; ++n) {
-					buf[N_CHANNELS * n + i] = src[n];
-				}
+				ARDOUR::interleave_buffer (buf, src, _samples_per_period, i, N_CHANNELS);
 			}
 
 			if (pa_stream_write (p_stream, buf, bytes_to_write, NULL, 0, PA_SEEK_RELATIVE) < 0) {
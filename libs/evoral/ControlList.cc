@@ -39,6 +39,7 @@
 #include <cmath>
 #include <iostream>
 #include <utility>
+#include <algorithm>
 
 #include "evoral/ControlList.h"
 #include "evoral/Curve.h"
@@ -1191,6 +1192,7 @@ ControlList::thaw ()
 			unlocked_remove_duplicates ();
 			unlocked_invalidate_insert_iterator ();
 			_sort_pending = false;
+			mark_dirty ();
 		}
 	}
 	maybe_signal_changed ();
@@ -1208,6 +1210,77 @@ ControlList::mark_dirty () const
 	if (_curve) {
 		_curve->mark_dirty();
 	}
+
+	/* The contiguous copy is rebuilt by the next read, which may be
+	 * in a realtime thread. Make space for it here, growing
+	 * geometrically so that bulk add() remains linear.
+	 */
+	g_atomic_int_set (&_flat.state, FlatEvents::Dirty);
+
+	if (_flat.when.capacity () < _events.size ()) {
+		const size_t n = std::max (_events.size (), 2 * _flat.when.capacity ());
+		_flat.when.reserve (n);
+		_flat.value.reserve (n);
+	}
+}
+
+/** Make sure that the contiguous copy of the event list is up to date.
+ * Must be called with the read-lock held. Concurrent readers do not wait
+ * for each other, only one of them rebuilds the copy while the others
+ * walk the event list.
+ * @return true if the copy can be used
+ */
+bool
+ControlList::unlocked_ensure_flat () const
+{
+	const gint state = g_atomic_int_get (&_flat.state);
+
+	if (state != FlatEvents::Dirty) {
+		return state == FlatEvents::Valid;
+	}
+
+	/* events may be unsorted while frozen */
+	if (_frozen || !_flat.lock.try_lock ()) {
+		return false;
+	}
+
+	if (g_atomic_int_get (&_flat.state) == FlatEvents::Dirty) {
+		g_atomic_int_set (&_flat.state, unlocked_update_flat ());
+	}
+
+	_flat.lock.unlock ();
+
+	return g_atomic_int_get (&_flat.state) == FlatEvents::Valid;
+}
+
+/** Rebuild the contiguous copy of the event list, into space that
+ * was reserved by mark_dirty(). This does not allocate memory.
+ * @return the new FlatEvents::State
+ */
+int
+ControlList::unlocked_update_flat () const
+{
+	if (_flat.when.capacity () < _events.size () || _flat.value.capacity () < _events.size ()) {
+		return FlatEvents::Dirty;
+	}
+
+	_flat.when.clear ();
+	_flat.value.clear ();
+
+	for (const_iterator i = _events.begin (); i != _events.end (); ++i) {
+		if ((*i)->when.time_domain () != _time_domain) {
+			return FlatEvents::Unavailable;
+		}
+		const int64_t w = (*i)->when.val ();
+		if (!_flat.when.empty () && w < _flat.when.back ()) {
+			return FlatEvents::Unavailable;
+		}
+		_flat.when.push_back (w);
+		_flat.value.push_back ((*i)->value);
+	}
+
+	_flat.time_domain = _time_domain;
+	return FlatEvents::Valid;
 }
 
 void
@@ -1477,6 +1550,10 @@ ControlList::unlocked_eval (timepos_t const & xtime) const
 			return _events.front()->value;
 		}
 
+		if (unlocked_ensure_flat () && xtime.time_domain () == _flat.time_domain) {
+			return flat_eval (xtime.val ());
+		}
+
 		return multipoint_eval (xtime);
 	}
 
@@ -1569,6 +1646,141 @@ ControlList::multipoint_eval (timepos_t const & xtime) const
 	return (*range.first)->value;
 }
 
+/** Same as multipoint_eval(), using the contiguous copy of the event list.
+ * \p x must be within the range of the list.
+ */
+double
+ControlList::flat_eval (int64_t x) const
+{
+	const int64_t* w = &_flat.when[0];
+	const size_t   n = _flat.when.size ();
+	const size_t   i = lower_bound (w, w + n, x) - w;
+
+	if (i == n) {
+		return _flat.value[n - 1];
+	}
+	if (i == 0 || w[i] == x) {
+		/* x is a control point in the data */
+		return _flat.value[i];
+	}
+
+	const double lval = _flat.value[i - 1];
+	const double uval = _flat.value[i];
+	const double fraction = (double) (x - w[i - 1]) / (double) (w[i] - w[i - 1]);
+
+	switch (_interpolation) {
+		case Discrete:
+			return lval;
+		case Logarithmic:
+			return interpolate_logarithmic (lval, uval, fraction, _desc.lower, _desc.upper);
+		case Exponential:
+			return interpolate_gain (lval, uval, fraction, _desc.upper);
+		case Curved:
+			/* only used x-fade curves, never direct eval */
+			assert (0);
+		default: // Linear
+			return interpolate_linear (lval, uval, fraction);
+	}
+}
+
+bool
+ControlList::unlocked_eval_vector (timepos_t const & x0, timepos_t const & x1, float* vec, int32_t veclen) const
+{
+	if (_interpolation == Curved || !unlocked_ensure_flat () || x0.time_domain () != _flat.time_domain || x1.time_domain () != _flat.time_domain) {
+		return false;
+	}
+
+	if (veclen <= 0) {
+		return true;
+	}
+
+	const size_t n = _flat.when.size ();
+
+	if (n == 0) {
+		std::fill (vec, vec + veclen, (float) _desc.normal);
+		return true;
+	}
+
+	const int64_t* w = &_flat.when[0];
+	const double*  v = &_flat.value[0];
+
+	const double start = x0.val ();
+	const double dx    = veclen > 1 ? (x1.val () - start) / (veclen - 1) : 0;
+
+	/* w[k-1] <= start < w[k] */
+	size_t  k = upper_bound (w, w + n, x0.val ()) - w;
+	int32_t i = 0;
+
+	while (i < veclen) {
+
+		const double x = start + i * dx;
+
+		while (k < n && w[k] <= x) {
+			++k;
+		}
+
+		if (k == n) {
+			/* at or after the last point */
+			std::fill (vec + i, vec + veclen, (float) v[n - 1]);
+			break;
+		}
+
+		/* index of the first sample at or after w[k] */
+		int32_t end = veclen;
+		if (dx > 0) {
+			end = (int32_t) std::min ((double) veclen, ceil ((w[k] - start) / dx));
+			end = std::max (end, i + 1);
+		}
+
+		if (k == 0) {
+			/* before the first point */
+			std::fill (vec + i, vec + end, (float) v[0]);
+			i = end;
+			continue;
+		}
+
+		const double lpos  = w[k - 1];
+		const double lval  = v[k - 1];
+		const double uval  = v[k];
+		const double range = w[k] - lpos;
+
+		if (lval == uval || _interpolation == Discrete) {
+			std::fill (vec + i, vec + end, (float) lval);
+			i = end;
+			continue;
+		}
+
+		switch (_interpolation) {
+			case Logarithmic:
+				for (int32_t j = i; j < end; ++j) {
+					vec[j] = interpolate_logarithmic (lval, uval, (start + j * dx - lpos) / range, _desc.lower, _desc.upper);
+				}
+				break;
+			case Exponential:
+				for (int32_t j = i; j < end; ++j) {
+					vec[j] = interpolate_gain (lval, uval, (start + j * dx - lpos) / range, _desc.upper);
+				}
+				break;
+			default: // Linear
+				{
+					/* y = b + j * m, no dependencies between iterations,
+					 * so this loop can be vectorized by the compiler.
+					 */
+					const double m = dx * (uval - lval) / range;
+					const double b = lval + (start - lpos) * (uval - lval) / range;
+					for (int32_t j = i; j < end; ++j) {
+						vec[j] = b + j * m;
+					}
+				}
+				break;
+		}
+
+		i = end;
+	}
+
+	return true;
+}
+
 void
 ControlList::build_search_cache_if_necessary (timepos_t const & start_time) const
 {
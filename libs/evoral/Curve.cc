@@ -364,6 +364,15 @@ Curve::_get_vector (Temporal::timepos_t const & x0, Temporal::timepos_t const &
 		return;
 	}
 
+	if (_list.interpolation() != ControlList::Curved) {
+		/* evaluate segment by segment from the contiguous copy of the list */
+		const Temporal::timepos_t l = x0.is_beats() ? Temporal::timepos_t::from_ticks (lx) : Temporal::timepos_t::from_superclock (lx);
+		const Temporal::timepos_t h = x0.is_beats() ? Temporal::timepos_t::from_ticks (hx) : Temporal::timepos_t::from_superclock (hx);
+		if (_list.unlocked_eval_vector (l, h, vec, veclen)) {
+			return;
+		}
+	}
+
 	if (_dirty) {
 		solve ();
 	}
@@ -0,0 +1,384 @@
+/*
+ * Copyright (C) 2026 The Ardour Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+
+#include "temporal/beats.h"
+
+#include "evoral/NoteStore.h"
+#include "evoral/midi_events.h"
+
+namespace Evoral {
+
+template<typename Time> const typename NoteStore<Time>::Handle NoteStore<Time>::invalid_handle;
+template<typename Time> const uint32_t NoteStore<Time>::invalid_row;
+
+template<typename Time>
+NoteStore<Time>::NoteStore ()
+{
+}
+
+template<typename Time>
+void
+NoteStore<Time>::clear ()
+{
+	_time.clear ();
+	_length.clear ();
+	_channel.clear ();
+	_note.clear ();
+	_velocity.clear ();
+	_off_velocity.clear ();
+	_id.clear ();
+	_handle.clear ();
+	_row_of.clear ();
+	_free_handles.clear ();
+
+	for (int c = 0; c < 16; ++c) {
+		for (int n = 0; n < 128; ++n) {
+			_pitches[c][n].clear ();
+		}
+	}
+}
+
+template<typename Time>
+void
+NoteStore<Time>::reserve (size_t n)
+{
+	_time.reserve (n);
+	_length.reserve (n);
+	_channel.reserve (n);
+	_note.reserve (n);
+	_velocity.reserve (n);
+	_off_velocity.reserve (n);
+	_id.reserve (n);
+	_handle.reserve (n);
+	_row_of.reserve (n);
+}
+
+template<typename Time>
+size_t
+NoteStore<Time>::lower_bound (Time t) const
+{
+	return std::lower_bound (_time.begin(), _time.end(), t) - _time.begin();
+}
+
+template<typename Time>
+size_t
+NoteStore<Time>::insert_position (Time t) const
+{
+	/* after any notes at the same time, as std::multiset::insert() does */
+
+	if (_time.empty() || !(t < _time.back())) {
+		return _time.size();
+	}
+
+	return std::upper_bound (_time.begin(), _time.end(), t) - _time.begin();
+}
+
+template<typename Time>
+typename NoteStore<Time>::Handle
+NoteStore<Time>::new_handle ()
+{
+	if (!_free_handles.empty()) {
+		Handle h = _free_handles.back ();
+		_free_handles.pop_back ();
+		return h;
+	}
+
+	_row_of.push_back (invalid_row);
+	return _row_of.size() - 1;
+}
+
+template<typename Time>
+void
+NoteStore<Time>::renumber_from (size_t row)
+{
+	for (size_t r = row; r < _handle.size(); ++r) {
+		_row_of[_handle[r]] = r;
+	}
+}
+
+/* The pitch index holds handles ordered by row. Rows only ever shift as a
+ * block, so that order survives adding and removing other notes.
+ */
+
+namespace {
+
+struct RowOrder {
+	RowOrder (std::vector<uint32_t> const & r) : row_of (r) {}
+	bool operator() (uint32_t h, uint32_t row) const { return row_of[h] < row; }
+	std::vector<uint32_t> const & row_of;
+};
+
+} // anonymous namespace
+
+template<typename Time>
+void
+NoteStore<Time>::index_pitch (Handle h)
+{
+	const uint32_t row = _row_of[h];
+	std::vector<Handle>& p (_pitches[_channel[row] & 0xf][_note[row] & 0x7f]);
+
+	if (p.empty() || _row_of[p.back()] < row) {
+		p.push_back (h);
+	} else {
+		p.insert (std::lower_bound (p.begin(), p.end(), row, RowOrder (_row_of)), h);
+	}
+}
+
+template<typename Time>
+void
+NoteStore<Time>::unindex_pitch (Handle h)
+{
+	const uint32_t row = _row_of[h];
+	std::vector<Handle>& p (_pitches[_channel[row] & 0xf][_note[row] & 0x7f]);
+	typename std::vector<Handle>::iterator i = std::lower_bound (p.begin(), p.end(), row, RowOrder (_row_of));
+
+	if (i != p.end() && *i == h) {
+		p.erase (i);
+	}
+}
+
+template<typename Time>
+void
+NoteStore<Time>::insert_row (size_t row, Handle h, Time time, Time length, uint8_t channel, uint8_t note, uint8_t velocity, uint8_t off_velocity, event_id_t id)
+{
+	if (row == _time.size()) {
+		_time.push_back (time);
+		_length.push_back (length);
+		_channel.push_back (channel);
+		_note.push_back (note);
+		_velocity.push_back (velocity);
+		_off_velocity.push_back (off_velocity);
+		_id.push_back (id);
+		_handle.push_back (h);
+		_row_of[h] = row;
+		return;
+	}
+
+	_time.insert (_time.begin() + row, time);
+	_length.insert (_length.begin() + row, length);
+	_channel.insert (_channel.begin() + row, channel);
+	_note.insert (_note.begin() + row, note);
+	_velocity.insert (_velocity.begin() + row, velocity);
+	_off_velocity.insert (_off_velocity.begin() + row, off_velocity);
+	_id.insert (_id.begin() + row, id);
+	_handle.insert (_handle.begin() + row, h);
+
+	renumber_from (row);
+}
+
+template<typename Time>
+void
+NoteStore<Time>::erase_row (size_t row)
+{
+	_row_of[_handle[row]] = invalid_row;
+
+	_time.erase (_time.begin() + row);
+	_length.erase (_length.begin() + row);
+	_channel.erase (_channel.begin() + row);
+	_note.erase (_note.begin() + row);
+	_velocity.erase (_velocity.begin() + row);
+	_off_velocity.erase (_off_velocity.begin() + row);
+	_id.erase (_id.begin() + row);
+	_handle.erase (_handle.begin() + row);
+
+	renumber_from (row);
+}
+
+/** Move the note in row @param from to row @param to, shifting the rows
+ *  in between by one. Only those rows are renumbered.
+ */
+template<typename Time>
+void
+NoteStore<Time>::move_row (size_t from, size_t to)
+{
+	size_t first;
+	size_t middle;
+	size_t last;
+
+	if (from < to) {
+		first  = from;
+		middle = from + 1;
+		last   = to + 1;
+	} else {
+		first  = to;
+		middle = from;
+		last   = from + 1;
+	}
+
+	std::rotate (_time.begin() + first, _time.begin() + middle, _time.begin() + last);
+	std::rotate (_length.begin() + first, _length.begin() + middle, _length.begin() + last);
+	std::rotate (_channel.begin() + first, _channel.begin() + middle, _channel.begin() + last);
+	std::rotate (_note.begin() + first, _note.begin() + middle, _note.begin() + last);
+	std::rotate (_velocity.begin() + first, _velocity.begin() + middle, _velocity.begin() + last);
+	std::rotate (_off_velocity.begin() + first, _off_velocity.begin() + middle, _off_velocity.begin() + last);
+	std::rotate (_id.begin() + first, _id.begin() + middle, _id.begin() + last);
+	std::rotate (_handle.begin() + first, _handle.begin() + middle, _handle.begin() + last);
+
+	for (size_t r = first; r < last; ++r) {
+		_row_of[_handle[r]] = r;
+	}
+}
+
+template<typename Time>
+typename NoteStore<Time>::Handle
+NoteStore<Time>::add (Time time, Time length, uint8_t channel, uint8_t note, uint8_t velocity, uint8_t off_velocity, event_id_t id)
+{
+	if (id < 0) {
+		id = next_event_id ();
+	}
+
+	const Handle h = new_handle ();
+
+	insert_row (insert_position (time), h, time, length, channel & 0xf, note & 0x7f, velocity, off_velocity, id);
+	index_pitch (h);
+
+	return h;
+}
+
+template<typename Time>
+void
+NoteStore<Time>::remove (Handle h)
+{
+	if (!valid (h)) {
+		return;
+	}
+
+	unindex_pitch (h);
+	erase_row (_row_of[h]);
+	_free_handles.push_back (h);
+}
+
+template<typename Time>
+void
+NoteStore<Time>::set_time (Handle h, Time t)
+{
+	const size_t row = _row_of[h];
+
+	if (_time[row] == t) {
+		return;
+	}
+
+	/* Where the note goes once it is out of the way. Notes move by small
+	 * amounts most of the time, so only move the rows in between (and
+	 * keep the handle and ID).
+	 */
+
+	size_t to = insert_position (t);
+
+	if (to > row) {
+		--to;
+	}
+
+	unindex_pitch (h);
+	if (to != row) {
+		move_row (row, to);
+	}
+	_time[to] = t;
+	index_pitch (h);
+}
+
+template<typename Time>
+void
+NoteStore<Time>::set_note (Handle h, uint8_t note)
+{
+	unindex_pitch (h);
+	_note[_row_of[h]] = note & 0x7f;
+	index_pitch (h);
+}
+
+template<typename Time>
+typename NoteStore<Time>::NotePtr
+NoteStore<Time>::note_ptr (size_t row) const
+{
+	NotePtr n (new Note<Time> (_channel[row], _time[row], _length[row], _note[row], _velocity[row]));
+	n->set_off_velocity (_off_velocity[row]);
+	n->set_id (_id[row]);
+	return n;
+}
+
+/* ITERATOR */
+
+template<typename Time>
+NoteStore<Time>::const_iterator::const_iterator (NoteStore<Time> const & store, Time t)
+	: _store (&store)
+	, _next_on (store.lower_bound (t))
+	, _row (0)
+	, _note_on (false)
+	, _is_end (false)
+{
+	choose_next ();
+}
+
+template<typename Time>
+void
+NoteStore<Time>::const_iterator::choose_next ()
+{
+	const bool have_on = _next_on < _store->size();
+
+	/* prefer a note-off if it is not later than the next note-on */
+
+	if (!_active.empty() && (!have_on || !(_store->time (_next_on) < _active.front().end))) {
+		_time = _active.front().end;
+		_row = _active.front().row;
+		_note_on = false;
+		std::pop_heap (_active.begin(), _active.end());
+		_active.pop_back ();
+		return;
+	}
+
+	if (have_on) {
+		_row = _next_on++;
+		_time = _store->time (_row);
+		_note_on = true;
+		_active.push_back (Active (_store->end_time (_row), _row));
+		std::push_heap (_active.begin(), _active.end());
+		return;
+	}
+
+	_is_end = true;
+}
+
+template<typename Time>
+typename NoteStore<Time>::const_iterator&
+NoteStore<Time>::const_iterator::operator++ ()
+{
+	if (!_is_end) {
+		choose_next ();
+	}
+	return *this;
+}
+
+template<typename Time>
+void
+NoteStore<Time>::const_iterator::get_midi (uint8_t* buf) const
+{
+	if (_note_on) {
+		buf[0] = MIDI_CMD_NOTE_ON | _store->channel (_row);
+		buf[2] = _store->velocity (_row);
+	} else {
+		buf[0] = MIDI_CMD_NOTE_OFF | _store->channel (_row);
+		buf[2] = _store->off_velocity (_row);
+	}
+	buf[1] = _store->note (_row);
+}
+
+template class NoteStore<Temporal::Beats>;
+
+} // namespace Evoral
@@ -87,7 +87,7 @@ Sequence<Time>::const_iterator::const_iterator(const Sequence<Time>&
 	, _active_patch_change_message (0)
 	, _type(NIL)
 	, _is_end((t == std::numeric_limits<Time>::max()) || seq.empty())
-	, _note_iter(seq.notes().end())
+	, _note_iter(seq._notes.end())
 	, _sysex_iter(seq.sysexes().end())
 	, _patch_change_iter(seq.patch_changes().end())
 	, _control_iter(_control_iters.end())
@@ -101,18 +101,29 @@ Sequence<Time>::const_iterator::const_iterator(const Sequence<Time>&
 
 	_lock = seq.read_lock();
 
-	// Add currently active notes, if given
-	if (active_notes) {
-		for (typename std::set<WeakNotePtr>::const_iterator i = active_notes->begin(); i != active_notes->end(); ++i) {
-			NotePtr note = i->lock();
-			if (note && note->time() <= t && note->end_time() > t) {
-				_active_notes.push(note);
+	if (seq.notes_in_store ()) {
+		/* may have been expanded since, in which case this stays empty */
+		Glib::Threads::Mutex::Lock lm (seq._note_store_lock);
+		_note_store = seq._note_store;
+	}
+
+	if (_note_store) {
+		// Find first note which begins at or after t
+		_store_iter = _note_store->begin (t);
+	} else {
+		// Add currently active notes, if given
+		if (active_notes) {
+			for (typename std::set<WeakNotePtr>::const_iterator i = active_notes->begin(); i != active_notes->end(); ++i) {
+				NotePtr note = i->lock();
+				if (note && note->time() <= t && note->end_time() > t) {
+					_active_notes.push(note);
+				}
 			}
 		}
-	}
 
-	// Find first note which begins at or after t
-	_note_iter = seq.note_lower_bound(t);
+		// Find first note which begins at or after t
+		_note_iter = seq.note_lower_bound(t);
+	}
 	// Find first sysex event at or after t
 	for (typename Sequence<Time>::SysExes::const_iterator i = seq.sysexes().begin();
 	     i != seq.sysexes().end(); ++i) {
@@ -216,6 +227,7 @@ template<typename Time>
 void
 Sequence<Time>::const_iterator::get_active_notes (std::set<WeakNotePtr>& active_notes) const
 {
+	/* notes in a NoteStore have no NotePtr to hand out */
 	/* can't iterate over a std::priority_queue<> such as ActiveNotes */
 	ActiveNotes copy (_active_notes);
 	while (!copy.empty()) {
@@ -233,8 +245,10 @@ Sequence<Time>::const_iterator::invalidate(bool preserve_active_notes)
 	}
 	_type = NIL;
 	_is_end = true;
+	_store_iter = typename NoteStore<Time>::const_iterator ();
+	_note_store.reset ();
 	if (_seq) {
-		_note_iter = _seq->notes().end();
+		_note_iter = _seq->_notes.end();
 		_sysex_iter = _seq->sysexes().end();
 		_patch_change_iter = _seq->patch_changes().end();
 		_active_patch_change_message = 0;
@@ -251,7 +265,13 @@ Sequence<Time>::const_iterator::choose_next(Time earliest_t)
 	_type = NIL;
 
 	// Next earliest note on, if any
-	if (_note_iter != _seq->notes().end()) {
+	if (_note_store) {
+		/* the store iterator yields note-ons and offs in order */
+		if (_store_iter.valid() && _store_iter.note_on()) {
+			_type      = NOTE_ON;
+			earliest_t = _store_iter.time();
+		}
+	} else if (_note_iter != _seq->_notes.end()) {
 		_type      = NOTE_ON;
 		earliest_t = (*_note_iter)->time();
 	}
@@ -276,7 +296,14 @@ Sequence<Time>::const_iterator::choose_next(Time earliest_t)
 	}
 
 	/* .. but prefer to send any Note-off first */
-	if ((!_active_notes.empty())) {
+	if (_note_store) {
+		if (_store_iter.valid() && !_store_iter.note_on()) {
+			if (_type == NIL || _store_iter.time() <= earliest_t) {
+				_type      = NOTE_OFF;
+				earliest_t = _store_iter.time();
+			}
+		}
+	} else if ((!_active_notes.empty())) {
 		if (_type == NIL || _active_notes.top()->end_time() <= earliest_t) {
 			_type      = NOTE_OFF;
 			earliest_t = _active_notes.top()->end_time();
@@ -301,11 +328,19 @@ Sequence<Time>::const_iterator::set_event()
 	switch (_type) {
 	case NOTE_ON:
 		DEBUG_TRACE(DEBUG::Sequence, "iterator = note on\n");
+		if (_note_store) {
+			set_store_event ();
+			break;
+		}
 		_event->assign ((*_note_iter)->on_event());
 		_active_notes.push(*_note_iter);
 		break;
 	case NOTE_OFF:
 		DEBUG_TRACE(DEBUG::Sequence, "iterator = note off\n");
+		if (_note_store) {
+			set_store_event ();
+			break;
+		}
 		assert(!_active_notes.empty());
 		_event->assign (_active_notes.top()->off_event());
 		// We don't pop the active note until we increment past it
@@ -336,6 +371,21 @@ Sequence<Time>::const_iterator::set_event()
 	}
 }
 
+/** Set the event from the current position of the NoteStore iterator,
+ *  the same way as the on/off events of a Note would be.
+ */
+template<typename Time>
+void
+Sequence<Time>::const_iterator::set_store_event()
+{
+	uint8_t buf[3];
+	_store_iter.get_midi (buf);
+
+	_event->set (buf, 3, _store_iter.time());
+	_event->set_event_type (MIDI_EVENT);
+	_event->set_id (_note_store->id (_store_iter.row()));
+}
+
 template<typename Time>
 const typename Sequence<Time>::const_iterator&
 Sequence<Time>::const_iterator::operator++()
@@ -366,10 +416,18 @@ Sequence<Time>::const_iterator::operator++()
 	// Increment past current event
 	switch (_type) {
 	case NOTE_ON:
-		++_note_iter;
+		if (_note_store) {
+			++_store_iter;
+		} else {
+			++_note_iter;
+		}
 		break;
 	case NOTE_OFF:
-		_active_notes.pop();
+		if (_note_store) {
+			++_store_iter;
+		} else {
+			_active_notes.pop();
+		}
 		break;
 	case CONTROL:
 		// Increment current controller iterator
@@ -448,6 +506,8 @@ Sequence<Time>::const_iterator::operator=(const const_iterator& other)
 	_type          = other._type;
 	_is_end        = other._is_end;
 	_note_iter     = other._note_iter;
+	_note_store    = other._note_store;
+	_store_iter    = other._store_iter;
 	_sysex_iter    = other._sysex_iter;
 	_patch_change_iter = other._patch_change_iter;
 	_control_iters = other._control_iters;
@@ -479,6 +539,8 @@ Sequence<Time>::Sequence(const TypeMap& type_map)
 	, _overlap_pitch_resolution (FirstOnFirstOff)
 	, _writing(false)
 	, _type_map(type_map)
+	, _compact_notes(false)
+	, _notes_in_store(0)
 	, _end_iter(*this, std::numeric_limits<Time>::max(), false, std::set<Evoral::Parameter> ())
 	, _percussive(false)
 	, _lowest_note(127)
@@ -501,11 +563,21 @@ Sequence<Time>::Sequence(const Sequence<Time>& other)
 	, _overlap_pitch_resolution (other._overlap_pitch_resolution)
 	, _writing(false)
 	, _type_map(other._type_map)
+	, _compact_notes(other._compact_notes)
+	, _notes_in_store(0)
 	, _end_iter(*this, std::numeric_limits<Time>::max(), false, std::set<Evoral::Parameter> ())
 	, _percussive(other._percussive)
 	, _lowest_note(other._lowest_note)
 	, _highest_note(other._highest_note)
 {
+	if (other.notes_in_store ()) {
+		Glib::Threads::Mutex::Lock lm (other._note_store_lock);
+		if (other._note_store) {
+			_note_store.reset (new NoteStore<Time> (*other._note_store));
+			g_atomic_int_set (&_notes_in_store, 1);
+		}
+	}
+
 	for (typename Notes::const_iterator i = other._notes.begin(); i != other._notes.end(); ++i) {
 		NotePtr n (new Note<Time> (**i));
 		_notes.insert (n);
@@ -618,6 +690,80 @@ Sequence<Time>::control_to_midi_event(
 	return true;
 }
 
+template<typename Time>
+size_t
+Sequence<Time>::n_notes () const
+{
+	if (notes_in_store ()) {
+		Glib::Threads::Mutex::Lock lm (_note_store_lock);
+		if (_note_store) {
+			return _note_store->size ();
+		}
+	}
+	return _notes.size ();
+}
+
+/** Convert notes held in the NoteStore to Note objects.
+ *
+ * Called (via expand_notes()) by everything that needs NotePtrs. This can
+ * happen with only a read-lock held, so the store itself is left alone:
+ * iterators that still use it keep a reference.
+ */
+template<typename Time>
+void
+Sequence<Time>::expand_note_store ()
+{
+	Glib::Threads::Mutex::Lock lm (_note_store_lock);
+
+	if (!_note_store) {
+		/* another thread got here first */
+		return;
+	}
+
+	NoteStore<Time> const & store (*_note_store);
+	std::vector<NotePtr>    by_row;
+
+	DEBUG_TRACE (DEBUG::Sequence, string_compose ("%1 : expand %2 notes\n", this, store.size()));
+
+	if (_writing) {
+		by_row.reserve (store.size());
+	}
+
+	for (size_t row = 0; row < store.size(); ++row) {
+		NotePtr n (store.note_ptr (row));
+		/* rows are in time order, keep notes at the same time in order */
+		_notes.insert (_notes.end(), n);
+		_pitches[n->channel()].insert (n);
+		if (_writing) {
+			by_row.push_back (n);
+		}
+	}
+
+	for (int c = 0; c < 16; ++c) {
+		for (typename std::vector<StoreHandle>::const_iterator h = _write_handles[c].begin(); h != _write_handles[c].end(); ++h) {
+			_write_notes[c].insert (by_row[store.row (*h)]);
+		}
+		_write_handles[c].clear ();
+	}
+
+	g_atomic_int_set (&_notes_in_store, 0);
+	_note_store.reset ();
+}
+
+template<typename Time>
+void
+Sequence<Time>::drop_note_store ()
+{
+	Glib::Threads::Mutex::Lock lm (_note_store_lock);
+
+	g_atomic_int_set (&_notes_in_store, 0);
+	_note_store.reset ();
+
+	for (int c = 0; c < 16; ++c) {
+		_write_handles[c].clear ();
+	}
+}
+
 /** Clear all events from the model.
  */
 template<typename Time>
@@ -625,6 +771,7 @@ void
 Sequence<Time>::clear()
 {
 	WriteLock lock(write_lock());
+	drop_note_store ();
 	_notes.clear();
 	for (Controls::iterator li = _controls.begin(); li != _controls.end(); ++li)
 		li->second->list()->clear();
@@ -646,6 +793,7 @@ Sequence<Time>::start_write()
 	_writing = true;
 	for (int i = 0; i < 16; ++i) {
 		_write_notes[i].clear();
+		_write_handles[i].clear();
 	}
 }
 
@@ -665,7 +813,11 @@ Sequence<Time>::end_write (StuckNoteOption option, Time when)
 		return;
 	}
 
-	DEBUG_TRACE (DEBUG::Sequence, string_compose ("%1 : end_write (%2 notes) delete stuck option %3 @ %4\n", this, _notes.size(), option, when));
+	DEBUG_TRACE (DEBUG::Sequence, string_compose ("%1 : end_write (%2 notes) delete stuck option %3 @ %4\n", this, n_notes(), option, when));
+
+	if (notes_in_store ()) {
+		resolve_stuck_notes_in_store (option, when);
+	}
 
 	for (typename Notes::iterator n = _notes.begin(); n != _notes.end() ;) {
 		typename Notes::iterator next = n;
@@ -697,11 +849,46 @@ Sequence<Time>::end_write (StuckNoteOption option, Time when)
 
 	for (int i = 0; i < 16; ++i) {
 		_write_notes[i].clear();
+		_write_handles[i].clear();
 	}
 
 	_writing = false;
 }
 
+template<typename Time>
+void
+Sequence<Time>::resolve_stuck_notes_in_store (StuckNoteOption option, Time when)
+{
+	NoteStore<Time>& store (*_note_store);
+
+	/* the notes still in _write_handles never saw a note-off */
+
+	for (int c = 0; c < 16; ++c) {
+		for (typename std::vector<StoreHandle>::const_iterator h = _write_handles[c].begin(); h != _write_handles[c].end(); ++h) {
+			const size_t row = store.row (*h);
+
+			switch (option) {
+			case Relax:
+				break;
+			case DeleteStuckNotes:
+				cerr << "WARNING: Stuck note lost (end was " << when << "): " << *store.note_ptr (row) << endl;
+				store.remove (*h);
+				break;
+			case ResolveStuckNotes:
+				if (when <= store.time (row)) {
+					cerr << "WARNING: Stuck note resolution - end time @ "
+					     << when << " is before note on: " << *store.note_ptr (row) << endl;
+					store.remove (*h);
+				} else {
+					store.set_length (*h, when - store.time (row));
+					cerr << "WARNING: resolved note-on with no note-off to generate " << *store.note_ptr (row) << endl;
+				}
+				break;
+			}
+		}
+	}
+}
+
 
 template<typename Time>
 bool
@@ -712,6 +899,8 @@ Sequence<Time>::add_note_unlocked(const NotePtr note, void* arg)
 
 	DEBUG_TRACE (DEBUG::Sequence, string_compose ("%1 add note %2 @ %3 dur %4\n", this, (int)note->note(), note->time(), note->length()));
 
+	expand_notes ();
+
 	if (resolve_overlaps_unlocked (note, arg)) {
 		DEBUG_TRACE (DEBUG::Sequence, string_compose ("%1 DISALLOWED: note %2 @ %3\n", this, (int)note->note(), note->time()));
 		return false;
@@ -743,6 +932,8 @@ Sequence<Time>::remove_note_unlocked(const constNotePtr note)
 
 	DEBUG_TRACE (DEBUG::Sequence, string_compose ("%1 remove note #%2 %3 @ %4\n", this, note->id(), (int)note->note(), note->time()));
 
+	expand_notes ();
+
 	/* first try searching for the note using the time index, which is
 	 * faster since the container is "indexed" by time. (technically, this
 	 * means that lower_bound() can do a binary search rather than linear)
@@ -919,7 +1110,7 @@ Sequence<Time>::append(const Event<Time>& ev, event_id_t evid)
 {
 	WriteLock lock(write_lock());
 
-	assert(_notes.empty() || ev.time() >= (*_notes.rbegin())->time());
+	assert(notes_in_store() || _notes.empty() || ev.time() >= (*_notes.rbegin())->time());
 	assert(_writing);
 
 	if (!midi_event_is_valid(ev.buffer(), ev.size())) {
@@ -1004,6 +1195,17 @@ Sequence<Time>::append_note_on_unlocked (const Event<Time>& ev, event_id_t evid)
 		return;
 	}
 
+	if (_compact_notes && !notes_in_store () && _notes.empty ()) {
+		Glib::Threads::Mutex::Lock lm (_note_store_lock);
+		_note_store.reset (new NoteStore<Time>);
+		g_atomic_int_set (&_notes_in_store, 1);
+	}
+
+	if (notes_in_store ()) {
+		append_note_on_to_store (ev, evid);
+		return;
+	}
+
 	/* nascent (incoming notes without a note-off ...yet) have a duration
 	   that extends to Beats::max()
 	*/
@@ -1038,6 +1240,11 @@ Sequence<Time>::append_note_off_unlocked (const Event<Time>& ev)
 
 	_edited = true;
 
+	if (notes_in_store ()) {
+		append_note_off_to_store (ev);
+		return;
+	}
+
 	bool resolved = false;
 
 	/* _write_notes is sorted earliest-latest, so this will find the first matching note (FIFO) that
@@ -1075,6 +1282,49 @@ Sequence<Time>::append_note_off_unlocked (const Event<Time>& ev)
 	}
 }
 
+template<typename Time>
+void
+Sequence<Time>::append_note_on_to_store (const Event<Time>& ev, event_id_t evid)
+{
+	if (ev.note() < _lowest_note)
+		_lowest_note = ev.note();
+	if (ev.note() > _highest_note)
+		_highest_note = ev.note();
+
+	/* as above, the note lasts until its note-off arrives */
+	const StoreHandle h = _note_store->add (ev.time(), std::numeric_limits<Temporal::Beats>::max() - ev.time(),
+	                                        ev.channel(), ev.note(), ev.velocity(), 0x40, evid);
+
+	_write_handles[ev.channel()].push_back (h);
+	_edited = true;
+}
+
+template<typename Time>
+void
+Sequence<Time>::append_note_off_to_store (const Event<Time>& ev)
+{
+	/* _write_handles are in time order, resolve FIFO as above */
+
+	std::vector<StoreHandle>& open (_write_handles[ev.channel()]);
+
+	for (typename std::vector<StoreHandle>::iterator h = open.begin(); h != open.end(); ++h) {
+		const size_t row = _note_store->row (*h);
+
+		if (_note_store->note (row) == ev.note()) {
+			assert(ev.time() >= _note_store->time (row));
+
+			_note_store->set_length (*h, ev.time() - _note_store->time (row));
+			_note_store->set_off_velocity (*h, ev.velocity());
+
+			open.erase (h);
+			return;
+		}
+	}
+
+	cerr << this << " spurious note off chan " << (int)ev.channel()
+	     << ", note " << (int)ev.note() << " @ " << ev.time() << endl;
+}
+
 template<typename Time>
 void
 Sequence<Time>::append_control_unlocked(const Parameter& param, Time time, double value, event_id_t /* evid */)
@@ -1206,6 +1456,7 @@ template<typename Time>
 void
 Sequence<Time>::set_notes (const typename Sequence<Time>::Notes& n)
 {
+	drop_note_store ();
 	_notes = n;
 }
 
@@ -1216,6 +1467,7 @@ template<typename Time>
 typename Sequence<Time>::Notes::const_iterator
 Sequence<Time>::note_lower_bound (Time t) const
 {
+	expand_notes ();
 	NotePtr search_note(new Note<Time>(0, t, Time(), 0, 0));
 	typename Sequence<Time>::Notes::const_iterator i = _notes.lower_bound(search_note);
 	assert(i == _notes.end() || (*i)->time() >= t);
@@ -1251,6 +1503,7 @@ template<typename Time>
 typename Sequence<Time>::Notes::iterator
 Sequence<Time>::note_lower_bound (Time t)
 {
+	expand_notes ();
 	NotePtr search_note(new Note<Time>(0, t, Time(), 0, 0));
 	typename Sequence<Time>::Notes::iterator i = _notes.lower_bound(search_note);
 	assert(i == _notes.end() || (*i)->time() >= t);
@@ -1360,6 +1613,8 @@ Sequence<Time>::get_notes_by_velocity (Notes& n, NoteOperator op, uint8_t val, i
 {
 	ReadLock lock (read_lock());
 
+	expand_notes ();
+
 	for (typename Notes::const_iterator i = _notes.begin(); i != _notes.end(); ++i) {
 
 		if (chan_mask != 0 && !((1<<((*i)->channel())) & chan_mask)) {
@@ -25,6 +25,7 @@
 
 #include <cassert>
 #include <list>
+#include <vector>
 #include <stdint.h>
 
 #include <boost/pool/pool.hpp>
@@ -32,7 +33,9 @@
 
 #include <glibmm/threads.h>
 
+#include "pbd/g_atomic_compat.h"
 #include "pbd/signals.h"
+#include "pbd/spinlock.h"
 
 #include "temporal/timeline.h"
 #include "temporal/types.h"
@@ -307,6 +310,16 @@ public:
 	 */
 	double unlocked_eval (Temporal::timepos_t const & x) const;
 
+	/** Evaluate the list at \p veclen equally spaced positions from \p x0
+	 * to \p x1 (inclusive) using the contiguous copy of the event list.
+	 * Must be called with the read-lock held.
+	 *
+	 * @return false if no contiguous copy is available (the list is
+	 * frozen, another thread is rebuilding it, or \p x0 uses a different
+	 * time-domain), in which case \p vec is not modified.
+	 */
+	bool unlocked_eval_vector (Temporal::timepos_t const & x0, Temporal::timepos_t const & x1, float* vec, int32_t veclen) const;
+
 	bool rt_safe_earliest_event_discrete_unlocked (Temporal::timepos_t const & start, Temporal::timepos_t & x, double& y, bool inclusive) const;
 	bool rt_safe_earliest_event_linear_unlocked (Temporal::timepos_t const & start, Temporal::timepos_t & x, double& y, bool inclusive, Temporal::timecnt_t min_x_delta = Temporal::timecnt_t ()) const;
 
@@ -369,6 +382,31 @@ public:
 	/** Called by unlocked_eval() to handle cases of 3 or more control points. */
 	double multipoint_eval (Temporal::timepos_t const & x) const;
 
+	/** Contiguous copy of the event list: parallel arrays of time and value.
+	 * Evaluation uses this for binary search instead of walking _events.
+	 * mark_dirty() invalidates it and reserves space, the copy is rebuilt
+	 * by the first read after that.
+	 */
+	struct FlatEvents {
+		enum State {
+			Dirty = 0,
+			Valid,
+			Unavailable ///< events are unsorted or use mixed time-domains
+		};
+
+		FlatEvents () : state (Dirty), time_domain (Temporal::AudioTime) {}
+
+		std::vector<int64_t> when; ///< timepos_t::val() of each event
+		std::vector<double>  value;
+		GATOMIC_QUAL gint    state;
+		Temporal::TimeDomain time_domain;
+		PBD::spinlock_t      lock; ///< held while rebuilding
+	};
+
+	bool   unlocked_ensure_flat () const;
+	int    unlocked_update_flat () const;
+	double flat_eval (int64_t x) const;
+
 	void build_search_cache_if_necessary (Temporal::timepos_t const & start) const;
 
 	boost::shared_ptr<ControlList> cut_copy_clear (Temporal::timepos_t const &, Temporal::timepos_t const &, int op);
@@ -386,6 +424,7 @@ public:
 
 	mutable LookupCache   _lookup_cache;
 	mutable SearchCache   _search_cache;
+	mutable FlatEvents    _flat;
 
 	mutable Glib::Threads::RWLock _lock;
 
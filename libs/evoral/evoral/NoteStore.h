@@ -0,0 +1,200 @@
+/*
+ * Copyright (C) 2026 The Ardour Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef EVORAL_NOTE_STORE_HPP
+#define EVORAL_NOTE_STORE_HPP
+
+#include <stdint.h>
+
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+
+#include "evoral/visibility.h"
+#include "evoral/Note.h"
+#include "evoral/types.h"
+
+namespace Evoral {
+
+/** Columnar storage for a large number of notes.
+ *
+ * Sequence keeps every note as its own heap-allocated, reference counted
+ * Note (two Events, each with a separately allocated buffer) in two
+ * multisets. That is convenient for editing, but costs a few hundred bytes
+ * per note and a pointer chase for every step of an iteration.
+ *
+ * NoteStore keeps the same information in parallel arrays, sorted by note
+ * start time, with notes at the same time in the order they were added (as
+ * in a multiset). Notes are identified by a Handle that remains valid until
+ * the note is removed, no matter how many other notes are added, moved or
+ * removed. A secondary index lists the notes of each channel+pitch in time
+ * order.
+ *
+ * Appending notes in time order (as when loading a file) is O(1). Adding or
+ * removing a note elsewhere is O(n), but n here means moving contiguous
+ * memory rather than walking a tree. Moving a note in time only shifts the
+ * notes between its old and new position.
+ *
+ * Sequence uses a NoteStore instead of its note sets when compact notes
+ * are enabled (see Sequence::set_compact_notes()).
+ *
+ * This is not thread safe; callers are expected to use the same locking as
+ * they would for a Sequence.
+ */
+template<typename Time>
+class LIBEVORAL_API NoteStore {
+public:
+	typedef uint32_t Handle;
+	typedef boost::shared_ptr<Note<Time> > NotePtr;
+
+	static const Handle invalid_handle = ~((Handle) 0);
+
+	NoteStore ();
+
+	size_t size ()  const { return _time.size(); }
+	bool   empty () const { return _time.empty(); }
+
+	void clear ();
+	void reserve (size_t);
+
+	/** Add a note. If @param id is negative, a new event ID is allocated
+	 *  (as Sequence does).
+	 */
+	Handle add (Time time, Time length, uint8_t channel, uint8_t note, uint8_t velocity, uint8_t off_velocity = 0x40, event_id_t id = -1);
+	Handle add (Note<Time> const & n) {
+		return add (n.time(), n.length(), n.channel(), n.note(), n.velocity(), n.off_velocity(), n.id());
+	}
+
+	/** Add all notes from a container of NotePtr (e.g. Sequence::Notes) */
+	template<typename Container> void import (Container const & notes) {
+		reserve (size() + notes.size());
+		for (typename Container::const_iterator n = notes.begin(); n != notes.end(); ++n) {
+			add (**n);
+		}
+	}
+
+	void remove (Handle);
+
+	bool valid (Handle h) const { return h < _row_of.size() && _row_of[h] != invalid_row; }
+
+	void set_time (Handle, Time);
+	void set_length (Handle h, Time l)         { _length[_row_of[h]] = l; }
+	void set_note (Handle, uint8_t);
+	void set_velocity (Handle h, uint8_t v)     { _velocity[_row_of[h]] = v; }
+	void set_off_velocity (Handle h, uint8_t v) { _off_velocity[_row_of[h]] = v; }
+
+	/* Per-row access. Rows are in time order and change whenever notes
+	 * are added, moved or removed; handles do not.
+	 */
+
+	size_t row (Handle h) const      { return _row_of[h]; }
+	Handle handle (size_t row) const { return _handle[row]; }
+
+	Time       time (size_t row)         const { return _time[row]; }
+	Time       length (size_t row)       const { return _length[row]; }
+	Time       end_time (size_t row)     const { return _time[row] + _length[row]; }
+	uint8_t    channel (size_t row)      const { return _channel[row]; }
+	uint8_t    note (size_t row)         const { return _note[row]; }
+	uint8_t    velocity (size_t row)     const { return _velocity[row]; }
+	uint8_t    off_velocity (size_t row) const { return _off_velocity[row]; }
+	event_id_t id (size_t row)           const { return _id[row]; }
+
+	/** @return the first row whose time is not earlier than @param t */
+	size_t lower_bound (Time t) const;
+
+	/** @return handles of all notes on @param chan with pitch @param note, in time order */
+	std::vector<Handle> const & pitch_index (uint8_t chan, uint8_t note) const {
+		return _pitches[chan & 0xf][note & 0x7f];
+	}
+
+	/** @return a (new) Note with the same properties as the note in @param row */
+	NotePtr note_ptr (size_t row) const;
+
+	/** Note-on and note-off events in time order, as Sequence::const_iterator
+	 *  delivers them (a note-off precedes a simultaneous note-on).
+	 *  Modifying the store invalidates the iterator.
+	 */
+	class LIBEVORAL_API const_iterator {
+	public:
+		const_iterator () : _store (0), _next_on (0), _row (0), _note_on (false), _is_end (true) {}
+		const_iterator (NoteStore<Time> const &, Time t);
+
+		bool valid () const { return !_is_end; }
+
+		Time   time ()    const { return _time; }
+		size_t row ()     const { return _row; }
+		bool   note_on () const { return _note_on; }
+
+		/** write the 3 byte MIDI message for the current event to @param buf */
+		void get_midi (uint8_t* buf) const;
+
+		const_iterator& operator++ ();
+
+	private:
+		struct Active {
+			Active (Time t, size_t r) : end (t), row (r) {}
+			Time   end;
+			size_t row;
+			bool operator< (Active const & other) const { return other.end < end; } /* min-heap */
+		};
+
+		void choose_next ();
+
+		NoteStore<Time> const * _store;
+		size_t                  _next_on;
+		std::vector<Active>     _active;
+		Time                    _time;
+		size_t                  _row;
+		bool                    _note_on;
+		bool                    _is_end;
+	};
+
+	const_iterator begin (Time t = Time()) const { return const_iterator (*this, t); }
+
+private:
+	static const uint32_t invalid_row = ~((uint32_t) 0);
+
+	Handle new_handle ();
+	void   insert_row (size_t row, Handle, Time time, Time length, uint8_t channel, uint8_t note, uint8_t velocity, uint8_t off_velocity, event_id_t id);
+	void   erase_row (size_t row);
+	void   move_row (size_t from, size_t to);
+	size_t insert_position (Time t) const;
+	void   renumber_from (size_t row);
+	void   index_pitch (Handle);
+	void   unindex_pitch (Handle);
+
+	/* the columns, all with one entry per note */
+	std::vector<Time>       _time;
+	std::vector<Time>       _length;
+	std::vector<uint8_t>    _channel;
+	std::vector<uint8_t>    _note;
+	std::vector<uint8_t>    _velocity;
+	std::vector<uint8_t>    _off_velocity;
+	std::vector<event_id_t> _id;
+	std::vector<Handle>     _handle;
+
+	/* row of each handle, or invalid_row if the handle is unused */
+	std::vector<uint32_t>   _row_of;
+	std::vector<Handle>     _free_handles;
+
+	std::vector<Handle>     _pitches[16][128];
+};
+
+} // namespace Evoral
+
+#endif // EVORAL_NOTE_STORE_HPP
@@ -31,8 +31,11 @@
 #include <boost/shared_ptr.hpp>
 #include <glibmm/threads.h>
 
+#include "pbd/g_atomic_compat.h"
+
 #include "evoral/visibility.h"
 #include "evoral/Note.h"
+#include "evoral/NoteStore.h"
 #include "evoral/ControlSet.h"
 #include "evoral/ControlList.h"
 #include "evoral/PatchChange.h"
@@ -115,8 +118,22 @@ public:
 
 	const TypeMap& type_map() const { return _type_map; }
 
-	inline size_t n_notes() const { return _notes.size(); }
-	inline bool   empty()   const { return _notes.empty() && _sysexes.empty() && _patch_changes.empty() && ControlSet::controls_empty(); }
+	size_t      n_notes() const;
+	inline bool empty()   const { return n_notes() == 0 && _sysexes.empty() && _patch_changes.empty() && ControlSet::controls_empty(); }
+
+	/** Keep notes that are loaded via start_write()/append() in a compact
+	 * NoteStore rather than as individual Note objects.
+	 *
+	 * This only takes effect for the next write to an empty sequence. The
+	 * notes stay compact for as long as they are only read with a
+	 * const_iterator; the first call that needs NotePtrs (notes(),
+	 * pitches(), adding or removing a note, ...) converts them once.
+	 */
+	void set_compact_notes (bool yn) { _compact_notes = yn; }
+	bool compact_notes () const { return _compact_notes; }
+
+	/** @return true if the notes are currently held in a NoteStore */
+	bool notes_in_store () const { return g_atomic_int_get (&_notes_in_store) != 0; }
 
 	inline static bool note_time_comparator(const boost::shared_ptr< const Note<Time> >& a,
 	                                        const boost::shared_ptr< const Note<Time> >& b) {
@@ -156,8 +173,8 @@ public:
 	};
 
 	typedef std::multiset<NotePtr, EarlierNoteComparator> Notes;
-	inline       Notes& notes()       { return _notes; }
-	inline const Notes& notes() const { return _notes; }
+	inline       Notes& notes()       { expand_notes (); return _notes; }
+	inline const Notes& notes() const { expand_notes (); return _notes; }
 
 	enum NoteOperator {
 		PitchEqual,
@@ -251,6 +268,7 @@ public:
 
 		Time choose_next(Time earliest_t);
 		void set_event();
+		void set_store_event();
 
 		typedef std::vector<ControlIterator> ControlIterators;
 		enum MIDIMessageType { NIL, NOTE_ON, NOTE_OFF, CONTROL, SYSEX, PATCH_CHANGE };
@@ -266,6 +284,8 @@ public:
 		bool                                  _is_end;
 		typename Sequence::ReadLock           _lock;
 		typename Notes::const_iterator        _note_iter;
+		boost::shared_ptr<const NoteStore<Time> > _note_store;
+		typename NoteStore<Time>::const_iterator  _store_iter;
 		typename SysExes::const_iterator      _sysex_iter;
 		typename PatchChanges::const_iterator _patch_change_iter;
 		ControlIterators                      _control_iters;
@@ -330,8 +350,8 @@ protected:
 	}
 
 	typedef std::multiset<NotePtr, NoteNumberComparator>  Pitches;
-	inline       Pitches& pitches(uint8_t chan)       { return _pitches[chan&0xf]; }
-	inline const Pitches& pitches(uint8_t chan) const { return _pitches[chan&0xf]; }
+	inline       Pitches& pitches(uint8_t chan)       { expand_notes (); return _pitches[chan&0xf]; }
+	inline const Pitches& pitches(uint8_t chan) const { expand_notes (); return _pitches[chan&0xf]; }
 
 	virtual void control_list_marked_dirty ();
 
@@ -350,6 +370,18 @@ private:
 	void get_notes_by_pitch (Notes&, NoteOperator, uint8_t val, int chan_mask = 0) const;
 	void get_notes_by_velocity (Notes&, NoteOperator, uint8_t val, int chan_mask = 0) const;
 
+	void expand_notes () const {
+		if (notes_in_store ()) {
+			const_cast<Sequence<Time>*> (this)->expand_note_store ();
+		}
+	}
+
+	void expand_note_store ();
+	void drop_note_store ();
+	void append_note_on_to_store (const Event<Time>& event, Evoral::event_id_t);
+	void append_note_off_to_store (const Event<Time>& event);
+	void resolve_stuck_notes_in_store (StuckNoteOption, Time when);
+
 	const TypeMap& _type_map;
 
 	Notes        _notes;       // notes indexed by time
@@ -360,6 +392,18 @@ private:
 	typedef std::multiset<NotePtr, EarlierNoteComparator> WriteNotes;
 	WriteNotes _write_notes[16];
 
+	/* Compact notes. While _notes_in_store is set, _note_store holds all
+	 * notes and _notes/_pitches are empty. Iterators share the store, so
+	 * expanding it does not pull the rug from under a reader.
+	 */
+	typedef typename NoteStore<Time>::Handle StoreHandle;
+
+	bool                                _compact_notes;
+	GATOMIC_QUAL gint                   _notes_in_store;
+	mutable Glib::Threads::Mutex        _note_store_lock;
+	boost::shared_ptr<NoteStore<Time> > _note_store;
+	std::vector<StoreHandle>            _write_handles[16];
+
 	/** Current bank number on each channel so that we know what
 	 *  to put in PatchChange events when program changes are
 	 *  seen.
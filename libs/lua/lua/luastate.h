@@ -33,9 +33,13 @@ public:
 
 	int do_command (std::string);
 	int do_file (std::string);
+	/* like do_command, uses and fills a cache of the compiled chunk */
+	int do_chunk (std::string const&, std::string& bytecode);
 	void collect_garbage ();
-	void collect_garbage_step (int debt = 0);
+	/* returns true when a GC cycle was completed */
+	bool collect_garbage_step (int debt = 0);
 	void tweak_rt_gc ();
+	void stop_auto_gc ();
 	void sandbox (bool rt_safe = false);
 
 	sigc::signal<void,std::string> Print;
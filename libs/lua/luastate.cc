@@ -19,6 +19,11 @@
 #include <assert.h>
 #include "lua/luastate.h"
 
+static int bytecode_writer (lua_State *, const void* p, size_t sz, void* ud) {
+	static_cast<std::string*> (ud)->append (static_cast<const char*> (p), sz);
+	return 0;
+}
+
 // from lauxlib.c
 static int panic (lua_State *L) {
 	lua_writestringerror("PANIC: unprotected error in call to Lua API (%s)\n",
@@ -71,14 +76,35 @@ LuaState::do_file (std::string fn) {
 	return result;
 }
 
+int
+LuaState::do_chunk (std::string const& cmd, std::string& bytecode) {
+	int result;
+	if (bytecode.empty ()) {
+		result = luaL_loadstring (L, cmd.c_str());
+		if (result == 0 && lua_dump (L, &bytecode_writer, &bytecode, 0) != 0) {
+			bytecode.clear ();
+		}
+	} else {
+		/* the chunk-name is only used for errors while loading */
+		result = luaL_loadbufferx (L, bytecode.data (), bytecode.size (), cmd.c_str(), "b");
+	}
+	if (result == 0) {
+		result = lua_pcall (L, 0, LUA_MULTRET, 0);
+	}
+	if (result != 0) {
+		print ("Error: " + std::string (lua_tostring (L, -1)));
+	}
+	return result;
+}
+
 void
 LuaState::collect_garbage () {
 	lua_gc (L, LUA_GCCOLLECT, 0);
 }
 
-void
+bool
 LuaState::collect_garbage_step (int debt) {
-	lua_gc (L, LUA_GCSTEP, debt);
+	return lua_gc (L, LUA_GCSTEP, debt) == 1;
 }
 
 void
@@ -88,6 +114,12 @@ LuaState::tweak_rt_gc () {
 	lua_gc (L, LUA_GCSETSTEPMUL, 100);
 }
 
+void
+LuaState::stop_auto_gc () {
+	/* only collect when explicitly asked to (collect_garbage_step) */
+	lua_gc (L, LUA_GCSTOP, 0);
+}
+
 void
 LuaState::sandbox (bool rt_safe) {
 	do_command ("dofile = nil require = nil dofile = nil package = nil debug = nil os.exit = nil os.setlocale = nil rawget = nil rawset = nil coroutine = nil module = nil");
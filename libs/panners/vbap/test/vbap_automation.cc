@@ -0,0 +1,203 @@
+/*
+ * Copyright (C) 2026 The Ardour Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "pbd/cartesian.h"
+#include "pbd/compose.h"
+#include "pbd/microseconds.h"
+
+#include "ardour/ardour.h"
+#include "ardour/speakers.h"
+#include "ardour/types.h"
+
+#include "vbap.h"
+#include "vbap_speakers.h"
+
+using namespace std;
+using namespace PBD;
+using namespace ARDOUR;
+
+static const char* localedir = LOCALEDIR;
+
+/* Automated VBAP panning of 64 moving sources into 32 speakers,
+ * for a horizontal ring and a dome with elevated speakers.
+ *
+ * Compares the sample-accurate (sub-block interpolated) distribution
+ * with the cost of a single gain step per cycle, and the cached speaker
+ * tuple lookup with a full search.
+ */
+
+struct Source {
+	Source (pframes_t nframes, uint32_t n_speakers, uint32_t n_blocks)
+		: data (nframes)
+		, gains (n_speakers, 0.0)
+		, azi (n_blocks)
+		, ele (n_blocks)
+		, tuple (-1)
+	{
+		outputs[0] = outputs[1] = outputs[2] = -1;
+		for (pframes_t i = 0; i < nframes; ++i) {
+			data[i] = (rand () / (float)RAND_MAX) - .5f;
+		}
+	}
+
+	std::vector<Sample> data;
+	std::vector<double> gains;
+	std::vector<float>  azi;
+	std::vector<float>  ele;
+	int                 outputs[3];
+	int                 tuple;
+};
+
+/* every source circles at a different speed and height */
+static void
+move (VBAPSpeakers const& vbap, Source* src, uint32_t s, uint32_t n_sources, int c, pframes_t n_blocks, double dt)
+{
+	for (pframes_t b = 0; b < n_blocks; ++b) {
+		const double t = c * dt + (b + 1) * dt / n_blocks;
+		src->azi[b] = fmod (360.0 * t * (1 + s / (double)n_sources) + s * 17.0, 360.0);
+		src->ele[b] = vbap.dimension () == 3 ? 45.0 * (.5 + .5 * sin (t + s)) : 0.0;
+	}
+}
+
+static void
+run (std::string const& name, boost::shared_ptr<Speakers> spk, uint32_t n_sources, pframes_t nframes, int cycles)
+{
+	VBAPSpeakers     vbap (spk);
+	const uint32_t   n_speakers = vbap.n_speakers ();
+	const pframes_t  n_blocks   = (nframes + VBAPanner::automation_subblock - 1) / VBAPanner::automation_subblock;
+	const double     dt         = nframes / 48000.0;
+
+	std::vector<Source*>             sources;
+	std::vector<std::vector<Sample> > out (n_speakers, std::vector<Sample> (nframes, 0.f));
+	std::vector<Sample*>             dst;
+	std::vector<Sample>              scratch (nframes);
+
+	for (uint32_t s = 0; s < n_sources; ++s) {
+		sources.push_back (new Source (nframes, n_speakers, n_blocks));
+	}
+	for (uint32_t o = 0; o < n_speakers; ++o) {
+		dst.push_back (&out[o][0]);
+	}
+
+	microseconds_t t0 = get_microseconds ();
+	for (int c = 0; c < cycles; ++c) {
+		for (uint32_t s = 0; s < n_sources; ++s) {
+			Source* src = sources[s];
+			move (vbap, src, s, n_sources, c, n_blocks, dt);
+			VBAPanner::distribute_moving (vbap, &src->data[0], &scratch[0], &dst[0], nframes,
+			                              &src->azi[0], &src->ele[0], &src->gains[0], src->outputs, src->tuple);
+		}
+	}
+	microseconds_t t1 = get_microseconds ();
+	for (int c = 0; c < cycles; ++c) {
+		for (uint32_t s = 0; s < n_sources; ++s) {
+			Source* src = sources[s];
+			move (vbap, src, s, n_sources, c, n_blocks, dt);
+			double  g[3];
+			int     ids[3];
+			vbap.compute_gains (g, ids, src->azi[n_blocks - 1], src->ele[n_blocks - 1]);
+			for (int o = 0; o < 3; ++o) {
+				if (ids[o] >= 0) {
+					mix_buffers_with_gain (dst[ids[o]], &src->data[0], nframes, g[o]);
+				}
+			}
+		}
+	}
+	microseconds_t t2 = get_microseconds ();
+	for (int c = 0; c < cycles; ++c) {
+		for (uint32_t s = 0; s < n_sources; ++s) {
+			Source* src = sources[s];
+			move (vbap, src, s, n_sources, c, n_blocks, dt);
+			double  g[3];
+			int     ids[3];
+			for (pframes_t b = 0; b < n_blocks; ++b) {
+				src->tuple = vbap.compute_gains (g, ids, src->azi[b], src->ele[b], src->tuple);
+			}
+		}
+	}
+	microseconds_t t3 = get_microseconds ();
+	for (int c = 0; c < cycles; ++c) {
+		for (uint32_t s = 0; s < n_sources; ++s) {
+			Source* src = sources[s];
+			move (vbap, src, s, n_sources, c, n_blocks, dt);
+			double  g[3];
+			int     ids[3];
+			for (pframes_t b = 0; b < n_blocks; ++b) {
+				vbap.compute_gains (g, ids, src->azi[b], src->ele[b]);
+			}
+		}
+	}
+	microseconds_t t4 = get_microseconds ();
+
+	for (int c = 0; c < cycles; ++c) {
+		for (uint32_t s = 0; s < n_sources; ++s) {
+			move (vbap, sources[s], s, n_sources, c, n_blocks, dt);
+		}
+	}
+	microseconds_t t5 = get_microseconds ();
+
+	/* subtract the cost of computing the trajectories */
+	const double traj   = (t5 - t4) / (double)cycles;
+	const double period = 1e6 * dt;
+	const double moving = (t1 - t0) / (double)cycles - traj;
+
+	cout << string_compose ("%1: %2 sources, %3 speakers (%4 tuples), %5 samples/cycle\n",
+	                        name, n_sources, n_speakers, vbap.n_tuples (), nframes);
+	cout << string_compose ("  sample-accurate: %1 us/cycle (%2%% of a 48kHz cycle)\n", moving, 100. * moving / period);
+	cout << string_compose ("  per-cycle step:  %1 us/cycle\n", (t2 - t1) / (double)cycles - traj);
+	cout << string_compose ("  tuple lookup:    cached %1 us/cycle, full search %2 us/cycle\n",
+	                        (t3 - t2) / (double)cycles - traj, (t4 - t3) / (double)cycles - traj);
+
+	for (uint32_t s = 0; s < n_sources; ++s) {
+		delete sources[s];
+	}
+}
+
+int
+main (int argc, char* argv[])
+{
+	const int       cycles  = argc > 1 ? atoi (argv[1]) : 1000;
+	const pframes_t nframes = argc > 2 ? atoi (argv[2]) : 1024;
+
+	/* setup runtime-dispatched (SIMD) mix functions */
+	ARDOUR::init (true, localedir);
+
+	boost::shared_ptr<Speakers> ring (new Speakers);
+	for (int i = 0; i < 32; ++i) {
+		ring->add_speaker (AngularVector (i * 360.0 / 32, 0.0));
+	}
+
+	boost::shared_ptr<Speakers> dome (new Speakers);
+	for (int i = 0; i < 24; ++i) {
+		dome->add_speaker (AngularVector (i * 360.0 / 24, 0.0));
+	}
+	for (int i = 0; i < 8; ++i) {
+		dome->add_speaker (AngularVector (i * 360.0 / 8, 45.0));
+	}
+
+	run ("ring", ring, 64, nframes, cycles);
+	run ("dome", dome, 64, nframes, cycles);
+
+	ARDOUR::cleanup ();
+	return 0;
+}
@@ -34,11 +34,14 @@
 #include "pbd/cartesian.h"
 #include "pbd/compose.h"
 
+#include "evoral/Curve.h"
+
 #include "ardour/amp.h"
 #include "ardour/audio_buffer.h"
 #include "ardour/buffer_set.h"
 #include "ardour/pan_controllable.h"
 #include "ardour/pannable.h"
+#include "ardour/runtime_functions.h"
 #include "ardour/speakers.h"
 
 #include "vbap.h"
@@ -65,7 +68,10 @@ panner_descriptor ()
 	return &_descriptor;
 }
 
+const pframes_t VBAPanner::automation_subblock;
+
 VBAPanner::Signal::Signal (VBAPanner&, uint32_t, uint32_t n_speakers)
+	: tuple (-1)
 {
 	resize_gains (n_speakers);
 
@@ -136,95 +142,38 @@ VBAPanner::update ()
 	}
 
 	/* recompute signal directions based on panner azimuth and, if relevant, width (diffusion) and elevation parameters */
-	double elevation = _pannable->pan_elevation_control->get_value () * 90.0;
-
-	if (_signals.size () > 1) {
-		double w                   = -(_pannable->pan_width_control->get_value ());
-		double signal_direction    = 1.0 - (_pannable->pan_azimuth_control->get_value () + (w / 2));
-		double grd_step_per_signal = w / (_signals.size () - 1);
-		for (vector<Signal*>::iterator s = _signals.begin (); s != _signals.end (); ++s) {
-			Signal* signal = *s;
-
-			int over = signal_direction;
-			over -= (signal_direction >= 0) ? 0 : 1;
-			signal_direction -= (double)over;
-
-			signal->direction = AngularVector (signal_direction * 360.0, elevation);
-			compute_gains (signal->desired_gains, signal->desired_outputs, signal->direction.azi, signal->direction.ele);
-			signal_direction += grd_step_per_signal;
-		}
-	} else if (_signals.size () == 1) {
-		double center = (1.0 - _pannable->pan_azimuth_control->get_value ()) * 360.0;
+	double   elevation = _pannable->pan_elevation_control->get_value () * 90.0;
+	double   width     = _pannable->pan_width_control->get_value ();
+	double   azimuth   = _pannable->pan_azimuth_control->get_value ();
+	uint32_t n         = 0;
 
-		/* width has no role to play if there is only 1 signal: VBAP does not do "diffusion" of a single channel */
+	for (vector<Signal*>::iterator s = _signals.begin (); s != _signals.end (); ++s, ++n) {
+		Signal* signal = *s;
 
-		Signal* s    = _signals.front ();
-		s->direction = AngularVector (center, elevation);
-		compute_gains (s->desired_gains, s->desired_outputs, s->direction.azi, s->direction.ele);
+		signal->direction = AngularVector (signal_azimuth (azimuth, width, n), elevation);
+		_speakers->compute_gains (signal->desired_gains, signal->desired_outputs, signal->direction.azi, signal->direction.ele);
 	}
 
 	SignalPositionChanged (); /* emit */
 }
 
-void
-VBAPanner::compute_gains (double gains[3], int speaker_ids[3], int azi, int ele)
+double
+VBAPanner::signal_azimuth (double azimuth, double width, uint32_t which) const
 {
-	/* calculates gain factors using loudspeaker setup and given direction */
-	double    cartdir[3];
-	double    power;
-	int       i, j, k;
-	double    small_g;
-	double    big_sm_g, gtmp[3];
-	const int dimension = _speakers->dimension ();
-	assert (dimension == 2 || dimension == 3);
-
-	spherical_to_cartesian (azi, ele, 1.0, cartdir[0], cartdir[1], cartdir[2]);
-	big_sm_g = -100000.0;
-
-	gains[0] = gains[1] = gains[2] = 0;
-	speaker_ids[0] = speaker_ids[1] = speaker_ids[2] = 0;
-
-	for (i = 0; i < _speakers->n_tuples (); i++) {
-		small_g = 10000000.0;
+	const uint32_t n = _signals.size ();
 
-		for (j = 0; j < dimension; j++) {
-			gtmp[j] = 0.0;
-
-			for (k = 0; k < dimension; k++) {
-				gtmp[j] += cartdir[k] * _speakers->matrix (i)[j * dimension + k];
-			}
-
-			if (gtmp[j] < small_g) {
-				small_g = gtmp[j];
-			}
-		}
-
-		if (small_g > big_sm_g) {
-			big_sm_g = small_g;
-
-			gains[0] = gtmp[0];
-			gains[1] = gtmp[1];
-
-			speaker_ids[0] = _speakers->speaker_for_tuple (i, 0);
-			speaker_ids[1] = _speakers->speaker_for_tuple (i, 1);
-
-			if (_speakers->dimension () == 3) {
-				gains[2]       = gtmp[2];
-				speaker_ids[2] = _speakers->speaker_for_tuple (i, 2);
-			} else {
-				gains[2]       = 0.0;
-				speaker_ids[2] = -1;
-			}
-		}
+	if (n < 2) {
+		/* width has no role to play if there is only 1 signal: VBAP does not do "diffusion" of a single channel */
+		return (1.0 - azimuth) * 360.0;
 	}
 
-	power = sqrt (gains[0] * gains[0] + gains[1] * gains[1] + gains[2] * gains[2]);
+	/* spread the signals across the width (diffusion), centered on the azimuth */
+	double w         = -width;
+	double direction = 1.0 - (azimuth + (w / 2)) + which * (w / (n - 1));
 
-	if (power > 0) {
-		gains[0] /= power;
-		gains[1] /= power;
-		gains[2] /= power;
-	}
+	direction -= floor (direction);
+
+	return direction * 360.0;
 }
 
 void
@@ -357,11 +306,128 @@ VBAPanner::distribute_one (AudioBuffer& srcbuf, BufferSet& obufs, gain_t gain_co
 }
 
 void
-VBAPanner::distribute_one_automated (AudioBuffer& /*src*/, BufferSet& /*obufs*/,
-                                     samplepos_t /*start*/, samplepos_t /*end*/,
-                                     pframes_t /*nframes*/, pan_t** /*buffers*/, uint32_t /*which*/)
+VBAPanner::distribute_one_automated (AudioBuffer& srcbuf, BufferSet& obufs,
+                                     samplepos_t start, samplepos_t end,
+                                     pframes_t nframes, pan_t** buffers, uint32_t which)
 {
-	/* XXX to be implemented */
+	Signal*                   signal (_signals[which]);
+	vector<double>::size_type sz = signal->gains.size ();
+
+	assert (sz == obufs.count ().n_audio ());
+
+	pan_t* const position  = buffers[0];
+	pan_t* const elevation = buffers[1];
+
+	/* fetch positional data */
+
+	if (!_pannable->pan_azimuth_control->list ()->curve ().rt_safe_get_vector (timepos_t (start), timepos_t (end), position, nframes)) {
+		/* fallback */
+		distribute_one (srcbuf, obufs, 1.0, nframes, which);
+		memcpy (signal->outputs, signal->desired_outputs, sizeof (signal->outputs));
+		return;
+	}
+
+	const bool ele_automated = _speakers->dimension () == 3
+	                           && _pannable->pan_elevation_control->list ()->curve ().rt_safe_get_vector (timepos_t (start), timepos_t (end), elevation, nframes);
+
+	/* width is not interpolated within a cycle */
+	const double width = _pannable->pan_width_control->get_value ();
+	const double ele   = _pannable->pan_elevation_control->get_value ();
+
+	/* directions at the end of each sub-block, on the stack, no malloc */
+
+	const pframes_t n_blocks = (nframes + automation_subblock - 1) / automation_subblock;
+
+	float* azis = (float*)alloca (n_blocks * sizeof (float));
+	float* eles = (float*)alloca (n_blocks * sizeof (float));
+
+	for (pframes_t b = 0; b < n_blocks; ++b) {
+		const pframes_t n = min<pframes_t> ((b + 1) * automation_subblock, nframes) - 1;
+		azis[b] = signal_azimuth (position[n], width, which);
+		eles[b] = (ele_automated ? elevation[n] : ele) * 90.0;
+	}
+
+	Sample** dst = (Sample**)alloca (sz * sizeof (Sample*));
+
+	for (uint32_t o = 0; o < sz; ++o) {
+		dst[o] = obufs.get_audio (o).data ();
+	}
+
+	/* the positional data has been consumed, re-use the buffer as scratch space */
+
+	distribute_moving (*_speakers, srcbuf.data (), buffers[0], dst, nframes, azis, eles, &signal->gains[0], signal->outputs, signal->tuple);
+}
+
+void
+VBAPanner::distribute_moving (VBAPSpeakers const& speakers, Sample const* src, Sample* scratch, Sample** dst,
+                              pframes_t nframes, float const* azi, float const* ele,
+                              double* gains, int outputs[3], int& tuple)
+{
+	/* A speaker gain that moves linearly from g0 to g1 during a sub-block is
+	 *
+	 *   dst[i] += src[i] * (g0 + (g1 - g0) * i / len)
+	 *           = src[i] * g0 + scratch[i] * (g1 - g0)
+	 *
+	 * with scratch[i] = src[i] * i / len. The scratch buffer is shared by all
+	 * speakers, so that each of them is only mixed using the (SIMD)
+	 * mix_buffers_with_gain() kernel.
+	 */
+
+	for (pframes_t off = 0; off < nframes; off += automation_subblock) {
+		const pframes_t len  = min (automation_subblock, nframes - off);
+		const float     step = 1.f / len;
+		for (pframes_t i = 0; i < len; ++i) {
+			scratch[off + i] = src[off + i] * (i * step);
+		}
+	}
+
+	for (pframes_t off = 0, b = 0; off < nframes; off += automation_subblock, ++b) {
+		const pframes_t len = min (automation_subblock, nframes - off);
+
+		double g[3];
+		int    ids[3];
+
+		tuple = speakers.compute_gains (g, ids, azi[b], ele[b], tuple);
+
+		/* fade out speakers that are no longer used */
+
+		for (int o = 0; o < 3; ++o) {
+			const int id = outputs[o];
+
+			if (id < 0 || id == ids[0] || id == ids[1] || id == ids[2] || gains[id] == 0) {
+				continue;
+			}
+
+			mix_buffers_with_gain (dst[id] + off, src + off, len, gains[id]);
+			mix_buffers_with_gain (dst[id] + off, scratch + off, len, -gains[id]);
+			gains[id] = 0;
+		}
+
+		/* interpolate towards the gains of the speakers in use now */
+
+		for (int o = 0; o < 3; ++o) {
+			const int id = ids[o];
+
+			if (id < 0) {
+				continue;
+			}
+
+			const float g0 = gains[id];
+			const float g1 = g[o];
+
+			if (g0 != 0) {
+				mix_buffers_with_gain (dst[id] + off, src + off, len, g0);
+			}
+
+			if (g1 != g0) {
+				mix_buffers_with_gain (dst[id] + off, scratch + off, len, g1 - g0);
+			}
+
+			gains[id] = g1;
+		}
+
+		memcpy (outputs, ids, sizeof (ids));
+	}
 }
 
 XMLNode&
@@ -64,6 +64,27 @@ public:
 
 	void reset ();
 
+	/** Number of samples after which the direction of an automated
+	 * signal is re-evaluated. Speaker gains are linearly interpolated
+	 * for every sample in between.
+	 */
+	static const pframes_t automation_subblock = 64;
+
+	/** Mix a moving signal into the speaker buffers.
+	 *
+	 * @param src signal to distribute, @a nframes samples
+	 * @param scratch buffer of at least @a nframes samples
+	 * @param dst one buffer per speaker, mixed into
+	 * @param azi direction (degrees) at the end of each sub-block of automation_subblock samples
+	 * @param ele elevation (degrees) at the end of each sub-block
+	 * @param gains current gain of every speaker, updated
+	 * @param outputs speakers that are currently in use, updated
+	 * @param tuple speaker tuple that was last used, updated
+	 */
+	static void distribute_moving (VBAPSpeakers const&, Sample const* src, Sample* scratch, Sample** dst,
+	                               pframes_t nframes, float const* azi, float const* ele,
+	                               double* gains, int outputs[3], int& tuple);
+
 private:
 	struct Signal {
 		PBD::AngularVector  direction;
@@ -72,6 +93,7 @@ private:
 		int    outputs[3];         /* most recent set of outputs used (2 or 3, depending on dimension) */
 		int    desired_outputs[3]; /* outputs to use the next time we distribute */
 		double desired_gains[3];   /* target gains for desired_outputs */
+		int    tuple;              /* speaker tuple most recently used for automation */
 
 		Signal (VBAPanner&, uint32_t which, uint32_t n_speakers);
 		void resize_gains (uint32_t n_speakers);
@@ -80,14 +102,14 @@ private:
 	std::vector<Signal*>            _signals;
 	boost::shared_ptr<VBAPSpeakers> _speakers;
 
-	void compute_gains (double g[3], int ls[3], int azi, int ele);
-	void update ();
-	void clear_signals ();
+	double signal_azimuth (double azimuth, double width, uint32_t which) const;
+	void   update ();
+	void   clear_signals ();
 
-	void distribute_one (AudioBuffer& src, BufferSet& obufs, gain_t gain_coeff, pframes_t nframes, uint32_t which);
-	void distribute_one_automated (AudioBuffer& src, BufferSet& obufs,
-	                               samplepos_t start, samplepos_t end, pframes_t nframes,
-	                               pan_t** buffers, uint32_t which);
+	void   distribute_one (AudioBuffer& src, BufferSet& obufs, gain_t gain_coeff, pframes_t nframes, uint32_t which);
+	void   distribute_one_automated (AudioBuffer& src, BufferSet& obufs,
+	                                 samplepos_t start, samplepos_t end, pframes_t nframes,
+	                                 pan_t** buffers, uint32_t which);
 };
 
 } // namespace ARDOUR
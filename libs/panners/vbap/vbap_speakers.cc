@@ -90,6 +90,98 @@ VBAPSpeakers::update ()
 	}
 }
 
+int
+VBAPSpeakers::compute_gains (double gains[3], int speaker_ids[3], double azi, double ele, int hint) const
+{
+	/* calculates gain factors using loudspeaker setup and given direction */
+	double    cartdir[3];
+	double    big_sm_g = -100000.0;
+	int       tuple    = -1;
+	bool      found    = false;
+	const int n_tuples = _matrices.size ();
+
+	spherical_to_cartesian (azi, ele, 1.0, cartdir[0], cartdir[1], cartdir[2]);
+
+	gains[0] = gains[1] = gains[2] = 0;
+	speaker_ids[0] = speaker_ids[1] = speaker_ids[2] = 0;
+
+	/* Speaker tuples do not overlap, so if the direction is inside the
+	 * tuple that was last used (all gains are positive), it is the one
+	 * that the full search below would pick.
+	 */
+	if (hint >= 0 && hint < n_tuples) {
+		double gtmp[3];
+		if (tuple_gains (hint, cartdir, gtmp) >= 0) {
+			found    = true;
+			tuple    = hint;
+			gains[0] = gtmp[0];
+			gains[1] = gtmp[1];
+			gains[2] = gtmp[2];
+		}
+	}
+
+	for (int i = 0; i < n_tuples && !found; ++i) {
+		double gtmp[3];
+		double small_g = tuple_gains (i, cartdir, gtmp);
+
+		if (small_g > big_sm_g) {
+			big_sm_g = small_g;
+			tuple    = i;
+			gains[0] = gtmp[0];
+			gains[1] = gtmp[1];
+			gains[2] = gtmp[2];
+		}
+	}
+
+	if (tuple < 0) {
+		speaker_ids[0] = speaker_ids[1] = speaker_ids[2] = -1;
+		return -1;
+	}
+
+	speaker_ids[0] = _speaker_tuples[tuple][0];
+	speaker_ids[1] = _speaker_tuples[tuple][1];
+
+	if (_dimension == 3) {
+		speaker_ids[2] = _speaker_tuples[tuple][2];
+	} else {
+		gains[2]       = 0.0;
+		speaker_ids[2] = -1;
+	}
+
+	double power = sqrt (gains[0] * gains[0] + gains[1] * gains[1] + gains[2] * gains[2]);
+
+	if (power > 0) {
+		gains[0] /= power;
+		gains[1] /= power;
+		gains[2] /= power;
+	}
+
+	return tuple;
+}
+
+double
+VBAPSpeakers::tuple_gains (int tuple, double const cartdir[3], double gtmp[3]) const
+{
+	dvector const& mx (_matrices[tuple]);
+	double         small_g = 10000000.0;
+
+	gtmp[2] = 0.0;
+
+	for (int j = 0; j < _dimension; j++) {
+		gtmp[j] = 0.0;
+
+		for (int k = 0; k < _dimension; k++) {
+			gtmp[j] += cartdir[k] * mx[j * _dimension + k];
+		}
+
+		if (gtmp[j] < small_g) {
+			small_g = gtmp[j];
+		}
+	}
+
+	return small_g;
+}
+
 void
 VBAPSpeakers::choose_speaker_triplets (struct ls_triplet_chain** ls_triplets)
 {
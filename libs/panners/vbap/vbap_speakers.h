@@ -40,7 +40,7 @@ public:
 
 	typedef std::vector<double> dvector;
 
-	const dvector matrix (int tuple) const
+	const dvector& matrix (int tuple) const
 	{
 		return _matrices[tuple];
 	}
@@ -70,6 +70,15 @@ public:
 		return _parent;
 	}
 
+	/** Compute the gains of the (up to 3) speakers that render a signal
+	 * from the given direction, normalized to constant power.
+	 *
+	 * @param hint tuple to try first, typically the one used for the
+	 * previous direction of the same signal, or -1.
+	 * @return the tuple that was used, or -1
+	 */
+	int compute_gains (double gains[3], int speaker_ids[3], double azi, double ele, int hint = -1) const;
+
 	~VBAPSpeakers ();
 
 private:
@@ -114,15 +123,16 @@ private:
 	static double vol_p_side_lgth (int i, int j, int k, const std::vector<Speaker>&);
 	static void   cross_prod (PBD::CartesianVector v1, PBD::CartesianVector v2, PBD::CartesianVector* res);
 
-	void update ();
-	int  any_ls_inside_triplet (int a, int b, int c);
-	void add_ldsp_triplet (int i, int j, int k, struct ls_triplet_chain** ls_triplets);
-	int  lines_intersect (int i, int j, int k, int l);
-	void calculate_3x3_matrixes (struct ls_triplet_chain* ls_triplets);
-	void choose_speaker_triplets (struct ls_triplet_chain** ls_triplets);
-	void choose_speaker_pairs ();
-	void sort_2D_lss (int* sorted_lss);
-	int  calc_2D_inv_tmatrix (double azi1, double azi2, double* inv_mat);
+	void   update ();
+	double tuple_gains (int tuple, double const cartdir[3], double gains[3]) const;
+	int    any_ls_inside_triplet (int a, int b, int c);
+	void   add_ldsp_triplet (int i, int j, int k, struct ls_triplet_chain** ls_triplets);
+	int    lines_intersect (int i, int j, int k, int l);
+	void   calculate_3x3_matrixes (struct ls_triplet_chain* ls_triplets);
+	void   choose_speaker_triplets (struct ls_triplet_chain** ls_triplets);
+	void   choose_speaker_pairs ();
+	void   sort_2D_lss (int* sorted_lss);
+	int    calc_2D_inv_tmatrix (double azi1, double azi2, double* inv_mat);
 };
 
 } // namespace ARDOUR
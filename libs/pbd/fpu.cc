@@ -77,6 +77,34 @@ __cpuid(int regs[4], int cpuid_leaf)
 			"%ecx", "%edx", "memory");
 }
 
+/* __cpuid() variant which also sets the sub-leaf in %ecx, as the
+ * MSVC/mingw __cpuidex() intrinsic. Needed for extended features (leaf 7).
+ */
+
+static void
+__cpuidex(int regs[4], int cpuid_leaf, int cpuid_subleaf)
+{
+	asm volatile (
+#if defined(__i386__)
+			"pushl %%ebx;\n\t"
+#endif
+			"cpuid;\n\t"
+			"movl %%eax, (%2);\n\t"
+			"movl %%ebx, 4(%2);\n\t"
+			"movl %%ecx, 8(%2);\n\t"
+			"movl %%edx, 12(%2);\n\t"
+#if defined(__i386__)
+			"popl %%ebx;\n\t"
+#endif
+			:"+a" (cpuid_leaf), "+c" (cpuid_subleaf) /* both clobbered by CPUID */
+			:"S" (regs)
+			:
+#if !defined(__i386__)
+			"%ebx",
+#endif
+			"%edx", "memory");
+}
+
 #endif /* !PLATFORM_WINDOWS */
 
 #ifndef HAVE_XGETBV // Allow definition by build system
@@ -219,6 +247,17 @@ FPU::FPU ()
 			_flags = Flags (_flags | (HasFMA));
 		}
 
+		if (num_ids >= 7 && (_flags & HasAVX)) {
+			int ext_info[4];
+			__cpuidex (ext_info, 7, 0);
+
+			if ((ext_info[1] & (1<<16)) /* AVX512F */ &&
+			    ((_xgetbv (_XCR_XFEATURE_ENABLED_MASK) & 0xe6) == 0xe6)) { /* OS saves opmask and ZMM state */
+				info << _("AVX-512F capable processor") << endmsg;
+				_flags = Flags (_flags | (HasAVX512F));
+			}
+		}
+
 		if (cpu_info[3] & (1<<25)) {
 			_flags = Flags (_flags | (HasSSE|HasFlushToZero));
 		}
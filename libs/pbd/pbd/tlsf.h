@@ -47,9 +47,15 @@ public:
 	size_t get_used_size () const;
 	size_t get_max_size () const;
 
+	/** @return true if @a ptr points into this pool */
+	bool owns (void const* ptr) const {
+		return (char const*) ptr >= _mp && (char const*) ptr < _mp + _size;
+	}
+
 private:
 	std::string _name;
 	char*_mp;
+	size_t _size;
 
 	void* _malloc (size_t);
 	void* _realloc (void *, size_t);
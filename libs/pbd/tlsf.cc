@@ -411,6 +411,7 @@ PBD::TLSF::TLSF (std::string name, size_t mem_pool_size)
 
 	tlsf_t *tlsf = (tlsf_t *) mem_pool;
 	_mp = mem_pool;
+	_size = mem_pool_size;
 
 	/* Zeroing the memory pool */
 	memset(_mp, 0, sizeof(tlsf_t));
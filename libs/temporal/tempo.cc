@@ -669,7 +669,8 @@ TempoMapPoint::end_float ()
 /* TEMPOMAP */
 
 TempoMap::TempoMap (Tempo const & initial_tempo, Meter const & initial_meter)
-	: _time_domain (AudioTime)
+	: _segments_valid (false)
+	, _time_domain (AudioTime)
 {
 	TempoPoint* tp = new TempoPoint (*this, initial_tempo, 0, Beats(), BBT_Time());
 	MeterPoint* mp = new MeterPoint (*this, initial_meter, 0, Beats(), BBT_Time());
@@ -686,12 +687,14 @@ TempoMap::~TempoMap()
 }
 
 TempoMap::TempoMap (XMLNode const & node, int version)
+	: _segments_valid (false)
 {
 	set_state (node, version);
 }
 
 TempoMap::TempoMap (TempoMap const & other)
-	: _time_domain (other.time_domain())
+	: _segments_valid (false)
+	, _time_domain (other.time_domain())
 {
 	copy_points (other);
 }
@@ -734,6 +737,8 @@ TempoMap::copy_points (TempoMap const & other)
 	for (std::vector<Point*>::iterator pi = p.begin(); pi != p.end(); ++pi) {
 		_points.push_back (**pi);
 	}
+
+	_segments_valid = false;
 }
 
 void
@@ -766,6 +771,7 @@ TempoMap::set_time_domain (TimeDomain td)
 #endif
 
 	_time_domain = td;
+	_segments_valid = false;
 }
 
 MeterPoint*
@@ -1100,6 +1106,8 @@ TempoMap::remove_point (Point const & point)
 			break;
 		}
 	}
+
+	_segments_valid = false;
 }
 
 void
@@ -1112,6 +1120,8 @@ TempoMap::reset_starting_at (superclock_t sc)
 	assert (!_tempos.empty());
 	assert (!_meters.empty());
 
+	_segments_valid = false;
+
 	TempoPoint* current_tempo;
 	MeterPoint* current_meter;
 
@@ -1690,6 +1700,8 @@ TempoMap::sample_rate_changed (samplecnt_t new_sr)
 	for (MusicTimes::iterator p = _bartimes.begin(); p != _bartimes.end(); ++p) {
 		p->map_reset_set_sclock_for_sr_change (llrint (ratio * p->sclock()));
 	}
+
+	_segments_valid = false;
 }
 
 void
@@ -1795,6 +1807,101 @@ TempoMap::_get_tempo_and_meter (typename const_traits_t::tempo_point_type & tp,
 	return last_used;
 }
 
+void
+TempoMap::build_segments ()
+{
+	assert (!_tempos.empty());
+	assert (!_meters.empty());
+
+	TempoPoint const * tp = &_tempos.front();
+	MeterPoint const * mp = &_meters.front();
+
+	_segments.clear ();
+	_segments.reserve (_points.size());
+
+	for (Points::const_iterator p = _points.begin(); p != _points.end(); ++p) {
+
+		TempoPoint const * tpp;
+		MeterPoint const * mpp;
+
+		if ((tpp = dynamic_cast<TempoPoint const *> (&(*p))) != 0) {
+			tp = tpp;
+		}
+
+		if ((mpp = dynamic_cast<MeterPoint const *> (&(*p))) != 0) {
+			mp = mpp;
+		}
+
+		Segment s;
+		s.sclock = p->sclock();
+		s.beats = p->beats();
+		s.bbt = p->bbt();
+		s.tempo = tp;
+		s.meter = mp;
+
+		_segments.push_back (s);
+	}
+
+	_segments_valid = true;
+}
+
+/* index of the segment returned by the most recent lookup in this thread.
+ * Successive conversions from the same thread (e.g. a process() callback
+ * walking forward through a cycle) almost always land in the same or the
+ * next segment, so check those before bisecting. This is only a hint: it
+ * is range-checked and verified before use, so it does not matter which
+ * map (or map version) set it.
+ */
+static thread_local size_t segment_hint = 0;
+
+template<typename T> TempoMetric
+TempoMap::segment_metric_at (T Segment::*member, T const & arg, bool can_match) const
+{
+	const size_t n = _segments.size();
+
+	/* see ::_get_tempo_and_meter() for why "zero" always matches */
+
+	can_match = (can_match || arg == T ());
+
+	/* Find the last segment that starts at or before @param arg (or
+	 * strictly before, if !can_match). This relies on points being
+	 * ordered identically in all three time domains.
+	 */
+
+#define SEGMENT_QUALIFIES(i) (can_match ? !(arg < _segments[i].*member) : (_segments[i].*member < arg))
+
+	size_t h = segment_hint;
+
+	for (size_t i = h; i < n && i <= h + 1; ++i) {
+		if (SEGMENT_QUALIFIES (i) && (i + 1 == n || !SEGMENT_QUALIFIES (i + 1))) {
+			segment_hint = i;
+			return TempoMetric (*_segments[i].tempo, *_segments[i].meter);
+		}
+	}
+
+	size_t lo = 0;
+	size_t hi = n;
+
+	while (lo < hi) {
+		const size_t mid = lo + (hi - lo) / 2;
+		if (SEGMENT_QUALIFIES (mid)) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+
+#undef SEGMENT_QUALIFIES
+
+	if (lo == 0) {
+		return TempoMetric (_tempos.front(), _meters.front());
+	}
+
+	segment_hint = lo - 1;
+
+	return TempoMetric (*_segments[lo - 1].tempo, *_segments[lo - 1].meter);
+}
+
 void
 TempoMap::get_grid (TempoMapPoints& ret, superclock_t start, superclock_t end, uint32_t bar_mod)
 {
@@ -2389,6 +2496,9 @@ int
 TempoMap::set_state (XMLNode const & node, int version)
 {
 	cerr << "\n\n\n TMAP set state\n\n";
+
+	_segments_valid = false;
+
 	if (version <= 6000) {
 		cerr << "Old version " << version << "\n";
 		return set_state_3x (node);
@@ -2795,6 +2905,8 @@ TempoMap::insert_time (timepos_t const & pos, timecnt_t const & duration)
 	case BeatTime:
 		break;
 	}
+
+	_segments_valid = false;
 }
 
 bool
@@ -2917,6 +3029,10 @@ TempoMap::metric_at (timepos_t const & pos) const
 TempoMetric
 TempoMap::metric_at (superclock_t sc, bool can_match) const
 {
+	if (_segments_valid) {
+		return segment_metric_at (&Segment::sclock, sc, can_match);
+	}
+
 	TempoPoint const * tp = 0;
 	MeterPoint const * mp = 0;
 
@@ -2928,6 +3044,10 @@ TempoMap::metric_at (superclock_t sc, bool can_match) const
 TempoMetric
 TempoMap::metric_at (Beats const & b, bool can_match) const
 {
+	if (_segments_valid) {
+		return segment_metric_at (&Segment::beats, b, can_match);
+	}
+
 	TempoPoint const * tp = 0;
 	MeterPoint const * mp = 0;
 
@@ -2939,6 +3059,10 @@ TempoMap::metric_at (Beats const & b, bool can_match) const
 TempoMetric
 TempoMap::metric_at (BBT_Time const & bbt, bool can_match) const
 {
+	if (_segments_valid) {
+		return segment_metric_at (&Segment::bbt, bbt, can_match);
+	}
+
 	TempoPoint const * tp = 0;
 	MeterPoint const * mp = 0;
 
@@ -3188,6 +3312,7 @@ void
 TempoMap::init ()
 {
 	SharedPtr new_map (new TempoMap (Tempo (120, 4), Meter (4, 4)));
+	new_map->build_segments ();
 	_map_mgr.init (new_map);
 	fetch ();
 }
@@ -3201,6 +3326,11 @@ TempoMap::write_copy()
 int
 TempoMap::update (TempoMap::SharedPtr m)
 {
+	/* readers only ever see published maps, so this is the one place the
+	 * lookup index needs to be (re)built.
+	 */
+	m->build_segments ();
+
 	if (!_map_mgr.update (m)) {
 		return -1;
 	}
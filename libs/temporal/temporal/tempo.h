@@ -756,6 +756,15 @@ class /*LIBTEMPORAL_API*/ TempoMap : public PBD::StatefulDestructible
 	LIBTEMPORAL_API	TempoMetric metric_at (Beats const &, bool can_match = true) const;
 	LIBTEMPORAL_API	TempoMetric metric_at (BBT_Time const &, bool can_match = true) const;
 
+	/* Rebuild the flat segment index used by metric_at(). This is done by
+	 * ::update() before a map is published, so that every reader sees an
+	 * immutable, binary-searchable copy. Any modification of the map
+	 * invalidates the index, and lookups fall back to walking _points
+	 * until it is rebuilt.
+	 */
+	LIBTEMPORAL_API void build_segments ();
+	LIBTEMPORAL_API bool segments_valid () const { return _segments_valid; }
+
   private:
 	template<typename TimeType, typename Comparator> TempoPoint const & _tempo_at (TimeType when, Comparator cmp) const {
 		assert (!_tempos.empty());
@@ -884,6 +893,23 @@ class /*LIBTEMPORAL_API*/ TempoMap : public PBD::StatefulDestructible
 	MusicTimes   _bartimes;
 	Points       _points;
 
+	/* one entry per element of _points, in the same order, holding the
+	 * position of the point in all three time domains and the tempo and
+	 * meter in effect at (and including) that point.
+	 */
+	struct Segment {
+		superclock_t       sclock;
+		Beats              beats;
+		BBT_Time           bbt;
+		TempoPoint const * tempo;
+		MeterPoint const * meter;
+	};
+
+	typedef std::vector<Segment> Segments;
+
+	Segments     _segments;
+	bool         _segments_valid;
+
 	TimeDomain _time_domain;
 
 	int set_tempos_from_state (XMLNode const &);
@@ -905,6 +931,8 @@ class /*LIBTEMPORAL_API*/ TempoMap : public PBD::StatefulDestructible
 
 	void copy_points (TempoMap const & other);
 
+	template<typename T> TempoMetric segment_metric_at (T Segment::*, T const &, bool can_match) const;
+
 	BBT_Time bbt_at (superclock_t sc) const;
 
 	template<typename T, typename T1> struct const_traits {
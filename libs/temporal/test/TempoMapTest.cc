@@ -1,5 +1,11 @@
 #include <stdlib.h>
 
+#include <iostream>
+#include <sstream>
+
+#include "pbd/microseconds.h"
+#include "pbd/xml++.h"
+
 #include "temporal/tempo.h"
 
 #include "TempoMapTest.h"
@@ -38,3 +44,200 @@ TempoMapTest::convertTest()
 {
 }
 
+
+/* Build a map with @param n_tempos tempo changes, one at the start of each
+ * bar, and an additional (4/4) meter point every @param meter_every bars.
+ * This goes via XML state, since adding points one at a time recomputes
+ * (and dumps) the entire map for every addition.
+ */
+static TempoMap*
+make_map (uint32_t n_tempos, uint32_t meter_every)
+{
+	TempoMap base (Tempo (120, 4), Meter (4, 4));
+	XMLNode& state (base.get_state ());
+
+	XMLNode* tempos = state.child (X_("Tempos"));
+	XMLNode* meters = state.child (X_("Meters"));
+	XMLNode tempo_node (*tempos->children().front());
+	XMLNode meter_node (*meters->children().front());
+
+	tempos->remove_nodes_and_delete (Tempo::xml_node_name);
+	meters->remove_nodes_and_delete (Meter::xml_node_name);
+
+	superclock_t sc = 0;
+
+	for (uint32_t n = 0; n < n_tempos; ++n) {
+
+		const double npm = 100. + (n % 50);
+		const Beats beats (Beats::beats (4 * n));
+		const BBT_Time bbt (n + 1, 1, 0);
+
+		XMLNode* t = tempos->add_child_copy (tempo_node);
+		t->set_property (X_("npm"), npm);
+		t->set_property (X_("enpm"), npm);
+		t->set_property (X_("sclock"), sc);
+		t->set_property (X_("quarters"), beats);
+		t->set_property (X_("bbt"), bbt);
+
+		if ((n % meter_every) == 0) {
+			XMLNode* m = meters->add_child_copy (meter_node);
+			m->set_property (X_("sclock"), sc);
+			m->set_property (X_("quarters"), beats);
+			m->set_property (X_("bbt"), bbt);
+		}
+
+		sc += 4 * Tempo (npm, 4).superclocks_per_quarter_note ();
+	}
+
+	/* TempoMap::set_state() is rather chatty */
+
+	std::streambuf* old_buf = std::cerr.rdbuf ();
+	std::ostringstream discard;
+	std::cerr.rdbuf (discard.rdbuf ());
+
+	TempoMap* map = new TempoMap (state, 7000);
+
+	std::cerr.rdbuf (old_buf);
+
+	delete &state;
+
+	return map;
+}
+
+typedef std::pair<TempoPoint const *, MeterPoint const *> MetricPair;
+
+static void
+collect_metrics (TempoMap& map, std::vector<MetricPair>& results)
+{
+	TempoMap::Metrics points;
+	map.get_metrics (points);
+
+	for (int can_match = 0; can_match < 2; ++can_match) {
+		for (TempoMap::Metrics::const_iterator p = points.begin(); p != points.end(); ++p) {
+
+			superclock_t sc = (*p)->sclock();
+			Beats b = (*p)->beats();
+			BBT_Time bbt = (*p)->bbt();
+
+			TempoMetric metrics[] = {
+				map.metric_at (sc > 0 ? sc - 1 : sc, can_match),
+				map.metric_at (sc, can_match),
+				map.metric_at (sc + 1, can_match),
+				map.metric_at (b, can_match),
+				map.metric_at (b + Beats::one_tick(), can_match),
+				map.metric_at (bbt, can_match),
+				map.metric_at (BBT_Time (bbt.bars, bbt.beats, bbt.ticks + 1), can_match),
+			};
+
+			for (size_t n = 0; n < sizeof (metrics) / sizeof (metrics[0]); ++n) {
+				results.push_back (MetricPair (&metrics[n].tempo(), &metrics[n].meter()));
+			}
+		}
+	}
+}
+
+void
+TempoMapTest::lookupTest()
+{
+	TempoMap* map = make_map (500, 7);
+
+	CPPUNIT_ASSERT (!map->segments_valid ());
+	CPPUNIT_ASSERT_EQUAL (uint32_t (500), map->n_tempos ());
+
+	std::vector<MetricPair> linear;
+	collect_metrics (*map, linear);
+
+	map->build_segments ();
+	CPPUNIT_ASSERT (map->segments_valid ());
+
+	std::vector<MetricPair> indexed;
+	collect_metrics (*map, indexed);
+
+	CPPUNIT_ASSERT_EQUAL (linear.size(), indexed.size());
+
+	for (size_t n = 0; n < linear.size(); ++n) {
+		CPPUNIT_ASSERT (linear[n] == indexed[n]);
+	}
+
+	/* same again, visiting points back to front, which defeats the
+	 * per-thread segment hint.
+	 */
+
+	TempoMap::Metrics points;
+	map->get_metrics (points);
+
+	for (TempoMap::Metrics::const_reverse_iterator p = points.rbegin(); p != points.rend(); ++p) {
+		TempoMetric m (map->metric_at ((*p)->sclock(), true));
+		CPPUNIT_ASSERT (m.tempo().sclock() <= (*p)->sclock());
+		CPPUNIT_ASSERT (m.meter().sclock() <= (*p)->sclock());
+		CPPUNIT_ASSERT (map->metric_at ((*p)->beats(), true).tempo().sclock() == m.tempo().sclock());
+	}
+
+	/* modifying the map invalidates the index */
+
+	map->set_time_domain (BeatTime);
+	CPPUNIT_ASSERT (!map->segments_valid ());
+
+	delete map;
+}
+
+void
+TempoMapTest::lookupBenchmark()
+{
+	const uint32_t n_tempos = 10000;
+	const int linear_lookups = 2000;
+	const int indexed_lookups = 1000000;
+
+	TempoMap* indexed = make_map (n_tempos, 16);
+	TempoMap linear (*indexed); /* copies do not inherit the index */
+
+	indexed->build_segments ();
+	CPPUNIT_ASSERT (!linear.segments_valid ());
+
+	const superclock_t end = indexed->metric_at (Beats::beats (4 * n_tempos)).tempo().sclock();
+
+	std::vector<superclock_t> positions;
+	positions.reserve (indexed_lookups);
+
+	srand (0x7e3b0);
+	for (int n = 0; n < indexed_lookups; ++n) {
+		positions.push_back ((superclock_t) ((rand() / (double) RAND_MAX) * end));
+	}
+
+	superclock_t check = 0;
+
+	PBD::microseconds_t t0 = PBD::get_microseconds ();
+	for (int n = 0; n < linear_lookups; ++n) {
+		check += linear.metric_at (positions[n]).tempo().sclock();
+	}
+	PBD::microseconds_t t1 = PBD::get_microseconds ();
+	for (int n = 0; n < linear_lookups; ++n) {
+		check -= indexed->metric_at (positions[n]).tempo().sclock();
+	}
+
+	CPPUNIT_ASSERT_EQUAL (superclock_t (0), check);
+
+	PBD::microseconds_t t2 = PBD::get_microseconds ();
+	for (int n = 0; n < indexed_lookups; ++n) {
+		check += indexed->metric_at (positions[n]).tempo().sclock();
+	}
+	PBD::microseconds_t t3 = PBD::get_microseconds ();
+
+	/* monotonic, as when converting successive positions in a process cycle */
+
+	const superclock_t step = end / indexed_lookups;
+	superclock_t pos = 0;
+
+	for (int n = 0; n < indexed_lookups; ++n, pos += step) {
+		check += indexed->metric_at (pos).tempo().sclock();
+	}
+	PBD::microseconds_t t4 = PBD::get_microseconds ();
+
+	std::cout << "\nTempoMap lookup, " << n_tempos << " tempos: "
+	          << "linear " << (t1 - t0) * 1000. / linear_lookups << " ns, "
+	          << "indexed (random) " << (t3 - t2) * 1000. / indexed_lookups << " ns, "
+	          << "indexed (sequential) " << (t4 - t3) * 1000. / indexed_lookups << " ns "
+	          << "per lookup\n";
+
+	delete indexed;
+}
@@ -10,6 +10,8 @@ class TempoMapTest : public CppUnit::TestFixture
 	CPPUNIT_TEST(multiplyTest);
 	CPPUNIT_TEST(convertTest);
 	CPPUNIT_TEST(roundTest);
+	CPPUNIT_TEST(lookupTest);
+	CPPUNIT_TEST(lookupBenchmark);
 	CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -19,4 +21,6 @@ public:
 	void multiplyTest();
 	void convertTest();
 	void roundTest();
+	void lookupTest();
+	void lookupBenchmark();
 };
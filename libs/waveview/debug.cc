@@ -21,3 +21,4 @@
 #include "waveview/debug.h"
 
 PBD::DebugBits PBD::DEBUG::WaveView = PBD::new_debug_bit ("waveview");
+PBD::DebugBits PBD::DEBUG::WaveViewCache = PBD::new_debug_bit ("waveviewcache");
@@ -354,6 +354,7 @@ WaveView::queue_draw_request (boost::shared_ptr<WaveViewDrawRequest> const& requ
 		// now we can finally set an optimal image now that we are not using the
 		// properties for comparisons.
 		request->image->props.set_width_samples (optimal_image_width_samples ());
+		request->priority = draw_priority (request->image->props);
 
 		current_request = request;
 
@@ -364,6 +365,30 @@ WaveView::queue_draw_request (boost::shared_ptr<WaveViewDrawRequest> const& requ
 	}
 }
 
+double
+WaveView::draw_priority (WaveViewProperties const& props) const
+{
+	/* images that are visible are rendered first, closest to the
+	 * center of the visible area first, then the remaining ones by
+	 * distance to the visible area.
+	 */
+	Rect const visible = _canvas->visible_area ();
+
+	double const x0 = (props.get_sample_start () - _props->region_start) / _props->samples_per_pixel;
+	double const x1 = (props.get_sample_end () - _props->region_start) / _props->samples_per_pixel;
+
+	Rect const area = item_to_window (Rect (x0, 0.0, x1, _props->height));
+
+	double const dx = (area.x0 + area.x1 - visible.x0 - visible.x1) / 2.0;
+	double const dy = (area.y0 + area.y1 - visible.y0 - visible.y1) / 2.0;
+	double const distance = sqrt (dx * dx + dy * dy);
+
+	if (area.intersection (visible)) {
+		return distance;
+	}
+	return distance + visible.width () + visible.height ();
+}
+
 void
 WaveView::compute_tips (ARDOUR::PeakData const& peak, WaveView::LineTips& tips,
                         double const effective_height)
@@ -884,6 +909,8 @@ WaveView::process_draw_request (boost::shared_ptr<WaveViewDrawRequest> req)
 		return;
 	}
 
+	const int64_t start_time = g_get_monotonic_time ();
+
 	WaveViewProperties const& props = req->image->props;
 
 	const int n_peaks = props.get_width_pixels ();
@@ -944,6 +971,8 @@ WaveView::process_draw_request (boost::shared_ptr<WaveViewDrawRequest> req)
 	// Assign now that we are sure all drawing is complete as that is what
 	// determines whether a request was finished.
 	req->image->cairo_image = cairo_image;
+
+	WaveViewCache::get_instance ()->add_render_time (g_get_monotonic_time () - start_time);
 }
 
 bool
@@ -20,12 +20,14 @@
 #include <cmath>
 #include "ardour/lmath.h"
 
+#include "pbd/compose.h"
 #include "pbd/cpus.h"
 #include "pbd/pthread_utils.h"
 
 #include "ardour/audioregion.h"
 #include "ardour/audiosource.h"
 
+#include "waveview/debug.h"
 #include "waveview/wave_view_private.h"
 
 namespace ArdourWaveView {
@@ -59,7 +61,6 @@ WaveViewImage::WaveViewImage (boost::shared_ptr<const ARDOUR::AudioRegion> const
                               WaveViewProperties const& properties)
 	: region (region_ptr)
 	, props (properties)
-	, timestamp (0)
 {
 
 }
@@ -71,6 +72,31 @@ WaveViewImage::~WaveViewImage ()
 
 /*-------------------------------------------------*/
 
+WaveViewImageKey::WaveViewImageKey (WaveViewProperties const& props)
+	: channel (props.channel)
+	, samples_per_pixel (props.samples_per_pixel)
+	, height (props.height)
+	, shape (props.shape)
+{
+}
+
+bool
+WaveViewImageKey::operator< (WaveViewImageKey const& other) const
+{
+	if (channel != other.channel) {
+		return channel < other.channel;
+	}
+	if (samples_per_pixel != other.samples_per_pixel) {
+		return samples_per_pixel < other.samples_per_pixel;
+	}
+	if (height != other.height) {
+		return height < other.height;
+	}
+	return shape < other.shape;
+}
+
+/*-------------------------------------------------*/
+
 WaveViewCacheGroup::WaveViewCacheGroup (WaveViewCache& parent_cache)
 	: _parent_cache (parent_cache)
 {
@@ -90,73 +116,60 @@ WaveViewCacheGroup::add_image (boost::shared_ptr<WaveViewImage> image)
 		return;
 	}
 
-	ImageCache::iterator oldest_image_it = _cached_images.begin();
-	ImageCache::iterator second_oldest_image_it = _cached_images.end();
+	WaveViewImageKey const key (image->props);
+	std::pair<ImageCache::iterator, ImageCache::iterator> range = _cached_images.equal_range (key);
 
-	for (ImageCache::iterator it = _cached_images.begin (); it != _cached_images.end (); ++it) {
-		if ((*it) == image) {
+	for (ImageCache::iterator it = range.first; it != range.second; ++it) {
+		boost::shared_ptr<WaveViewImage> const& cached = it->second->image;
+		if (cached == image || cached->props.is_equivalent (image->props)) {
 			// Must never be more than one instance of the image in the cache
-			(*it)->timestamp = g_get_monotonic_time ();
-			return;
-		} else if ((*it)->props.is_equivalent (image->props)) {
-			// Equivalent Image already in cache, updating timestamp
-			(*it)->timestamp = g_get_monotonic_time ();
+			_parent_cache.touch (it->second, false);
 			return;
 		}
-
-		if ((*it)->timestamp < (*oldest_image_it)->timestamp) {
-			second_oldest_image_it = oldest_image_it;
-			oldest_image_it = it;
-		}
 	}
 
 	// no duplicate or equivalent image so we are definitely adding it to cache
-	image->timestamp = g_get_monotonic_time ();
-
-	if (_parent_cache.full () || full ()) {
-		if (oldest_image_it != _cached_images.end()) {
-			// Replacing oldest Image in cache
-			_parent_cache.decrease_size ((*oldest_image_it)->size_in_bytes ());
-			*oldest_image_it = image;
-			_parent_cache.increase_size (image->size_in_bytes ());
-
-			if (second_oldest_image_it != _cached_images.end ()) {
-				// Removing second oldest Image in cache
-				_parent_cache.decrease_size ((*second_oldest_image_it)->size_in_bytes ());
-				_cached_images.erase (second_oldest_image_it);
-			}
-			return;
-		} else {
-			/**
-			 * Add the image to the cache even if the threshold is exceeded so that
-			 * new WaveViews can still cache images with a full cache, the size of
-			 * the cache will quickly equalize back to the threshold as new images
-			 * are added and the size of the cache is reduced.
-			 */
-		}
-	}
+	_cached_images.insert (std::make_pair (key, _parent_cache.insert (this, image)));
 
-	_cached_images.push_back (image);
-	_parent_cache.increase_size (image->size_in_bytes ());
+	_parent_cache.evict ();
 }
 
 boost::shared_ptr<WaveViewImage>
 WaveViewCacheGroup::lookup_image (WaveViewProperties const& props)
 {
-	for (ImageCache::iterator i = _cached_images.begin (); i != _cached_images.end (); ++i) {
-		if ((*i)->props.is_equivalent (props)) {
-			return (*i);
+	std::pair<ImageCache::iterator, ImageCache::iterator> range = _cached_images.equal_range (WaveViewImageKey (props));
+
+	for (ImageCache::iterator i = range.first; i != range.second; ++i) {
+		if (i->second->image->props.is_equivalent (props)) {
+			_parent_cache.touch (i->second, true);
+			return i->second->image;
 		}
 	}
+
+	_parent_cache.miss ();
 	return boost::shared_ptr<WaveViewImage>();
 }
 
+void
+WaveViewCacheGroup::remove_image (boost::shared_ptr<WaveViewImage> const& image)
+{
+	std::pair<ImageCache::iterator, ImageCache::iterator> range = _cached_images.equal_range (WaveViewImageKey (image->props));
+
+	for (ImageCache::iterator i = range.first; i != range.second; ++i) {
+		if (i->second->image == image) {
+			_cached_images.erase (i);
+			return;
+		}
+	}
+	assert (0);
+}
+
 void
 WaveViewCacheGroup::clear_cache ()
 {
 	// Tell the parent cache about the images we are about to drop references to
 	for (ImageCache::iterator it = _cached_images.begin (); it != _cached_images.end (); ++it) {
-		_parent_cache.decrease_size ((*it)->size_in_bytes ());
+		_parent_cache.remove (it->second);
 	}
 	_cached_images.clear ();
 }
@@ -166,6 +179,12 @@ WaveViewCacheGroup::clear_cache ()
 WaveViewCache::WaveViewCache ()
 	: image_cache_size (0)
 	, _image_cache_threshold (100 * 1048576) /* bytes */
+	, _hits (0)
+	, _misses (0)
+	, _evictions (0)
+	, _renders (0)
+	, _render_usecs (0)
+	, _render_usecs_max (0)
 {
 
 }
@@ -181,18 +200,52 @@ WaveViewCache::get_instance ()
 	return instance;
 }
 
-void
-WaveViewCache::increase_size (uint64_t bytes)
+WaveViewCacheLRU::iterator
+WaveViewCache::insert (WaveViewCacheGroup* group, boost::shared_ptr<WaveViewImage> const& image)
 {
+	const uint64_t bytes = image->size_in_bytes ();
+	_lru.push_front (WaveViewCacheEntry (group, image, bytes));
 	image_cache_size += bytes;
+	return _lru.begin ();
+}
+
+void
+WaveViewCache::touch (WaveViewCacheLRU::iterator it, bool hit)
+{
+	_lru.splice (_lru.begin (), _lru, it);
+
+	if (hit && (++_hits % 1024) == 0) {
+		debug_stats ("lookup");
+	}
+}
+
+void
+WaveViewCache::miss ()
+{
+	++_misses;
+}
+
+void
+WaveViewCache::remove (WaveViewCacheLRU::iterator it)
+{
+	assert (it->bytes <= image_cache_size);
+	image_cache_size -= it->bytes;
+	_lru.erase (it);
 }
 
 void
-WaveViewCache::decrease_size (uint64_t bytes)
+WaveViewCache::evict ()
 {
-	assert (bytes > 0);
-	assert (bytes <= image_cache_size);
-	image_cache_size -= bytes;
+	/* Never evict the most recently used image: a new WaveView must
+	 * be able to cache its image even if it alone exceeds the limit.
+	 */
+	while (full () && _lru.size () > 1) {
+		WaveViewCacheLRU::iterator oldest = --_lru.end ();
+		DEBUG_TRACE (PBD::DEBUG::WaveViewCache, string_compose ("evict image of %1 bytes, cache size %2\n", oldest->bytes, image_cache_size));
+		oldest->group->remove_image (oldest->image);
+		remove (oldest);
+		++_evictions;
+	}
 }
 
 boost::shared_ptr<WaveViewCacheGroup>
@@ -242,15 +295,76 @@ WaveViewCache::reset_cache_group (boost::shared_ptr<WaveViewCacheGroup>& group)
 void
 WaveViewCache::clear_cache ()
 {
+	debug_stats ("clear");
+
 	for (CacheGroups::iterator it = cache_group_map.begin (); it != cache_group_map.end (); ++it) {
 		(*it).second->clear_cache ();
 	}
+	assert (_lru.empty ());
 }
 
 void
 WaveViewCache::set_image_cache_threshold (uint64_t sz)
 {
 	_image_cache_threshold = sz;
+	evict ();
+}
+
+void
+WaveViewCache::add_render_time (int64_t usecs)
+{
+	Glib::Threads::Mutex::Lock lm (_render_stats_lock);
+	++_renders;
+	_render_usecs += usecs;
+	_render_usecs_max = std::max<uint64_t> (_render_usecs_max, usecs);
+}
+
+WaveViewCache::Stats
+WaveViewCache::stats () const
+{
+	Stats s;
+	s.hits      = _hits;
+	s.misses    = _misses;
+	s.evictions = _evictions;
+	s.images    = _lru.size ();
+	s.bytes     = image_cache_size;
+
+	Glib::Threads::Mutex::Lock lm (_render_stats_lock);
+	s.renders          = _renders;
+	s.render_usecs     = _render_usecs;
+	s.render_usecs_max = _render_usecs_max;
+	return s;
+}
+
+void
+WaveViewCache::reset_stats ()
+{
+	_hits      = 0;
+	_misses    = 0;
+	_evictions = 0;
+
+	Glib::Threads::Mutex::Lock lm (_render_stats_lock);
+	_renders          = 0;
+	_render_usecs     = 0;
+	_render_usecs_max = 0;
+}
+
+void
+WaveViewCache::debug_stats (char const* when) const
+{
+#ifndef NDEBUG
+	if (!DEBUG_ENABLED (PBD::DEBUG::WaveViewCache)) {
+		return;
+	}
+
+	Stats const s (stats ());
+
+	DEBUG_TRACE (PBD::DEBUG::WaveViewCache,
+	             string_compose ("%1: %2 images, %3 of %4 MB, hits %5 misses %6 (%7%%), evictions %8, renders %9 avg %10 us max %11 us\n",
+	                             when, s.images, s.bytes / 1048576, _image_cache_threshold / 1048576,
+	                             s.hits, s.misses, s.hits + s.misses > 0 ? 100 * s.hits / (s.hits + s.misses) : 0,
+	                             s.evictions, s.renders, s.renders > 0 ? s.render_usecs / s.renders : 0, s.render_usecs_max));
+#endif
 }
 
 /*-------------------------------------------------*/
@@ -300,7 +414,23 @@ void
 WaveViewThreads::_enqueue_draw_request (boost::shared_ptr<WaveViewDrawRequest>& request)
 {
 	Glib::Threads::Mutex::Lock lm (_queue_mutex);
-	_queue.push_back (request);
+
+	/* drop requests that were cancelled while waiting */
+	for (DrawRequestQueueType::iterator i = _queue.begin (); i != _queue.end ();) {
+		if ((*i)->stopped ()) {
+			i = _queue.erase (i);
+		} else {
+			++i;
+		}
+	}
+
+	/* insert after all requests with the same or a lower priority value */
+	DrawRequestQueueType::iterator i = _queue.begin ();
+	while (i != _queue.end () && (*i)->priority <= request->priority) {
+		++i;
+	}
+	_queue.insert (i, request);
+
 	/* wake one (random) thread */
 	_cond.signal ();
 }
@@ -378,6 +508,7 @@ WaveViewThreads::stop_threads ()
 
 /*-------------------------------------------------*/
 WaveViewDrawRequest::WaveViewDrawRequest ()
+	: priority (0)
 {
 	g_atomic_int_set (&_stop, 0);
 }
@@ -28,6 +28,7 @@
 namespace PBD {
 	namespace DEBUG {
 		LIBWAVEVIEW_API extern DebugBits WaveView;
+		LIBWAVEVIEW_API extern DebugBits WaveViewCache;
 	}
 }
 
@@ -251,6 +251,9 @@ private:
 
 	void queue_draw_request (boost::shared_ptr<WaveViewDrawRequest> const&) const;
 
+	/** @return the order in which a request for an image with \p props should be rendered */
+	double draw_priority (WaveViewProperties const& props) const;
+
 	static void process_draw_request (boost::shared_ptr<WaveViewDrawRequest>);
 
 	boost::shared_ptr<WaveViewCacheGroup> get_cache_group () const;
@@ -20,6 +20,8 @@
 #define _WAVEVIEW_WAVE_VIEW_PRIVATE_H_
 
 #include <deque>
+#include <list>
+#include <map>
 
 #include "pbd/pthread_utils.h"
 #include "waveview/wave_view.h"
@@ -175,7 +177,6 @@ public: // member variables
 	boost::weak_ptr<const ARDOUR::AudioRegion> region;
 	WaveViewProperties props;
 	Cairo::RefPtr<Cairo::ImageSurface> cairo_image;
-	uint64_t timestamp;
 
 public: // methods
 	bool finished() { return static_cast<bool>(cairo_image); }
@@ -209,6 +210,9 @@ public:
 
 	boost::shared_ptr<WaveViewImage> image;
 
+	/** Requests with a lower value are rendered first, see WaveView::draw_priority() */
+	double priority;
+
 	bool is_valid () {
 		return (image && image->is_valid());
 	}
@@ -218,6 +222,36 @@ private:
 };
 
 class WaveViewCache;
+class WaveViewCacheGroup;
+
+/** The properties of an image that must match for it to be
+ * equivalent to another, apart from the sample range and colors.
+ * Together with the cache group's AudioSource this is the cache key.
+ */
+struct WaveViewImageKey
+{
+	WaveViewImageKey (WaveViewProperties const&);
+
+	bool operator< (WaveViewImageKey const&) const;
+
+	uint16_t        channel;
+	double          samples_per_pixel;
+	double          height;
+	WaveView::Shape shape;
+};
+
+/** An image in the global LRU list of the cache */
+struct WaveViewCacheEntry
+{
+	WaveViewCacheEntry (WaveViewCacheGroup* g, boost::shared_ptr<WaveViewImage> const& i, uint64_t b)
+		: group (g), image (i), bytes (b) {}
+
+	WaveViewCacheGroup*              group;
+	boost::shared_ptr<WaveViewImage> image;
+	uint64_t                         bytes;
+};
+
+typedef std::list<WaveViewCacheEntry> WaveViewCacheLRU;
 
 class WaveViewCacheGroup
 {
@@ -233,13 +267,13 @@ public:
 
 	void add_image (boost::shared_ptr<WaveViewImage>);
 
-	bool full () const { return _cached_images.size() > max_size(); }
-
-	static uint32_t max_size () { return 16; }
-
 	void clear_cache ();
 
 private:
+	friend class WaveViewCache;
+
+	/** called by the parent cache when evicting an image */
+	void remove_image (boost::shared_ptr<WaveViewImage> const&);
 
 	/**
 	 * At time of writing we don't strictly need a reference to the parent cache
@@ -248,10 +282,16 @@ private:
 	 */
 	WaveViewCache& _parent_cache;
 
-	typedef std::list<boost::shared_ptr<WaveViewImage> > ImageCache;
+	typedef std::multimap<WaveViewImageKey, WaveViewCacheLRU::iterator> ImageCache;
 	ImageCache _cached_images;
 };
 
+/** Rendered images of all sources, with a global size limit.
+ *
+ * Images are evicted in least-recently-used order regardless of the
+ * source they belong to. Only used from the GUI thread, except for
+ * the render statistics which are also updated by WaveViewThreads.
+ */
 class WaveViewCache
 {
 public:
@@ -266,6 +306,25 @@ public:
 
 	void reset_cache_group (boost::shared_ptr<WaveViewCacheGroup>&);
 
+	struct Stats {
+		Stats () : hits (0), misses (0), evictions (0), images (0), bytes (0), renders (0), render_usecs (0), render_usecs_max (0) {}
+
+		uint64_t hits;
+		uint64_t misses;
+		uint64_t evictions;
+		uint64_t images;
+		uint64_t bytes;
+		uint64_t renders;
+		uint64_t render_usecs;
+		uint64_t render_usecs_max;
+	};
+
+	Stats stats () const;
+	void reset_stats ();
+
+	/** called after rendering an image, from any thread */
+	void add_render_time (int64_t usecs);
+
 private:
 	WaveViewCache();
 	~WaveViewCache();
@@ -276,14 +335,30 @@ private:
 
 	CacheGroups cache_group_map;
 
+	/** most recently used image at the front */
+	WaveViewCacheLRU _lru;
+
 	uint64_t image_cache_size;
 	uint64_t _image_cache_threshold;
 
+	uint64_t _hits;
+	uint64_t _misses;
+	uint64_t _evictions;
+
+	mutable Glib::Threads::Mutex _render_stats_lock;
+	uint64_t _renders;
+	uint64_t _render_usecs;
+	uint64_t _render_usecs_max;
+
 private:
 	friend class WaveViewCacheGroup;
 
-	void increase_size (uint64_t bytes);
-	void decrease_size (uint64_t bytes);
+	WaveViewCacheLRU::iterator insert (WaveViewCacheGroup*, boost::shared_ptr<WaveViewImage> const&);
+	void touch (WaveViewCacheLRU::iterator, bool hit);
+	void remove (WaveViewCacheLRU::iterator);
+	void evict ();
+	void miss ();
+	void debug_stats (char const* when) const;
 
 	bool full () { return image_cache_size > _image_cache_threshold; }
 };
@@ -343,6 +418,7 @@ private:
 	mutable Glib::Threads::Mutex _queue_mutex;
 	Glib::Threads::Cond _cond;
 
+	/* ordered by WaveViewDrawRequest::priority, FIFO for requests with the same priority */
 	typedef std::deque<boost::shared_ptr<WaveViewDrawRequest> > DrawRequestQueueType;
 	DrawRequestQueueType _queue;
 };
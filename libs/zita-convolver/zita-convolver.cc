@@ -229,6 +229,41 @@ Convproc::impdata_clear (uint32_t inp, uint32_t out)
 	return 0;
 }
 
+int
+Convproc::impdata_link (uint32_t  inp,
+                        uint32_t  out,
+                        Convproc& src,
+                        uint32_t  src_inp,
+                        uint32_t  src_out)
+{
+	uint32_t j;
+
+	if ((_state != ST_STOP) || (src._state == ST_IDLE)) {
+		return Converror::BAD_STATE;
+	}
+	if ((inp >= _ninp) || (out >= _nout) || (src_inp >= src._ninp) || (src_out >= src._nout)) {
+		return Converror::BAD_PARAM;
+	}
+	if ((_nlevels != src._nlevels) || (_options != src._options)) {
+		return Converror::BAD_PARAM;
+	}
+	for (j = 0; j < _nlevels; j++) {
+		if (!_convlev[j]->same_layout (src._convlev[j])) {
+			return Converror::BAD_PARAM;
+		}
+	}
+
+	try {
+		for (j = 0; j < _nlevels; j++) {
+			_convlev[j]->impdata_link (inp, out, src._convlev[j], src_inp, src_out);
+		}
+	} catch (...) {
+		cleanup ();
+		return Converror::MEM_ALLOC;
+	}
+	return 0;
+}
+
 int
 Convproc::reset (void)
 {
@@ -561,6 +596,32 @@ Convlevel::impdata_clear (uint32_t inp, uint32_t out)
 	}
 }
 
+void
+Convlevel::impdata_link (uint32_t   inp,
+                         uint32_t   out,
+                         Convlevel* src,
+                         uint32_t   src_inp,
+                         uint32_t   src_out)
+{
+	Macnode* M;
+	Macnode* S;
+
+	S = src->findmacnode (src_inp, src_out, false);
+	if (S && S->_link) {
+		S = S->_link;
+	}
+	if (S == 0 || S->_fftb == 0) {
+		/* the impulse response does not extend into this level */
+		return;
+	}
+
+	M = findmacnode (inp, out, true);
+	if (M == 0 || M->_fftb) {
+		return;
+	}
+	M->_link = S;
+}
+
 void
 Convlevel::reset (uint32_t inpsize,
                   uint32_t outsize,
@@ -262,6 +262,17 @@ private:
 	void impdata_clear (uint32_t inp,
 	                    uint32_t out);
 
+	void impdata_link (uint32_t   inp,
+	                   uint32_t   out,
+	                   Convlevel* src,
+	                   uint32_t   src_inp,
+	                   uint32_t   src_out);
+
+	bool same_layout (Convlevel const* other) const
+	{
+		return _offs == other->_offs && _npar == other->_npar && _parsize == other->_parsize;
+	}
+
 	void reset (uint32_t inpsize,
 	            uint32_t outsize,
 	            float**  inpbuff,
@@ -386,6 +397,18 @@ public:
 	int impdata_clear (uint32_t inp,
 	                   uint32_t out);
 
+	/* Use the impulse response data of src_inp -> src_out of another
+	 * instance for inp -> out, instead of computing it here.
+	 * Both instances must have been configured with the same parameters.
+	 * The data is not copied: src must not be cleaned up while this
+	 * instance is in use.
+	 */
+	int impdata_link (uint32_t  inp,
+	                  uint32_t  out,
+	                  Convproc& src,
+	                  uint32_t  src_inp,
+	                  uint32_t  src_out);
+
 	void set_options (uint32_t options);
 
 	int reset (void);
@@ -55,6 +55,7 @@ static LuaState*                 lua;
 
 static bool keep_running          = true;
 static bool terminate_when_halted = false;
+static bool offline_engine        = false;
 
 /* extern VST functions */
 int vstfx_init (void*) { return 0; }
@@ -73,8 +74,12 @@ protected:
 				/* ignore */
 				return;
 			case Transmitter::Info:
-				/* ignore */
-				return;
+				if (!offline_engine) {
+					return;
+				}
+				/* include the dummy-backend's timing report */
+				prefix = "[INFO]: ";
+				break;
 			case Transmitter::Warning:
 				prefix = "[WARNING]: ";
 				break;
@@ -157,6 +162,7 @@ init ()
 
 	static LuaReceiver lua_receiver;
 
+	lua_receiver.listen_to (info);
 	lua_receiver.listen_to (warning);
 	lua_receiver.listen_to (error);
 	lua_receiver.listen_to (fatal);
@@ -196,6 +202,15 @@ prepare_engine ()
 		return -1;
 	}
 
+	if (offline_engine) {
+		/* the dummy backend lists its unpaced "Offline" driver last */
+		std::vector<std::string> drivers = engine->current_backend ()->enumerate_drivers ();
+		if (drivers.empty () || engine->current_backend ()->set_driver (drivers.back ())) {
+			std::cerr << "Cannot select offline driver\n";
+			return -1;
+		}
+	}
+
 	if (engine->running ()) {
 		engine->stop ();
 	}
@@ -547,6 +562,8 @@ usage ()
   -h, --help                 display this help and exit\n\
   -i, --interactive          enter interactive mode after executing 'script',\n\
                              force the interpreter to run interactively\n\
+  -O, --offline              process as fast as possible with reproducible\n\
+                             generators, print timing statistics on exit\n\
   -X, --exit-when-halted     terminate when the audio-engine halts\n\
                              unexpectedly (disconnect, or too many xruns)\n\
   -V, --version              print version information and exit\n\
@@ -563,11 +580,12 @@ Ardour at your finger tips...\n\
 int
 main (int argc, char** argv)
 {
-	const char* optstring = "hiVX";
+	const char* optstring = "hiOVX";
 
 	const struct option longopts[] = {
 		{ "help",             0, 0, 'h' },
 		{ "interactive",      0, 0, 'i' },
+		{ "offline",          0, 0, 'O' },
 		{ "version",          0, 0, 'V' },
 		{ "exit-when-halted", 0, 0, 'X' },
 	};
@@ -587,6 +605,10 @@ main (int argc, char** argv)
 				interactive = true;
 				break;
 
+			case 'O':
+				offline_engine = true;
+				break;
+
 			case 'V':
 				printf ("ardour-lua version %s\n\n", VERSIONSTRING);
 				printf ("Copyright (C) GPL 2015-2020 Robin Gareus <robin@gareus.org>\n");
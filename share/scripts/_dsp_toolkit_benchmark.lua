@@ -0,0 +1,183 @@
+ardour { ["type"] = "Snippet", name = "DSP Toolkit Benchmark",
+	license     = "MIT",
+	author      = "Ardour Team",
+	description = [[Compare ARDOUR.DSP block-processing primitives with equivalent per-sample Lua code]]
+}
+
+function factory () return function ()
+
+	local n_samples = 8192
+	local n_iter    = 50
+	local rate      = Session:nominal_sample_rate ()
+
+	-- http://manual.ardour.org/lua-scripting/class_reference/#ARDOUR:DSP:DspShm
+	local cmem = ARDOUR.DSP.DspShm (4 * n_samples)
+	local a = cmem:to_float (0)
+	local b = cmem:to_float (n_samples)
+	local c = cmem:to_float (2 * n_samples)
+
+	local function fill ()
+		local da = a:array ()
+		local db = b:array ()
+		for i = 1, n_samples do
+			da[i] = math.sin (i * .01)
+			db[i] = math.cos (i * .013)
+		end
+	end
+
+	local function bench (name, native, lua)
+		fill ()
+		local t0 = ARDOUR.LuaAPI.monotonic_time ()
+		for i = 1, n_iter do native () end
+		local t1 = ARDOUR.LuaAPI.monotonic_time ()
+		fill ()
+		for i = 1, n_iter do lua () end
+		local t2 = ARDOUR.LuaAPI.monotonic_time ()
+		local tn = (t1 - t0) / n_iter
+		local tl = (t2 - t1) / n_iter
+		print (string.format (" * %-16s | native: %8.1f us  lua: %9.1f us  speedup: %6.1fx",
+		       name, tn, tl, tl / math.max (tn, 1)))
+	end
+
+	print (string.format ("DSP toolkit, %d samples per block, %d iterations", n_samples, n_iter))
+
+	bench ("gain ramp",
+		function () ARDOUR.DSP.gain_ramp (a, 0, 1, n_samples) end,
+		function ()
+			local d = a:array ()
+			local g = 0
+			local dg = 1 / n_samples
+			for i = 1, n_samples do
+				d[i] = d[i] * g
+				g = g + dg
+			end
+		end)
+
+	bench ("mix ramp",
+		function () ARDOUR.DSP.mix_ramp (a, b, 1, 0, n_samples) end,
+		function ()
+			local d = a:array ()
+			local s = b:array ()
+			local g = 1
+			local dg = -1 / n_samples
+			for i = 1, n_samples do
+				d[i] = d[i] + s[i] * g
+				g = g + dg
+			end
+		end)
+
+	bench ("xfade",
+		function () ARDOUR.DSP.xfade (a, b, n_samples, true) end,
+		function ()
+			local d = a:array ()
+			local s = b:array ()
+			for i = 1, n_samples do
+				local p = .5 * math.pi * (i - 1) / n_samples
+				d[i] = d[i] * math.cos (p) + s[i] * math.sin (p)
+			end
+		end)
+
+	local bq = ARDOUR.DSP.BiquadCascade (rate, 4, 1)
+	for s = 0, 3 do
+		bq:compute (s, ARDOUR.DSP.BiquadType.LowPass, 1000, .707, 0)
+	end
+	-- RBJ low-pass coefficients, as used by ARDOUR.DSP.Biquad
+	local w0 = 2 * math.pi * 1000 / rate
+	local alpha = math.sin (w0) / (2 * .707)
+	local a0 = 1 + alpha
+	local b0 = (1 - math.cos (w0)) / (2 * a0)
+	local b1 = (1 - math.cos (w0)) / a0
+	local b2 = b0
+	local a1 = -2 * math.cos (w0) / a0
+	local a2 = (1 - alpha) / a0
+	local z = { 0, 0, 0, 0, 0, 0, 0, 0 }
+
+	bench ("biquad x4",
+		function () bq:run (0, a, n_samples) end,
+		function ()
+			-- direct form II transposed
+			local d = a:array ()
+			for s = 0, 3 do
+				local z1 = z[2 * s + 1]
+				local z2 = z[2 * s + 2]
+				for i = 1, n_samples do
+					local x = d[i]
+					local y = b0 * x + z1
+					z1 = b1 * x - a1 * y + z2
+					z2 = b2 * x - a2 * y
+					d[i] = y
+				end
+				z[2 * s + 1] = z1
+				z[2 * s + 2] = z2
+			end
+		end)
+
+	local ef = ARDOUR.DSP.EnvelopeFollower (rate, 5, 100)
+	local env = 0
+	local ca = 1 - math.exp (-1 / (.005 * rate))
+	local cr = 1 - math.exp (-1 / (.1 * rate))
+
+	bench ("envelope",
+		function () ef:run (a, c, n_samples) end,
+		function ()
+			local d = a:array ()
+			local e = c:array ()
+			for i = 1, n_samples do
+				local x = math.abs (d[i])
+				if x > env then
+					env = env + ca * (x - env)
+				else
+					env = env + cr * (x - env)
+				end
+				e[i] = env
+			end
+		end)
+
+	local rs = ARDOUR.DSP.Resampler (.5, 32)
+	bench ("resample 2:1",
+		function () rs:process (a, n_samples, c, n_samples / 2) end,
+		function ()
+			-- linear interpolation, far lower quality than the native resampler
+			local d = a:array ()
+			local o = c:array ()
+			for i = 1, n_samples / 2 do
+				o[i] = .5 * (d[2 * i - 1] + d[2 * i])
+			end
+		end)
+
+	-- FFT convolution with a short impulse-response held in memory
+	local ir_len = 256
+	local irmem = ARDOUR.DSP.DspShm (ir_len)
+	local ir = irmem:to_float (0):array ()
+	for i = 1, ir_len do ir[i] = math.exp (-i / 32) / 8 end
+
+	local conv = ARDOUR.DSP.Convolution (Session, 1, 1)
+	conv:add_impdata (0, 0, ARDOUR.AudioRom.new_rom (irmem:to_float (0), ir_len), 1, 0, 0, 0, 0)
+	conv:restart ()
+
+	local hist = {}
+	for i = 1, ir_len do hist[i] = 0 end
+
+	bench ("convolution",
+		function () conv:run_mono_no_latency (a, n_samples) end,
+		function ()
+			-- direct-form FIR
+			local d = a:array ()
+			local pos = 1
+			for i = 1, n_samples do
+				hist[pos] = d[i]
+				local acc = 0
+				local k = pos
+				for j = 1, ir_len do
+					acc = acc + hist[k] * ir[j]
+					k = k - 1
+					if k < 1 then k = ir_len end
+				end
+				d[i] = acc
+				pos = pos + 1
+				if pos > ir_len then pos = 1 end
+			end
+		end)
+
+	collectgarbage ()
+end end